@@ -0,0 +1,92 @@
+#include "adpcm.h"
+
+static const int16_t STEPS[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+
+static const int8_t INDEX_ADJUST[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+// Shared by both ends: apply one code to the state
+static inline void step(AdpcmState& s, uint8_t code) {
+    int stepSize = STEPS[s.index];
+    int diff = stepSize >> 3;
+    if (code & 4) diff += stepSize;
+    if (code & 2) diff += stepSize >> 1;
+    if (code & 1) diff += stepSize >> 2;
+    int predictor = s.predictor + ((code & 8) ? -diff : diff);
+    if (predictor > 32767) predictor = 32767;
+    if (predictor < -32768) predictor = -32768;
+    s.predictor = (int16_t)predictor;
+
+    int index = s.index + INDEX_ADJUST[code & 7];
+    if (index < 0) index = 0;
+    if (index > 88) index = 88;
+    s.index = (uint8_t)index;
+}
+
+static inline uint8_t encodeSample(AdpcmState& s, int16_t sample) {
+    int diff = sample - s.predictor;
+    uint8_t code = 0;
+    if (diff < 0) {
+        code = 8;
+        diff = -diff;
+    }
+    int stepSize = STEPS[s.index];
+    if (diff >= stepSize) {
+        code |= 4;
+        diff -= stepSize;
+    }
+    stepSize >>= 1;
+    if (diff >= stepSize) {
+        code |= 2;
+        diff -= stepSize;
+    }
+    stepSize >>= 1;
+    if (diff >= stepSize) code |= 1;
+    step(s, code);
+    return code;
+}
+
+AdpcmEncoder::AdpcmEncoder() {
+    reset();
+}
+
+void AdpcmEncoder::reset() {
+    state.predictor = 0;
+    state.index = 0;
+}
+
+size_t AdpcmEncoder::encode(const int16_t* pcm, size_t count, uint8_t* out) {
+    size_t bytes = count / 2;
+    for (size_t i = 0; i < bytes; i++) {
+        uint8_t lo = encodeSample(state, pcm[2 * i]);
+        uint8_t hi = encodeSample(state, pcm[2 * i + 1]);
+        out[i] = lo | (hi << 4);
+    }
+    return bytes;
+}
+
+AdpcmDecoder::AdpcmDecoder() {
+    reset();
+}
+
+void AdpcmDecoder::reset() {
+    state.predictor = 0;
+    state.index = 0;
+}
+
+size_t AdpcmDecoder::decode(const uint8_t* in, size_t bytes, int16_t* pcm) {
+    for (size_t i = 0; i < bytes; i++) {
+        step(state, in[i] & 0xF);
+        pcm[2 * i] = state.predictor;
+        step(state, in[i] >> 4);
+        pcm[2 * i + 1] = state.predictor;
+    }
+    return bytes * 2;
+}
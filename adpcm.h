@@ -0,0 +1,46 @@
+#ifndef ADPCM_H
+#define ADPCM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// IMA-ADPCM codec
+// 16-bit PCM to 4-bit codes (4:1), one sample at a time, so a recording can
+// be encoded as the microphone delivers it. Codes are packed two per byte,
+// the earlier sample in the low nibble (as in IMA ADPCM WAV files). Both
+// ends start from predictor 0, step index 0; a stream is only decodable
+// from its first byte. Integer only, with the standard step and index
+// tables. No Arduino dependencies; tools/tests/adpcm_test.cpp round-trips
+// WAV files through it on a host, and tools/memos_to_wav.py implements the
+// same decoder.
+
+struct AdpcmState {
+    int16_t predictor;
+    uint8_t index;
+};
+
+class AdpcmEncoder {
+private:
+    AdpcmState state;
+
+public:
+    AdpcmEncoder();
+    void reset();
+
+    // count must be even; writes count / 2 bytes, returns them
+    size_t encode(const int16_t* pcm, size_t count, uint8_t* out);
+};
+
+class AdpcmDecoder {
+private:
+    AdpcmState state;
+
+public:
+    AdpcmDecoder();
+    void reset();
+
+    // Writes bytes * 2 samples, returns them
+    size_t decode(const uint8_t* in, size_t bytes, int16_t* pcm);
+};
+
+#endif
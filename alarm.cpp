@@ -1,4 +1,6 @@
 #include "alarm.h"
+#include "tasks.h"
+#include "timebase.h"
 
 Alarm::Alarm(Settings* sett) {
     settings = sett;
@@ -15,7 +17,7 @@ void Alarm::begin() {
     ledcWriteTone(BUZZER_CHANNEL, 0);
     
     if (settings->nextAlarmTime == 0) {
-        scheduleNext(millis());
+        scheduleNext(TimeBase::epochSec());
     }
 }
 
@@ -35,11 +37,12 @@ void Alarm::update(unsigned long currentTime) {
         stopBuzzer();
     }
     
-    if (!isActive && currentTime >= settings->nextAlarmTime) {
+    int64_t nowSec = TimeBase::epochSec();
+    if (!isActive && nowSec >= settings->nextAlarmTime) {
         if (!isQuietHours()) {
             trigger();
         } else {
-            scheduleNext(currentTime);
+            scheduleNext(nowSec);
         }
     }
 }
@@ -51,7 +54,7 @@ void Alarm::trigger() {
     chirpCount = 0;
     lastChirpTime = 0;
     currentRCType = getRandomRCType();
-    settings->setLastAlarmTime(millis());
+    settings->setLastAlarmTime(TimeBase::epochSec());
 }
 
 void Alarm::dismiss() {
@@ -59,7 +62,7 @@ void Alarm::dismiss() {
     isActive = false;
     stopBuzzer();
     settings->incrementCheckCount();
-    scheduleNext(millis());
+    scheduleNext(TimeBase::epochSec());
 }
 
 bool Alarm::isTriggered() {
@@ -83,8 +86,8 @@ void Alarm::stopBuzzer() {
 bool Alarm::isQuietHours() {
     if (!settings->quietHoursEnabled) return false;
     
-    auto dt = M5.Rtc.getDateTime();
-    int hour = (dt.time.hours + TIMEZONE) % 24;
+    ClockSnapshot clk = Tasks::clock();
+    int hour = (clk.hours + TIMEZONE) % 24;
     
     if (QUIET_START_HOUR < QUIET_END_HOUR) {
         return hour >= QUIET_START_HOUR && hour < QUIET_END_HOUR;
@@ -109,12 +112,11 @@ int Alarm::getRandomRCType() {
     return enabledTypes[randomIndex];
 }
 
-unsigned long Alarm::calculateNextInterval() {
-    unsigned long intervalMinutes = random(MIN_INTERVAL_MINUTES, MAX_INTERVAL_MINUTES + 1);
-    return intervalMinutes * 60 * 1000;
+int64_t Alarm::calculateNextInterval() {
+    int64_t intervalMinutes = random(MIN_INTERVAL_MINUTES, MAX_INTERVAL_MINUTES + 1);
+    return intervalMinutes * 60;
 }
 
-void Alarm::scheduleNext(unsigned long currentTime) {
-    unsigned long interval = calculateNextInterval();
-    settings->setNextAlarmTime(currentTime + interval);
+void Alarm::scheduleNext(int64_t nowSec) {
+    settings->setNextAlarmTime(nowSec + calculateNextInterval());
 }
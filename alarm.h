@@ -19,7 +19,7 @@ private:
     void stopBuzzer();
     bool isQuietHours();
     int getRandomRCType();
-    unsigned long calculateNextInterval();
+    int64_t calculateNextInterval();  // Seconds
     
 public:
     Alarm(Settings* sett);
@@ -29,7 +29,7 @@ public:
     void dismiss();
     bool isTriggered();
     int getCurrentRCType();
-    void scheduleNext(unsigned long currentTime);
+    void scheduleNext(int64_t nowSec);
 };
 
 #endif
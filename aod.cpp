@@ -0,0 +1,84 @@
+#include "aod.h"
+#include <M5StickCPlus2.h>
+#include "config.h"
+#include "night_monitor.h"
+
+// ST7789 commands
+#define ST7789_PTLON 0x12
+#define ST7789_NORON 0x13
+#define ST7789_PTLAR 0x30
+#define ST7789_IDMOFF 0x38
+#define ST7789_IDMON 0x39
+
+static bool active = false;
+static uint32_t savedCpuMhz = 0;
+static int shownMinute = -1;  // Hour * 60 + minute on the panel
+
+static void writeRowPair(uint16_t start, uint16_t end) {
+    M5.Display.writeData(start >> 8);
+    M5.Display.writeData(start & 0xFF);
+    M5.Display.writeData(end >> 8);
+    M5.Display.writeData(end & 0xFF);
+}
+
+void AlwaysOn::enter(uint8_t backlight) {
+    if (active) return;
+    active = true;
+    shownMinute = -1;
+
+    M5.Display.fillScreen(BLACK);
+    M5.Display.startWrite();
+    M5.Display.writeCommand(ST7789_PTLAR);
+    writeRowPair(AOD_PANEL_ROW0 + AOD_X, AOD_PANEL_ROW0 + AOD_X + AOD_WIDTH - 1);
+    M5.Display.writeCommand(ST7789_PTLON);
+    M5.Display.writeCommand(ST7789_IDMON);
+    M5.Display.endWrite();
+    M5.Display.setBrightness(backlight);
+
+    savedCpuMhz = getCpuFrequencyMhz();
+    setCpuFrequencyMhz(CLOCK_FREQUENCY);
+}
+
+void AlwaysOn::exit(uint8_t backlight) {
+    if (!active) return;
+    active = false;
+
+    setCpuFrequencyMhz(savedCpuMhz);
+
+    M5.Display.startWrite();
+    M5.Display.writeCommand(ST7789_IDMOFF);
+    M5.Display.writeCommand(ST7789_NORON);
+    M5.Display.endWrite();
+    M5.Display.fillScreen(BLACK);
+    M5.Display.setBrightness(backlight);
+}
+
+bool AlwaysOn::isActive() {
+    return active;
+}
+
+bool AlwaysOn::needsRedraw(int hour, int minute) {
+    int shown = hour * 60 + minute;
+    if (!active || shown == shownMinute) return false;
+    shownMinute = shown;
+    return true;
+}
+
+float aodMeanCurrentMa(AodPanelMode mode, uint8_t backlight, uint32_t pollMs) {
+    float panel = POWER_PANEL_NORMAL_MA;
+    float active = POWER_CPU_ACTIVE_MA;
+    float idle = POWER_CPU_IDLE_MA;
+    float busyMs = POWER_LOOP_BUSY_MS;
+    if (mode == AOD_PANEL_FACE) {
+        panel = POWER_PANEL_FACE_MA;
+        active = POWER_CPU_SLOW_ACTIVE_MA;
+        idle = POWER_CPU_SLOW_IDLE_MA;
+        busyMs = POWER_LOOP_BUSY_MS * 240 / CLOCK_FREQUENCY;
+    } else if (mode == AOD_PANEL_OFF) {
+        panel = POWER_PANEL_SLEEP_MA;
+        backlight = 0;
+    }
+    float busy = busyMs / (busyMs + pollMs);
+    float cpu = busy * active + (1 - busy) * idle;
+    return POWER_BOARD_MA + POWER_IMU_FULL_MA + panel + POWER_BACKLIGHT_FULL_MA * backlight / 255 + cpu;
+}
@@ -0,0 +1,60 @@
+#ifndef AOD_H
+#define AOD_H
+
+#include <stdint.h>
+
+// Always-on clock face
+// Instead of switching the panel off at screen timeout, the ST7789 is put in
+// idle mode (8 colours, lower drive current) and partial mode so only a band
+// around HH:MM is scanned; the backlight drops to its lowest step and the CPU
+// is clocked down to CLOCK_FREQUENCY. The face is redrawn once a minute from
+// the RTC snapshot. exit() restores full display, backlight level and CPU
+// clock.
+//
+// In landscape (rotation 3) the band is a range of screen columns, since the
+// panel scans along the long edge. It is centred so the same panel rows are
+// selected whichever way the panel is mirrored.
+//
+// aodMeanCurrentMa() models what the face costs against switching the panel
+// off at the timeout, with the constants from night_monitor.h.
+// tools/tests/aod_test.cpp runs AlwaysOn against a host display and prints
+// the comparison.
+
+#define AOD_X 60             // Visible band, screen columns [AOD_X, AOD_X + AOD_WIDTH)
+#define AOD_WIDTH 120        // "HH:MM" at text size 4
+#define AOD_PANEL_ROW0 40    // First visible row in panel memory (135x240 in 240x320)
+#define AOD_LOOP_DELAY_MS 100
+#define AOD_AWAKE_DELAY_MS 10   // loop()'s delay with the panel on or off
+
+// Energy model (mA at the battery), from datasheet figures, as
+// night_monitor.h. The IMU stays on for wake gestures in every mode.
+#define POWER_PANEL_NORMAL_MA 6.0f       // ST7789 scanning all 240 lines, 262k colours
+#define POWER_PANEL_FACE_MA 1.2f         // Idle + partial: 8 colours, AOD_WIDTH lines
+#define POWER_PANEL_SLEEP_MA 0.01f       // Sleep in
+#define POWER_BACKLIGHT_FULL_MA 20.0f    // LED at PWM 255; linear in the duty
+#define POWER_CPU_IDLE_MA 20.0f          // 240 MHz, waiting in delay()
+#define POWER_CPU_SLOW_ACTIVE_MA 13.0f   // CLOCK_FREQUENCY, running
+#define POWER_CPU_SLOW_IDLE_MA 8.0f      // CLOCK_FREQUENCY, waiting in delay()
+#define POWER_LOOP_BUSY_MS 1.5f          // One loop() pass at 240 MHz
+
+enum AodPanelMode {
+    AOD_PANEL_ON,    // Normal mode at the set backlight, full clock
+    AOD_PANEL_FACE,  // The always-on face: idle + partial, CLOCK_FREQUENCY
+    AOD_PANEL_OFF    // Panel asleep, backlight off, full clock
+};
+
+class AlwaysOn {
+public:
+    static void enter(uint8_t backlight);
+    static void exit(uint8_t backlight);
+    static bool isActive();
+
+    // True once per minute change; the caller redraws the face
+    static bool needsRedraw(int hour, int minute);
+};
+
+// Mean battery current in a panel mode, with loop() polled every pollMs.
+// The face's once-a-minute redraw is left out (a few ms a minute).
+float aodMeanCurrentMa(AodPanelMode mode, uint8_t backlight, uint32_t pollMs);
+
+#endif
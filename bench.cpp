@@ -0,0 +1,46 @@
+#include "bench.h"
+
+#ifdef LUCID_BENCH
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "memstats.h"
+#define BENCH_PRINTF logPrintf
+#else
+#include <stdio.h>
+#define BENCH_PRINTF printf
+#endif
+
+void Bench::begin() {
+    BENCH_PRINTF("{\"bench_begin\":{\"firmware\":\"%s\",\"cycles_per_us\":%lu}}\n",
+                 FIRMWARE_VERSION, (unsigned long)Profiler::cyclesPerMicro());
+}
+
+void Bench::run(const char* name, Fn fn, int iterations) {
+    uint32_t minCycles = 0xFFFFFFFFUL;
+    uint32_t maxCycles = 0;
+    uint64_t totalCycles = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        uint32_t start = Profiler::cycles();
+        fn(i);
+        uint32_t elapsed = Profiler::cycles() - start;
+
+        if (elapsed < minCycles) minCycles = elapsed;
+        if (elapsed > maxCycles) maxCycles = elapsed;
+        totalCycles += elapsed;
+    }
+
+    uint32_t cpm = Profiler::cyclesPerMicro();
+    uint32_t mean = iterations > 0 ? (uint32_t)(totalCycles / iterations) : 0;
+    BENCH_PRINTF("{\"bench\":\"%s\",\"iterations\":%d,\"mean_cycles\":%lu,\"min_cycles\":%lu,"
+                 "\"max_cycles\":%lu,\"mean_us\":%lu}\n",
+                 name, iterations, (unsigned long)mean, (unsigned long)minCycles,
+                 (unsigned long)maxCycles, (unsigned long)(mean / cpm));
+}
+
+void Bench::end() {
+    BENCH_PRINTF("{\"bench_end\":true}\n");
+}
+
+#endif
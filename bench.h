@@ -0,0 +1,27 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include "config.h"
+#include "profiler.h"
+
+// On-device benchmark runner
+// Build with -DLUCID_BENCH (m5stick-c-plus2-bench env). Each run prints one
+// JSON line so results can be diffed across firmware versions before flashing.
+// tools/tests/bench.sh runs the same runner on a host, where cycles are
+// nanoseconds.
+
+#if defined(LUCID_BENCH) && !defined(LUCID_PROFILE)
+#error "LUCID_BENCH needs LUCID_PROFILE for the cycle counter"
+#endif
+
+class Bench {
+public:
+    typedef void (*Fn)(int iteration);
+
+    static void begin();
+    static void run(const char* name, Fn fn, int iterations);
+    static void end();
+};
+
+#endif
@@ -0,0 +1,25 @@
+#include "chirp_adapt.h"
+#include "sound_features.h"
+
+// Upper bound of each level but the last, dB
+static const uint8_t LEVEL_MAX_DB[CUE_CHIRP_LEVEL_COUNT - 1] = {40, 50, 60, 70};
+
+uint8_t ChirpAdapt::ambientDb(const int16_t* pcm, int count) {
+    if (count <= 0) return 0;
+    int64_t sum = 0;
+    for (int i = 0; i < count; i++) sum += pcm[i];
+    int32_t dc = (int32_t)(sum / count);
+
+    uint64_t energy = 0;
+    for (int i = 0; i < count; i++) {
+        int32_t v = pcm[i] - dc;
+        energy += (uint64_t)((int64_t)v * v);
+    }
+    return SoundFeatures::powerDb(energy / count);
+}
+
+int ChirpAdapt::levelFor(uint8_t ambientDb) {
+    int level = 0;
+    while (level < CUE_CHIRP_LEVEL_COUNT - 1 && ambientDb >= LEVEL_MAX_DB[level]) level++;
+    return level;
+}
@@ -0,0 +1,31 @@
+#ifndef CHIRP_ADAPT_H
+#define CHIRP_ADAPT_H
+
+#include <stdint.h>
+#include "cue.h"
+
+// Ambient-adaptive reality check chirp
+// CHIRP_SAMPLE_LEAD_SEC before a scheduled reality check the mic records one
+// short window; its DC-removed level (dB re 1 LSB^2, the scale of
+// sound_features.h) picks a row of CUE_CHIRP_LEVELS when the check fires:
+//   < 40 dB  quiet room    2 soft chirps
+//   < 50 dB  office        3 chirps at a third of full volume
+//   < 60 dB  lively room   3 full chirps (the old fixed pattern)
+//   < 70 dB  loud          4 longer chirps at 2.7 kHz
+//   else     street        5 long chirps at 4 kHz
+// At the default mic gain this is roughly SPL minus 5 dB. The trigger only
+// does the table lookup, so it adds no latency; checks without a fresh
+// sample (motion checks, a busy mic) play the default level. No Arduino
+// dependencies; tools/tests/chirp_adapt_test.cpp runs ambient clips through
+// it on a host.
+
+#define CHIRP_SAMPLE_LEAD_SEC 2
+#define CHIRP_AMBIENT_MAX_AGE_SEC 120   // Older samples fall back to the default
+
+class ChirpAdapt {
+public:
+    static uint8_t ambientDb(const int16_t* pcm, int count);
+    static int levelFor(uint8_t ambientDb);  // Index into CUE_CHIRP_LEVELS
+};
+
+#endif
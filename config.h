@@ -1,6 +1,9 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+// Firmware
+#define FIRMWARE_VERSION "2.2"
+
 // Battery
 #define MAX_VOLTAGE 4350
 #define MIN_VOLTAGE 3000
@@ -39,6 +42,17 @@
 #define BUZZER_CHIRP_COUNT 3
 #define BUZZER_CHIRP_INTERVAL 150
 
+// Red LED (M5StickC Plus2 GPIO 19, shared with the IR LED; active high)
+#define LED_PIN 19
+#define LED_CHANNEL 2             // LEDC timer 1, so buzzer tones don't retune it
+#define LED_PWM_HZ 5000
+#define LED_RESOLUTION_BITS 12
+
+// Power / wake (M5StickC Plus2)
+#define POWER_HOLD_PIN 4    // Must stay high or the board powers itself off
+#define WAKE_BUTTON_PIN 37  // Button A, an RTC GPIO so it can end deep sleep
+#define PWR_BUTTON_PIN 35   // Active low; ends light sleep in the night monitor
+
 // Night Quiet Hours
 #define QUIET_START_HOUR 1
 #define QUIET_END_HOUR 7
@@ -58,8 +72,8 @@
 // NVS Storage Keys
 #define NVS_NAMESPACE "lucid_watch"
 #define NVS_CHECKS_PER_DAY "checks_day"
-#define NVS_LAST_ALARM "last_alarm"
-#define NVS_NEXT_ALARM "next_alarm"
+#define NVS_LAST_ALARM "last_alarm_s"  // Epoch seconds; the old keys held millis()
+#define NVS_NEXT_ALARM "next_alarm_s"
 #define NVS_IMU_ENABLED "imu_enabled"
 #define NVS_RC_ENABLED "rc_enabled"
 #define NVS_QUIET_HOURS "quiet_hours"
@@ -98,4 +112,24 @@
 #define IMU_ROTATION_THRESHOLD 200.0f
 #define IMU_WEIRD_PHYSICS_THRESHOLD 20.0f
 
+// Wrist-raise wake (gravity in Q12 g, 4096 = 1 g)
+#define WRIST_ACCEL_WEIGHT 26        // Complementary filter accel weight /256
+#define WRIST_LOW_Z_Q12 1229         // Face turned away: below 0.3 g on Z
+#define WRIST_VIEW_Z_Q12 2867        // Face in view: above 0.7 g on Z
+#define WRIST_RAISE_WINDOW_MS 2500   // Max time from face-away to face-in-view
+#define WRIST_HOLD_MS 300            // Must be held steady this long
+#define WRIST_HOLD_GYRO_DPS 60       // "Steady" angular rate limit
+
+// Motion-context reality checks (features over IMU_BATCH_SIZE samples)
+#define MOTION_RC_HOP 16                    // Re-classify every 16 samples (1.6 s)
+#define MOTION_RC_BURST 2                   // Token bucket capacity
+#define MOTION_RC_REFILL_MS (45UL * 60 * 1000)  // One token per 45 minutes
+#define MOTION_STILL_VAR 0.002f             // |a|^2 variance below this = still
+#define MOTION_STILL_JERK 0.05f
+#define MOTION_WALK_CROSSINGS 6             // 1 g crossings per window for walking
+#define MOTION_WALK_VAR 0.02f
+#define MOTION_STAND_UP_JERK 1.0f
+#define MOTION_FREE_FALL_MAG_SQ 0.09f       // Below 0.3 g
+#define MOTION_SPIN_DPS IMU_ROTATION_THRESHOLD
+
 #endif
@@ -0,0 +1,199 @@
+#include "cue.h"
+#include "config.h"
+#include <string.h>
+
+// Reality check alarm: 3 x 100 ms chirps, 150 ms apart, 50% duty
+static const CueStep REALITY_CHECK_STEPS[] = {
+    {BUZZER_FREQUENCY, 128, BUZZER_CHIRP_DURATION},
+    {0, 0, BUZZER_CHIRP_INTERVAL},
+    {BUZZER_FREQUENCY, 128, BUZZER_CHIRP_DURATION},
+    {0, 0, BUZZER_CHIRP_INTERVAL},
+    {BUZZER_FREQUENCY, 128, BUZZER_CHIRP_DURATION}
+};
+
+// REM cue / dream journal: 800, 900, 1000 Hz at 25% volume
+static const CueStep REM_GENTLE_STEPS[] = {
+    {800, 64, 200},
+    {0, 0, 250},
+    {900, 64, 200},
+    {0, 0, 250},
+    {1000, 64, 200},
+    {0, 0, 250}
+};
+
+// REM cue as wavetable notes: the release lets each tone ring out into the
+// gap instead of stopping dead
+static const CueStep REM_WAVE_STEPS[] = {
+    {800, 64, 300},
+    {0, 0, 150},
+    {900, 64, 300},
+    {0, 0, 150},
+    {1000, 64, 400},
+    {0, 0, 100}
+};
+
+// Dream journal memo starts: two quick rising tones
+static const CueStep MEMO_START_STEPS[] = {
+    {1000, 48, 40},
+    {1500, 48, 60}
+};
+
+// REM cue levels: same tones, duty 8 (barely audible) to 128, 100-300 ms
+#define REM_STEPS(level, ms) \
+    {{800, level, ms}, {0, 0, 250}, {900, level, ms}, {0, 0, 250}, {1000, level, ms}, {0, 0, 250}}
+static const CueStep REM_LEVEL_STEPS[CUE_REM_LEVEL_COUNT][6] = {
+    REM_STEPS(8, 100),
+    REM_STEPS(12, 120),
+    REM_STEPS(20, 150),
+    REM_STEPS(32, 150),
+    REM_STEPS(48, 200),
+    REM_STEPS(64, 200),
+    REM_STEPS(96, 250),
+    REM_STEPS(128, 300)
+};
+
+// Reality check by ambient level: more, longer chirps as it gets louder,
+// and above 60 dB higher tones, nearer the buzzer's resonance, so they carry
+// further at the same duty (128 is already the loudest square wave)
+#define CHIRP_GAP {0, 0, BUZZER_CHIRP_INTERVAL}
+static const CueStep CHIRP_QUIET_STEPS[] = {
+    {BUZZER_FREQUENCY, 16, 80}, CHIRP_GAP, {BUZZER_FREQUENCY, 16, 80}
+};
+static const CueStep CHIRP_OFFICE_STEPS[] = {
+    {BUZZER_FREQUENCY, 40, 100}, CHIRP_GAP, {BUZZER_FREQUENCY, 40, 100}, CHIRP_GAP, {BUZZER_FREQUENCY, 40, 100}
+};
+static const CueStep CHIRP_LOUD_STEPS[] = {
+    {2700, 128, 150}, CHIRP_GAP, {2700, 128, 150}, CHIRP_GAP, {2700, 128, 150}, CHIRP_GAP, {2700, 128, 150}
+};
+static const CueStep CHIRP_STREET_STEPS[] = {
+    {4000, 128, 200}, CHIRP_GAP, {4000, 128, 200}, CHIRP_GAP, {4000, 128, 200}, CHIRP_GAP,
+    {4000, 128, 200}, CHIRP_GAP, {4000, 128, 200}
+};
+#define STEP_COUNT(steps) (sizeof(steps) / sizeof(steps[0]))
+
+// Light cues. Flashes ramp over 40 ms rather than snapping, which reads as
+// softer at the same peak; breaths take 1.2 s each way
+#define LED_FLASH {CUE_LED_FADE, 255, 40}, {0, 255, 60}, {CUE_LED_FADE, 0, 40}
+static const CueStep LIGHT_REALITY_CHECK_STEPS[] = {
+    LED_FLASH, {0, 0, 110}, LED_FLASH, {0, 0, 110}, LED_FLASH
+};
+
+#define LED_BREATHS(level) \
+    {{CUE_LED_FADE, level, 1200}, {CUE_LED_FADE, 0, 1200}, {0, 0, 400}, \
+     {CUE_LED_FADE, level, 1200}, {CUE_LED_FADE, 0, 1200}, {0, 0, 400}, \
+     {CUE_LED_FADE, level, 1200}, {CUE_LED_FADE, 0, 1200}, {0, 0, 400}}
+static const CueStep LIGHT_REM_LEVEL_STEPS[CUE_REM_LEVEL_COUNT][9] = {
+    LED_BREATHS(8),
+    LED_BREATHS(12),
+    LED_BREATHS(20),
+    LED_BREATHS(32),
+    LED_BREATHS(48),
+    LED_BREATHS(64),
+    LED_BREATHS(96),
+    LED_BREATHS(128)
+};
+
+static const CueStep LIGHT_MEMO_STEPS[] = {
+    LED_FLASH
+};
+
+// Morse at a 150 ms unit: dot 1, dash 3, gap 1 within a letter, 7 between words
+#define LED_DOT {0, 200, 150}, {0, 0, 150}
+#define LED_DASH {0, 200, 450}, {0, 0, 150}
+#define LED_WORD_GAP {0, 0, 900}
+static const CueStep LIGHT_ALARM_STEPS[] = {
+    LED_DOT, LED_DASH, LED_DASH, LED_WORD_GAP,
+    LED_DOT, LED_DASH, LED_DASH
+};
+
+const CuePattern CUE_REM_GENTLE = {
+    "rem_gentle", REM_GENTLE_STEPS, sizeof(REM_GENTLE_STEPS) / sizeof(REM_GENTLE_STEPS[0]),
+    CUE_VOICE_SQUARE, NULL, 0
+};
+
+const CuePattern CUE_REM_WAVE = {
+    "rem_wave", REM_WAVE_STEPS, STEP_COUNT(REM_WAVE_STEPS), CUE_VOICE_WAVE, NULL, 0
+};
+
+const CuePattern CUE_REM_LEVELS[CUE_REM_LEVEL_COUNT] = {
+    {"rem_l0", REM_LEVEL_STEPS[0], 6, CUE_VOICE_SQUARE, NULL, 0},
+    {"rem_l1", REM_LEVEL_STEPS[1], 6, CUE_VOICE_SQUARE, NULL, 0},
+    {"rem_l2", REM_LEVEL_STEPS[2], 6, CUE_VOICE_SQUARE, NULL, 0},
+    {"rem_l3", REM_LEVEL_STEPS[3], 6, CUE_VOICE_SQUARE, NULL, 0},
+    {"rem_l4", REM_LEVEL_STEPS[4], 6, CUE_VOICE_SQUARE, NULL, 0},
+    {"rem_l5", REM_LEVEL_STEPS[5], 6, CUE_VOICE_SQUARE, NULL, 0},
+    {"rem_l6", REM_LEVEL_STEPS[6], 6, CUE_VOICE_SQUARE, NULL, 0},
+    {"rem_l7", REM_LEVEL_STEPS[7], 6, CUE_VOICE_SQUARE, NULL, 0}
+};
+
+const CuePattern CUE_CHIRP_LEVELS[CUE_CHIRP_LEVEL_COUNT] = {
+    {"chirp_quiet", CHIRP_QUIET_STEPS, STEP_COUNT(CHIRP_QUIET_STEPS), CUE_VOICE_SQUARE, NULL, 0},
+    {"chirp_office", CHIRP_OFFICE_STEPS, STEP_COUNT(CHIRP_OFFICE_STEPS), CUE_VOICE_SQUARE, NULL, 0},
+    {"reality_check", REALITY_CHECK_STEPS, STEP_COUNT(REALITY_CHECK_STEPS), CUE_VOICE_SQUARE, NULL, 0},
+    {"chirp_loud", CHIRP_LOUD_STEPS, STEP_COUNT(CHIRP_LOUD_STEPS), CUE_VOICE_SQUARE, NULL, 0},
+    {"chirp_street", CHIRP_STREET_STEPS, STEP_COUNT(CHIRP_STREET_STEPS), CUE_VOICE_SQUARE, NULL, 0}
+};
+
+// The plain reality check is the default chirp level, not a copy of it
+const CuePattern& CUE_REALITY_CHECK = CUE_CHIRP_LEVELS[CUE_CHIRP_DEFAULT_LEVEL];
+
+const CuePattern CUE_MEMO_START = {
+    "memo_start", MEMO_START_STEPS, STEP_COUNT(MEMO_START_STEPS), CUE_VOICE_SQUARE, NULL, 0
+};
+
+const CuePattern CUE_LIGHT_REALITY_CHECK = {
+    "led_pulse", LIGHT_REALITY_CHECK_STEPS, STEP_COUNT(LIGHT_REALITY_CHECK_STEPS), CUE_VOICE_LIGHT, NULL, 0
+};
+
+const CuePattern CUE_LIGHT_REM_LEVELS[CUE_REM_LEVEL_COUNT] = {
+    {"led_rem_l0", LIGHT_REM_LEVEL_STEPS[0], 9, CUE_VOICE_LIGHT, NULL, 0},
+    {"led_rem_l1", LIGHT_REM_LEVEL_STEPS[1], 9, CUE_VOICE_LIGHT, NULL, 0},
+    {"led_rem_l2", LIGHT_REM_LEVEL_STEPS[2], 9, CUE_VOICE_LIGHT, NULL, 0},
+    {"led_rem_l3", LIGHT_REM_LEVEL_STEPS[3], 9, CUE_VOICE_LIGHT, NULL, 0},
+    {"led_rem_l4", LIGHT_REM_LEVEL_STEPS[4], 9, CUE_VOICE_LIGHT, NULL, 0},
+    {"led_rem_l5", LIGHT_REM_LEVEL_STEPS[5], 9, CUE_VOICE_LIGHT, NULL, 0},
+    {"led_rem_l6", LIGHT_REM_LEVEL_STEPS[6], 9, CUE_VOICE_LIGHT, NULL, 0},
+    {"led_rem_l7", LIGHT_REM_LEVEL_STEPS[7], 9, CUE_VOICE_LIGHT, NULL, 0}
+};
+
+const CuePattern CUE_LIGHT_ALARM = {
+    "led_morse", LIGHT_ALARM_STEPS, STEP_COUNT(LIGHT_ALARM_STEPS), CUE_VOICE_LIGHT, NULL, 0
+};
+
+const CuePattern CUE_LIGHT_MEMO = {
+    "led_flash", LIGHT_MEMO_STEPS, STEP_COUNT(LIGHT_MEMO_STEPS), CUE_VOICE_LIGHT, NULL, 0
+};
+
+const char* cueOutputName(uint8_t output) {
+    switch (output) {
+        case CUE_OUT_LIGHT: return "Light";
+        case CUE_OUT_BOTH: return "Both";
+        default: return "Sound";
+    }
+}
+
+uint32_t cueDurationMs(const CuePattern& pattern) {
+    uint32_t total = 0;
+    for (int i = 0; i < pattern.count; i++) {
+        total += pattern.steps[i].durationMs;
+    }
+    return total;
+}
+
+const CuePattern* cueByName(const char* name) {
+    static const CuePattern* const NAMED[] = {
+        &CUE_REALITY_CHECK, &CUE_REM_GENTLE, &CUE_REM_WAVE, &CUE_CHIME, &CUE_MEMO_START,
+        &CUE_LIGHT_REALITY_CHECK, &CUE_LIGHT_ALARM, &CUE_LIGHT_MEMO
+    };
+    for (size_t i = 0; i < STEP_COUNT(NAMED); i++) {
+        if (strcmp(NAMED[i]->name, name) == 0) return NAMED[i];
+    }
+    for (int i = 0; i < CUE_REM_LEVEL_COUNT; i++) {
+        if (strcmp(CUE_REM_LEVELS[i].name, name) == 0) return &CUE_REM_LEVELS[i];
+        if (strcmp(CUE_LIGHT_REM_LEVELS[i].name, name) == 0) return &CUE_LIGHT_REM_LEVELS[i];
+    }
+    for (int i = 0; i < CUE_CHIRP_LEVEL_COUNT; i++) {
+        if (strcmp(CUE_CHIRP_LEVELS[i].name, name) == 0) return &CUE_CHIRP_LEVELS[i];
+    }
+    return NULL;
+}
@@ -0,0 +1,89 @@
+#ifndef CUE_H
+#define CUE_H
+
+#include <stdint.h>
+
+// Cue patterns
+// A cue is a fixed list of steps played by the audio task. The same format
+// drives every cue output, so a pattern can be tuned in one place. The
+// voice picks how the buzzer plays it:
+//   square - one LEDC tone per step (the default when left out)
+//   wave   - each step a wavetable note with attack and release, streamed
+//            as PWM samples (wave_synth.h)
+//   clip   - an IMA-ADPCM clip from flash at WAVE_SAMPLE_RATE; its single
+//            step gives the level and the clip's length
+//   light  - the red LED instead of the buzzer (the light task in tasks.h):
+//            level is brightness, and freqHz is CUE_LED_FADE to fade there
+//            over the step with the LEDC fade engine, or 0 to switch at once
+//            and hold
+
+struct CueStep {
+    uint16_t freqHz;      // 0 = silence for durationMs
+    uint8_t level;        // PWM duty, 0-255 (128 = loudest square wave)
+    uint16_t durationMs;
+};
+
+enum CueVoice : uint8_t {
+    CUE_VOICE_SQUARE,
+    CUE_VOICE_WAVE,
+    CUE_VOICE_CLIP,
+    CUE_VOICE_LIGHT
+};
+
+#define CUE_LED_FADE 1
+
+struct CuePattern {
+    const char* name;
+    const CueStep* steps;
+    uint8_t count;
+    uint8_t voice;          // CueVoice
+    const uint8_t* clip;    // CUE_VOICE_CLIP only
+    uint16_t clipBytes;
+};
+
+extern const CuePattern& CUE_REALITY_CHECK; // 3 sharp chirps (a CUE_CHIRP_LEVELS row)
+extern const CuePattern CUE_REM_GENTLE;     // 3 soft ascending tones
+extern const CuePattern CUE_REM_WAVE;       // The same tones as wavetable notes
+extern const CuePattern CUE_CHIME;          // Recorded chime clip (cue_clips.cpp)
+extern const CuePattern CUE_MEMO_START;     // Short rising blip: recording
+
+// Night-mode REM cue, quietest first (see cue_adapt.h). The default level
+// is CUE_REM_GENTLE.
+#define CUE_REM_LEVEL_COUNT 8
+#define CUE_REM_DEFAULT_LEVEL 5
+extern const CuePattern CUE_REM_LEVELS[CUE_REM_LEVEL_COUNT];
+
+// Reality check chirps by ambient noise, quietest first (see
+// chirp_adapt.h). The default level is CUE_REALITY_CHECK.
+#define CUE_CHIRP_LEVEL_COUNT 5
+#define CUE_CHIRP_DEFAULT_LEVEL 2
+extern const CuePattern CUE_CHIRP_LEVELS[CUE_CHIRP_LEVEL_COUNT];
+
+// Light cues, one per event. The REM cue breathes at a brightness that
+// follows the learned REM level.
+extern const CuePattern CUE_LIGHT_REALITY_CHECK;                    // 3 quick flashes
+extern const CuePattern CUE_LIGHT_REM_LEVELS[CUE_REM_LEVEL_COUNT];  // 3 slow breaths
+extern const CuePattern CUE_LIGHT_ALARM;                            // "W" in Morse, twice
+extern const CuePattern CUE_LIGHT_MEMO;                             // 1 flash: memo started or saved
+
+// Where each event's cue plays (per-event setting)
+enum CueEvent : uint8_t {
+    CUE_EVENT_REALITY_CHECK,
+    CUE_EVENT_REM,
+    CUE_EVENT_ALARM,
+    CUE_EVENT_COUNT
+};
+
+#define CUE_OUT_SOUND 1
+#define CUE_OUT_LIGHT 2
+#define CUE_OUT_BOTH 3
+const char* cueOutputName(uint8_t output);
+
+// Total length of a pattern in ms
+uint32_t cueDurationMs(const CuePattern& pattern);
+
+// Every named pattern, for the serial "cue" command and tools/cue_to_wav;
+// NULL if none matches
+const CuePattern* cueByName(const char* name);
+
+#endif
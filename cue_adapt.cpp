@@ -0,0 +1,67 @@
+#include "cue_adapt.h"
+
+CueAdapt::CueAdapt() {
+    begin(CUE_REM_DEFAULT_LEVEL);
+}
+
+void CueAdapt::begin(int learnedLevel, int extra) {
+    if (learnedLevel < 0 || learnedLevel >= CUE_REM_LEVEL_COUNT) learnedLevel = CUE_REM_DEFAULT_LEVEL;
+    if (extra < 0 || extra > CUE_MAX_EXTRA_MIN) extra = 0;
+    level = learnedLevel;
+    extraMin = extra;
+    quietCues = 0;
+    listening = false;
+    response = CUE_RESPONSE_NONE;
+}
+
+const CuePattern& CueAdapt::startCue() {
+    listening = true;
+    primed = false;
+    samples = 0;
+    moves = 0;
+    return CUE_REM_LEVELS[level];
+}
+
+bool CueAdapt::update(float ax, float ay, float az) {
+    if (!listening) return false;
+
+    if (primed) {
+        float dx = ax - lastX;
+        float dy = ay - lastY;
+        float dz = az - lastZ;
+        if (dx * dx + dy * dy + dz * dz > CUE_MOVE_G2) moves++;
+    }
+    lastX = ax;
+    lastY = ay;
+    lastZ = az;
+    primed = true;
+
+    if (++samples < CUE_RESPONSE_SAMPLES) return false;
+    listening = false;
+
+    if (moves >= CUE_AROUSAL_MOVES) {
+        response = CUE_RESPONSE_AROUSAL;
+        level = level > CUE_BACKOFF_LEVELS ? level - CUE_BACKOFF_LEVELS : 0;
+        extraMin = extraMin + CUE_BACKOFF_MIN < CUE_MAX_EXTRA_MIN ? extraMin + CUE_BACKOFF_MIN : CUE_MAX_EXTRA_MIN;
+        quietCues = 0;
+        return true;
+    }
+
+    if (extraMin > 0) extraMin--;
+    if (moves >= CUE_STIR_MOVES) {
+        response = CUE_RESPONSE_STIR;
+        quietCues = 0;
+    } else {
+        response = CUE_RESPONSE_NONE;
+        if (++quietCues >= CUE_NUDGE_AFTER) {
+            if (level + 1 < CUE_REM_LEVEL_COUNT) level++;
+            quietCues = 0;
+        }
+    }
+    return true;
+}
+
+const char* CueAdapt::responseName(CueResponse r) {
+    static const char* NAMES[] = {"none", "stir", "arousal"};
+    return r <= CUE_RESPONSE_AROUSAL ? NAMES[r] : "?";
+}
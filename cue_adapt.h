@@ -0,0 +1,68 @@
+#ifndef CUE_ADAPT_H
+#define CUE_ADAPT_H
+
+#include <stdint.h>
+#include "cue.h"
+
+// Closed-loop REM cue control
+// After each night-mode cue the next CUE_RESPONSE_SAMPLES IMU samples are
+// checked for movement (same squared-delta test as smart_wake.h):
+//   none    - the cue went unnoticed; after CUE_NUDGE_AFTER in a row the
+//             level goes up one step
+//   stir    - a few movements: perceived without waking, level is kept
+//   arousal - sustained movement: level drops CUE_BACKOFF_LEVELS and the
+//             gap to the next cue grows by CUE_BACKOFF_MIN
+// Levels index CUE_REM_LEVELS (volume and tone length). The level carries
+// over to the next night; the extra spacing starts at zero each night and
+// shrinks by a minute after every calm cue. Constant memory, O(1) per
+// sample. No Arduino dependencies; tools/tests/cue_adapt_test.cpp replays
+// synthetic response traces through it on a host.
+
+#define CUE_RESPONSE_SAMPLES 150   // 15 s at 10 Hz from the start of the cue
+#define CUE_MOVE_G2 0.0025f        // (0.05 g)^2 between consecutive samples
+#define CUE_STIR_MOVES 2           // Moving samples that count as a response
+#define CUE_AROUSAL_MOVES 15       // ... and as waking up
+#define CUE_NUDGE_AFTER 2          // Unanswered cues before a step up
+#define CUE_BACKOFF_LEVELS 2
+#define CUE_BACKOFF_MIN 4          // Extra minutes to the next cue per arousal
+#define CUE_MAX_EXTRA_MIN 16
+
+enum CueResponse : uint8_t {
+    CUE_RESPONSE_NONE,
+    CUE_RESPONSE_STIR,
+    CUE_RESPONSE_AROUSAL
+};
+
+class CueAdapt {
+private:
+    uint8_t level;
+    uint8_t extraMin;
+    uint8_t quietCues;  // Consecutive unanswered cues
+    bool listening;
+    bool primed;
+    int samples;
+    int moves;
+    float lastX;
+    float lastY;
+    float lastZ;
+    CueResponse response;
+
+public:
+    CueAdapt();
+    void begin(int learnedLevel, int extra = 0);  // Start (or resumed) night
+
+    // Pattern for the next cue; opens the response window
+    const CuePattern& startCue();
+
+    // Feed one sample (accel in g) while listening. True when the window
+    // closes and the level/spacing have been updated.
+    bool update(float ax, float ay, float az);
+
+    bool isListening() { return listening; }
+    int getLevel() { return level; }
+    int getExtraMin() { return extraMin; }
+    CueResponse lastResponse() { return response; }
+    static const char* responseName(CueResponse r);
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include "cue.h"
+
+// Recorded cue clips, IMA-ADPCM at WAVE_SAMPLE_RATE (wave_synth.h), kept in
+// flash and decoded by the audio task as they play. Generated with
+// tools/cue_to_wav.cpp --encode; the comment above each array says from what.
+
+// Chime: G6 bell, partials at 2x and 2.4x, 220 ms decay, 30 ms fade-out
+// CHIME_CLIP: 0.60 s at 8000 Hz, 2400 bytes
+static const uint8_t CHIME_CLIP[] = {
+    0x70, 0xf7, 0x2f, 0x77, 0xff, 0x78, 0x88, 0x1e, 0x96, 0xb8, 0x60, 0xb0, 0xb8, 0x07, 0xa9, 0x58,
+    0xb1, 0xa9, 0x17, 0x8b, 0x7b, 0x90, 0x9a, 0x43, 0x8b, 0x3c, 0xa4, 0xb9, 0x34, 0xb9, 0x0a, 0x97,
+    0xa8, 0x51, 0x99, 0x0a, 0x05, 0x8b, 0x79, 0x89, 0x8b, 0x15, 0xaa, 0x59, 0xa1, 0xc8, 0x05, 0xa9,
+    0x39, 0xb5, 0xb8, 0x34, 0x8b, 0x3c, 0x93, 0xab, 0x70, 0x98, 0x0a, 0x86, 0xa9, 0x40, 0xb0, 0x99,
+    0x87, 0xb8, 0x58, 0x90, 0x9a, 0x15, 0x8a, 0x5b, 0x91, 0x9a, 0x52, 0x9a, 0x2a, 0xa5, 0xb8, 0x33,
+    0xb9, 0x0a, 0x87, 0xa9, 0x70, 0x99, 0x0a, 0x05, 0x9a, 0x69, 0x98, 0x8a, 0x05, 0x9a, 0x49, 0xb2,
+    0xc8, 0x15, 0xa9, 0x29, 0xa4, 0xb9, 0x63, 0x8a, 0x3b, 0x83, 0x9c, 0x70, 0x99, 0x09, 0x95, 0xa8,
+    0x58, 0xa0, 0x99, 0x86, 0xa9, 0x48, 0xa1, 0x9a, 0x25, 0x9b, 0x6b, 0x91, 0x9a, 0x43, 0xaa, 0x3a,
+    0xa5, 0xc8, 0x42, 0xa9, 0x09, 0x96, 0xa8, 0x50, 0x89, 0x0a, 0x04, 0x8b, 0x7a, 0x98, 0x99, 0x05,
+    0x99, 0x4a, 0xb2, 0xb8, 0x15, 0xa9, 0x39, 0xa4, 0xba, 0x73, 0x99, 0x2a, 0x83, 0xab, 0x78, 0x98,
+    0x0a, 0x86, 0xa9, 0x40, 0xa0, 0xa9, 0x07, 0xa9, 0x59, 0x90, 0x99, 0x33, 0x8c, 0x5b, 0x91, 0x9a,
+    0x52, 0x9a, 0x2a, 0xa5, 0xb8, 0x52, 0xb8, 0x09, 0x86, 0xa9, 0x68, 0x98, 0x0a, 0x04, 0x9a, 0x6a,
+    0x90, 0x99, 0x14, 0xaa, 0x49, 0xa2, 0xc9, 0x24, 0xa9, 0x3a, 0xa5, 0xb9, 0x62, 0x99, 0x1a, 0x85,
+    0xaa, 0x60, 0x98, 0x0a, 0x84, 0xa9, 0x40, 0xb1, 0xa9, 0x07, 0x99, 0x39, 0xa2, 0x9b, 0x44, 0x9b,
+    0x5b, 0x92, 0xaa, 0x53, 0x9a, 0x2b, 0x97, 0xa9, 0x41, 0xa8, 0x89, 0x86, 0xa9, 0x50, 0x98, 0x0a,
+    0x04, 0x9a, 0x6a, 0x90, 0x99, 0x14, 0xaa, 0x49, 0xa2, 0xc9, 0x24, 0xa9, 0x2a, 0x96, 0x9a, 0x51,
+    0x99, 0x1a, 0x84, 0xaa, 0x70, 0x98, 0x0a, 0x84, 0xa9, 0x58, 0xb1, 0x99, 0x15, 0x9a, 0x5a, 0xa1,
+    0x99, 0x43, 0x9b, 0x5b, 0x92, 0xba, 0x63, 0xa9, 0x2a, 0x95, 0xb9, 0x52, 0xa8, 0x0a, 0x86, 0xa9,
+    0x58, 0xa0, 0x89, 0x14, 0x9b, 0x59, 0xa1, 0x9a, 0x15, 0xa9, 0x4a, 0xb3, 0xc9, 0x24, 0xa9, 0x2a,
+    0x96, 0x9a, 0x51, 0x99, 0x1a, 0x85, 0xaa, 0x60, 0x98, 0x8a, 0x05, 0x9a, 0x48, 0xa0, 0x99, 0x15,
+    0xaa, 0x59, 0x91, 0xaa, 0x34, 0x9b, 0x4b, 0xa4, 0xaa, 0x53, 0xa9, 0x1a, 0x97, 0x99, 0x40, 0xa8,
+    0x89, 0x86, 0x99, 0x48, 0xa0, 0x8a, 0x15, 0xaa, 0x59, 0xa1, 0xa9, 0x15, 0xa9, 0x39, 0xa4, 0xba,
+    0x44, 0x9a, 0x3b, 0x95, 0xaa, 0x61, 0xa8, 0x1a, 0x85, 0x9a, 0x58, 0xa0, 0x8a, 0x06, 0xa9, 0x38,
+    0xb2, 0xaa, 0x16, 0xa9, 0x5a, 0x91, 0x9a, 0x43, 0xaa, 0x4b, 0x94, 0xba, 0x53, 0xa9, 0x1a, 0x97,
+    0xa8, 0x40, 0x98, 0x8a, 0x86, 0x99, 0x48, 0xa0, 0x8a, 0x15, 0xaa, 0x59, 0xa1, 0xa9, 0x24, 0xb9,
+    0x4a, 0xa4, 0xb9, 0x53, 0xa9, 0x2a, 0x95, 0xaa, 0x71, 0xa8, 0x09, 0x84, 0xa9, 0x58, 0xa0, 0x99,
+    0x06, 0xa9, 0x38, 0xb2, 0xaa, 0x26, 0xaa, 0x5a, 0xa2, 0xaa, 0x53, 0xa9, 0x2a, 0x95, 0xaa, 0x52,
+    0xa8, 0x1b, 0x87, 0xa9, 0x40, 0x98, 0x8a, 0x05, 0x9a, 0x59, 0xa1, 0x8a, 0x14, 0xaa, 0x59, 0xa2,
+    0xba, 0x25, 0xb9, 0x39, 0xa5, 0xb9, 0x53, 0xa9, 0x2b, 0x86, 0xaa, 0x51, 0xa8, 0x0a, 0x86, 0xa9,
+    0x40, 0xa0, 0x8a, 0x15, 0xaa, 0x59, 0xa1, 0xa9, 0x24, 0xaa, 0x5a, 0x92, 0xab, 0x63, 0xa9, 0x2a,
+    0x95, 0xb9, 0x52, 0xa8, 0x0a, 0x86, 0xa9, 0x40, 0xa0, 0x8a, 0x15, 0x9b, 0x59, 0xa1, 0x9a, 0x15,
+    0x9a, 0x4a, 0xa3, 0xab, 0x25, 0xb9, 0x3a, 0x97, 0xaa, 0x52, 0x99, 0x1a, 0x84, 0xaa, 0x60, 0x98,
+    0x0a, 0x04, 0xaa, 0x68, 0xa0, 0x99, 0x15, 0xaa, 0x49, 0xa2, 0xaa, 0x25, 0xaa, 0x4a, 0x93, 0xbb,
+    0x54, 0xa9, 0x3b, 0x95, 0xaa, 0x61, 0xa8, 0x09, 0x04, 0xba, 0x60, 0xa0, 0x8a, 0x05, 0xa9, 0x59,
+    0xa1, 0x8a, 0x33, 0xbb, 0x6a, 0x92, 0xab, 0x44, 0xb9, 0x3a, 0x95, 0xba, 0x53, 0xb8, 0x1a, 0x86,
+    0x9a, 0x68, 0x98, 0x0a, 0x04, 0xaa, 0x58, 0xa1, 0x9a, 0x15, 0xaa, 0x38, 0xa3, 0xac, 0x25, 0xb9,
+    0x4a, 0x94, 0xab, 0x53, 0xa9, 0x2a, 0x85, 0xab, 0x61, 0xa8, 0x09, 0x04, 0xba, 0x60, 0xa0, 0x8a,
+    0x15, 0xaa, 0x59, 0xa1, 0x8a, 0x33, 0xca, 0x5a, 0x92, 0xab, 0x34, 0xb9, 0x3b, 0x87, 0xaa, 0x51,
+    0xa8, 0x0a, 0x05, 0xaa, 0x68, 0xa0, 0x0a, 0x04, 0xaa, 0x58, 0xa1, 0x9a, 0x15, 0xb9, 0x49, 0xa3,
+    0xab, 0x44, 0xaa, 0x3a, 0x95, 0xaa, 0x52, 0xb8, 0x1a, 0x86, 0xaa, 0x51, 0xa8, 0x89, 0x05, 0xaa,
+    0x40, 0xa1, 0x8b, 0x15, 0xaa, 0x59, 0xa2, 0x9b, 0x34, 0xba, 0x5b, 0xa4, 0xaa, 0x53, 0xa9, 0x2a,
+    0x85, 0xab, 0x61, 0xa8, 0x1a, 0x85, 0x9a, 0x58, 0xa0, 0x0a, 0x14, 0xba, 0x58, 0xa1, 0x9a, 0x25,
+    0xba, 0x49, 0xa3, 0xbb, 0x35, 0xb9, 0x4b, 0x94, 0xba, 0x72, 0xa8, 0x1a, 0x85, 0xaa, 0x41, 0xb0,
+    0x0a, 0x06, 0xaa, 0x58, 0x90, 0x8a, 0x14, 0xaa, 0x5a, 0xa2, 0xaa, 0x34, 0xc9, 0x39, 0x94, 0xbb,
+    0x44, 0xa9, 0x2b, 0x86, 0xaa, 0x51, 0xa8, 0x0a, 0x05, 0xaa, 0x50, 0xa0, 0x8a, 0x05, 0xa9, 0x49,
+    0xa2, 0x9b, 0x25, 0xaa, 0x4a, 0x93, 0xac, 0x53, 0xa9, 0x2a, 0x85, 0xab, 0x52, 0xa8, 0x1b, 0x86,
+    0xb9, 0x41, 0xa0, 0x0b, 0x06, 0xaa, 0x58, 0xa1, 0x9a, 0x15, 0xb9, 0x49, 0x92, 0xab, 0x44, 0xb9,
+    0x3a, 0x95, 0xaa, 0x52, 0xb8, 0x1a, 0x86, 0xaa, 0x51, 0xa8, 0x09, 0x04, 0xba, 0x50, 0xa1, 0x8b,
+    0x15, 0xaa, 0x59, 0x91, 0x9b, 0x34, 0xba, 0x4a, 0x94, 0xab, 0x63, 0xa9, 0x2a, 0x85, 0xab, 0x61,
+    0xa8, 0x1a, 0x04, 0xba, 0x60, 0xa0, 0x0a, 0x14, 0xba, 0x58, 0xa1, 0x9a, 0x24, 0xba, 0x59, 0x92,
+    0xbb, 0x35, 0xc9, 0x29, 0x95, 0xaa, 0x52, 0xb8, 0x1a, 0x86, 0x9a, 0x40, 0xa0, 0x0b, 0x15, 0xba,
+    0x58, 0xa1, 0x9a, 0x15, 0xb9, 0x59, 0xa2, 0x9b, 0x34, 0xba, 0x4a, 0x94, 0xab, 0x53, 0xb8, 0x3b,
+    0x85, 0xab, 0x61, 0xa8, 0x1a, 0x05, 0xba, 0x50, 0xa0, 0x8a, 0x15, 0xaa, 0x59, 0x91, 0x9b, 0x34,
+    0xba, 0x4a, 0x94, 0xab, 0x53, 0xb9, 0x3a, 0x85, 0xab, 0x52, 0xa8, 0x1b, 0x06, 0xab, 0x41, 0xa0,
+    0x0b, 0x06, 0xaa, 0x58, 0xa1, 0x9a, 0x15, 0xb9, 0x49, 0x92, 0xab, 0x44, 0xb9, 0x3a, 0x95, 0xaa,
+    0x52, 0xb8, 0x1a, 0x86, 0xaa, 0x51, 0xa8, 0x1a, 0x04, 0xba, 0x50, 0xa1, 0x8b, 0x15, 0xaa, 0x59,
+    0xa2, 0x9b, 0x34, 0xca, 0x39, 0x95, 0xab, 0x53, 0xa9, 0x2a, 0x85, 0xab, 0x52, 0xa8, 0x1b, 0x06,
+    0xba, 0x41, 0xa0, 0x0b, 0x15, 0xba, 0x58, 0xa1, 0x9a, 0x25, 0xba, 0x49, 0xa3, 0xbb, 0x35, 0xb9,
+    0x4b, 0x84, 0x9c, 0x51, 0xa8, 0x1a, 0x04, 0xbb, 0x61, 0xa0, 0x8a, 0x05, 0xb9, 0x40, 0xa1, 0x8b,
+    0x25, 0xca, 0x38, 0xa3, 0x9c, 0x34, 0xba, 0x5b, 0x93, 0x9c, 0x52, 0xa9, 0x2a, 0x85, 0xab, 0x51,
+    0xa0, 0x1b, 0x05, 0xba, 0x50, 0xb1, 0x8a, 0x15, 0xba, 0x58, 0x91, 0x9b, 0x15, 0xb9, 0x49, 0xa3,
+    0xab, 0x44, 0xb9, 0x3a, 0x85, 0xbb, 0x62, 0xa8, 0x1a, 0x05, 0xab, 0x50, 0xa0, 0x0a, 0x14, 0xca,
+    0x40, 0xa1, 0x8b, 0x15, 0xb9, 0x49, 0xa3, 0x9c, 0x43, 0xb9, 0x3a, 0x96, 0xaa, 0x52, 0xb8, 0x2a,
+    0x85, 0xba, 0x51, 0xa0, 0x0b, 0x06, 0xaa, 0x40, 0xa1, 0x8b, 0x15, 0xba, 0x58, 0x91, 0x9b, 0x34,
+    0xca, 0x39, 0x94, 0xab, 0x63, 0xa9, 0x2a, 0x85, 0xab, 0x52, 0xa8, 0x1b, 0x05, 0xba, 0x51, 0xa0,
+    0x0b, 0x15, 0xba, 0x58, 0xa1, 0x9a, 0x15, 0xb9, 0x49, 0xa3, 0xab, 0x44, 0xb9, 0x3a, 0x85, 0x9c,
+    0x51, 0xa8, 0x1a, 0x04, 0xbb, 0x61, 0xa0, 0x0a, 0x14, 0xbb, 0x50, 0xa1, 0x8b, 0x15, 0xb9, 0x49,
+    0xa3, 0x9c, 0x24, 0xb9, 0x4a, 0x94, 0xab, 0x53, 0xc8, 0x19, 0x84, 0xaa, 0x51, 0xb0, 0x0a, 0x05,
+    0xba, 0x60, 0x90, 0x0b, 0x14, 0xba, 0x58, 0x91, 0x9b, 0x34, 0xca, 0x39, 0x94, 0xab, 0x63, 0xa9,
+    0x2a, 0x85, 0xab, 0x52, 0xb8, 0x1a, 0x05, 0xba, 0x51, 0xa0, 0x0b, 0x15, 0xba, 0x58, 0xa1, 0x8b,
+    0x15, 0xb9, 0x49, 0xa3, 0x9c, 0x24, 0xb9, 0x4a, 0x83, 0xac, 0x52, 0xb8, 0x2a, 0x85, 0xba, 0x61,
+    0xa0, 0x1b, 0x04, 0xba, 0x50, 0xa1, 0x8b, 0x15, 0xba, 0x58, 0xa2, 0x9b, 0x34, 0xca, 0x49, 0x82,
+    0x9c, 0x42, 0xc8, 0x29, 0x83, 0xcb, 0x52, 0xb0, 0x1b, 0x06, 0xaa, 0x40, 0xa0, 0x0b, 0x15, 0xba,
+    0x58, 0x91, 0x9b, 0x25, 0xba, 0x49, 0xa3, 0x9c, 0x43, 0xb9, 0x3a, 0x86, 0xab, 0x52, 0xb8, 0x2a,
+    0x04, 0xbb, 0x61, 0xa0, 0x0b, 0x15, 0xba, 0x58, 0xa1, 0x8b, 0x15, 0xb9, 0x59, 0xa2, 0x9b, 0x34,
+    0xc9, 0x29, 0x84, 0x9c, 0x42, 0xb8, 0x3b, 0x85, 0xab, 0x61, 0xa8, 0x1a, 0x04, 0xba, 0x60, 0xa0,
+    0x0a, 0x14, 0xba, 0x58, 0x91, 0x8c, 0x33, 0xca, 0x39, 0x94, 0x9c, 0x43, 0xb9, 0x3a, 0x85, 0xbb,
+    0x62, 0xa8, 0x1a, 0x05, 0xab, 0x50, 0xa0, 0x0a, 0x14, 0xca, 0x40, 0xa1, 0x8b, 0x24, 0xba, 0x59,
+    0x92, 0x9c, 0x43, 0xc9, 0x39, 0x94, 0xab, 0x53, 0xb8, 0x2b, 0x86, 0xaa, 0x41, 0xb0, 0x0a, 0x06,
+    0xaa, 0x40, 0xa1, 0x0c, 0x23, 0xca, 0x59, 0xa2, 0x9b, 0x34, 0xba, 0x4a, 0x94, 0xab, 0x53, 0xc8,
+    0x29, 0x84, 0xbb, 0x62, 0xa8, 0x1a, 0x04, 0xba, 0x60, 0xa0, 0x0a, 0x14, 0xca, 0x30, 0xa2, 0x9c,
+    0x25, 0xba, 0x49, 0xa3, 0xab, 0x44, 0xb9, 0x3a, 0x85, 0xbb, 0x53, 0xb8, 0x2b, 0x06, 0xab, 0x41,
+    0xb1, 0x0b, 0x06, 0xaa, 0x58, 0xa1, 0x8b, 0x15, 0xb9, 0x49, 0xa3, 0x9c, 0x24, 0xb9, 0x4a, 0x93,
+    0x9c, 0x52, 0xb8, 0x2a, 0x85, 0xab, 0x42, 0xb0, 0x1b, 0x06, 0xba, 0x50, 0xa1, 0x8b, 0x15, 0xba,
+    0x58, 0xa2, 0x9b, 0x25, 0xba, 0x49, 0x93, 0xac, 0x43, 0xc8, 0x29, 0x84, 0xbb, 0x53, 0xb8, 0x1a,
+    0x06, 0xab, 0x41, 0xa0, 0x0b, 0x15, 0xba, 0x58, 0xa1, 0x8b, 0x25, 0xba, 0x49, 0xa3, 0x9c, 0x34,
+    0xc9, 0x3a, 0x84, 0x9c, 0x42, 0xb8, 0x2b, 0x05, 0xbb, 0x52, 0xb0, 0x0a, 0x15, 0xbb, 0x60, 0x90,
+    0x0b, 0x14, 0xba, 0x48, 0xa3, 0x8d, 0x33, 0xca, 0x39, 0x94, 0x9c, 0x43, 0xb9, 0x2a, 0x86, 0xaa,
+    0x41, 0xb0, 0x1b, 0x06, 0xba, 0x41, 0xb1, 0x0b, 0x15, 0xba, 0x58, 0xa2, 0x8c, 0x14, 0xb9, 0x49,
+    0xa3, 0x9c, 0x43, 0xc8, 0x29, 0x84, 0x9c, 0x32, 0xb8, 0x2c, 0x05, 0xbb, 0x51, 0xa0, 0x1b, 0x05,
+    0xba, 0x50, 0xa1, 0x8b, 0x15, 0xc9, 0x38, 0xa3, 0x9c, 0x24, 0xb9, 0x4a, 0x83, 0x9d, 0x42, 0xb8,
+    0x3b, 0x85, 0xab, 0x61, 0xb0, 0x1a, 0x04, 0xba, 0x50, 0xa1, 0x0c, 0x14, 0xba, 0x58, 0x91, 0x9b,
+    0x24, 0xc9, 0x49, 0x92, 0xab, 0x34, 0xd8, 0x29, 0x84, 0xab, 0x51, 0xb0, 0x2b, 0x05, 0xab, 0x50,
+    0xb1, 0x0b, 0x06, 0xb9, 0x40, 0xa1, 0x8b, 0x24, 0xca, 0x48, 0x92, 0x9c, 0x43, 0xb9, 0x3a, 0x85,
+    0x9c, 0x32, 0xc8, 0x2a, 0x85, 0xba, 0x42, 0xc1, 0x0a, 0x05, 0xaa, 0x40, 0xa1, 0x0c, 0x23, 0xca,
+    0x48, 0xa2, 0x8c, 0x43, 0xba, 0x4a, 0x94, 0xab, 0x53, 0xb8, 0x2a, 0x85, 0xab, 0x52, 0xa8, 0x1b,
+    0x05, 0xba, 0x60, 0xa0, 0x0a, 0x14, 0xca, 0x30, 0xa2, 0x8c, 0x24, 0xca, 0x38, 0x93, 0x9d, 0x43,
+    0xb9, 0x3a, 0x85, 0x9c, 0x41, 0xb0, 0x2b, 0x05, 0xbb, 0x61, 0xa0, 0x1b, 0x14, 0xbb, 0x50, 0xa1,
+    0x8b, 0x15, 0xc9, 0x38, 0xa3, 0x9c, 0x24, 0xb9, 0x4a, 0x94, 0xab, 0x53, 0xb8, 0x3b, 0x85, 0xab,
+    0x61, 0xb0, 0x1a, 0x04, 0xba, 0x50, 0xa1, 0x0c, 0x14, 0xba, 0x58, 0x91, 0x8c, 0x33, 0xca, 0x49,
+    0x92, 0xab, 0x34, 0xd8, 0x29, 0x84, 0xbb, 0x53, 0xb8, 0x1a, 0x05, 0xab, 0x51, 0xa0, 0x0b, 0x15,
+    0xca, 0x30, 0xa2, 0x8d, 0x24, 0xba, 0x49, 0xa3, 0x8c, 0x33, 0xd9, 0x39, 0x83, 0xad, 0x43, 0xb8,
+    0x2b, 0x86, 0xaa, 0x41, 0xb0, 0x1b, 0x06, 0xaa, 0x40, 0xa1, 0x0c, 0x33, 0xdb, 0x48, 0xa2, 0x9b,
+    0x34, 0xd9, 0x39, 0x93, 0x9c, 0x43, 0xb9, 0x3b, 0x86, 0xab, 0x52, 0xb0, 0x2b, 0x14, 0xac, 0x50,
+    0xa0, 0x0a, 0x14, 0xca, 0x30, 0xa2, 0x8d, 0x24, 0xba, 0x49, 0x93, 0x8d, 0x32, 0xc9, 0x29, 0x85,
+    0xab, 0x42, 0xc0, 0x2a, 0x04, 0xbb, 0x51, 0xb1, 0x0b, 0x06, 0xaa, 0x40, 0xa1, 0x0c, 0x23, 0xca,
+    0x59, 0xa2, 0x9b, 0x34, 0xc9, 0x39, 0x93, 0x9d, 0x52, 0xb8, 0x2a, 0x04, 0xac, 0x42, 0xb0, 0x1b,
+    0x15, 0xbb, 0x50, 0xa1, 0x8b, 0x15, 0xba, 0x58, 0xa2, 0x9b, 0x25, 0xba, 0x49, 0x93, 0xac, 0x53,
+    0xb9, 0x29, 0x85, 0xab, 0x52, 0xb8, 0x2a, 0x04, 0xbb, 0x61, 0xa0, 0x0b, 0x15, 0xba, 0x58, 0x91,
+    0x8c, 0x14, 0xb9, 0x38, 0x93, 0x8e, 0x32, 0xc9, 0x39, 0x94, 0xbb, 0x44, 0xb8, 0x2b, 0x05, 0xbb,
+    0x52, 0xb0, 0x1b, 0x15, 0xbb, 0x60, 0xa1, 0x8b, 0x15, 0xaa, 0x38, 0xa3, 0x9d, 0x24, 0xc9, 0x28,
+    0x94, 0xab, 0x53, 0xb8, 0x2a, 0x85, 0xab, 0x52, 0xb0, 0x1b, 0x05, 0xba, 0x60, 0xa0, 0x0a, 0x14,
+    0xca, 0x30, 0xa2, 0x8c, 0x24, 0xca, 0x38, 0x93, 0x9d, 0x43, 0xc9, 0x29, 0x84, 0xab, 0x52, 0xb8,
+    0x2a, 0x05, 0xbb, 0x51, 0xb1, 0x0b, 0x15, 0xba, 0x40, 0xb2, 0x8c, 0x15, 0xb9, 0x49, 0x92, 0x8c,
+    0x33, 0xca, 0x4a, 0x83, 0x9d, 0x42, 0xb8, 0x2a, 0x04, 0xac, 0x51, 0xb0, 0x1a, 0x14, 0xbb, 0x50,
+    0xa1, 0x0c, 0x14, 0xba, 0x58, 0x91, 0x8c, 0x33, 0xca, 0x49, 0x92, 0xab, 0x34, 0xd8, 0x29, 0x84,
+    0xbb, 0x53, 0xb8, 0x1a, 0x05, 0xab, 0x51, 0xa0, 0x0b, 0x15, 0xca, 0x30, 0xa2, 0x0d, 0x23, 0xca,
+    0x49, 0xa3, 0x9c, 0x24, 0xc8, 0x29, 0x84, 0x9c, 0x32, 0xb8, 0x2b, 0x06, 0xbb, 0x52, 0xb0, 0x1b,
+    0x15, 0xbb, 0x50, 0xa1, 0x8b, 0x25, 0xca, 0x48, 0x91, 0x9b, 0x34, 0xca, 0x28, 0x94, 0xab, 0x34,
+    0xd8, 0x29, 0x03, 0x9d, 0x41, 0xb0, 0x2b, 0x14, 0xac, 0x50, 0xa0, 0x0a, 0x14, 0xca, 0x30, 0xa2,
+    0x8d, 0x24, 0xba, 0x49, 0x93, 0x9d, 0x33, 0xc9, 0x29, 0x85, 0xab, 0x52, 0xb8, 0x2a, 0x04, 0xbb,
+    0x61, 0xa0, 0x1b, 0x14, 0xbb, 0x50, 0xb2, 0x0c, 0x33, 0xdb, 0x48, 0x92, 0x9c, 0x33, 0xc9, 0x39,
+    0x94, 0x9c, 0x42, 0xb8, 0x2a, 0x05, 0xac, 0x42, 0xb0, 0x1b, 0x15, 0xbb, 0x50, 0xa1, 0x0c, 0x14,
+    0xba, 0x58, 0x91, 0x9b, 0x34, 0xca, 0x49, 0x92, 0xab, 0x34, 0xd8, 0x29, 0x03, 0x9d, 0x41, 0xb0,
+    0x2b, 0x14, 0xac, 0x50, 0xa0, 0x1b, 0x14, 0xca, 0x40, 0xa1, 0x8b, 0x24, 0xd9, 0x38, 0xa3, 0x9c,
+    0x43, 0xc9, 0x39, 0x83, 0x9d, 0x42, 0xb8, 0x3b, 0x85, 0xab, 0x51, 0xb1, 0x1c, 0x04, 0xba, 0x50,
+    0xa1, 0x8b, 0x15, 0xc9, 0x48, 0x91, 0x8b, 0x33, 0xe9, 0x28, 0x93, 0x9c, 0x42, 0xb8, 0x3b, 0x86,
+    0xab, 0x42, 0xb0, 0x1b, 0x06, 0xba, 0x41, 0xb1, 0x0b, 0x25, 0xcb, 0x40, 0x91, 0x8c, 0x33, 0xda,
+    0x38, 0xa3, 0x9c, 0x43, 0xd8, 0x29, 0x84, 0xab, 0x42, 0xc0, 0x2a, 0x04, 0xbb, 0x51, 0xb1, 0x0b,
+    0x15, 0xba, 0x58, 0xa1, 0x0b, 0x24, 0xca, 0x38, 0xa4, 0x8c, 0x33, 0xd9, 0x39, 0x83, 0xad, 0x43,
+    0xc8, 0x19, 0x04, 0xbb, 0x52, 0xb0, 0x2b, 0x14, 0xcb, 0x50, 0x90, 0x0b, 0x14, 0xca, 0x30, 0xa2,
+    0x9c, 0x25, 0xc9, 0x28, 0x93, 0x9c, 0x33, 0xd8, 0x3a, 0x84, 0x9c, 0x41, 0xb0, 0x2b, 0x05, 0xbb,
+    0x51, 0xb1, 0x0b, 0x16, 0xba, 0x30, 0xb3, 0x8d, 0x24, 0xca, 0x38, 0x93, 0x9d, 0x33, 0xc9, 0x39,
+    0x84, 0x9d, 0x32, 0xc0, 0x1a, 0x05, 0xab, 0x41, 0xb0, 0x1b, 0x06, 0xba, 0x41, 0xa1, 0x0c, 0x14,
+    0xba, 0x48, 0xa3, 0x8d, 0x33, 0xca, 0x39, 0x94, 0x9c, 0x33, 0xd8, 0x29, 0x84, 0xbb, 0x62, 0xb0,
+    0x1a, 0x04, 0xca, 0x41, 0xa0, 0x0b, 0x15, 0xba, 0x58, 0x91, 0x8c, 0x33, 0xca, 0x49, 0x92, 0x9c,
+    0x43, 0xb9, 0x3a, 0x85, 0xab, 0x52, 0xb8, 0x2a, 0x05, 0xbb, 0x51, 0xb1, 0x0b, 0x15, 0xca, 0x40,
+    0xa1, 0x8b, 0x15, 0xc9, 0x38, 0xa3, 0x9c, 0x24, 0xc9, 0x28, 0x94, 0xab, 0x53, 0xb8, 0x2a, 0x85,
+    0xab, 0x51, 0xb0, 0x1a, 0x05, 0xba, 0x50, 0xa1, 0x0c, 0x14, 0xba, 0x48, 0xa2, 0x8c, 0x24, 0xc9,
+    0x39, 0x93, 0x9c, 0x43, 0xc9, 0x29, 0x84, 0xab, 0x52, 0xc0, 0x2a, 0x13, 0xbc, 0x51, 0xb1, 0x0b,
+    0x15, 0xba, 0x58, 0x91, 0x8c, 0x14, 0xb9, 0x38, 0x93, 0x8e, 0x32, 0xc9, 0x39, 0x94, 0xbb, 0x34,
+    0xd0, 0x2a, 0x04, 0xbb, 0x61, 0xa0, 0x1b, 0x14, 0xbb, 0x50, 0xa1, 0x0c, 0x14, 0xba, 0x48, 0x92,
+    0x9c, 0x24, 0xc9, 0x39, 0x94, 0xab, 0x53, 0xc8, 0x29, 0x03, 0xac, 0x51, 0xb0, 0x1a, 0x04, 0xca,
+    0x41, 0xa0, 0x0b, 0x15, 0xba, 0x58, 0x91, 0x8c, 0x23, 0xc9, 0x38, 0xa3, 0x9c, 0x43, 0xc9, 0x39,
+    0x83, 0x9d, 0x42, 0xb8, 0x1a, 0x05, 0xab, 0x51, 0xb0, 0x0a, 0x15, 0xbb, 0x41, 0xa1, 0x0c, 0x33,
+    0xcb, 0x48, 0xa2, 0x8c, 0x33, 0xd9, 0x39, 0x83, 0x9d, 0x42, 0xc8, 0x29, 0x83, 0xbb, 0x62, 0xb0,
+    0x1a, 0x04, 0xca, 0x31, 0xb2, 0x0d, 0x14, 0xba, 0x48, 0xa2, 0x9b, 0x25, 0xc9, 0x28, 0x93, 0x9c,
+    0x33, 0xd8, 0x29, 0x03, 0x9d, 0x41, 0xa8, 0x2b, 0x04, 0xbb, 0x42, 0xb1, 0x1c, 0x14, 0xbb, 0x50,
+    0xa1, 0x8b, 0x24, 0xc9, 0x38, 0x92, 0x9c, 0x33, 0xc9, 0x39, 0x83, 0xad, 0x33, 0xd0, 0x19, 0x03,
+    0xbb, 0x52, 0xb0, 0x1a, 0x04, 0xba, 0x40, 0xa1, 0x8a, 0x14, 0xaa, 0x20, 0x91, 0x8a, 0x12, 0x89
+};
+
+static const CueStep CHIME_STEPS[] = {
+    {0, 96, 600}
+};
+
+const CuePattern CUE_CHIME = {
+    "chime", CHIME_STEPS, 1, CUE_VOICE_CLIP, CHIME_CLIP, sizeof(CHIME_CLIP)
+};
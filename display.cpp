@@ -1,4 +1,5 @@
 #include "display.h"
+#include "tasks.h"
 
 Display::Display(Settings* sett) {
     settings = sett;
@@ -30,9 +31,9 @@ void Display::update(unsigned long currentTime) {
 void Display::showClock() {
     M5.Display.clear();
     
-    auto dt = M5.Rtc.getDateTime();
-    int hour = (dt.time.hours + TIMEZONE) % 24;
-    int minute = dt.time.minutes;
+    ClockSnapshot clk = Tasks::clock();
+    int hour = (clk.hours + TIMEZONE) % 24;
+    int minute = clk.minutes;
     
     M5.Display.setTextColor(COLOR_YELLOW);
     M5.Display.setTextSize(2);
@@ -282,9 +283,9 @@ void Display::drawBattery() {
 }
 
 void Display::drawTime() {
-    auto dt = M5.Rtc.getDateTime();
-    int hour = (dt.time.hours + TIMEZONE) % 24;
-    int minute = dt.time.minutes;
+    ClockSnapshot clk = Tasks::clock();
+    int hour = (clk.hours + TIMEZONE) % 24;
+    int minute = clk.minutes;
     
     M5.Display.setTextColor(COLOR_WHITE);
     M5.Display.setTextSize(1);
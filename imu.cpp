@@ -1,9 +1,11 @@
 #include "imu.h"
-#include <cmath>
 
 IMU::IMU() {
     dataValid = false;
     lastUpdateTime = 0;
+    accelMagSq = 0.0f;
+    gyroMagSq = 0.0f;
+    imuBatchClear(batch);
 }
 
 void IMU::begin() {
@@ -12,6 +14,7 @@ void IMU::begin() {
         currentData = M5.Imu.getImuData();
         previousData = currentData;
         dataValid = true;
+        cacheMagnitudes();
     }
 }
 
@@ -22,35 +25,30 @@ void IMU::update() {
         currentData = M5.Imu.getImuData();
         dataValid = true;
         lastUpdateTime = millis();
+        cacheMagnitudes();
     }
 }
 
-float IMU::getAccelMagnitude() {
-    if (!dataValid) return 0.0f;
-    
-    float x = currentData.accel.x;
-    float y = currentData.accel.y;
-    float z = currentData.accel.z;
-    
-    return sqrt(x*x + y*y + z*z);
+void IMU::update(const m5::imu_data_t& sample) {
+    previousData = dataValid ? currentData : sample;
+    currentData = sample;
+    dataValid = true;
+    lastUpdateTime = millis();
+    cacheMagnitudes();
 }
 
-float IMU::getGyroMagnitude() {
-    if (!dataValid) return 0.0f;
-    
-    float x = currentData.gyro.x;
-    float y = currentData.gyro.y;
-    float z = currentData.gyro.z;
-    
-    return sqrt(x*x + y*y + z*z);
+// Squared magnitudes once per sample; detectors compare against squared thresholds
+void IMU::cacheMagnitudes() {
+    const m5::imu_data_t& d = currentData;
+    accelMagSq = d.accel.x * d.accel.x + d.accel.y * d.accel.y + d.accel.z * d.accel.z;
+    gyroMagSq = d.gyro.x * d.gyro.x + d.gyro.y * d.gyro.y + d.gyro.z * d.gyro.z;
+    imuBatchPush(batch, d.accel.x, d.accel.y, d.accel.z, d.gyro.x, d.gyro.y, d.gyro.z);
 }
 
 bool IMU::detectFall() {
     if (!dataValid) return false;
     
-    float accelMag = getAccelMagnitude();
-    
-    if (accelMag < 2.0f) {
+    if (accelMagSq < 2.0f * 2.0f) {
         return true;
     }
     
@@ -60,9 +58,7 @@ bool IMU::detectFall() {
 bool IMU::detectWeirdPhysics() {
     if (!dataValid) return false;
     
-    float accelMag = getAccelMagnitude();
-    
-    if (accelMag > IMU_WEIRD_PHYSICS_THRESHOLD || accelMag < 5.0f) {
+    if (accelMagSq > IMU_WEIRD_PHYSICS_THRESHOLD * IMU_WEIRD_PHYSICS_THRESHOLD || accelMagSq < 5.0f * 5.0f) {
         return true;
     }
     
@@ -72,9 +68,7 @@ bool IMU::detectWeirdPhysics() {
 bool IMU::detectRotation() {
     if (!dataValid) return false;
     
-    float gyroMag = getGyroMagnitude();
-    
-    if (gyroMag > IMU_ROTATION_THRESHOLD) {
+    if (gyroMagSq > IMU_ROTATION_THRESHOLD * IMU_ROTATION_THRESHOLD) {
         return true;
     }
     
@@ -87,6 +81,10 @@ bool IMU::shouldTriggerRC() {
     return detectFall() || detectWeirdPhysics() || detectRotation();
 }
 
+void IMU::getFeatures(ImuFeatures& features) {
+    imuComputeFeatures(batch, features);
+}
+
 float IMU::getAccelX() {
     return dataValid ? currentData.accel.x : 0.0f;
 }
@@ -3,6 +3,7 @@
 
 #include <M5StickCPlus2.h>
 #include "config.h"
+#include "imu_kernels.h"
 
 class IMU {
 private:
@@ -10,18 +11,22 @@ private:
     m5::imu_data_t previousData;
     bool dataValid;
     unsigned long lastUpdateTime;
+    float accelMagSq;  // Cached per sample, shared by every detector
+    float gyroMagSq;
+    ImuBatch batch;    // Recent samples for windowed features
     
-    float getAccelMagnitude();
-    float getGyroMagnitude();
+    void cacheMagnitudes();
     
 public:
     IMU();
     void begin();
     void update();
+    void update(const m5::imu_data_t& sample);  // Replay a recorded/synthetic sample
     bool detectFall();
     bool detectWeirdPhysics();
     bool detectRotation();
     bool shouldTriggerRC();
+    void getFeatures(ImuFeatures& features);
     float getAccelX();
     float getAccelY();
     float getAccelZ();
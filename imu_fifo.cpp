@@ -0,0 +1,74 @@
+#include "imu_fifo.h"
+
+#define MPU6886_ADDR 0x68
+#define MPU6886_I2C_FREQ 400000
+#define REG_SMPLRT_DIV 0x19
+#define REG_ACCEL_CONFIG 0x1C
+#define REG_FIFO_EN 0x23
+#define REG_USER_CTRL 0x6A
+#define REG_PWR_MGMT_2 0x6C
+#define REG_FIFO_COUNTH 0x72
+#define REG_FIFO_R_W 0x74
+
+#define FIFO_EN_ACCEL 0x08
+#define USER_CTRL_FIFO_EN 0x40
+#define USER_CTRL_FIFO_RST 0x04
+#define PWR_MGMT_2_GYRO_OFF 0x07
+#define FIFO_BYTES 1024
+
+static uint8_t savedDiv, savedFifoEn, savedUserCtrl, savedPwr2;
+static float lsbPerG = 16384.0f;
+
+static uint8_t readReg(uint8_t reg) {
+    return M5.In_I2C.readRegister8(MPU6886_ADDR, reg, MPU6886_I2C_FREQ);
+}
+
+static bool writeReg(uint8_t reg, uint8_t value) {
+    return M5.In_I2C.writeRegister8(MPU6886_ADDR, reg, value, MPU6886_I2C_FREQ);
+}
+
+bool ImuFifo::begin() {
+    savedDiv = readReg(REG_SMPLRT_DIV);
+    savedFifoEn = readReg(REG_FIFO_EN);
+    savedUserCtrl = readReg(REG_USER_CTRL);
+    savedPwr2 = readReg(REG_PWR_MGMT_2);
+    lsbPerG = (float)(16384 >> ((readReg(REG_ACCEL_CONFIG) >> 3) & 0x3));
+
+    // 1 kHz internal rate (DLPF on) / (1 + 99)
+    bool ok = writeReg(REG_SMPLRT_DIV, 1000 / IMU_FIFO_RATE_HZ - 1);
+    ok = ok && writeReg(REG_PWR_MGMT_2, PWR_MGMT_2_GYRO_OFF);
+    ok = ok && writeReg(REG_USER_CTRL, (savedUserCtrl & ~USER_CTRL_FIFO_EN) | USER_CTRL_FIFO_RST);
+    ok = ok && writeReg(REG_FIFO_EN, FIFO_EN_ACCEL);
+    ok = ok && writeReg(REG_USER_CTRL, savedUserCtrl | USER_CTRL_FIFO_EN);
+    if (!ok) end();
+    return ok;
+}
+
+int ImuFifo::read(float* ax, float* ay, float* az, int max) {
+    uint8_t count[2];
+    if (!M5.In_I2C.readRegister(MPU6886_ADDR, REG_FIFO_COUNTH, count, 2, MPU6886_I2C_FREQ)) return 0;
+    int available = (((count[0] & 0x1F) << 8) | count[1]) / IMU_FIFO_RECORD;
+    if (available * IMU_FIFO_RECORD >= FIFO_BYTES - IMU_FIFO_RECORD) {
+        // Full: the oldest samples were overwritten mid-record, start over
+        writeReg(REG_USER_CTRL, savedUserCtrl | USER_CTRL_FIFO_EN | USER_CTRL_FIFO_RST);
+        return 0;
+    }
+    if (available > max) available = max;
+
+    for (int i = 0; i < available; i++) {
+        uint8_t r[IMU_FIFO_RECORD];
+        if (!M5.In_I2C.readRegister(MPU6886_ADDR, REG_FIFO_R_W, r, IMU_FIFO_RECORD, MPU6886_I2C_FREQ)) return i;
+        ax[i] = (int16_t)((r[0] << 8) | r[1]) / lsbPerG;
+        ay[i] = (int16_t)((r[2] << 8) | r[3]) / lsbPerG;
+        az[i] = (int16_t)((r[4] << 8) | r[5]) / lsbPerG;
+    }
+    return available;
+}
+
+void ImuFifo::end() {
+    writeReg(REG_FIFO_EN, savedFifoEn);
+    writeReg(REG_USER_CTRL, (savedUserCtrl & ~USER_CTRL_FIFO_EN) | USER_CTRL_FIFO_RST);
+    writeReg(REG_USER_CTRL, savedUserCtrl);
+    writeReg(REG_SMPLRT_DIV, savedDiv);
+    writeReg(REG_PWR_MGMT_2, savedPwr2);
+}
@@ -0,0 +1,24 @@
+#ifndef IMU_FIFO_H
+#define IMU_FIFO_H
+
+#include <M5StickCPlus2.h>
+
+// MPU6886 accelerometer FIFO for the night monitor
+// begin() turns the gyro off and has the IMU buffer accelerometer samples
+// at 10 Hz in its 1 KB FIFO (170 samples) so the CPU can light-sleep;
+// end() restores what M5Unified set up, so M5.Imu.update() works again.
+// Talks to the bus directly: only call while the sensor task is parked.
+
+#define IMU_FIFO_RATE_HZ 10
+#define IMU_FIFO_RECORD 6         // Accel X, Y, Z, big-endian int16
+#define IMU_FIFO_MAX_SAMPLES 170
+
+class ImuFifo {
+public:
+    static bool begin();
+    // Oldest first, accel in g; returns the samples read (at most max)
+    static int read(float* ax, float* ay, float* az, int max);
+    static void end();
+};
+
+#endif
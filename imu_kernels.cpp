@@ -0,0 +1,90 @@
+#include "imu_kernels.h"
+
+void imuBatchClear(ImuBatch& batch) {
+    batch.count = 0;
+    batch.head = 0;
+}
+
+void imuBatchPush(ImuBatch& batch, float ax, float ay, float az, float gx, float gy, float gz) {
+    int i = batch.head;
+    batch.ax[i] = ax;
+    batch.ay[i] = ay;
+    batch.az[i] = az;
+    batch.gx[i] = gx;
+    batch.gy[i] = gy;
+    batch.gz[i] = gz;
+    batch.head = (i + 1) % IMU_BATCH_SIZE;
+    if (batch.count < IMU_BATCH_SIZE) batch.count++;
+}
+
+// Unrolled by four so the FPU multiply-add pipeline stays busy
+void imuMagSq(const float* x, const float* y, const float* z, float* out, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        out[i]     = x[i]     * x[i]     + y[i]     * y[i]     + z[i]     * z[i];
+        out[i + 1] = x[i + 1] * x[i + 1] + y[i + 1] * y[i + 1] + z[i + 1] * z[i + 1];
+        out[i + 2] = x[i + 2] * x[i + 2] + y[i + 2] * y[i + 2] + z[i + 2] * z[i + 2];
+        out[i + 3] = x[i + 3] * x[i + 3] + y[i + 3] * y[i + 3] + z[i + 3] * z[i + 3];
+    }
+    for (; i < n; i++) {
+        out[i] = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+    }
+}
+
+void imuComputeFeatures(const ImuBatch& batch, ImuFeatures& f) {
+    f = ImuFeatures();
+    int n = batch.count;
+    f.samples = n;
+    if (n == 0) return;
+
+    float accelSq[IMU_BATCH_SIZE];
+    float gyroSq[IMU_BATCH_SIZE];
+    imuMagSq(batch.ax, batch.ay, batch.az, accelSq, n);
+    imuMagSq(batch.gx, batch.gy, batch.gz, gyroSq, n);
+
+    // Ring order: oldest sample sits at head once the batch is full
+    int start = (n < IMU_BATCH_SIZE) ? 0 : batch.head;
+
+    float sum = 0.0f, sumSq = 0.0f, gyroSum = 0.0f, jerk = 0.0f;
+    float minA = accelSq[start], maxA = accelSq[start], maxG = 0.0f;
+    int crossings = 0;
+    int prev = start;
+    bool prevAbove = accelSq[start] > 1.0f;
+
+    for (int k = 0; k < n; k++) {
+        int i = start + k;
+        if (i >= IMU_BATCH_SIZE) i -= IMU_BATCH_SIZE;
+
+        float a = accelSq[i];
+        float g = gyroSq[i];
+        sum += a;
+        sumSq += a * a;
+        gyroSum += g;
+        if (a < minA) minA = a;
+        if (a > maxA) maxA = a;
+        if (g > maxG) maxG = g;
+
+        if (k > 0) {
+            float dx = batch.ax[i] - batch.ax[prev];
+            float dy = batch.ay[i] - batch.ay[prev];
+            float dz = batch.az[i] - batch.az[prev];
+            jerk += dx * dx + dy * dy + dz * dz;
+
+            bool above = a > 1.0f;
+            if (above != prevAbove) crossings++;
+            prevAbove = above;
+        }
+        prev = i;
+    }
+
+    float inv = 1.0f / n;
+    f.accelMagSqMean = sum * inv;
+    f.accelMagSqVar = sumSq * inv - f.accelMagSqMean * f.accelMagSqMean;
+    if (f.accelMagSqVar < 0.0f) f.accelMagSqVar = 0.0f;
+    f.accelMagSqMin = minA;
+    f.accelMagSqMax = maxA;
+    f.gyroMagSqMean = gyroSum * inv;
+    f.gyroMagSqMax = maxG;
+    f.jerkSum = jerk;
+    f.gravityCrossings = crossings;
+}
@@ -0,0 +1,46 @@
+#ifndef IMU_KERNELS_H
+#define IMU_KERNELS_H
+
+#include <stdint.h>
+
+// Batched IMU feature kernels
+// Samples are stored structure-of-arrays so each kernel walks contiguous
+// floats. Every feature is computed on squared magnitudes in a single pass -
+// no sqrt per sample. Plain C++; tools/tests/motion_trigger_test.cpp runs
+// it on a host.
+
+#define IMU_BATCH_SIZE 32
+
+struct ImuBatch {
+    float ax[IMU_BATCH_SIZE];
+    float ay[IMU_BATCH_SIZE];
+    float az[IMU_BATCH_SIZE];
+    float gx[IMU_BATCH_SIZE];
+    float gy[IMU_BATCH_SIZE];
+    float gz[IMU_BATCH_SIZE];
+    int count;  // Valid samples
+    int head;   // Next write position (ring)
+};
+
+struct ImuFeatures {
+    int samples;
+    float accelMagSqMean;   // g^2
+    float accelMagSqVar;    // g^4
+    float accelMagSqMin;
+    float accelMagSqMax;
+    float gyroMagSqMean;    // (deg/s)^2
+    float gyroMagSqMax;
+    float jerkSum;          // Sum of |delta accel|^2 between consecutive samples
+    int gravityCrossings;   // Crossings of |a|^2 through 1 g^2 (steps, sway)
+};
+
+void imuBatchClear(ImuBatch& batch);
+void imuBatchPush(ImuBatch& batch, float ax, float ay, float az, float gx, float gy, float gz);
+
+// Squared magnitudes for n samples: out[i] = x[i]^2 + y[i]^2 + z[i]^2
+void imuMagSq(const float* x, const float* y, const float* z, float* out, int n);
+
+// All features in one pass over the batch, oldest sample first
+void imuComputeFeatures(const ImuBatch& batch, ImuFeatures& features);
+
+#endif
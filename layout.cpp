@@ -0,0 +1,134 @@
+#include "layout.h"
+#include <M5StickCPlus2.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+static bool overlaps(const LayoutRect& a, const LayoutRect& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+LayoutRenderer::LayoutRenderer() {
+    current = nullptr;
+    full = true;
+    memset(pending, 0, sizeof(pending));
+    memset(drawn, 0, sizeof(drawn));
+    dirty = {0, 0, 0, 0};
+}
+
+void LayoutRenderer::invalidate() {
+    full = true;
+}
+
+void LayoutRenderer::begin(const Layout& layout) {
+    if (current != &layout) {
+        current = &layout;
+        full = true;
+    }
+    for (int i = 0; i < current->count; i++) {
+        const LayoutOp& op = current->ops[i];
+        if (op.kind != OP_FIELD) continue;
+        Slot& s = pending[op.field];
+        s.text[0] = '\0';
+        s.fg = op.color;
+        s.bg = BLACK;
+    }
+}
+
+void LayoutRenderer::set(int field, const char* text) {
+    strncpy(pending[field].text, text, LAYOUT_FIELD_CHARS - 1);
+    pending[field].text[LAYOUT_FIELD_CHARS - 1] = '\0';
+}
+
+void LayoutRenderer::setf(int field, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(pending[field].text, LAYOUT_FIELD_CHARS, fmt, args);
+    va_end(args);
+}
+
+void LayoutRenderer::setColor(int field, uint16_t fg, uint16_t bg) {
+    pending[field].fg = fg;
+    pending[field].bg = bg;
+}
+
+void LayoutRenderer::addDirty(const LayoutRect& box) {
+    if (dirty.w == 0) {
+        dirty = box;
+        return;
+    }
+    int16_t x1 = dirty.x < box.x ? dirty.x : box.x;
+    int16_t y1 = dirty.y < box.y ? dirty.y : box.y;
+    int16_t x2 = (dirty.x + dirty.w) > (box.x + box.w) ? (dirty.x + dirty.w) : (box.x + box.w);
+    int16_t y2 = (dirty.y + dirty.h) > (box.y + box.h) ? (dirty.y + dirty.h) : (box.y + box.h);
+    dirty = {x1, y1, (int16_t)(x2 - x1), (int16_t)(y2 - y1)};
+}
+
+void LayoutRenderer::drawOp(const LayoutOp& op, const Slot* slot) {
+    const char* text = slot ? slot->text : op.text;
+    if (!text[0]) return;
+
+    // Clip to the box so a long value never spills into its neighbours
+    char clipped[LAYOUT_FIELD_CHARS];
+    int maxChars = op.box.w / (LAYOUT_FONT_W * op.size);
+    if (slot && (int)strlen(text) > maxChars) {
+        memcpy(clipped, text, maxChars);
+        clipped[maxChars] = '\0';
+        text = clipped;
+    }
+
+    M5.Display.setTextSize(op.size);
+    if (slot) {
+        M5.Display.setTextColor(slot->fg, slot->bg);
+    } else {
+        M5.Display.setTextColor(op.color);
+    }
+    M5.Display.setCursor(op.box.x, op.box.y);
+    M5.Display.print(text);
+}
+
+void LayoutRenderer::end() {
+    if (!current) return;
+    dirty = {0, 0, 0, 0};
+
+    if (full) {
+        M5.Display.fillScreen(BLACK);
+        for (int i = 0; i < current->count; i++) {
+            const LayoutOp& op = current->ops[i];
+            drawOp(op, op.kind == OP_FIELD ? &pending[op.field] : nullptr);
+        }
+        memcpy(drawn, pending, sizeof(drawn));
+        dirty = {0, 0, (int16_t)M5.Display.width(), (int16_t)M5.Display.height()};
+        full = false;
+        return;
+    }
+
+    // Clear every field whose value changed...
+    uint32_t changed = 0;
+    for (int i = 0; i < current->count; i++) {
+        const LayoutOp& op = current->ops[i];
+        if (op.kind != OP_FIELD) continue;
+        const Slot& p = pending[op.field];
+        const Slot& d = drawn[op.field];
+        if (p.fg == d.fg && p.bg == d.bg && strcmp(p.text, d.text) == 0) continue;
+        changed |= 1UL << i;
+        M5.Display.fillRect(op.box.x, op.box.y, op.box.w, op.box.h, BLACK);
+        addDirty(op.box);
+    }
+    if (!changed) return;
+
+    // ...then redraw them, plus anything sharing pixels with a cleared box
+    for (int i = 0; i < current->count; i++) {
+        const LayoutOp& op = current->ops[i];
+        bool redraw = changed & (1UL << i);
+        if (!redraw) {
+            for (int j = 0; j < current->count && !redraw; j++) {
+                redraw = (changed & (1UL << j)) && overlaps(op.box, current->ops[j].box);
+            }
+        }
+        if (redraw) {
+            drawOp(op, op.kind == OP_FIELD ? &pending[op.field] : nullptr);
+        }
+    }
+    memcpy(drawn, pending, sizeof(drawn));
+}
@@ -0,0 +1,90 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <stdint.h>
+
+// Declarative screen layouts
+// A screen is a constexpr array of ops: fixed labels (LTEXT) and value slots
+// (LFIELD). Each op carries a bounding box computed at compile time from the
+// built-in 6x8 font, so the renderer can work out what changed between frames
+// from the field text alone and only clear and redraw those boxes.
+
+#define LAYOUT_FONT_W 6
+#define LAYOUT_FONT_H 8
+#define LAYOUT_MAX_FIELDS 6
+#define LAYOUT_FIELD_CHARS 24  // Including terminator
+
+struct LayoutRect {
+    int16_t x, y, w, h;
+};
+
+enum LayoutOpKind : uint8_t {
+    OP_TEXT,   // Fixed label, drawn on full redraws only
+    OP_FIELD   // Value slot, redrawn when its text or colour changes
+};
+
+struct LayoutOp {
+    LayoutOpKind kind;
+    uint8_t size;       // Text size multiplier
+    uint8_t field;      // OP_FIELD: slot index
+    uint16_t color;     // Default foreground
+    const char* text;   // OP_TEXT only
+    LayoutRect box;
+};
+
+struct Layout {
+    const LayoutOp* ops;
+    uint8_t count;
+};
+
+constexpr int16_t layoutTextLen(const char* s) {
+    return *s ? 1 + layoutTextLen(s + 1) : 0;
+}
+
+constexpr LayoutOp LTEXT(int16_t x, int16_t y, uint8_t size, uint16_t color, const char* text) {
+    return LayoutOp{OP_TEXT, size, 0, color, text,
+                    {x, y, (int16_t)(layoutTextLen(text) * LAYOUT_FONT_W * size), (int16_t)(LAYOUT_FONT_H * size)}};
+}
+
+// maxChars sizes the box; longer values are truncated to fit
+constexpr LayoutOp LFIELD(int16_t x, int16_t y, uint8_t size, uint16_t color, uint8_t field, uint8_t maxChars) {
+    return LayoutOp{OP_FIELD, size, field, color, nullptr,
+                    {x, y, (int16_t)(maxChars * LAYOUT_FONT_W * size), (int16_t)(LAYOUT_FONT_H * size)}};
+}
+
+template <int N>
+constexpr Layout makeLayout(const LayoutOp (&ops)[N]) {
+    static_assert(N <= 32, "LayoutRenderer tracks changed ops in a 32-bit mask");
+    return Layout{ops, (uint8_t)N};
+}
+
+// Draws one layout per frame: begin(), set() the fields, end()
+class LayoutRenderer {
+private:
+    struct Slot {
+        char text[LAYOUT_FIELD_CHARS];
+        uint16_t fg;
+        uint16_t bg;
+    };
+
+    const Layout* current;
+    bool full;
+    Slot pending[LAYOUT_MAX_FIELDS];
+    Slot drawn[LAYOUT_MAX_FIELDS];
+    LayoutRect dirty;
+
+    void drawOp(const LayoutOp& op, const Slot* slot);
+    void addDirty(const LayoutRect& box);
+
+public:
+    LayoutRenderer();
+    void invalidate();  // Next end() repaints everything
+    void begin(const Layout& layout);
+    void set(int field, const char* text);
+    void setf(int field, const char* fmt, ...);
+    void setColor(int field, uint16_t fg, uint16_t bg);
+    void end();
+    LayoutRect dirtyRect() const { return dirty; }  // Area touched by the last end()
+};
+
+#endif
@@ -2,56 +2,65 @@
 // Minimal, non-blocking test for M5StickC Plus2
 #include <M5StickCPlus2.h>
 #include <Preferences.h>
-
-// NVS storage
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include "profiler.h"
+#include "bench.h"
+#include "alarm.h"
+#include "imu.h"
+#include "settings.h"
+#include "wrist_raise.h"
+#include "shake_detector.h"
+#include "motion_trigger.h"
+#include "screen.h"
+#include "layout.h"
+#include "cue.h"
+#include "tasks.h"
+#include "memstats.h"
+#include "pcprof.h"
+#include "trace.h"
+#include "aod.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "smart_wake.h"
+#include "cue_adapt.h"
+#include "night_log.h"
+#include "night_store.h"
+#include "night_session.h"
+#include "night_monitor.h"
+#include "imu_fifo.h"
+#include "adpcm.h"
+#include "memo_store.h"
+#include "sound_features.h"
+#include "chirp_adapt.h"
+#include "wave_synth.h"
+#include "wave_player.h"
+
+// NVS storage, opened by loadSettings() in setup() and kept open so saves
+// from loop() don't allocate a handle each time
 Preferences preferences;
 
 // Buzzer configuration (M5StickC Plus2 uses GPIO 2)
 #define BUZZER_PIN 2
 #define BUZZER_CHANNEL 0
 #define BUZZER_FREQUENCY 2000
-#define BUZZER_CHIRP_DURATION 100
-#define BUZZER_CHIRP_COUNT 3
-#define BUZZER_CHIRP_INTERVAL 150
 
 // Timer variables
 unsigned long startMillis;
-unsigned long lastRender = 0;
 const unsigned long RENDER_MS = 200;
 
-// Buzzer state variables
-bool buzzerActive = false;
-int buzzerChirpNumber = 0;
-unsigned long buzzerLastChirp = 0;
-bool buzzerToneOn = false;
-unsigned long buzzerToneStart = 0;
-
-// Mode system
-enum DisplayMode {
-  MODE_NORMAL,
-  MODE_MENU,
-  MODE_SET_TIME,
-  MODE_REALITY_CHECK,
-  MODE_NIGHT,
-  MODE_DREAM_JOURNAL
-};
-DisplayMode currentMode = MODE_NORMAL;
+// Screen system - see the screen table after loop()
+ScreenStack screens;
+LayoutRenderer ui;  // Editors drawn from constexpr layouts
+
+// Current RTC time, read once per loop
+int currentHour = 0;
+int currentMinute = 0;
+int currentSecond = 0;
 
 // Menu system
 int menuSelection = 0;  // Which menu item is selected
-const int MENU_ITEMS = 10;  // Number of menu items
-const char* menuItems[] = {
-  "Set Time",
-  "Morning Alarm",
-  "Alarms/Day",
-  "Quiet Hours",
-  "12/24 Format",
-  "Screen Timeout",
-  "Shake Sense",
-  "Brightness",
-  "Clock Color",
-  "Test RC"  // Reality Check test
-};
+const int MENU_ITEMS_PER_PAGE = 12;  // 2 columns x 6 rows
 
 // Time-setting variables
 int editHour = 0;
@@ -67,7 +76,7 @@ const unsigned long BTN_B_HOLD_TIME = 2000;  // 2 seconds
 int alarmsPerDay = 12;  // Default: 12 reality checks per day
 int quietHoursStart = 23;  // 11 PM
 int quietHoursEnd = 7;     // 7 AM
-unsigned long nextAlarmMinute = 0;  // Minutes since midnight
+EventScheduler scheduler;  // Reality checks, morning alarm, REM cues (local epoch seconds)
 bool alarmActive = false;
 int currentRealityCheck = 0;  // Which reality check to show
 
@@ -79,17 +88,33 @@ const unsigned long REALITY_CHECK_TIMEOUT = 10000;  // 10 seconds
 bool manualAlarmEnabled = false;
 int manualAlarmHour = 7;  // Default: 7:00 AM
 int manualAlarmMinute = 0;
-bool manualAlarmTriggered = false;
+int smartWakeMinutes = 0;  // Wake window before the alarm in night mode, 0 = off
+const int SMART_WAKE_OPTIONS[] = {0, 10, 20, 30};
+const int SMART_WAKE_OPTION_COUNT = 4;
+SmartWake smartWake;
+bool smartWakeActive = false;  // Inside the window, watching for light sleep
+bool smartWakeLight = false;   // Light sleep seen; acted on in loop()
 unsigned long dreamJournalStartTime = 0;
 unsigned long lastDreamJournalBeep = 0;
 
+// Dream memo - voice recording from the dream journal screen
+const int MEMO_CHUNK_SAMPLES = 512;  // 64 ms at 8 kHz
+const int MEMO_MIC_BUFFERS = 3;      // Two in the mic's queue, one being encoded
+int16_t memoPcm[MEMO_MIC_BUFFERS][MEMO_CHUNK_SAMPLES];
+uint8_t memoCodes[MEMO_CHUNK_SAMPLES / 2];
+AdpcmEncoder memoEncoder;
+uint32_t memoMaxSamples = 0;
+int memoQueued = 0;    // Chunks handed to the mic
+int memoEncoded = 0;   // ... and written out
+bool memoFull = false;  // Length limit or write error: queue no more
+int memoSavedSlot = -1;  // Shown once recording stops
+
+// Mic and speaker share the I2S peripheral
+const unsigned long MIC_DRAIN_TIMEOUT_MS = 1000;  // Longest queued window is 256 ms
+bool speakerWasEnabled = false;  // Restored when the last mic user lets go
+
 // Settings editing variables
-bool editingManualAlarm = false;
 bool editingMAHour = true;  // true = editing hour, false = editing minute
-bool editingAlarmCount = false;
-bool editingScreenTimeout = false;
-bool editingSensitivity = false;
-bool editingBrightness = false;
 
 // Interactive Reality Check - Light Switch
 bool lightSwitchOn = false;
@@ -97,21 +122,69 @@ unsigned long lightSwitchTime = 0;
 
 // Night Mode - REM Cue System
 bool nightModeActive = false;
-unsigned long sleepStartTime = 0;
-unsigned long lastREMCue = 0;
-const unsigned long SLEEP_CYCLE = 90UL * 60 * 1000;  // 90 minutes in ms
-const unsigned long NIGHT_START_DELAY = 10UL * 60 * 1000;  // 10 min delay before starting
+RTC_NOINIT_ATTR NightSession nightSession;  // Start time, pending cue; survives resets
+const int FIRST_REM_CUE_MIN = 270;   // 4h 30min of deep sleep before the first cue
+const int LATE_REM_WINDOW_MIN = 345;  // Cues every 8 min until 5h 45min, then every 7
+CueAdapt remCue;  // Cue level and spacing from the response to each cue
+int remCueLevel = CUE_REM_DEFAULT_LEVEL;  // Learned level, kept across nights
+RTC_NOINIT_ATTR NightRecorder nightLog;  // This night's epochs, saved on exit
+bool nightDeepSleep = false;  // Deep sleep between REM cues (setting)
+const int64_t NIGHT_SLEEP_MIN_SEC = 60;       // Not worth a reboot for less
+const int64_t NIGHT_SLEEP_MAX_SEC = 15 * 60;  // Bounds the RTC slow-clock error
+const int64_t NIGHT_SLEEP_LEAD_SEC = 10;      // Boot time plus slow-clock error
+NightMonitor nightMonitor;  // Light sleep between IMU FIFO drains
+unsigned long nightMonitorAwakeUntil = 0;  // Stay in the loop until then
+const unsigned long NIGHT_MONITOR_MOVE_HOLD_MS = 60000;  // Cue response, smart wake
+const unsigned long NIGHT_MONITOR_BUTTON_HOLD_MS = 3000;
+const unsigned long NIGHT_MONITOR_RESYNC_HOLD_MS = 3000;  // Sensor task edge resync
+bool nightSoundEnabled = false;  // Mic sound features in night mode (setting)
+uint8_t cueOutput[CUE_EVENT_COUNT] = {CUE_OUT_SOUND, CUE_OUT_SOUND, CUE_OUT_SOUND};  // Buzzer and/or LED (setting)
+int cueOutputRow = 0;  // Event being edited
+bool nightSoundActive = false;   // Mic begun for them
+SoundFeatures nightSound;
+SoundFrame nightSoundFrame;
+int16_t soundPcm[SOUND_WINDOW_SAMPLES];  // Also the ambient sample before a reality check
+bool soundWindowQueued = false;
+unsigned long lastSoundWindow = 0;
+int64_t lastNoiseSec = 0;
+const unsigned long SOUND_PERIOD_MS = 1000;  // One window a second
+const int64_t SOUND_CUE_QUIET_SEC = 30;      // No REM cue this soon after noise
+const int64_t SOUND_CUE_DEFER_SEC = 60;
+int64_t ambientSampledFor = 0;  // Reality check the last ambient sample was for
+bool ambientSampling = false;   // Mic recording into soundPcm
+uint8_t ambientDb = 0;          // Picks the reality check chirp level
+int64_t ambientSec = 0;         // When it was measured, 0 = never
+float monitorX[IMU_FIFO_MAX_SAMPLES], monitorY[IMU_FIFO_MAX_SAMPLES], monitorZ[IMU_FIFO_MAX_SAMPLES];
+
+// Sleep report - one stored night as a hypnogram
+const int REPORT_COLUMNS = 240;
+const int REPORT_TOP = 16;          // Bars hang from here; deeper = longer
+const int REPORT_CUE_Y = 84;
+const uint8_t REPORT_STAGE_MASK = 0x7;  // Column: stage + 1, 0 = no epoch
+const uint8_t REPORT_CUE_BIT = 0x8;
+int reportAge = 0;                   // 0 = last night
+bool reportLoaded = false;
+NightHeader reportHeader;
+uint8_t reportData[NIGHT_LOG_BYTES];
+uint8_t reportColumns[REPORT_COLUMNS];
+uint16_t reportStageEpochs[4];
+int reportWakeups = 0;
 
 // Screen timeout and IMU wake settings
 int screenTimeoutSeconds = 15;  // Default: 15 seconds
 bool screenOn = true;
+bool alwaysOnFace = false;  // Dim HH:MM face instead of screen off at timeout
 unsigned long lastActivityTime = 0;
-float lastAccelX = 0, lastAccelY = 0, lastAccelZ = 0;
+ShakeDetector shake;
 
-// Sensitivity levels: 0=Light Tap, 1=Gentle, 2=Normal, 3=Firm, 4=Hard Shake, 5=Very Hard, 6=Button Only
+// Sensitivity levels: 0=Light Tap, 1=Gentle, 2=Normal, 3=Firm, 4=Hard Shake, 5=Very Hard, 6=Button Only,
+// 7=Wrist Raise (tilt-to-view gesture instead of shake)
 int sensitivityLevel = 2;  // Default: Normal
-const float SENSITIVITY_VALUES[] = {0.15, 0.30, 0.50, 0.80, 1.2, 1.8, 999.0};  // Thresholds (999 = disabled)
-const char* SENSITIVITY_NAMES[] = {"Light Tap", "Gentle", "Normal", "Firm", "Hard", "Very Hard", "Button Only"};
+const int SENSITIVITY_BUTTON_ONLY = 6;
+const int SENSITIVITY_WRIST_RAISE = 7;
+const float SENSITIVITY_VALUES[] = {0.15, 0.30, 0.50, 0.80, 1.2, 1.8, 999.0, 999.0};  // Thresholds (999 = not used)
+const char* SENSITIVITY_NAMES[] = {"Light Tap", "Gentle", "Normal", "Firm", "Hard", "Very Hard", "Button Only", "Wrist Raise"};
+WristRaise wristRaise;
 
 // Brightness levels: 0-10 (0=dimmest, 10=brightest)
 int brightnessLevel = 8;  // Default: 80%
@@ -122,25 +195,38 @@ int clockColorIndex = 0;  // Default: White
 const int CLOCK_COLORS[] = {WHITE, CYAN, GREEN, YELLOW, ORANGE, MAGENTA, RED, BLUE};
 const char* COLOR_NAMES[] = {"White", "Cyan", "Green", "Yellow", "Orange", "Magenta", "Red", "Blue"};
 const int NUM_COLORS = 8;
-bool editingClockColor = false;
 
 // Quiet Hours editing
-bool editingQuietHours = false;
 bool editingQHStart = true;  // true = editing start hour, false = editing end hour
 
 // 12/24 Hour format
 bool use24HourFormat = true;  // Default: 24-hour format
-bool editingTimeFormat = false;
 
 // Reality Check Test mode
-bool testingRealityCheck = false;
 int testRCIndex = 0;  // Which RC to show during test
 
+// Motion-triggered reality checks (stand-up, walk start, spin, free-fall)
+bool motionRCEnabled = false;
+IMU motionImu;  // Batches the 100ms IMU polls for windowed features
+MotionTrigger motionTrigger;
+MotionContext pendingMotion = MOTION_NONE;
+int motionSamplesSinceClassify = 0;
+
 // Forward declarations
 void startBuzzer();
 void stopBuzzer();
-void updateBuzzer();
 void checkIMUActivity();
+void processImuSample(const m5::imu_data_t& data, unsigned long ms);
+void processNightSample(float ax, float ay, float az);
+void processAccelSample(float ax, float ay, float az, unsigned long now);
+void processWristRaiseSample(const m5::imu_data_t& data, unsigned long now);
+void printSensitivity(const char* prefix);
+void processMotionSample(const m5::imu_data_t& data);
+void drawMotionRCUI();
+void drawNightSleepUI();
+void drawNightSoundUI();
+void drawCueOutputUI();
+void playEventCue(CueEvent event, const CuePattern& sound, const CuePattern& light);
 void updateScreenTimeout();
 void drawTimeSetUI();
 void drawNormalUI(int hh, int mm, int ss);
@@ -150,27 +236,83 @@ void drawAlarmsPerDayUI();
 void drawScreenTimeoutUI();
 void drawSensitivityUI();
 void gentleREMBeep();
-void checkNightMode();
+void playREMCue();
+void saveREMCueLevel();
+void saveNightSession();
+void nightDeepSleepIfIdle(int64_t nowSec);
+uint32_t nightMonitorSleepMs(int64_t nowUs);
+void runNightMonitor();
+void nightSoundStart();
+void nightSoundStop();
+void nightSoundPoll(bool wait);
+void ambientPoll(int64_t nowSec);
+void runTimedEvents(int64_t nowSec, int hh);
+void scheduleMorningAlarm(int64_t nowSec);
+void scheduleNextREMCue(int64_t nowSec);
+void startDreamJournal(int64_t nowSec);
+void memoStart();
+void memoPoll();
+void memoStop();
+void drawSmartWakeUI();
 void drawNightModeUI();
+void loadSleepReport();
+void drawSleepReportUI();
 void drawDreamJournalUI();
 void drawBrightnessUI();
 void drawClockColorUI();
 void drawQuietHoursUI();
 void drawTimeFormatUI();
+void drawAlwaysOnUI();
+void drawAlwaysOnFace(int hh, int mm);
+void wakeScreen();
+void sleepScreen();
 void drawManualAlarmUI();
 void scheduleNextAlarm();
+int nextAlarmIntervalMin(int perDay);
+void scheduleNextAlarmFrom(int64_t nowSec);
+void saveNextAlarm();
 bool isQuietHours(int hour);
-unsigned long getCurrentMinutes(int hh, int mm);
 void loadSettings();
 void saveSettings();
+void writeSettings(Preferences& prefs);
+void handleSerialCommand();
+#ifdef LUCID_PROFILE
+void drawDebugUI();
+#endif
+#ifdef LUCID_BENCH
+void runBenchmarks();
+#endif
+void triggerRealityCheck(int rcIndex);
+void clearForScreen();
+
+// Screens (defined after loop())
+extern const Screen clockScreen;
+extern const Screen menuScreen;
+extern const Screen realityCheckScreen;
+extern const Screen nightScreen;
+extern const Screen dreamJournalScreen;
+#ifdef LUCID_PROFILE
+extern const Screen debugScreen;
+#endif
+
+// Menu entries open the screen next to their label
+struct MenuItem {
+  const char* label;
+  const Screen* screen;
+};
+extern const MenuItem MENU[];
+extern const int MENU_ITEMS;
 
 void setup() {
   M5.begin();
+  gpio_hold_dis((gpio_num_t)POWER_HOLD_PIN);  // Latched high for deep sleep
   Serial.begin(115200);
   startMillis = millis();
+  esp_sleep_wakeup_cause_t wakeCause = esp_sleep_get_wakeup_cause();
 
   // Load saved settings from NVS
   loadSettings();
+  MemoStore::begin(NightStore::begin());
 
   // Rotate display 90 degrees counter-clockwise (landscape mode)
   M5.Display.setRotation(3);  // 0=portrait, 1=90°CW, 2=180°, 3=90°CCW
@@ -180,18 +322,21 @@ void setup() {
   ledcAttachPin(BUZZER_PIN, BUZZER_CHANNEL);
   ledcWrite(BUZZER_CHANNEL, 0);  // Start silent
 
-  M5.Display.clear();
-  M5.Display.setTextSize(2);
-  M5.Display.setCursor(4, 8);
-  M5.Display.println("Starting...");
-  delay(300);
+  // No splash when night mode wakes from deep sleep
+  if (wakeCause == ESP_SLEEP_WAKEUP_UNDEFINED) {
+    M5.Display.clear();
+    M5.Display.setTextSize(2);
+    M5.Display.setCursor(4, 8);
+    M5.Display.println("Starting...");
+    delay(300);
 
-  M5.Display.fillScreen(BLACK);
-  M5.Display.setTextSize(2);
-  M5.Display.setTextColor(WHITE, BLACK);
-  M5.Display.setCursor(6, 6);
-  M5.Display.println("Test boot OK");
-  delay(300);
+    M5.Display.fillScreen(BLACK);
+    M5.Display.setTextSize(2);
+    M5.Display.setTextColor(WHITE, BLACK);
+    M5.Display.setCursor(6, 6);
+    M5.Display.println("Test boot OK");
+    delay(300);
+  }
   M5.Display.fillScreen(BLACK);
   
   // Initialize IMU
@@ -200,874 +345,1198 @@ void setup() {
     Serial.println("IMU initialized successfully");
     // Get initial accelerometer values
     auto data = M5.Imu.getImuData();
-    lastAccelX = data.accel.x;
-    lastAccelY = data.accel.y;
-    lastAccelZ = data.accel.z;
+    shake.reset(data.accel.x, data.accel.y, data.accel.z);
   } else {
     Serial.println("Warning: IMU initialization failed");
   }
+
+  // Start the sensor and audio tasks (core 0); loop() stays the UI task
+  Tasks::begin();
   
   Serial.println("=== LUCID DREAM WATCH STARTED ===");
   Serial.println("Random alarms enabled (2-minute intervals for testing)");
   Serial.printf("Screen timeout: %d seconds\n", screenTimeoutSeconds);
   Serial.println("Shake watch to wake screen");
   
-  // Set initial brightness
-  M5.Display.setBrightness(BRIGHTNESS_VALUES[brightnessLevel]);
+  // Set initial brightness (a timer wake at night stays dark)
+  M5.Display.setBrightness(wakeCause == ESP_SLEEP_WAKEUP_TIMER ? 0 : BRIGHTNESS_VALUES[brightnessLevel]);
   Serial.printf("Brightness: %d%% (PWM: %d)\n", (brightnessLevel * 10), BRIGHTNESS_VALUES[brightnessLevel]);
   
-  // Schedule first alarm
-  scheduleNextAlarm();
+  // The random alarm comes back from NVS in loadSettings(); loop() replaces
+  // it if it was missed while the watch was off. None saved (first boot, or
+  // reality checks off): schedule one now, which with checks off does nothing.
+  if (!scheduler.isScheduled(EVENT_REALITY_CHECK)) scheduleNextAlarm();
+  scheduleMorningAlarm(TimeBase::epochSec());
   
   // Initialize activity timer
   lastActivityTime = millis();
+
+  // Start on the clock; every screen change clears the display first
+  screens.setTransitionHook(clearForScreen);
+  screens.setRoot(&clockScreen);
+
+  // Reset or deep-sleep wake in the middle of a night: straight back to it,
+  // screen off unless Button A did the waking
+  if (nightSessionValid(nightSession, TimeBase::epochSec())) {
+    screens.push(&nightScreen);
+    if (wakeCause == ESP_SLEEP_WAKEUP_TIMER) sleepScreen();
+  }
+
+#ifdef LUCID_BENCH
+  runBenchmarks();
+  M5.Display.clear();
+#endif
+
+#ifdef LUCID_PCPROF_HZ
+  PcProf::begin(LUCID_PCPROF_HZ);
+#endif
+
+  // No heap use from here on
+  MemStats::bootComplete();
 }
 
 void loop() {
+  MemStats::loopBegin();
+  TASK_BUSY_BEGIN();
+  PROFILE_BEGIN(STAGE_LOOP);
+
+  PROFILE_BEGIN(STAGE_M5_UPDATE);
   M5.update(); // update button states etc.
+  PROFILE_END(STAGE_M5_UPDATE);
+
+  // Serial console (profiler dump etc.)
+  handleSerialCommand();
 
-  // Update buzzer (non-blocking)
-  updateBuzzer();
-  
   // Check IMU for wake-on-shake
+  PROFILE_BEGIN(STAGE_IMU);
   checkIMUActivity();
+  PROFILE_END(STAGE_IMU);
+
+  // Night sound window, once a second
+  if (nightSoundActive && screens.isTop(&nightScreen)) {
+    nightSoundPoll(false);
+  }
   
   // Update screen timeout
+  PROFILE_BEGIN(STAGE_SCREEN_TIMEOUT);
   updateScreenTimeout();
+  PROFILE_END(STAGE_SCREEN_TIMEOUT);
   
-  // Check Night Mode REM cues
-  checkNightMode();
-
-  // Get real time from RTC
+  // Latest RTC time published by the sensor task
   unsigned long now = millis();
-  auto dt = M5.Rtc.getDateTime();
-  int hh = dt.time.hours;
-  int mm = dt.time.minutes;
-  int ss = dt.time.seconds;
+  PROFILE_BEGIN(STAGE_RTC_READ);
+  ClockSnapshot clk = Tasks::clock();
+  PROFILE_END(STAGE_RTC_READ);
+  int hh = currentHour = clk.hours;
+  currentMinute = clk.minutes;
+  currentSecond = clk.seconds;
+  int64_t nowSec = clk.epochUs / 1000000;
+
+  // Reality checks, the morning alarm and REM cues
+  PROFILE_BEGIN(STAGE_EVENTS);
+  ambientPoll(nowSec);
+  runTimedEvents(nowSec, hh);
+  PROFILE_END(STAGE_EVENTS);
+
+  // Check for motion-context reality check (rate limited)
+  if (pendingMotion != MOTION_NONE) {
+    MotionContext motion = pendingMotion;
+    pendingMotion = MOTION_NONE;
+    if (screens.top()->allowAlarms && !alarmActive && !isQuietHours(hh)) {
+      if (motionTrigger.tryConsumeToken(now)) {
+        logPrintf("MOTION RC TRIGGERED (%s)! Reality check time!\n", MotionTrigger::contextName(motion));
+        // Pick a check that fits the movement
+        if (motion == MOTION_WALK_START) {
+          triggerRealityCheck(RC_MEMORY_RECALL);
+        } else if (motion == MOTION_STAND_UP) {
+          triggerRealityCheck(RC_HAND_COUNT);
+        } else {
+          triggerRealityCheck(RC_IMU_PHYSICS);
+        }
+      } else {
+        Serial.printf("Motion (%s) ignored - rate limited\n", MotionTrigger::contextName(motion));
+      }
+    }
+  }
+
+  // Top screen: timers, display, buttons
+  screens.tick(now);
+
+  PROFILE_BEGIN(STAGE_RENDER);
+  screens.render(now);
+  PROFILE_END(STAGE_RENDER);
+
+  PROFILE_BEGIN(STAGE_INPUT);
+  screens.input();
+  PROFILE_END(STAGE_INPUT);
+
+  PROFILE_END(STAGE_LOOP);
+  TASK_BUSY_END(TASK_UI);
+  MemStats::loopEnd();
+
+  if (nightDeepSleep) {
+    nightDeepSleepIfIdle(nowSec);
+  }
+  runNightMonitor();
+
+#ifdef LUCID_TRACE
+  static unsigned long lastHeapTrace = 0;
+  if (now - lastHeapTrace >= 1000) {
+    lastHeapTrace = now;
+    TRACE_COUNTER("heap_free", ESP.getFreeHeap());
+  }
+  Trace::poll();
+#endif
+
+  // Short idle so loop isn't CPU bird-dogging, but non-blocking. The
+  // always-on face only changes once a minute, so poll buttons less often.
+  delay(AlwaysOn::isActive() ? AOD_LOOP_DELAY_MS : AOD_AWAKE_DELAY_MS);
+}
+
+// Start a reality check on top of the current screen
+void triggerRealityCheck(int rcIndex) {
+  TRACE_INSTANT("reality_check");
+  alarmActive = true;
+  realityCheckStartTime = millis();  // Start auto-dismiss timer
+  startBuzzer();
+  currentRealityCheck = rcIndex;
+  screens.push(&realityCheckScreen);
+}
 
+// Every screen change starts from a blank display
+void clearForScreen() {
+  M5.Display.clear();
+  ui.invalidate();
+}
+
+// ---------------------------------------------------------------------------
+// Clock (root screen)
+// ---------------------------------------------------------------------------
+
+void clockRender() {
+  // Skip if screen is off or light switch test is showing
+  if (screenOn && lightSwitchTime == 0) {
+    drawNormalUI(currentHour, currentMinute, currentSecond);
+  } else if (AlwaysOn::needsRedraw(currentHour, currentMinute)) {
+    drawAlwaysOnFace(currentHour, currentMinute);
+  }
+}
+
+void clockTick(unsigned long now) {
   // Auto-return from light switch test after 10 seconds of inactivity
   if (lightSwitchTime > 0 && (now - lightSwitchTime > 10000)) {
     lightSwitchTime = 0;
     M5.Display.clear();  // Will redraw clock on next loop
   }
+}
 
-  // Check for manual alarm trigger (only in normal mode)
-  // Check for dream journal alarm trigger (only in normal mode)
-  if (currentMode == MODE_NORMAL && !alarmActive && manualAlarmEnabled && !manualAlarmTriggered) {
-    if (hh == manualAlarmHour && mm == manualAlarmMinute) {
-      Serial.println("DREAM JOURNAL ALARM TRIGGERED!");
-      alarmActive = true;
-      manualAlarmTriggered = true;  // Prevent re-trigger
-      currentMode = MODE_DREAM_JOURNAL;
-      dreamJournalStartTime = millis();
-      lastDreamJournalBeep = 0;  // Trigger first beep immediately
-      M5.Display.clear();
-    }
-  }
-  
-  // Reset manual alarm triggered flag when time passes
-  if (manualAlarmTriggered && (hh != manualAlarmHour || mm != manualAlarmMinute)) {
-    manualAlarmTriggered = false;
-    Serial.println("Dream journal alarm ready for next trigger");
-  }
-
-  // Check for random alarm trigger (only in normal mode)
-  if (currentMode == MODE_NORMAL && !alarmActive) {
-    unsigned long currentMinutes = getCurrentMinutes(hh, mm);
-    if (currentMinutes >= nextAlarmMinute) {
-      // Check if in quiet hours
-      if (!isQuietHours(hh)) {
-        Serial.println("ALARM TRIGGERED! Reality check time!");
-        alarmActive = true;
-        currentMode = MODE_REALITY_CHECK;
-        realityCheckStartTime = millis();  // Start auto-dismiss timer
-        startBuzzer();
-        currentRealityCheck++;  // Rotate to next reality check
-        M5.Display.clear();
-      } else {
-        Serial.println("Alarm time but in quiet hours - scheduling next");
-        scheduleNextAlarm();
-      }
-    }
-  }
+void clockInput() {
+  unsigned long now = millis();
 
-  // Display based on current mode
-  if (currentMode == MODE_MENU) {
-    // Menu mode - show menu selection
-    static unsigned long lastMenuUpdate = 0;
-    if (now - lastMenuUpdate >= 200) {
-      drawMenuUI();
-      lastMenuUpdate = now;
-    }
-  } else if (currentMode == MODE_SET_TIME) {
-    // In time-setting mode - show time-setting UI
-    static unsigned long lastUIUpdate = 0;
-    if (now - lastUIUpdate >= 200) {  // Update UI every 200ms
-      drawTimeSetUI();
-      lastUIUpdate = now;
-    }
-  } else if (currentMode == MODE_REALITY_CHECK) {
-    // Reality check mode - show reality check screen
-    static unsigned long lastRCUpdate = 0;
-    if (now - lastRCUpdate >= 200) {
-      drawRealityCheckUI();
-      lastRCUpdate = now;
-    }
-    
-    // Auto-dismiss after 10 seconds
-    if (now - realityCheckStartTime >= REALITY_CHECK_TIMEOUT) {
-      Serial.println("Reality check auto-dismissed after 10 seconds");
-      stopBuzzer();
-      alarmActive = false;
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-      scheduleNextAlarm();
-      lastActivityTime = millis();  // Reset screen timeout
-    }
-  } else if (currentMode == MODE_NIGHT) {
-    // Night mode - show night mode UI
-    static unsigned long lastNightUpdate = 0;
-    if (now - lastNightUpdate >= 1000) {  // Update every second
-      drawNightModeUI();
-      lastNightUpdate = now;
-    }
-  } else if (currentMode == MODE_DREAM_JOURNAL) {
-    // Dream journal mode - gentle beeps every 20 seconds
-    static unsigned long lastDJUpdate = 0;
-    if (now - lastDJUpdate >= 200) {
-      drawDreamJournalUI();
-      lastDJUpdate = now;
-    }
-    
-    // Gentle beep every 20 seconds
-    if (now - lastDreamJournalBeep >= 20000) {
-      gentleREMBeep();  // Reuse the gentle beep function
-      lastDreamJournalBeep = now;
-    }
-  } else if (editingAlarmCount) {
-    // Editing alarms per day
-    static unsigned long lastAlarmsUpdate = 0;
-    if (now - lastAlarmsUpdate >= 200) {
-      drawAlarmsPerDayUI();
-      lastAlarmsUpdate = now;
-    }
-  } else if (editingManualAlarm) {
-    // Editing manual alarm
-    static unsigned long lastMAUpdate = 0;
-    if (now - lastMAUpdate >= 200) {
-      drawManualAlarmUI();
-      lastMAUpdate = now;
-    }
-  } else if (editingScreenTimeout) {
-    // Editing screen timeout
-    static unsigned long lastTimeoutUpdate = 0;
-    if (now - lastTimeoutUpdate >= 200) {
-      drawScreenTimeoutUI();
-      lastTimeoutUpdate = now;
-    }
-  } else if (editingSensitivity) {
-    // Editing shake sensitivity
-    static unsigned long lastSensUpdate = 0;
-    if (now - lastSensUpdate >= 200) {
-      drawSensitivityUI();
-      lastSensUpdate = now;
-    }
-  } else if (editingBrightness) {
-    // Editing brightness
-    static unsigned long lastBrightnessUpdate = 0;
-    if (now - lastBrightnessUpdate >= 200) {
-      drawBrightnessUI();
-      lastBrightnessUpdate = now;
-    }
-  } else if (editingClockColor) {
-    // Editing clock color
-    static unsigned long lastColorUpdate = 0;
-    if (now - lastColorUpdate >= 200) {
-      drawClockColorUI();
-      lastColorUpdate = now;
-    }
-  } else if (editingQuietHours) {
-    // Editing quiet hours
-    static unsigned long lastQHUpdate = 0;
-    if (now - lastQHUpdate >= 200) {
-      drawQuietHoursUI();
-      lastQHUpdate = now;
-    }
-  } else if (editingTimeFormat) {
-    // Editing time format
-    static unsigned long lastTFUpdate = 0;
-    if (now - lastTFUpdate >= 200) {
-      drawTimeFormatUI();
-      lastTFUpdate = now;
-    }
-  } else if (testingRealityCheck) {
-    // Testing reality checks
-    static unsigned long lastRCTest = 0;
-    if (now - lastRCTest >= 200) {
-      drawRealityCheckUI();
-      lastRCTest = now;
-    }
-  } else {
-    // Normal mode - show clock with LARGE time display (skip if light switch test active)
-    if (now - lastRender >= RENDER_MS && screenOn && lightSwitchTime == 0) {
-      lastRender = now;
-      M5.Display.fillRect(0, 0, 240, 135, BLACK);
-      
-      // Format time based on 12/24 hour setting
-      if (use24HourFormat) {
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%02d:%02d:%02d", hh, mm, ss);
-        M5.Display.setCursor(15, 40);
-        M5.Display.setTextSize(4);
-        M5.Display.setTextColor(CLOCK_COLORS[clockColorIndex], BLACK);
-        M5.Display.println(buf);
-      } else {
-        // 12-hour format with AM/PM on separate line
-        int displayHour = hh % 12;
-        if (displayHour == 0) displayHour = 12;  // 0 -> 12
-        const char* ampm = (hh >= 12) ? "PM" : "AM";
-        
-        // Time on first line
-        char buf[32];
-        snprintf(buf, sizeof(buf), "%2d:%02d:%02d", displayHour, mm, ss);
-        M5.Display.setCursor(15, 35);
-        M5.Display.setTextSize(4);
-        M5.Display.setTextColor(CLOCK_COLORS[clockColorIndex], BLACK);
-        M5.Display.println(buf);
-        
-        // AM/PM on second line, smaller
-        M5.Display.setTextSize(2);
-        M5.Display.setCursor(100, 70);
-        M5.Display.println(ampm);
-      }
-    }
+  // Button A: light switch OR HOLD for Night Mode
+  
+  // Check for HOLD (1 second) to enter Night Mode
+  if (M5.BtnA.pressedFor(1000) && screenOn) {
+    Serial.println("BTN A HELD - ENTERING NIGHT MODE");
+    screens.push(&nightScreen);
+    return;  // Skip rest of button logic
   }
-
-  // Button behavior depends on mode
-  if (currentMode == MODE_NORMAL && !editingAlarmCount && !editingManualAlarm && !editingScreenTimeout && !editingSensitivity && !editingBrightness && !editingClockColor && !editingQuietHours && !editingTimeFormat && !testingRealityCheck) {
-    // NORMAL MODE (not editing): Button A for light switch OR HOLD for Night Mode
-    
-    // Check for HOLD (1 second) to enter Night Mode
-    if (M5.BtnA.pressedFor(1000) && screenOn) {
-      Serial.println("BTN A HELD - ENTERING NIGHT MODE");
-      nightModeActive = true;
-      sleepStartTime = millis();
-      currentMode = MODE_NIGHT;
-      M5.Display.clear();
-      drawNightModeUI();
-      return;  // Skip rest of button logic
-    }
+  
+  if (M5.BtnA.wasPressed()) {
+    lastActivityTime = millis();  // Reset timeout
     
-    if (M5.BtnA.wasPressed()) {
-      lastActivityTime = millis();  // Reset timeout
+    if (!screenOn) {
+      // Screen is off - just wake it
+      Serial.println("BTN A PRESSED - WAKING SCREEN");
+      wakeScreen();
+    } else {
+      // Screen is on - trigger LIGHT SWITCH REALITY CHECK
+      Serial.println("BTN A PRESSED - LIGHT SWITCH RC");
+      lightSwitchOn = !lightSwitchOn;
+      lightSwitchTime = millis();  // Reset timeout on each press
       
-      if (!screenOn) {
-        // Screen is off - just wake it
-        Serial.println("BTN A PRESSED - WAKING SCREEN");
-        screenOn = true;
-        M5.Display.wakeup();
-        M5.Display.setBrightness(BRIGHTNESS_VALUES[brightnessLevel]);
-      } else {
-        // Screen is on - trigger LIGHT SWITCH REALITY CHECK
-        Serial.println("BTN A PRESSED - LIGHT SWITCH RC");
-        lightSwitchOn = !lightSwitchOn;
-        lightSwitchTime = millis();  // Reset timeout on each press
-        
-        // Toggle screen to full white or black
-        M5.Display.fillScreen(lightSwitchOn ? WHITE : BLACK);
-        
-        // Add text indicator
-        M5.Display.setTextColor(lightSwitchOn ? BLACK : WHITE);
-        M5.Display.setTextSize(2);
-        M5.Display.setCursor(20, 50);
-        M5.Display.println(lightSwitchOn ? "LIGHT ON" : "LIGHT OFF");
-      }
-    }
-    if (M5.BtnA.wasReleased()) {
-      Serial.println("BTN A RELEASED");
-    }
-  } else if (currentMode == MODE_MENU) {
-    // MENU MODE: Button A scrolls down
-    if (M5.BtnA.wasPressed()) {
-      menuSelection = (menuSelection + 1) % MENU_ITEMS;
-      Serial.printf("Menu selection: %d (%s)\n", menuSelection, menuItems[menuSelection]);
-      drawMenuUI();
-    }
-  } else if (currentMode == MODE_SET_TIME) {
-    // TIME-SETTING MODE: Button A increments hour or minute
-    if (M5.BtnA.wasPressed()) {
-      if (editingHour) {
-        editHour = (editHour + 1) % 24;  // 0-23
-        Serial.printf("Hour changed to: %d\n", editHour);
-      } else {
-        editMinute = (editMinute + 1) % 60;  // 0-59
-        Serial.printf("Minute changed to: %d\n", editMinute);
-      }
-      // Redraw immediately to show change
-      drawTimeSetUI();
-    }
-  } else if (editingAlarmCount) {
-    // EDITING ALARMS/DAY: Button A increments
-    if (M5.BtnA.wasPressed()) {
-      alarmsPerDay++;
-      if (alarmsPerDay > 20) alarmsPerDay = 20;
-      Serial.printf("Alarms/day: %d\n", alarmsPerDay);
-      drawAlarmsPerDayUI();
-    }
-  } else if (editingManualAlarm) {
-    // EDITING MANUAL ALARM: Button A toggles ON/OFF or increments time
-    if (M5.BtnA.wasPressed()) {
-      if (editingMAHour) {
-        manualAlarmHour = (manualAlarmHour + 1) % 24;
-        Serial.printf("Manual alarm hour: %d\n", manualAlarmHour);
-      } else {
-        manualAlarmMinute = (manualAlarmMinute + 1) % 60;
-        Serial.printf("Manual alarm minute: %d\n", manualAlarmMinute);
-      }
-      drawManualAlarmUI();
-    }
-  } else if (editingScreenTimeout) {
-    // EDITING SCREEN TIMEOUT: Button A increments (5 sec steps, then minutes, then always on)
-    if (M5.BtnA.wasPressed()) {
-      if (screenTimeoutSeconds == 0) {
-        screenTimeoutSeconds = 5;  // Always On -> 5 seconds
-      } else if (screenTimeoutSeconds < 60) {
-        screenTimeoutSeconds += 5;  // 5-60 seconds in 5 sec steps
-      } else if (screenTimeoutSeconds == 60) {
-        screenTimeoutSeconds = 120;  // 60 sec -> 2 minutes
-      } else if (screenTimeoutSeconds == 120) {
-        screenTimeoutSeconds = 180;  // 2 min -> 3 minutes
-      } else if (screenTimeoutSeconds == 180) {
-        screenTimeoutSeconds = 240;  // 3 min -> 4 minutes
-      } else if (screenTimeoutSeconds == 240) {
-        screenTimeoutSeconds = 300;  // 4 min -> 5 minutes
-      } else if (screenTimeoutSeconds == 300) {
-        screenTimeoutSeconds = 0;  // 5 min -> Always On
-      }
+      // Toggle screen to full white or black
+      M5.Display.fillScreen(lightSwitchOn ? WHITE : BLACK);
       
-      if (screenTimeoutSeconds == 0) {
-        Serial.println("Screen timeout: Always On");
-      } else {
-        Serial.printf("Screen timeout: %d sec\n", screenTimeoutSeconds);
-      }
-      drawScreenTimeoutUI();
-    }
-  } else if (editingSensitivity) {
-    // EDITING SENSITIVITY: Button A increments level
-    if (M5.BtnA.wasPressed()) {
-      sensitivityLevel++;
-      if (sensitivityLevel > 6) sensitivityLevel = 6;  // Max: Button Only
-      if (sensitivityLevel == 6) {
-        Serial.println("Sensitivity: Button Only (shake-to-wake DISABLED)");
-      } else {
-        Serial.printf("Sensitivity: %s (%.2f)\n", SENSITIVITY_NAMES[sensitivityLevel], SENSITIVITY_VALUES[sensitivityLevel]);
-      }
-      drawSensitivityUI();
-    }
-  } else if (editingBrightness) {
-    // EDITING BRIGHTNESS: Button A increments level
-    if (M5.BtnA.wasPressed()) {
-      brightnessLevel++;
-      if (brightnessLevel > 10) brightnessLevel = 10;  // Max: 100%
-      M5.Display.setBrightness(BRIGHTNESS_VALUES[brightnessLevel]);
-      Serial.printf("Brightness: %d%% (PWM: %d)\n", (brightnessLevel * 10), BRIGHTNESS_VALUES[brightnessLevel]);
-      drawBrightnessUI();
-    }
-  } else if (editingClockColor) {
-    // EDITING CLOCK COLOR: Button A cycles to next color
-    if (M5.BtnA.wasPressed()) {
-      clockColorIndex = (clockColorIndex + 1) % NUM_COLORS;
-      Serial.printf("Clock color: %s\n", COLOR_NAMES[clockColorIndex]);
-      drawClockColorUI();
-    }
-  } else if (editingQuietHours) {
-    // EDITING QUIET HOURS: Button A increments hour
-    if (M5.BtnA.wasPressed()) {
-      if (editingQHStart) {
-        quietHoursStart = (quietHoursStart + 1) % 24;
-        Serial.printf("Quiet hours start: %02d:00\n", quietHoursStart);
-      } else {
-        quietHoursEnd = (quietHoursEnd + 1) % 24;
-        Serial.printf("Quiet hours end: %02d:00\n", quietHoursEnd);
-      }
-      drawQuietHoursUI();
-    }
-  } else if (editingTimeFormat) {
-    // EDITING TIME FORMAT: Button A toggles 12/24 hour format
-    if (M5.BtnA.wasPressed()) {
-      use24HourFormat = !use24HourFormat;
-      Serial.printf("Time format: %s\n", use24HourFormat ? "24 Hour" : "12 Hour");
-      drawTimeFormatUI();
-    }
-  } else if (testingRealityCheck) {
-    // TESTING REALITY CHECKS: Button A cycles to next RC
-    if (M5.BtnA.wasPressed()) {
-      testRCIndex = (testRCIndex + 1) % 9;  // Cycle through 9 reality checks
-      currentRealityCheck = testRCIndex;  // Update which one to show
-      Serial.printf("Testing RC #%d\n", testRCIndex);
-      drawRealityCheckUI();
+      // Add text indicator
+      M5.Display.setTextColor(lightSwitchOn ? BLACK : WHITE);
+      M5.Display.setTextSize(2);
+      M5.Display.setCursor(20, 50);
+      M5.Display.println(lightSwitchOn ? "LIGHT ON" : "LIGHT OFF");
     }
   }
+  if (M5.BtnA.wasReleased()) {
+    Serial.println("BTN A RELEASED");
+  }
 
-  // Button B behavior
-  if (currentMode == MODE_NORMAL && !editingAlarmCount && !editingManualAlarm && !editingScreenTimeout && !editingSensitivity && !editingBrightness && !editingClockColor && !editingQuietHours && !editingTimeFormat && !testingRealityCheck) {
-    // NORMAL MODE (not editing): Hold Button B for 2 seconds to enter MENU
-    if (M5.BtnB.isPressed()) {
-      if (btnBPressTime == 0) {
-        btnBPressTime = now;  // Start timing
-        Serial.println("BTN B PRESSED - TIMING...");
-      } else if (!btnBHeld && (now - btnBPressTime >= BTN_B_HOLD_TIME)) {
-        // Held for 2 seconds - enter MENU mode
-        btnBHeld = true;
-        Serial.println("BTN B HELD 2 SEC - ENTERING MENU");
-        currentMode = MODE_MENU;
-        menuSelection = 0;  // Start at first menu item
-        M5.Display.clear();
-      }
-    } else {
-      // Button released
-      if (btnBPressTime > 0 && !btnBHeld) {
-        // Was a short press, not a hold
-        Serial.println("BTN B SHORT PRESS");
-        M5.Display.fillRect(0, 40, 160, 24, BLACK);
-        M5.Display.setCursor(6, 40);
-        M5.Display.println("Hold 2 sec");
-      }
-      btnBPressTime = 0;
-      btnBHeld = false;
-    }
-  } else if (currentMode == MODE_MENU) {
-    // MENU MODE: Button B selects menu item
-    if (M5.BtnB.wasPressed()) {
-      Serial.printf("Selected: %s\n", menuItems[menuSelection]);
-      if (menuSelection == 0) {
-        // Set Time
-        currentMode = MODE_SET_TIME;
-        editHour = hh;
-        editMinute = mm;
-        editingHour = true;
-        M5.Display.clear();
-      } else if (menuSelection == 1) {
-        // Manual Alarm
-        editingManualAlarm = true;
-        editingMAHour = true;
-        currentMode = MODE_NORMAL;  // Stay in normal but editing
-        M5.Display.clear();
-      } else if (menuSelection == 2) {
-        // Alarms per Day
-        editingAlarmCount = true;
-        currentMode = MODE_NORMAL;  // Stay in normal but editing
-        M5.Display.clear();
-      } else if (menuSelection == 3) {
-        // Quiet Hours
-        editingQuietHours = true;
-        editingQHStart = true;
-        currentMode = MODE_NORMAL;  // Stay in normal but editing
-        M5.Display.clear();
-      } else if (menuSelection == 4) {
-        // 12/24 Format
-        editingTimeFormat = true;
-        currentMode = MODE_NORMAL;  // Stay in normal but editing
-        M5.Display.clear();
-      } else if (menuSelection == 5) {
-        // Screen Timeout
-        editingScreenTimeout = true;
-        currentMode = MODE_NORMAL;  // Stay in normal but editing
-        M5.Display.clear();
-      } else if (menuSelection == 6) {
-        // Shake Sensitivity
-        editingSensitivity = true;
-        currentMode = MODE_NORMAL;  // Stay in normal but editing
-        M5.Display.clear();
-      } else if (menuSelection == 7) {
-        // Brightness
-        editingBrightness = true;
-        currentMode = MODE_NORMAL;  // Stay in normal but editing
-        M5.Display.clear();
-      } else if (menuSelection == 8) {
-        // Clock Color
-        editingClockColor = true;
-        currentMode = MODE_NORMAL;  // Stay in normal but editing
-        M5.Display.clear();
-      } else if (menuSelection == 9) {
-        // Test Reality Checks
-        testingRealityCheck = true;
-        testRCIndex = 0;  // Start with first RC
-        currentRealityCheck = 0;
-        currentMode = MODE_NORMAL;  // Stay in normal but testing
-        M5.Display.clear();
-        Serial.println("Entering Reality Check Test mode");
-      }
-    }
-  } else if (currentMode == MODE_SET_TIME) {
-    // TIME-SETTING MODE: Button B switches between hour/minute
-    if (M5.BtnB.wasPressed()) {
-      editingHour = !editingHour;
-      Serial.printf("Now editing: %s\n", editingHour ? "HOUR" : "MINUTE");
-      // Redraw immediately to show change
-      drawTimeSetUI();
-    }
-  } else if (editingAlarmCount) {
-    // EDITING ALARMS/DAY: Button B decrements
-    if (M5.BtnB.wasPressed()) {
-      alarmsPerDay--;
-      if (alarmsPerDay < 0) alarmsPerDay = 0;
-      Serial.printf("Alarms/day: %d\n", alarmsPerDay);
-      drawAlarmsPerDayUI();
-    }
-  } else if (editingManualAlarm) {
-    // EDITING MANUAL ALARM: Button B switches between hour/minute/enabled
-    if (M5.BtnB.wasPressed()) {
-      if (editingMAHour) {
-        editingMAHour = false;  // Switch to editing minute
-        Serial.println("Now editing manual alarm: MINUTE");
-      } else {
-        // Toggle enabled on/off when done editing time
-        manualAlarmEnabled = !manualAlarmEnabled;
-        Serial.printf("Manual alarm %s\n", manualAlarmEnabled ? "ENABLED" : "DISABLED");
-        editingMAHour = true;  // Reset for next time
-      }
-      drawManualAlarmUI();
-    }
-  } else if (editingScreenTimeout) {
-    // EDITING SCREEN TIMEOUT: Button B decrements (reverse order)
-    if (M5.BtnB.wasPressed()) {
-      if (screenTimeoutSeconds == 5) {
-        screenTimeoutSeconds = 0;  // 5 seconds -> Always On
-      } else if (screenTimeoutSeconds <= 60) {
-        screenTimeoutSeconds -= 5;  // 10-60 seconds in 5 sec steps
-        if (screenTimeoutSeconds < 5) screenTimeoutSeconds = 5;
-      } else if (screenTimeoutSeconds == 120) {
-        screenTimeoutSeconds = 60;  // 2 min -> 60 sec
-      } else if (screenTimeoutSeconds == 180) {
-        screenTimeoutSeconds = 120;  // 3 min -> 2 min
-      } else if (screenTimeoutSeconds == 240) {
-        screenTimeoutSeconds = 180;  // 4 min -> 3 min
-      } else if (screenTimeoutSeconds == 300) {
-        screenTimeoutSeconds = 240;  // 5 min -> 4 min
-      } else if (screenTimeoutSeconds == 0) {
-        screenTimeoutSeconds = 300;  // Always On -> 5 min
-      }
-      
-      if (screenTimeoutSeconds == 0) {
-        Serial.println("Screen timeout: Always On");
-      } else {
-        Serial.printf("Screen timeout: %d sec\n", screenTimeoutSeconds);
-      }
-      drawScreenTimeoutUI();
-    }
-  } else if (editingSensitivity) {
-    // EDITING SENSITIVITY: Button B decrements level
-    if (M5.BtnB.wasPressed()) {
-      sensitivityLevel--;
-      if (sensitivityLevel < 0) sensitivityLevel = 0;  // Min: Light Tap
-      if (sensitivityLevel == 6) {
-        Serial.println("Sensitivity: Button Only (shake-to-wake DISABLED)");
-      } else {
-        Serial.printf("Sensitivity: %s (%.2f)\n", SENSITIVITY_NAMES[sensitivityLevel], SENSITIVITY_VALUES[sensitivityLevel]);
-      }
-      drawSensitivityUI();
-    }
-  } else if (editingBrightness) {
-    // EDITING BRIGHTNESS: Button B decrements level
-    if (M5.BtnB.wasPressed()) {
-      brightnessLevel--;
-      if (brightnessLevel < 0) brightnessLevel = 0;  // Min: 0%
-      M5.Display.setBrightness(BRIGHTNESS_VALUES[brightnessLevel]);
-      Serial.printf("Brightness: %d%% (PWM: %d)\n", (brightnessLevel * 10), BRIGHTNESS_VALUES[brightnessLevel]);
-      drawBrightnessUI();
-    }
-  } else if (editingClockColor) {
-    // EDITING CLOCK COLOR: Button B cycles to previous color
-    if (M5.BtnB.wasPressed()) {
-      clockColorIndex--;
-      if (clockColorIndex < 0) clockColorIndex = NUM_COLORS - 1;
-      Serial.printf("Clock color: %s\n", COLOR_NAMES[clockColorIndex]);
-      drawClockColorUI();
-    }
-  } else if (editingQuietHours) {
-    // EDITING QUIET HOURS: Button B switches between start/end OR decrements
-    if (M5.BtnB.wasPressed()) {
-      if (editingQHStart) {
-        quietHoursStart--;
-        if (quietHoursStart < 0) quietHoursStart = 23;
-        Serial.printf("Quiet hours start: %02d:00\n", quietHoursStart);
-      } else {
-        quietHoursEnd--;
-        if (quietHoursEnd < 0) quietHoursEnd = 23;
-        Serial.printf("Quiet hours end: %02d:00\n", quietHoursEnd);
-      }
-      drawQuietHoursUI();
-    }
-  } else if (editingTimeFormat) {
-    // EDITING TIME FORMAT: Button B toggles (same as A)
-    if (M5.BtnB.wasPressed()) {
-      use24HourFormat = !use24HourFormat;
-      Serial.printf("Time format: %s\n", use24HourFormat ? "24 Hour" : "12 Hour");
-      drawTimeFormatUI();
-    }
-  } else if (testingRealityCheck) {
-    // TESTING REALITY CHECKS: Button B cycles to previous RC
-    if (M5.BtnB.wasPressed()) {
-      testRCIndex--;
-      if (testRCIndex < 0) testRCIndex = 8;  // Wrap to last RC (0-8 = 9 checks)
-      currentRealityCheck = testRCIndex;
-      Serial.printf("Testing RC #%d\n", testRCIndex);
-      drawRealityCheckUI();
-    }
-  } else if (currentMode == MODE_REALITY_CHECK) {
-    // REALITY CHECK MODE: Button B dismisses
-    if (M5.BtnB.wasPressed()) {
-      Serial.println("Reality check dismissed");
-      stopBuzzer();
-      alarmActive = false;
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-      scheduleNextAlarm();
-    }
-  } else if (currentMode == MODE_DREAM_JOURNAL) {
-    // DREAM JOURNAL MODE: Any button dismisses
-    if (M5.BtnA.wasPressed() || M5.BtnB.wasPressed() || M5.BtnPWR.wasPressed()) {
-      Serial.println("Dream journal alarm dismissed");
-      alarmActive = false;
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-      lastDreamJournalBeep = 0;
+  // Button B: hold for 2 seconds to enter MENU
+  if (M5.BtnB.isPressed()) {
+    if (btnBPressTime == 0) {
+      btnBPressTime = now;  // Start timing
+      Serial.println("BTN B PRESSED - TIMING...");
+    } else if (!btnBHeld && (now - btnBPressTime >= BTN_B_HOLD_TIME)) {
+      // Held for 2 seconds - enter MENU mode
+      btnBHeld = true;
+      Serial.println("BTN B HELD 2 SEC - ENTERING MENU");
+      screens.push(&menuScreen);
     }
+  } else {
+    // Button released
+    if (btnBPressTime > 0 && !btnBHeld) {
+      // Was a short press, not a hold
+      Serial.println("BTN B SHORT PRESS");
+      M5.Display.fillRect(0, 40, 160, 24, BLACK);
+      M5.Display.setCursor(6, 40);
+      M5.Display.println("Hold 2 sec");
+    }
+    btnBPressTime = 0;
+    btnBHeld = false;
   }
 
-  // Power Button - ONLY for saving/exiting modes (NOT for entering - causes power off)
-  
-  // Exit Night Mode with PWR button
-  if (currentMode == MODE_NIGHT && M5.BtnPWR.wasPressed()) {
-    Serial.println("Exiting Night Mode");
-    nightModeActive = false;
-    currentMode = MODE_NORMAL;
-    M5.Display.clear();
-  }
-  
-  // Exit light switch test with PWR button
+  // PWR: exit light switch test
   if (lightSwitchTime > 0 && M5.BtnPWR.wasPressed()) {
     Serial.println("Exiting light switch test");
     lightSwitchTime = 0;
     M5.Display.clear();
   }
-  
-  if (currentMode == MODE_MENU) {
-    // MENU MODE: PWR exits back to clock
-    if (M5.BtnPWR.wasPressed()) {
-      Serial.println("Exiting menu");
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-    }
-  } else if (currentMode == MODE_SET_TIME) {
-    // TIME-SETTING MODE: PWR saves and exits
-    if (M5.BtnPWR.wasPressed()) {
-      Serial.printf("Saving time: %02d:%02d\n", editHour, editMinute);
-      // Save to RTC
-      auto t = M5.Rtc.getTime();
-      t.hours = editHour;
-      t.minutes = editMinute;
-      t.seconds = 0;
-      M5.Rtc.setTime(&t);
-      
-      // Return to normal mode
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-      Serial.println("TIME SAVED - Returning to normal mode");
-    }
-  } else if (editingAlarmCount) {
-    // EDITING ALARMS/DAY: PWR saves and exits
-    if (M5.BtnPWR.wasPressed()) {
-      Serial.printf("Alarms/day saved: %d\n", alarmsPerDay);
-      saveSettings();
-      editingAlarmCount = false;
-      // Reschedule next alarm with new settings
-      scheduleNextAlarm();
-      // Return to normal mode
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-      Serial.println("SETTINGS SAVED - Returning to normal mode");
-    }
-  } else if (editingManualAlarm) {
-    // EDITING MANUAL ALARM: PWR saves and exits
-    if (M5.BtnPWR.wasPressed()) {
-      Serial.printf("Manual alarm saved: %02d:%02d (%s)\n", manualAlarmHour, manualAlarmMinute, manualAlarmEnabled ? "ON" : "OFF");
-      saveSettings();
-      editingManualAlarm = false;
-      manualAlarmTriggered = false;  // Reset trigger flag
-      // Return to normal mode
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-      Serial.println("MANUAL ALARM SAVED - Returning to normal mode");
-    }
-  } else if (editingScreenTimeout) {
-    // EDITING SCREEN TIMEOUT: PWR saves and exits
-    if (M5.BtnPWR.wasPressed()) {
-      Serial.printf("Screen timeout saved: %d sec\n", screenTimeoutSeconds);
-      saveSettings();
-      editingScreenTimeout = false;
-      lastActivityTime = millis();  // Reset timeout
-      // Return to normal mode
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-      Serial.println("SCREEN TIMEOUT SAVED - Returning to normal mode");
-    }
-  } else if (editingSensitivity) {
-    // EDITING SENSITIVITY: PWR saves and exits
-    if (M5.BtnPWR.wasPressed()) {
-      if (sensitivityLevel == 6) {
-        Serial.println("Sensitivity saved: Button Only (shake-to-wake DISABLED)");
-      } else {
-        Serial.printf("Sensitivity saved: %s (%.2f)\n", SENSITIVITY_NAMES[sensitivityLevel], SENSITIVITY_VALUES[sensitivityLevel]);
-      }
-      saveSettings();
-      editingSensitivity = false;
-      lastActivityTime = millis();  // Reset timeout
-      // Return to normal mode
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-      Serial.println("SENSITIVITY SAVED - Returning to normal mode");
-    }
-  } else if (editingBrightness) {
-    // EDITING BRIGHTNESS: PWR saves and exits
-    if (M5.BtnPWR.wasPressed()) {
-      Serial.printf("Brightness saved: %d%% (PWM: %d)\n", (brightnessLevel * 10), BRIGHTNESS_VALUES[brightnessLevel]);
-      saveSettings();
-      editingBrightness = false;
-      lastActivityTime = millis();  // Reset timeout
-      // Return to normal mode
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-      Serial.println("BRIGHTNESS SAVED - Returning to normal mode");
-    }
-  } else if (editingClockColor) {
-    // EDITING CLOCK COLOR: PWR saves and exits
-    if (M5.BtnPWR.wasPressed()) {
-      Serial.printf("Clock color saved: %s\n", COLOR_NAMES[clockColorIndex]);
-      saveSettings();
-      editingClockColor = false;
-      lastActivityTime = millis();  // Reset timeout
-      // Return to normal mode
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-      Serial.println("CLOCK COLOR SAVED - Returning to normal mode");
-    }
-  } else if (editingQuietHours) {
-    // EDITING QUIET HOURS: PWR switches between start/end, or exits if both done
-    if (M5.BtnPWR.wasPressed()) {
-      if (editingQHStart) {
-        editingQHStart = false;  // Switch to editing end time
-        Serial.println("Now editing quiet hours: END");
-        drawQuietHoursUI();
-      } else {
-        // Done editing, save and exit
-        Serial.printf("Quiet hours saved: %02d:00 - %02d:00\n", quietHoursStart, quietHoursEnd);
-        saveSettings();
-        editingQuietHours = false;
-        editingQHStart = true;  // Reset for next time
-        lastActivityTime = millis();  // Reset timeout
-        currentMode = MODE_NORMAL;
-        M5.Display.clear();
-        Serial.println("QUIET HOURS SAVED - Returning to normal mode");
-      }
-    }
-  } else if (editingTimeFormat) {
-    // EDITING TIME FORMAT: PWR saves and exits
-    if (M5.BtnPWR.wasPressed()) {
-      Serial.printf("Time format saved: %s\n", use24HourFormat ? "24 Hour" : "12 Hour");
-      saveSettings();
-      editingTimeFormat = false;
-      lastActivityTime = millis();  // Reset timeout
-      // Return to normal mode
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-      Serial.println("TIME FORMAT SAVED - Returning to normal mode");
-    }
-  } else if (testingRealityCheck) {
-    // TESTING REALITY CHECKS: PWR exits test mode
-    if (M5.BtnPWR.wasPressed()) {
-      Serial.println("Exiting Reality Check Test mode");
-      testingRealityCheck = false;
-      lastActivityTime = millis();  // Reset timeout
-      // Return to normal mode
-      currentMode = MODE_NORMAL;
-      M5.Display.clear();
-    }
+}
+
+// ---------------------------------------------------------------------------
+// Menu
+// ---------------------------------------------------------------------------
+
+void menuEnter() {
+  menuSelection = 0;  // Start at first menu item
+}
+
+void menuInput() {
+  // Button A scrolls down
+  if (M5.BtnA.wasPressed()) {
+    menuSelection = (menuSelection + 1) % MENU_ITEMS;
+    Serial.printf("Menu selection: %d (%s)\n", menuSelection, MENU[menuSelection].label);
+    screens.invalidate();
+  }
+
+  // Button B selects menu item
+#ifdef LUCID_PROFILE
+  if (M5.BtnB.wasPressed() && M5.BtnA.isPressed()) {
+    // Hidden: hold A and press B to open the profiler screen
+    Serial.println("Entering profiler screen");
+    screens.push(&debugScreen);
+    return;
+  }
+#endif
+  if (M5.BtnB.wasPressed()) {
+    Serial.printf("Selected: %s\n", MENU[menuSelection].label);
+    screens.push(MENU[menuSelection].screen);
+    return;
   }
 
-  // Short idle so loop isn't CPU bird-dogging, but non-blocking
-  delay(10);
+  // PWR exits back to clock
+  if (M5.BtnPWR.wasPressed()) {
+    Serial.println("Exiting menu");
+    screens.pop();
+  }
 }
 
-// Buzzer control functions
-void startBuzzer() {
-  buzzerActive = true;
-  buzzerChirpNumber = 0;
-  buzzerLastChirp = 0;
-  buzzerToneOn = false;
-  Serial.println("BUZZER: Starting chirp sequence");
+// Leave a settings editor: back to the clock with a fresh timeout
+void finishEditing() {
+  lastActivityTime = millis();  // Reset timeout
+  screens.popToRoot();
 }
 
-void stopBuzzer() {
-  ledcWrite(BUZZER_CHANNEL, 0);
-  buzzerActive = false;
-  buzzerToneOn = false;
-  Serial.println("BUZZER: Stopped");
+// ---------------------------------------------------------------------------
+// Set Time
+// ---------------------------------------------------------------------------
+
+void timeSetEnter() {
+  editHour = currentHour;
+  editMinute = currentMinute;
+  editingHour = true;
 }
 
-void updateBuzzer() {
-  if (!buzzerActive) return;
-  
-  unsigned long now = millis();
-  
-  // If tone is currently on, check if it's time to turn off
-  if (buzzerToneOn) {
-    if (now - buzzerToneStart >= BUZZER_CHIRP_DURATION) {
-      ledcWrite(BUZZER_CHANNEL, 0);  // Turn off
-      buzzerToneOn = false;
-      buzzerLastChirp = now;
-      buzzerChirpNumber++;
-      Serial.printf("BUZZER: Chirp %d/%d complete\n", buzzerChirpNumber, BUZZER_CHIRP_COUNT);
-      
-      // If all chirps done, stop
-      if (buzzerChirpNumber >= BUZZER_CHIRP_COUNT) {
-        stopBuzzer();
-      }
+void timeSetInput() {
+  // Button A increments hour or minute
+  if (M5.BtnA.wasPressed()) {
+    if (editingHour) {
+      editHour = (editHour + 1) % 24;  // 0-23
+      Serial.printf("Hour changed to: %d\n", editHour);
+    } else {
+      editMinute = (editMinute + 1) % 60;  // 0-59
+      Serial.printf("Minute changed to: %d\n", editMinute);
     }
+    screens.invalidate();
   }
-  // If tone is off and we need more chirps, wait for interval then play next
-  else if (buzzerChirpNumber < BUZZER_CHIRP_COUNT) {
-    if (buzzerChirpNumber == 0 || (now - buzzerLastChirp >= BUZZER_CHIRP_INTERVAL)) {
-      ledcWrite(BUZZER_CHANNEL, 128);  // Turn on (50% duty cycle)
-      buzzerToneOn = true;
-      buzzerToneStart = now;
-    }
+
+  // Button B switches between hour/minute
+  if (M5.BtnB.wasPressed()) {
+    editingHour = !editingHour;
+    Serial.printf("Now editing: %s\n", editingHour ? "HOUR" : "MINUTE");
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    Serial.printf("Saving time: %02d:%02d\n", editHour, editMinute);
+    // Save to RTC (written by the sensor task, which owns the bus)
+    Tasks::setTime(editHour, editMinute, 0);
+    
+    screens.popToRoot();
+    Serial.println("TIME SAVED - Returning to normal mode");
   }
 }
 
-// Draw time-setting UI
-void drawTimeSetUI() {
-  M5.Display.fillScreen(BLACK);
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(YELLOW);
-  M5.Display.setCursor(10, 5);
-  M5.Display.println("SET TIME");
-  
-  // Draw large time with highlighting
-  M5.Display.setTextSize(3);
-  M5.Display.setCursor(15, 40);
-  
-  // Hour (green if editing)
-  if (editingHour) {
-    M5.Display.setTextColor(GREEN);
+// ---------------------------------------------------------------------------
+// Reality Check (alarm)
+// ---------------------------------------------------------------------------
+
+void dismissRealityCheck() {
+  stopBuzzer();
+  alarmActive = false;
+  scheduleNextAlarm();
+  screens.pop();
+}
+
+void realityCheckTick(unsigned long now) {
+  // Auto-dismiss after 10 seconds
+  if (now - realityCheckStartTime >= REALITY_CHECK_TIMEOUT) {
+    Serial.println("Reality check auto-dismissed after 10 seconds");
+    dismissRealityCheck();
+    lastActivityTime = millis();  // Reset screen timeout
+  }
+}
+
+void realityCheckInput() {
+  // Button B dismisses
+  if (M5.BtnB.wasPressed()) {
+    Serial.println("Reality check dismissed");
+    dismissRealityCheck();
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Night Mode
+// ---------------------------------------------------------------------------
+
+void nightEnter() {
+  nightModeActive = true;
+  int64_t nowSec = TimeBase::epochSec();
+  if (nightSessionValid(nightSession, nowSec)) {
+    // Reset or deep sleep mid-night: carry on with the same cue timing
+    if (nightSession.logCrc != nightLog.checksum()) {
+      Serial.println("Night log corrupt - restarting it");
+      nightLog.begin(nightSession.startSec);
+    }
+    nightLog.resume(nowSec);
+    remCue.begin(nightSession.cueLevel, nightSession.cueExtraMin);
+    if (nightSession.nextCueSec) scheduler.schedule(EVENT_REM_CUE, nightSession.nextCueSec);
+    logPrintf("Night session resumed: %ld min in, next cue %ld s away, %u sleeps\n",
+              (long)((nowSec - nightSession.startSec) / 60),
+              nightSession.nextCueSec ? (long)(nightSession.nextCueSec - nowSec) : -1L, nightSession.sleeps);
   } else {
-    M5.Display.setTextColor(WHITE);
+    nightSession.startSec = nowSec;
+    nightSession.sleeps = 0;
+    remCue.begin(remCueLevel);
+    nightLog.begin(nowSec);
+    scheduler.schedule(EVENT_REM_CUE, nowSec + FIRST_REM_CUE_MIN * 60);
   }
-  M5.Display.printf("%02d", editHour);
-  
-  M5.Display.setTextColor(WHITE);
-  M5.Display.print(":");
+  if (nightSoundEnabled) nightSoundStart();
+  saveNightSession();
+}
+
+void nightExit() {
+  nightModeActive = false;
+  smartWakeActive = false;
+  smartWakeLight = false;
+  scheduler.cancel(EVENT_REM_CUE);
+  nightSoundStop();
+  nightSessionClear(nightSession);
+  NightStore::save(nightLog.getHeader(), nightLog.getData());
+}
+
+void nightInput() {
+  // PWR exits Night Mode
+  if (M5.BtnPWR.wasPressed()) {
+    Serial.println("Exiting Night Mode");
+    screens.pop();
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Dream Journal (morning alarm)
+// ---------------------------------------------------------------------------
+
+void dreamJournalEnter() {
+  dreamJournalStartTime = millis();
+  lastDreamJournalBeep = 0;  // Trigger first beep immediately
+  memoSavedSlot = -1;
+  // Pushed by the alarm, often over night mode with the panel off
+  lastActivityTime = dreamJournalStartTime;
+  if (!screenOn) wakeScreen();
+}
+
+void dreamJournalExit() {
+  if (MemoStore::isRecording()) memoStop();
+}
+
+void dreamJournalTick(unsigned long now) {
+  if (MemoStore::isRecording()) {
+    memoPoll();
+    return;
+  }
+  // Gentle beep every 20 seconds until a memo is taken, with the panel
+  // back on to show what it wants
+  if (memoSavedSlot < 0 && now - lastDreamJournalBeep >= 20000) {
+    gentleREMBeep();  // Reuse the gentle beep function
+    lastDreamJournalBeep = now;
+    lastActivityTime = now;
+    if (!screenOn) wakeScreen();
+  }
+}
+
+void dreamJournalInput() {
+  // A records a memo (again to stop), B or PWR dismisses
+  if (M5.BtnA.wasPressed()) {
+    if (MemoStore::isRecording()) {
+      memoStop();
+    } else {
+      memoStart();
+    }
+  }
+  if (M5.BtnB.wasPressed() || M5.BtnPWR.wasPressed()) {
+    Serial.println("Dream journal alarm dismissed");
+    alarmActive = false;
+    lastDreamJournalBeep = 0;
+    screens.pop();
+  }
+}
+
+// The mic takes the I2S peripheral from the speaker. The first user notes
+// whether the speaker had it, so micRelease() can hand it back.
+static void micTakeI2s() {
+  if (!M5.Mic.isEnabled()) speakerWasEnabled = M5.Speaker.isEnabled();
+  M5.Speaker.end();
+}
+
+static void micRelease() {
+  M5.Mic.end();
+  if (speakerWasEnabled) M5.Speaker.begin();
+  speakerWasEnabled = false;
+}
+
+// Let the queued windows finish; false if the mic stalls past timeoutMs
+static bool micWaitIdle(unsigned long timeoutMs) {
+  unsigned long start = millis();
+  while (M5.Mic.isRecording()) {
+    if (millis() - start >= timeoutMs) return false;
+    delay(1);
+  }
+  return true;
+}
+
+// Record into the next memo slot; the mic runs until memoStop()
+void memoStart() {
+  memoMaxSamples = MemoStore::start(TimeBase::epochSec());
+  if (memoMaxSamples == 0) return;
+  micTakeI2s();
+  bool micReady;
+  {
+    MemExemptScope exempt(MEM_EXEMPT_MIC);
+    micReady = M5.Mic.begin();
+  }
+  if (!micReady) {
+    Serial.println("Memo: mic unavailable");
+    if (!nightSoundActive) micRelease();
+    MemoStore::finish();
+    return;
+  }
+  // Replaces any reminder beep; the blip is the memo's first 100 ms
+  playEventCue(CUE_EVENT_ALARM, CUE_MEMO_START, CUE_LIGHT_MEMO);
+  memoEncoder.reset();
+  memoQueued = 0;
+  memoEncoded = 0;
+  memoFull = false;
+  memoSavedSlot = -1;
+  Serial.println("Memo: recording");
+  TRACE_BEGIN("memo_record");
+}
+
+static void memoEncodeNext() {
+  size_t bytes = memoEncoder.encode(memoPcm[memoEncoded % MEMO_MIC_BUFFERS], MEMO_CHUNK_SAMPLES, memoCodes);
+  if (!MemoStore::append(memoCodes, bytes)) memoFull = true;
+  memoEncoded++;
+}
+
+// Once per loop while recording. record() blocks while two chunks are
+// queued, so when it returns the chunk queued before those is complete.
+void memoPoll() {
+  if (memoFull || (uint32_t)(memoQueued + 1) * MEMO_CHUNK_SAMPLES > memoMaxSamples) {
+    memoStop();
+    return;
+  }
+  if (!M5.Mic.record(memoPcm[memoQueued % MEMO_MIC_BUFFERS], MEMO_CHUNK_SAMPLES, MEMO_SAMPLE_RATE)) {
+    memoStop();
+    return;
+  }
+  memoQueued++;
+  if (memoQueued - memoEncoded >= MEMO_MIC_BUFFERS) memoEncodeNext();
+  lastActivityTime = millis();  // Screen stays on while recording
+}
+
+// Drain the chunks still in the mic, then write the header. If the mic
+// stalls, the chunks it still holds are dropped rather than saved half filled.
+void memoStop() {
+  if (!micWaitIdle(MIC_DRAIN_TIMEOUT_MS)) {
+    Serial.println("Memo: mic stalled, dropping the last chunks");
+    memoQueued -= MEMO_MIC_BUFFERS - 1;
+    if (memoQueued < memoEncoded) memoQueued = memoEncoded;
+  }
+  while (memoEncoded < memoQueued) memoEncodeNext();
+  if (!nightSoundActive) micRelease();
+  memoSavedSlot = MemoStore::finish();
+  if (memoSavedSlot >= 0) playEventCue(CUE_EVENT_ALARM, CUE_CHIME, CUE_LIGHT_MEMO);
+  TRACE_END("memo_record");
+}
+
+// ---------------------------------------------------------------------------
+// Sleep Report
+// ---------------------------------------------------------------------------
+
+void sleepReportEnter() {
+  reportAge = 0;
+  loadSleepReport();
+}
+
+void sleepReportInput() {
+  // Button A goes back a night, B forward
+  if (M5.BtnA.wasPressed() && NightStore::find(reportAge + 1) >= 0) {
+    reportAge++;
+    loadSleepReport();
+    screens.invalidate();
+  }
+  if (M5.BtnB.wasPressed() && reportAge > 0) {
+    reportAge--;
+    loadSleepReport();
+    screens.invalidate();
+  }
+
+  // PWR exits
+  if (M5.BtnPWR.wasPressed()) {
+    finishEditing();
+  }
+}
+
+// Decode the night once into one stage/cue byte per screen column, so
+// drawing is a handful of fillRects however long the night was
+void loadSleepReport() {
+  memset(reportColumns, 0, sizeof(reportColumns));
+  memset(reportStageEpochs, 0, sizeof(reportStageEpochs));
+  reportWakeups = 0;
+  reportLoaded = NightStore::load(NightStore::find(reportAge), reportHeader, reportData) &&
+                 reportHeader.epochs > 0;
+  if (!reportLoaded) return;
+
+  NightReader reader(reportHeader, reportData);
+  NightEpoch epoch;
+  uint8_t lastStage = SLEEP_DEEP;
+  for (int i = 0; reader.next(epoch); i++) {
+    int c0 = i * REPORT_COLUMNS / reportHeader.epochs;
+    int c1 = (i + 1) * REPORT_COLUMNS / reportHeader.epochs;
+    if (c1 <= c0) c1 = c0 + 1;
+    for (int c = c0; c < c1 && c < REPORT_COLUMNS; c++) {
+      // Several epochs per column: show the most awake; unsampled only
+      // where nothing else landed
+      uint8_t stage = reportColumns[c] & REPORT_STAGE_MASK;
+      if (stage == 0 || stage == SLEEP_UNKNOWN + 1 ||
+          (epoch.stage != SLEEP_UNKNOWN && epoch.stage + 1 > stage)) {
+        stage = epoch.stage + 1;
+      }
+      reportColumns[c] = stage | (reportColumns[c] & REPORT_CUE_BIT) | (epoch.cue ? REPORT_CUE_BIT : 0);
+    }
+    reportStageEpochs[epoch.stage]++;
+    if (epoch.stage == SLEEP_WAKE && lastStage != SLEEP_WAKE) reportWakeups++;
+    lastStage = epoch.stage;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Settings editors
+// ---------------------------------------------------------------------------
+
+void alarmsPerDayInput() {
+  // Button A increments
+  if (M5.BtnA.wasPressed()) {
+    alarmsPerDay++;
+    if (alarmsPerDay > 20) alarmsPerDay = 20;
+    Serial.printf("Alarms/day: %d\n", alarmsPerDay);
+    screens.invalidate();
+  }
+
+  // Button B decrements
+  if (M5.BtnB.wasPressed()) {
+    alarmsPerDay--;
+    if (alarmsPerDay < 0) alarmsPerDay = 0;
+    Serial.printf("Alarms/day: %d\n", alarmsPerDay);
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    Serial.printf("Alarms/day saved: %d\n", alarmsPerDay);
+    saveSettings();
+    // Reschedule next alarm with new settings
+    scheduleNextAlarm();
+    screens.popToRoot();
+    Serial.println("SETTINGS SAVED - Returning to normal mode");
+  }
+}
+
+void manualAlarmEnter() {
+  editingMAHour = true;
+}
+
+void manualAlarmInput() {
+  // Button A increments time
+  if (M5.BtnA.wasPressed()) {
+    if (editingMAHour) {
+      manualAlarmHour = (manualAlarmHour + 1) % 24;
+      Serial.printf("Manual alarm hour: %d\n", manualAlarmHour);
+    } else {
+      manualAlarmMinute = (manualAlarmMinute + 1) % 60;
+      Serial.printf("Manual alarm minute: %d\n", manualAlarmMinute);
+    }
+    screens.invalidate();
+  }
+
+  // Button B switches between hour/minute/enabled
+  if (M5.BtnB.wasPressed()) {
+    if (editingMAHour) {
+      editingMAHour = false;  // Switch to editing minute
+      Serial.println("Now editing manual alarm: MINUTE");
+    } else {
+      // Toggle enabled on/off when done editing time
+      manualAlarmEnabled = !manualAlarmEnabled;
+      Serial.printf("Manual alarm %s\n", manualAlarmEnabled ? "ENABLED" : "DISABLED");
+      editingMAHour = true;  // Reset for next time
+    }
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    Serial.printf("Manual alarm saved: %02d:%02d (%s)\n", manualAlarmHour, manualAlarmMinute, manualAlarmEnabled ? "ON" : "OFF");
+    saveSettings();
+    scheduleMorningAlarm(TimeBase::epochSec());
+    screens.popToRoot();
+    Serial.println("MANUAL ALARM SAVED - Returning to normal mode");
+  }
+}
+
+void smartWakeInput() {
+  // Button A / B step through Off / 10 / 20 / 30 minutes
+  if (M5.BtnA.wasPressed() || M5.BtnB.wasPressed()) {
+    int option = 0;
+    while (option < SMART_WAKE_OPTION_COUNT && SMART_WAKE_OPTIONS[option] != smartWakeMinutes) option++;
+    int step = M5.BtnA.wasPressed() ? 1 : SMART_WAKE_OPTION_COUNT - 1;
+    smartWakeMinutes = SMART_WAKE_OPTIONS[(option + step) % SMART_WAKE_OPTION_COUNT];
+    Serial.printf("Smart wake: %d min\n", smartWakeMinutes);
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    saveSettings();
+    scheduleMorningAlarm(TimeBase::epochSec());
+    finishEditing();
+    Serial.println("SMART WAKE SAVED - Returning to normal mode");
+  }
+}
+
+void screenTimeoutInput() {
+  // Button A increments (5 sec steps, then minutes, then always on)
+  if (M5.BtnA.wasPressed()) {
+    if (screenTimeoutSeconds == 0) {
+      screenTimeoutSeconds = 5;  // Always On -> 5 seconds
+    } else if (screenTimeoutSeconds < 60) {
+      screenTimeoutSeconds += 5;  // 5-60 seconds in 5 sec steps
+    } else if (screenTimeoutSeconds == 60) {
+      screenTimeoutSeconds = 120;  // 60 sec -> 2 minutes
+    } else if (screenTimeoutSeconds == 120) {
+      screenTimeoutSeconds = 180;  // 2 min -> 3 minutes
+    } else if (screenTimeoutSeconds == 180) {
+      screenTimeoutSeconds = 240;  // 3 min -> 4 minutes
+    } else if (screenTimeoutSeconds == 240) {
+      screenTimeoutSeconds = 300;  // 4 min -> 5 minutes
+    } else if (screenTimeoutSeconds == 300) {
+      screenTimeoutSeconds = 0;  // 5 min -> Always On
+    }
+    
+    if (screenTimeoutSeconds == 0) {
+      Serial.println("Screen timeout: Always On");
+    } else {
+      Serial.printf("Screen timeout: %d sec\n", screenTimeoutSeconds);
+    }
+    screens.invalidate();
+  }
+
+  // Button B decrements (reverse order)
+  if (M5.BtnB.wasPressed()) {
+    if (screenTimeoutSeconds == 5) {
+      screenTimeoutSeconds = 0;  // 5 seconds -> Always On
+    } else if (screenTimeoutSeconds <= 60) {
+      screenTimeoutSeconds -= 5;  // 10-60 seconds in 5 sec steps
+      if (screenTimeoutSeconds < 5) screenTimeoutSeconds = 5;
+    } else if (screenTimeoutSeconds == 120) {
+      screenTimeoutSeconds = 60;  // 2 min -> 60 sec
+    } else if (screenTimeoutSeconds == 180) {
+      screenTimeoutSeconds = 120;  // 3 min -> 2 min
+    } else if (screenTimeoutSeconds == 240) {
+      screenTimeoutSeconds = 180;  // 4 min -> 3 min
+    } else if (screenTimeoutSeconds == 300) {
+      screenTimeoutSeconds = 240;  // 5 min -> 4 min
+    } else if (screenTimeoutSeconds == 0) {
+      screenTimeoutSeconds = 300;  // Always On -> 5 min
+    }
+    
+    if (screenTimeoutSeconds == 0) {
+      Serial.println("Screen timeout: Always On");
+    } else {
+      Serial.printf("Screen timeout: %d sec\n", screenTimeoutSeconds);
+    }
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    Serial.printf("Screen timeout saved: %d sec\n", screenTimeoutSeconds);
+    saveSettings();
+    finishEditing();
+    Serial.println("SCREEN TIMEOUT SAVED - Returning to normal mode");
+  }
+}
+
+void sensitivityInput() {
+  // Button A increments level
+  if (M5.BtnA.wasPressed()) {
+    sensitivityLevel++;
+    if (sensitivityLevel > SENSITIVITY_WRIST_RAISE) sensitivityLevel = SENSITIVITY_WRIST_RAISE;  // Max: Wrist Raise
+    printSensitivity("Sensitivity");
+    screens.invalidate();
+  }
+
+  // Button B decrements level
+  if (M5.BtnB.wasPressed()) {
+    sensitivityLevel--;
+    if (sensitivityLevel < 0) sensitivityLevel = 0;  // Min: Light Tap
+    printSensitivity("Sensitivity");
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    printSensitivity("Sensitivity saved");
+    saveSettings();
+    finishEditing();
+    Serial.println("SENSITIVITY SAVED - Returning to normal mode");
+  }
+}
+
+void brightnessInput() {
+  // Button A increments level
+  if (M5.BtnA.wasPressed()) {
+    brightnessLevel++;
+    if (brightnessLevel > 10) brightnessLevel = 10;  // Max: 100%
+    M5.Display.setBrightness(BRIGHTNESS_VALUES[brightnessLevel]);
+    Serial.printf("Brightness: %d%% (PWM: %d)\n", (brightnessLevel * 10), BRIGHTNESS_VALUES[brightnessLevel]);
+    screens.invalidate();
+  }
+
+  // Button B decrements level
+  if (M5.BtnB.wasPressed()) {
+    brightnessLevel--;
+    if (brightnessLevel < 0) brightnessLevel = 0;  // Min: 0%
+    M5.Display.setBrightness(BRIGHTNESS_VALUES[brightnessLevel]);
+    Serial.printf("Brightness: %d%% (PWM: %d)\n", (brightnessLevel * 10), BRIGHTNESS_VALUES[brightnessLevel]);
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    Serial.printf("Brightness saved: %d%% (PWM: %d)\n", (brightnessLevel * 10), BRIGHTNESS_VALUES[brightnessLevel]);
+    saveSettings();
+    finishEditing();
+    Serial.println("BRIGHTNESS SAVED - Returning to normal mode");
+  }
+}
+
+void clockColorInput() {
+  // Button A cycles to next color
+  if (M5.BtnA.wasPressed()) {
+    clockColorIndex = (clockColorIndex + 1) % NUM_COLORS;
+    Serial.printf("Clock color: %s\n", COLOR_NAMES[clockColorIndex]);
+    screens.invalidate();
+  }
+
+  // Button B cycles to previous color
+  if (M5.BtnB.wasPressed()) {
+    clockColorIndex--;
+    if (clockColorIndex < 0) clockColorIndex = NUM_COLORS - 1;
+    Serial.printf("Clock color: %s\n", COLOR_NAMES[clockColorIndex]);
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    Serial.printf("Clock color saved: %s\n", COLOR_NAMES[clockColorIndex]);
+    saveSettings();
+    finishEditing();
+    Serial.println("CLOCK COLOR SAVED - Returning to normal mode");
+  }
+}
+
+void quietHoursEnter() {
+  editingQHStart = true;
+}
+
+void quietHoursInput() {
+  // Button A increments hour
+  if (M5.BtnA.wasPressed()) {
+    if (editingQHStart) {
+      quietHoursStart = (quietHoursStart + 1) % 24;
+      Serial.printf("Quiet hours start: %02d:00\n", quietHoursStart);
+    } else {
+      quietHoursEnd = (quietHoursEnd + 1) % 24;
+      Serial.printf("Quiet hours end: %02d:00\n", quietHoursEnd);
+    }
+    screens.invalidate();
+  }
+
+  // Button B decrements hour
+  if (M5.BtnB.wasPressed()) {
+    if (editingQHStart) {
+      quietHoursStart--;
+      if (quietHoursStart < 0) quietHoursStart = 23;
+      Serial.printf("Quiet hours start: %02d:00\n", quietHoursStart);
+    } else {
+      quietHoursEnd--;
+      if (quietHoursEnd < 0) quietHoursEnd = 23;
+      Serial.printf("Quiet hours end: %02d:00\n", quietHoursEnd);
+    }
+    screens.invalidate();
+  }
+
+  // PWR switches between start/end, or exits if both done
+  if (M5.BtnPWR.wasPressed()) {
+    if (editingQHStart) {
+      editingQHStart = false;  // Switch to editing end time
+      Serial.println("Now editing quiet hours: END");
+      screens.invalidate();
+    } else {
+      // Done editing, save and exit
+      Serial.printf("Quiet hours saved: %02d:00 - %02d:00\n", quietHoursStart, quietHoursEnd);
+      saveSettings();
+      finishEditing();
+      Serial.println("QUIET HOURS SAVED - Returning to normal mode");
+    }
+  }
+}
+
+void timeFormatInput() {
+  // Button A / B toggle 12/24 hour format
+  if (M5.BtnA.wasPressed() || M5.BtnB.wasPressed()) {
+    use24HourFormat = !use24HourFormat;
+    Serial.printf("Time format: %s\n", use24HourFormat ? "24 Hour" : "12 Hour");
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    Serial.printf("Time format saved: %s\n", use24HourFormat ? "24 Hour" : "12 Hour");
+    saveSettings();
+    finishEditing();
+    Serial.println("TIME FORMAT SAVED - Returning to normal mode");
+  }
+}
+
+void alwaysOnInput() {
+  // Button A / B toggle the dim face at screen timeout
+  if (M5.BtnA.wasPressed() || M5.BtnB.wasPressed()) {
+    alwaysOnFace = !alwaysOnFace;
+    Serial.printf("Always-on face: %s\n", alwaysOnFace ? "ON" : "OFF");
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    saveSettings();
+    finishEditing();
+    Serial.println("ALWAYS-ON FACE SAVED - Returning to normal mode");
+  }
+}
+
+void testRCEnter() {
+  testRCIndex = 0;  // Start with first RC
+  currentRealityCheck = 0;
+  Serial.println("Entering Reality Check Test mode");
+}
+
+void testRCInput() {
+  // Button A cycles to next RC
+  if (M5.BtnA.wasPressed()) {
+    testRCIndex = (testRCIndex + 1) % 9;  // Cycle through 9 reality checks
+    currentRealityCheck = testRCIndex;  // Update which one to show
+    Serial.printf("Testing RC #%d\n", testRCIndex);
+    screens.invalidate();
+  }
+
+  // Button B cycles to previous RC
+  if (M5.BtnB.wasPressed()) {
+    testRCIndex--;
+    if (testRCIndex < 0) testRCIndex = 8;  // Wrap to last RC (0-8 = 9 checks)
+    currentRealityCheck = testRCIndex;
+    Serial.printf("Testing RC #%d\n", testRCIndex);
+    screens.invalidate();
+  }
+
+  // PWR exits test mode
+  if (M5.BtnPWR.wasPressed()) {
+    Serial.println("Exiting Reality Check Test mode");
+    finishEditing();
+  }
+}
+
+void motionRCInput() {
+  // Button A / B toggle on/off
+  if (M5.BtnA.wasPressed() || M5.BtnB.wasPressed()) {
+    motionRCEnabled = !motionRCEnabled;
+    Serial.printf("Motion RC: %s\n", motionRCEnabled ? "ON" : "OFF");
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    Serial.printf("Motion RC saved: %s\n", motionRCEnabled ? "ON" : "OFF");
+    saveSettings();
+    motionTrigger.reset(millis());
+    finishEditing();
+    Serial.println("MOTION RC SAVED - Returning to normal mode");
+  }
+}
+
+void nightSleepInput() {
+  // Button A / B toggle on/off
+  if (M5.BtnA.wasPressed() || M5.BtnB.wasPressed()) {
+    nightDeepSleep = !nightDeepSleep;
+    Serial.printf("Night sleep: %s\n", nightDeepSleep ? "ON" : "OFF");
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    saveSettings();
+    finishEditing();
+    Serial.println("NIGHT SLEEP SAVED - Returning to normal mode");
+  }
+}
+
+void nightSoundInput() {
+  // Button A / B toggle on/off
+  if (M5.BtnA.wasPressed() || M5.BtnB.wasPressed()) {
+    nightSoundEnabled = !nightSoundEnabled;
+    Serial.printf("Night sound: %s\n", nightSoundEnabled ? "ON" : "OFF");
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    saveSettings();
+    finishEditing();
+    Serial.println("NIGHT SOUND SAVED - Returning to normal mode");
+  }
+}
+
+void cueOutputEnter() {
+  cueOutputRow = 0;
+}
+
+void cueOutputInput() {
+  // Button A cycles Sound / Light / Both for the selected event
+  if (M5.BtnA.wasPressed()) {
+    uint8_t& output = cueOutput[cueOutputRow];
+    output = output == CUE_OUT_BOTH ? CUE_OUT_SOUND : output + 1;
+    Serial.printf("Cue output %d: %s\n", cueOutputRow, cueOutputName(output));
+    screens.invalidate();
+  }
+
+  // Button B moves to the next event
+  if (M5.BtnB.wasPressed()) {
+    cueOutputRow = (cueOutputRow + 1) % CUE_EVENT_COUNT;
+    screens.invalidate();
+  }
+
+  // PWR saves and exits
+  if (M5.BtnPWR.wasPressed()) {
+    saveSettings();
+    finishEditing();
+    Serial.println("CUE OUTPUT SAVED - Returning to normal mode");
+  }
+}
+
+#ifdef LUCID_PROFILE
+// ---------------------------------------------------------------------------
+// Profiler (hidden)
+// ---------------------------------------------------------------------------
+
+void debugInput() {
+  // Button A resets the counters
+  if (M5.BtnA.wasPressed()) {
+    Profiler::reset();
+    Serial.println("Profiler reset");
+    screens.invalidate();
+  }
+
+  // Button B dumps the histograms over serial
+  if (M5.BtnB.wasPressed()) {
+    Profiler::dump();
+  }
+
+  // PWR returns to the menu
+  if (M5.BtnPWR.wasPressed()) {
+    Serial.println("Exiting profiler screen");
+    screens.pop();
+  }
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Screen table
+// ---------------------------------------------------------------------------
+
+// Rows in screen_table.h
+#define SCREEN(var, name, renderMs, keepAwake, allowAlarms, enter, exit, render, input, tick) \
+  const Screen var = {name, renderMs, keepAwake, allowAlarms, enter, exit, render, input, tick};
+#include "screen_table.h"
+#undef SCREEN
+
+// Menu items in display order
+const MenuItem MENU[] = {
+#define MENU_ITEM(label, var) {label, &var},
+#include "screen_table.h"
+#undef MENU_ITEM
+};
+const int MENU_ITEMS = sizeof(MENU) / sizeof(MENU[0]);
+
+// Buzzer control functions (played by the audio task)
+
+// An event's cue on the outputs chosen for it (Cue Output screen)
+void playEventCue(CueEvent event, const CuePattern& sound, const CuePattern& light) {
+  if (cueOutput[event] & CUE_OUT_SOUND) Tasks::playCue(sound);
+  if (cueOutput[event] & CUE_OUT_LIGHT) Tasks::playLight(light);
+}
+
+void startBuzzer() {
+  int level = CUE_CHIRP_DEFAULT_LEVEL;
+  if (ambientSec && TimeBase::epochSec() - ambientSec <= CHIRP_AMBIENT_MAX_AGE_SEC) {
+    level = ChirpAdapt::levelFor(ambientDb);
+  }
+  playEventCue(CUE_EVENT_REALITY_CHECK, CUE_CHIRP_LEVELS[level], CUE_LIGHT_REALITY_CHECK);
+  Serial.printf("BUZZER: Starting chirp sequence (%s)\n", CUE_CHIRP_LEVELS[level].name);
+}
+
+// Sample the room just before a scheduled reality check so startBuzzer()
+// only has to look the chirp up. Non-blocking: queue the window, score it
+// on a later loop once the mic is done.
+void ambientPoll(int64_t nowSec) {
+  if (ambientSampling) {
+    if (M5.Mic.isRecording()) return;
+    ambientSampling = false;
+    micRelease();
+    ambientDb = ChirpAdapt::ambientDb(soundPcm, SOUND_WINDOW_SAMPLES);
+    ambientSec = nowSec;
+    TRACE_COUNTER("ambient_db", ambientDb);
+    Serial.printf("Ambient: %u dB - %s\n", ambientDb, CUE_CHIRP_LEVELS[ChirpAdapt::levelFor(ambientDb)].name);
+    return;
+  }
+
+  if (!(cueOutput[CUE_EVENT_REALITY_CHECK] & CUE_OUT_SOUND)) return;  // Light only
+  int64_t due = scheduler.dueOf(EVENT_REALITY_CHECK);
+  if (!due || due == ambientSampledFor || due - nowSec > CHIRP_SAMPLE_LEAD_SEC) return;
+  if (nightSoundActive || MemoStore::isRecording() || Tasks::isCueActive()) return;  // Mic busy or buzzing
+  ambientSampledFor = due;
+  micTakeI2s();
+  bool micReady;
+  {
+    MemExemptScope exempt(MEM_EXEMPT_MIC);
+    micReady = M5.Mic.begin();
+  }
+  if (!micReady || !M5.Mic.record(soundPcm, SOUND_WINDOW_SAMPLES, SOUND_SAMPLE_RATE)) {
+    micRelease();
+    return;
+  }
+  ambientSampling = true;
+}
+
+void stopBuzzer() {
+  Tasks::stopCue();
+  Tasks::stopLight();
+  Serial.println("BUZZER: Stopped");
+}
+
+// Draw the clock (LARGE time display)
+void drawNormalUI(int hh, int mm, int ss) {
+  M5.Display.fillRect(0, 0, 240, 135, BLACK);
+  
+  // Format time based on 12/24 hour setting
+  if (use24HourFormat) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%02d:%02d:%02d", hh, mm, ss);
+    M5.Display.setCursor(15, 40);
+    M5.Display.setTextSize(4);
+    M5.Display.setTextColor(CLOCK_COLORS[clockColorIndex], BLACK);
+    M5.Display.println(buf);
+  } else {
+    // 12-hour format with AM/PM on separate line
+    int displayHour = hh % 12;
+    if (displayHour == 0) displayHour = 12;  // 0 -> 12
+    const char* ampm = (hh >= 12) ? "PM" : "AM";
+    
+    // Time on first line
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%2d:%02d:%02d", displayHour, mm, ss);
+    M5.Display.setCursor(15, 35);
+    M5.Display.setTextSize(4);
+    M5.Display.setTextColor(CLOCK_COLORS[clockColorIndex], BLACK);
+    M5.Display.println(buf);
+    
+    // AM/PM on second line, smaller
+    M5.Display.setTextSize(2);
+    M5.Display.setCursor(100, 70);
+    M5.Display.println(ampm);
+  }
+}
+
+// Draw time-setting UI
+void drawTimeSetUI() {
+  M5.Display.fillScreen(BLACK);
+  M5.Display.setTextSize(1);
+  M5.Display.setTextColor(YELLOW);
+  M5.Display.setCursor(10, 5);
+  M5.Display.println("SET TIME");
+  
+  // Draw large time with highlighting
+  M5.Display.setTextSize(3);
+  M5.Display.setCursor(15, 40);
+  
+  // Hour (green if editing)
+  if (editingHour) {
+    M5.Display.setTextColor(GREEN);
+  } else {
+    M5.Display.setTextColor(WHITE);
+  }
+  M5.Display.printf("%02d", editHour);
+  
+  M5.Display.setTextColor(WHITE);
+  M5.Display.print(":");
   
   // Minute (green if editing)
   if (!editingHour) {
@@ -1086,11 +1555,6 @@ void drawTimeSetUI() {
   M5.Display.println("PWR:Save&Exit");
 }
 
-// Get current time in minutes since midnight
-unsigned long getCurrentMinutes(int hh, int mm) {
-  return (hh * 60) + mm;
-}
-
 // Check if current hour is in quiet hours
 bool isQuietHours(int hour) {
   if (quietHoursStart < quietHoursEnd) {
@@ -1102,34 +1566,136 @@ bool isQuietHours(int hour) {
   }
 }
 
-// Schedule next random alarm
+// Fire or reschedule whatever timed event is due
+void runTimedEvents(int64_t nowSec, int hh) {
+  // Alarms may only interrupt the clock and the settings editors; the morning
+  // alarm and REM cues also run in night mode
+  uint32_t allowed = 0;
+  if (!alarmActive && screens.top()->allowAlarms) {
+    allowed |= EVENT_BIT(EVENT_REALITY_CHECK) | EVENT_BIT(EVENT_MORNING_ALARM);
+  }
+  if (!alarmActive && screens.isTop(&nightScreen)) {
+    allowed |= EVENT_BIT(EVENT_MORNING_ALARM) | EVENT_BIT(EVENT_REM_CUE) | EVENT_BIT(EVENT_WAKE_WINDOW);
+
+    // Light sleep inside the wake window: the alarm goes off now
+    if (smartWakeLight) {
+      Serial.println("SMART WAKE: light sleep - alarm early");
+      startDreamJournal(nowSec);
+      return;
+    }
+  }
+
+  TimedEvent event;
+  SchedResult result = scheduler.poll(nowSec, allowed, event);
+  if (result == SCHED_NONE) return;
+  bool fire = result == SCHED_FIRE;
+
+  switch (event.kind) {
+    case EVENT_REALITY_CHECK:
+      // Move on (and persist) before firing, so a reset can't fire it twice
+      scheduleNextAlarm();
+      if (!fire) {
+        Serial.println("Reality check missed - scheduling next");
+      } else if (isQuietHours(hh)) {
+        Serial.println("Alarm time but in quiet hours - skipped");
+      } else {
+        Serial.println("ALARM TRIGGERED! Reality check time!");
+        triggerRealityCheck(currentRealityCheck + 1);  // Rotate to next reality check
+      }
+      break;
+    case EVENT_MORNING_ALARM:
+      if (fire) {
+        startDreamJournal(nowSec);
+      } else {
+        smartWakeActive = false;
+        scheduleMorningAlarm(nowSec);
+      }
+      break;
+    case EVENT_WAKE_WINDOW:
+      if (fire) {
+        // Cues now would only wake the user into the window or look like light sleep
+        Serial.printf("SMART WAKE: window open (%d min)\n", smartWakeMinutes);
+        scheduler.cancel(EVENT_REM_CUE);
+        smartWake.reset();
+        smartWakeActive = true;
+        smartWakeLight = false;
+      }
+      break;
+    case EVENT_REM_CUE:
+      if (!nightModeActive) break;
+      if (fire && nightSoundActive && nowSec - lastNoiseSec < SOUND_CUE_QUIET_SEC) {
+        // Wouldn't be heard over it, and the noise may have woken them already
+        Serial.println("REM cue deferred - noisy");
+        scheduler.schedule(EVENT_REM_CUE, nowSec + SOUND_CUE_DEFER_SEC);
+        break;
+      }
+      if (fire) playREMCue();
+      scheduleNextREMCue(nowSec);
+      break;
+  }
+  if (nightModeActive) saveNightSession();
+}
+
+// Next occurrence of the morning alarm time after nowSec, and the start of
+// its smart wake window
+void scheduleMorningAlarm(int64_t nowSec) {
+  if (!manualAlarmEnabled) {
+    scheduler.cancel(EVENT_MORNING_ALARM);
+    scheduler.cancel(EVENT_WAKE_WINDOW);
+    return;
+  }
+  int64_t due = EventScheduler::nextDaily(nowSec, manualAlarmHour * 3600 + manualAlarmMinute * 60);
+  scheduler.schedule(EVENT_MORNING_ALARM, due);
+
+  if (smartWakeMinutes > 0) {
+    int64_t windowStart = due - smartWakeMinutes * 60;
+    scheduler.schedule(EVENT_WAKE_WINDOW, windowStart > nowSec ? windowStart : nowSec);
+  } else {
+    scheduler.cancel(EVENT_WAKE_WINDOW);
+  }
+}
+
+// Dream journal alarm, at the set time or early from the wake window;
+// tomorrow's alarm is queued straight away
+void startDreamJournal(int64_t nowSec) {
+  int64_t due = scheduler.dueOf(EVENT_MORNING_ALARM);
+  scheduleMorningAlarm((due > nowSec ? due : nowSec) + 60);
+  smartWakeActive = false;
+  smartWakeLight = false;
+  Serial.println("DREAM JOURNAL ALARM TRIGGERED!");
+  alarmActive = true;
+  screens.push(&dreamJournalScreen);
+}
+
+// Schedule next random alarm from now and persist it
 void scheduleNextAlarm() {
-  auto dt = M5.Rtc.getDateTime();
-  int currentMinutes = getCurrentMinutes(dt.time.hours, dt.time.minutes);
-  
-  // Calculate random interval based on alarmsPerDay
-  // Awake hours: assume 16 hours (7 AM to 11 PM = 960 minutes)
-  // Divide awake time by number of alarms per day
-  int awakeMinutes = 960;  // 16 hours
-  int avgInterval = awakeMinutes / alarmsPerDay;
-  
-  // Add randomness: ±30% of average interval
-  int randomness = avgInterval * 0.3;
-  int minInterval = avgInterval - randomness;
-  int maxInterval = avgInterval + randomness;
-  
-  // Random interval between min and max
-  int interval = random(minInterval, maxInterval + 1);
-  
-  nextAlarmMinute = currentMinutes + interval;
-  
-  // Wrap around at midnight (1440 minutes per day)
-  if (nextAlarmMinute >= 1440) {
-    nextAlarmMinute -= 1440;
+  scheduleNextAlarmFrom(TimeBase::epochSec());
+  saveNextAlarm();
+}
+
+// Minutes until the next random alarm - no side effects besides random().
+// 0 when reality checks are off (0 per day).
+int nextAlarmIntervalMin(int perDay) {
+  // Spread perDay checks over the 16 waking hours, +/-30% at random
+  int minInterval, maxInterval;
+  if (!EventScheduler::checkIntervalRange(perDay, minInterval, maxInterval)) return 0;
+  return random(minInterval, maxInterval + 1);
+}
+
+// Schedule next random alarm relative to a given wall-clock time; with
+// reality checks off, drop any pending one instead
+void scheduleNextAlarmFrom(int64_t nowSec) {
+  int interval = nextAlarmIntervalMin(alarmsPerDay);
+  if (!interval) {
+    scheduler.cancel(EVENT_REALITY_CHECK);
+    logPrintf("Reality checks off (0 alarms/day)\n");
+    return;
   }
   
-  Serial.printf("Next alarm in ~%d minutes (avg interval: %d min for %d alarms/day)\n", 
-                interval, avgInterval, alarmsPerDay);
+  scheduler.schedule(EVENT_REALITY_CHECK, nowSec + interval * 60);
+  
+  logPrintf("Next alarm in ~%d minutes (avg interval: %d min for %d alarms/day)\n", 
+                interval, SCHED_AWAKE_MIN / alarmsPerDay, alarmsPerDay);
 }
 
 // Draw reality check screen
@@ -1176,14 +1742,14 @@ void drawRealityCheckUI() {
     case 3:  // Digital watch - SHOW LIVE CLOCK
       {
         // Get current time
-        auto dt = M5.Rtc.getDateTime();
+        ClockSnapshot clk = Tasks::clock();
         char timeBuf[16];
         if (use24HourFormat) {
-          snprintf(timeBuf, sizeof(timeBuf), "%02d:%02d:%02d", dt.time.hours, dt.time.minutes, dt.time.seconds);
+          snprintf(timeBuf, sizeof(timeBuf), "%02d:%02d:%02d", clk.hours, clk.minutes, clk.seconds);
         } else {
-          int displayHour = dt.time.hours % 12;
+          int displayHour = clk.hours % 12;
           if (displayHour == 0) displayHour = 12;
-          snprintf(timeBuf, sizeof(timeBuf), "%2d:%02d:%02d", displayHour, dt.time.minutes, dt.time.seconds);
+          snprintf(timeBuf, sizeof(timeBuf), "%2d:%02d:%02d", displayHour, clk.minutes, clk.seconds);
         }
         
         // Display live clock
@@ -1235,16 +1801,19 @@ void drawMenuUI() {
   
   M5.Display.setTextSize(1);
   
-  // Draw menu items in 2 columns
-  // Column 1: items 0-4 (left side)
-  // Column 2: items 5-8 (right side)
+  // Draw the current page of menu items in 2 columns
+  // Column 1: rows 0-5 (left side)
+  // Column 2: rows 6-11 (right side)
+  int page = menuSelection / MENU_ITEMS_PER_PAGE;
+  int first = page * MENU_ITEMS_PER_PAGE;
   
-  for (int i = 0; i < MENU_ITEMS; i++) {
-    int col = (i < 5) ? 0 : 1;  // Which column (0 = left, 1 = right)
-    int row = (i < 5) ? i : (i - 5);  // Which row in that column
+  for (int i = first; i < MENU_ITEMS && i < first + MENU_ITEMS_PER_PAGE; i++) {
+    int slot = i - first;
+    int col = (slot < 6) ? 0 : 1;  // Which column (0 = left, 1 = right)
+    int row = (slot < 6) ? slot : (slot - 6);  // Which row in that column
     
     int x = (col == 0) ? 5 : 125;  // X position
-    int y = 25 + (row * 22);  // Y position - tighter spacing (was 30 + row*25)
+    int y = 25 + (row * 18);  // Y position - 6 rows per column
     
     if (i == menuSelection) {
       // Selected item - green with arrow
@@ -1252,394 +1821,545 @@ void drawMenuUI() {
       M5.Display.setCursor(x, y);
       M5.Display.print(">");
       M5.Display.setCursor(x + 10, y);
-      M5.Display.println(menuItems[i]);
+      M5.Display.println(MENU[i].label);
     } else {
       // Unselected item - white
       M5.Display.setTextColor(WHITE);
       M5.Display.setCursor(x + 10, y);
-      M5.Display.println(menuItems[i]);
+      M5.Display.println(MENU[i].label);
     }
   }
+  
+  // Page indicator once the menu outgrows one screen
+  if (MENU_ITEMS > MENU_ITEMS_PER_PAGE) {
+    int pages = (MENU_ITEMS + MENU_ITEMS_PER_PAGE - 1) / MENU_ITEMS_PER_PAGE;
+    M5.Display.setTextColor(DARKGREY);
+    M5.Display.setCursor(200, 5);
+    M5.Display.printf("%d/%d", page + 1, pages);
+  }
 }
 
+// ---------------------------------------------------------------------------
+// Settings editor layouts
+// Fixed labels are LTEXT, values are LFIELD slots; the renderer only repaints
+// the slots whose text changed since the previous frame.
+// ---------------------------------------------------------------------------
+
+constexpr LayoutOp ALARMS_PER_DAY_OPS[] = {
+  LTEXT(10, 5, 2, YELLOW, "ALARMS/DAY"),
+  LTEXT(5, 35, 1, WHITE, "Reality checks:"),
+  LFIELD(60, 55, 4, GREEN, 0, 3),  // Current value in large green; 0 is Off
+  LTEXT(5, 100, 1, CYAN, "A:+  B:-  (0-20)"),
+  LTEXT(5, 115, 1, CYAN, "PWR:Save")
+};
+constexpr Layout ALARMS_PER_DAY_LAYOUT = makeLayout(ALARMS_PER_DAY_OPS);
+
 // Draw alarms per day editing screen
 void drawAlarmsPerDayUI() {
-  M5.Display.fillScreen(BLACK);
-  M5.Display.setTextSize(2);
-  M5.Display.setTextColor(YELLOW);
-  M5.Display.setCursor(10, 5);
-  M5.Display.println("ALARMS/DAY");
-  
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(WHITE);
-  M5.Display.setCursor(5, 35);
-  M5.Display.println("Reality checks:");
-  
-  // Show current value in large green
-  M5.Display.setTextSize(4);
-  M5.Display.setTextColor(GREEN);
-  M5.Display.setCursor(60, 55);
-  M5.Display.printf("%d", alarmsPerDay);
-  
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(CYAN);
-  M5.Display.setCursor(5, 100);
-  M5.Display.println("A:+  B:-  (0-20)");
-  M5.Display.setCursor(5, 115);
-  M5.Display.println("PWR:Save");
-}
-
-// Draw manual alarm editing screen
-void drawManualAlarmUI() {
-  M5.Display.fillScreen(BLACK);
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(YELLOW);
-  M5.Display.setCursor(5, 5);
-  M5.Display.println("MORNING");
-  M5.Display.setCursor(5, 20);
-  M5.Display.println("ALARM");
-  
-  // Show ON/OFF status
-  M5.Display.setTextSize(2);
-  M5.Display.setCursor(10, 40);
-  if (manualAlarmEnabled) {
-    M5.Display.setTextColor(GREEN);
-    M5.Display.println("ENABLED");
-  } else {
-    M5.Display.setTextColor(RED);
-    M5.Display.println("DISABLED");
-  }
-  
-  // Draw large time with highlighting
-  M5.Display.setTextSize(3);
-  M5.Display.setCursor(15, 50);
-  
-  // Hour (green if editing)
-  if (editingMAHour) {
-    M5.Display.setTextColor(GREEN);
-  } else {
-    M5.Display.setTextColor(WHITE);
-  }
-  M5.Display.printf("%02d", manualAlarmHour);
-  
-  M5.Display.setTextColor(WHITE);
-  M5.Display.print(":");
-  
-  // Minute (green if editing)
-  if (!editingMAHour) {
-    M5.Display.setTextColor(GREEN);
+  ui.begin(ALARMS_PER_DAY_LAYOUT);
+  if (alarmsPerDay) {
+    ui.setf(0, "%d", alarmsPerDay);
   } else {
-    M5.Display.setTextColor(WHITE);
+    ui.set(0, "Off");
   }
-  M5.Display.printf("%02d", manualAlarmMinute);
-  
-  // Instructions
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(CYAN);
-  M5.Display.setCursor(5, 95);
-  M5.Display.println("A:+  B:Switch/Toggle");
-  M5.Display.setCursor(5, 110);
-  M5.Display.println("PWR:Save");
+  ui.end();
 }
 
-// Check IMU for activity (shake detection to wake screen)
-void checkIMUActivity() {
-  // Skip IMU checks if "Button Only" mode selected (level 6)
-  if (sensitivityLevel == 6) {
-    return;  // IMU disabled - button-only wake
-  }
-  
-  static unsigned long lastIMUCheck = 0;
-  unsigned long now = millis();
-  
-  // Check IMU every 100ms
-  if (now - lastIMUCheck < 100) {
-    return;
-  }
-  lastIMUCheck = now;
-  
-  if (M5.Imu.update()) {
-    auto data = M5.Imu.getImuData();
-    float deltaX = abs(data.accel.x - lastAccelX);
-    float deltaY = abs(data.accel.y - lastAccelY);
-    float deltaZ = abs(data.accel.z - lastAccelZ);
-    
-    // Use current sensitivity setting
-    float currentThreshold = SENSITIVITY_VALUES[sensitivityLevel];
-    
-    // Check if significant movement detected
-    if (deltaX > currentThreshold || deltaY > currentThreshold || deltaZ > currentThreshold) {
-      // Movement detected - wake screen
-      if (!screenOn) {
-        Serial.printf("IMU: Movement detected (sensitivity: %s) - waking screen\n", SENSITIVITY_NAMES[sensitivityLevel]);
-        screenOn = true;
-        M5.Display.wakeup();
-        M5.Display.setBrightness(BRIGHTNESS_VALUES[brightnessLevel]);
-      }
-      lastActivityTime = now;  // Reset timeout
-    }
-    
-    // Update last values
-    lastAccelX = data.accel.x;
-    lastAccelY = data.accel.y;
-    lastAccelZ = data.accel.z;
-  }
-}
-
-// Update screen timeout (turn off screen after inactivity)
-void updateScreenTimeout() {
-  unsigned long now = millis();
-  
-  // Don't timeout during alarms or menu navigation
-  if (currentMode == MODE_REALITY_CHECK || currentMode == MODE_MENU || 
-      currentMode == MODE_SET_TIME || editingAlarmCount || editingScreenTimeout || 
-      editingSensitivity || editingBrightness || editingClockColor || editingManualAlarm) {
-    lastActivityTime = now;
-    if (!screenOn) {
-      screenOn = true;
-      M5.Display.wakeup();
-      M5.Display.setBrightness(BRIGHTNESS_VALUES[brightnessLevel]);
-    }
-    return;
-  }
-  
-  // Skip timeout if Always On mode (0 = never timeout)
-  if (screenTimeoutSeconds == 0) {
-    return;
-  }
-  
-  // Check timeout
-  if (screenOn && (now - lastActivityTime > (screenTimeoutSeconds * 1000))) {
-    Serial.println("Screen timeout - sleeping");
-    screenOn = false;
-    M5.Display.sleep();
-    M5.Display.setBrightness(0);
-  }
-}
+enum { TIMEOUT_VALUE, TIMEOUT_UNIT, TIMEOUT_ALWAYS };
+constexpr LayoutOp SCREEN_TIMEOUT_OPS[] = {
+  LTEXT(10, 5, 2, YELLOW, "TIMEOUT"),
+  LTEXT(5, 35, 1, WHITE, "Screen sleep:"),
+  LFIELD(50, 55, 4, GREEN, TIMEOUT_VALUE, 2),
+  LFIELD(120, 65, 2, GREEN, TIMEOUT_UNIT, 1),
+  LFIELD(20, 55, 2, GREEN, TIMEOUT_ALWAYS, 9),
+  LTEXT(5, 100, 1, CYAN, "5s-60s, 2m-5m, Always"),
+  LTEXT(5, 115, 1, CYAN, "PWR:Save")
+};
+constexpr Layout SCREEN_TIMEOUT_LAYOUT = makeLayout(SCREEN_TIMEOUT_OPS);
 
 // Draw screen timeout editing screen
 void drawScreenTimeoutUI() {
-  M5.Display.fillScreen(BLACK);
-  M5.Display.setTextSize(2);
-  M5.Display.setTextColor(YELLOW);
-  M5.Display.setCursor(10, 5);
-  M5.Display.println("TIMEOUT");
-  
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(WHITE);
-  M5.Display.setCursor(5, 35);
-  M5.Display.println("Screen sleep:");
-  
-  // Show current value in large green
-  M5.Display.setTextSize(4);
-  M5.Display.setTextColor(GREEN);
-  
+  ui.begin(SCREEN_TIMEOUT_LAYOUT);
   if (screenTimeoutSeconds == 0) {
-    // Always On mode
-    M5.Display.setCursor(20, 55);
-    M5.Display.setTextSize(2);
-    M5.Display.println("ALWAYS ON");
+    ui.set(TIMEOUT_ALWAYS, "ALWAYS ON");
   } else if (screenTimeoutSeconds >= 60) {
     // Display in minutes
-    M5.Display.setCursor(50, 55);
-    M5.Display.printf("%d", screenTimeoutSeconds / 60);
-    M5.Display.setTextSize(2);
-    M5.Display.setCursor(120, 65);
-    M5.Display.println("m");
+    ui.setf(TIMEOUT_VALUE, "%d", screenTimeoutSeconds / 60);
+    ui.set(TIMEOUT_UNIT, "m");
   } else {
     // Display in seconds
-    M5.Display.setCursor(50, 55);
-    M5.Display.printf("%d", screenTimeoutSeconds);
-    M5.Display.setTextSize(2);
-    M5.Display.setCursor(120, 65);
-    M5.Display.println("s");
+    ui.setf(TIMEOUT_VALUE, "%d", screenTimeoutSeconds);
+    ui.set(TIMEOUT_UNIT, "s");
   }
-  
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(CYAN);
-  M5.Display.setCursor(5, 100);
-  M5.Display.println("5s-60s, 2m-5m, Always");
-  M5.Display.setCursor(5, 115);
-  M5.Display.println("PWR:Save");
+  ui.end();
 }
 
+enum { SENSE_NAME, SENSE_LINE1, SENSE_LINE2 };
+constexpr LayoutOp SENSITIVITY_OPS[] = {
+  LTEXT(5, 2, 2, YELLOW, "SHAKE SENSE"),
+  LTEXT(5, 28, 1, WHITE, "Wake sensitivity:"),
+  LFIELD(15, 48, 2, GREEN, SENSE_NAME, 11),
+  LFIELD(5, 75, 1, CYAN, SENSE_LINE1, 20),
+  LFIELD(5, 87, 1, CYAN, SENSE_LINE2, 20),
+  LTEXT(5, 105, 1, CYAN, "A: More  B: Less"),
+  LTEXT(5, 118, 1, CYAN, "PWR: Save")
+};
+constexpr Layout SENSITIVITY_LAYOUT = makeLayout(SENSITIVITY_OPS);
+
 // Draw sensitivity editing screen
 void drawSensitivityUI() {
-  M5.Display.fillScreen(BLACK);
-  M5.Display.setTextSize(2);
-  M5.Display.setTextColor(YELLOW);
-  M5.Display.setCursor(5, 2);
-  M5.Display.println("SHAKE SENSE");
-  
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(WHITE);
-  M5.Display.setCursor(5, 28);
-  M5.Display.println("Wake sensitivity:");
-  
-  // Show current level name in large green
-  M5.Display.setTextSize(2);
-  M5.Display.setTextColor(GREEN);
-  M5.Display.setCursor(15, 48);
-  M5.Display.println(SENSITIVITY_NAMES[sensitivityLevel]);
-  
-  // Show visual indicator (bars) - skip if Button Only mode
-  if (sensitivityLevel < 6) {
-    M5.Display.setTextSize(1);
-    M5.Display.setTextColor(CYAN);
-    M5.Display.setCursor(5, 75);
-    for (int i = 0; i <= sensitivityLevel; i++) {
-      M5.Display.print("|||");
-    }
+  ui.begin(SENSITIVITY_LAYOUT);
+  ui.set(SENSE_NAME, SENSITIVITY_NAMES[sensitivityLevel]);
+  
+  if (sensitivityLevel < SENSITIVITY_BUTTON_ONLY) {
+    // Visual indicator (bars)
+    static const char BARS[] = "||||||||||||||||||";
+    ui.set(SENSE_LINE1, BARS + sizeof(BARS) - 1 - 3 * (sensitivityLevel + 1));
+  } else if (sensitivityLevel == SENSITIVITY_WRIST_RAISE) {
+    // Wrist Raise mode - explain the gesture
+    ui.set(SENSE_LINE1, "Raise & hold to wake");
+    ui.set(SENSE_LINE2, "(bumps are ignored)");
   } else {
     // Button Only mode - show special indicator
-    M5.Display.setTextSize(1);
-    M5.Display.setTextColor(RED);
-    M5.Display.setCursor(5, 75);
-    M5.Display.println("IMU DISABLED");
-    M5.Display.setCursor(5, 87);
-    M5.Display.println("(Button wake only)");
+    ui.set(SENSE_LINE1, "IMU DISABLED");
+    ui.set(SENSE_LINE2, "(Button wake only)");
+    ui.setColor(SENSE_LINE1, RED, BLACK);
+    ui.setColor(SENSE_LINE2, RED, BLACK);
   }
-  
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(CYAN);
-  M5.Display.setCursor(5, 105);
-  M5.Display.println("A: More  B: Less");
-  M5.Display.setCursor(5, 118);
-  M5.Display.println("PWR: Save");
+  ui.end();
 }
 
+enum { BRIGHTNESS_VALUE, BRIGHTNESS_BARS };
+constexpr LayoutOp BRIGHTNESS_OPS[] = {
+  LTEXT(5, 2, 2, YELLOW, "BRIGHTNESS"),
+  LTEXT(5, 28, 1, WHITE, "Screen brightness:"),
+  LFIELD(40, 48, 4, GREEN, BRIGHTNESS_VALUE, 4),
+  LFIELD(5, 80, 1, CYAN, BRIGHTNESS_BARS, 11),
+  LTEXT(5, 95, 1, CYAN, "A: +  B: -  (0-100%)"),
+  LTEXT(5, 108, 1, CYAN, "PWR: Save")
+};
+constexpr Layout BRIGHTNESS_LAYOUT = makeLayout(BRIGHTNESS_OPS);
+
 // Draw brightness editing screen
 void drawBrightnessUI() {
-  M5.Display.fillScreen(BLACK);
-  M5.Display.setTextSize(2);
-  M5.Display.setTextColor(YELLOW);
-  M5.Display.setCursor(5, 2);
-  M5.Display.println("BRIGHTNESS");
-  
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(WHITE);
-  M5.Display.setCursor(5, 28);
-  M5.Display.println("Screen brightness:");
-  
-  // Show current value in large green
+  static const char BARS[] = "|||||||||||";
+  ui.begin(BRIGHTNESS_LAYOUT);
+  ui.setf(BRIGHTNESS_VALUE, "%d%%", brightnessLevel * 10);
+  ui.set(BRIGHTNESS_BARS, BARS + sizeof(BARS) - 1 - (brightnessLevel + 1));
+  ui.end();
+}
+
+constexpr LayoutOp CLOCK_COLOR_OPS[] = {
+  LTEXT(5, 2, 2, YELLOW, "CLOCK COLOR"),
+  LTEXT(5, 28, 1, WHITE, "Clock display color:"),
+  LFIELD(20, 52, 3, WHITE, 0, 7),  // Color name in that color
+  LTEXT(5, 95, 1, WHITE, "A/B: Change  PWR: Save")
+};
+constexpr Layout CLOCK_COLOR_LAYOUT = makeLayout(CLOCK_COLOR_OPS);
+
+// Draw clock color editing screen
+void drawClockColorUI() {
+  ui.begin(CLOCK_COLOR_LAYOUT);
+  ui.set(0, COLOR_NAMES[clockColorIndex]);
+  ui.setColor(0, CLOCK_COLORS[clockColorIndex], BLACK);
+  ui.end();
+}
+
+enum { QH_START, QH_END };
+constexpr LayoutOp QUIET_HOURS_OPS[] = {
+  LTEXT(5, 2, 2, YELLOW, "QUIET HOURS"),
+  LTEXT(5, 28, 1, WHITE, "No alarms between:"),
+  LFIELD(30, 50, 2, WHITE, QH_START, 5),
+  LTEXT(100, 50, 2, WHITE, "-"),
+  LFIELD(130, 50, 2, WHITE, QH_END, 5),
+  LTEXT(5, 80, 1, WHITE, "A/B: +/-"),
+  LTEXT(5, 95, 1, WHITE, "PWR: Switch/Save")
+};
+constexpr Layout QUIET_HOURS_LAYOUT = makeLayout(QUIET_HOURS_OPS);
+
+// Draw quiet hours editing screen
+void drawQuietHoursUI() {
+  ui.begin(QUIET_HOURS_LAYOUT);
+  ui.setf(QH_START, "%02d:00", quietHoursStart);
+  ui.setf(QH_END, "%02d:00", quietHoursEnd);
+  // Highlight the hour being edited
+  ui.setColor(editingQHStart ? QH_START : QH_END, BLACK, YELLOW);  // Inverted
+  ui.end();
+}
+
+constexpr LayoutOp TIME_FORMAT_OPS[] = {
+  LTEXT(5, 2, 2, YELLOW, "TIME FORMAT"),
+  LTEXT(5, 28, 1, WHITE, "Clock display format:"),
+  LFIELD(40, 52, 3, CYAN, 0, 7),
+  LTEXT(5, 95, 1, WHITE, "A/B: Toggle  PWR: Save")
+};
+constexpr Layout TIME_FORMAT_LAYOUT = makeLayout(TIME_FORMAT_OPS);
+
+// Draw time format editing screen
+void drawTimeFormatUI() {
+  ui.begin(TIME_FORMAT_LAYOUT);
+  ui.set(0, use24HourFormat ? "24 Hour" : "12 Hour");
+  ui.end();
+}
+
+constexpr LayoutOp SMART_WAKE_OPS[] = {
+  LTEXT(5, 2, 2, YELLOW, "SMART WAKE"),
+  LTEXT(5, 28, 1, WHITE, "Night mode: alarm early in"),
+  LTEXT(5, 40, 1, WHITE, "light sleep, up to:"),
+  LFIELD(60, 58, 3, GREEN, 0, 6),
+  LTEXT(5, 95, 1, WHITE, "A/B: Change  PWR: Save")
+};
+constexpr Layout SMART_WAKE_LAYOUT = makeLayout(SMART_WAKE_OPS);
+
+// Draw smart wake window setting screen
+void drawSmartWakeUI() {
+  ui.begin(SMART_WAKE_LAYOUT);
+  if (smartWakeMinutes == 0) {
+    ui.set(0, "Off");
+  } else {
+    ui.setf(0, "%d min", smartWakeMinutes);
+  }
+  ui.end();
+}
+
+constexpr LayoutOp ALWAYS_ON_OPS[] = {
+  LTEXT(5, 2, 2, YELLOW, "ALWAYS-ON"),
+  LTEXT(5, 28, 1, WHITE, "At timeout, keep a dim clock:"),
+  LFIELD(80, 52, 3, GREEN, 0, 3),
+  LTEXT(5, 95, 1, WHITE, "A/B: Toggle  PWR: Save")
+};
+constexpr Layout ALWAYS_ON_LAYOUT = makeLayout(ALWAYS_ON_OPS);
+
+// Draw always-on face setting screen
+void drawAlwaysOnUI() {
+  ui.begin(ALWAYS_ON_LAYOUT);
+  ui.set(0, alwaysOnFace ? "ON" : "OFF");
+  ui.end();
+}
+
+// HH:MM inside the band the panel still scans in partial mode. Idle mode
+// shows 8 colours, so the clock colour is reduced to its top bits.
+void drawAlwaysOnFace(int hh, int mm) {
+  if (!use24HourFormat) {
+    hh %= 12;
+    if (hh == 0) hh = 12;
+  }
+  char buf[8];
+  snprintf(buf, sizeof(buf), "%02d:%02d", hh, mm);
+  M5.Display.fillRect(AOD_X, 0, AOD_WIDTH, 135, BLACK);
   M5.Display.setTextSize(4);
-  M5.Display.setTextColor(GREEN);
-  M5.Display.setCursor(40, 48);
-  M5.Display.printf("%d%%", brightnessLevel * 10);
-  
-  // Show visual indicator (bars)
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(CYAN);
-  M5.Display.setCursor(5, 80);
-  for (int i = 0; i <= brightnessLevel; i++) {
-    M5.Display.print("|");
+  M5.Display.setTextColor(CLOCK_COLORS[clockColorIndex], BLACK);
+  M5.Display.setCursor(AOD_X, 52);
+  M5.Display.print(buf);
+}
+
+enum { MOTION_STATE, MOTION_RATE };
+constexpr LayoutOp MOTION_RC_OPS[] = {
+  LTEXT(5, 2, 2, YELLOW, "MOTION RC"),
+  LTEXT(5, 28, 1, WHITE, "Check on stand/walk/spin:"),
+  LFIELD(60, 50, 3, GREEN, MOTION_STATE, 3),
+  LFIELD(5, 85, 1, CYAN, MOTION_RATE, 23),
+  LTEXT(5, 105, 1, WHITE, "A/B: Toggle  PWR: Save")
+};
+constexpr Layout MOTION_RC_LAYOUT = makeLayout(MOTION_RC_OPS);
+
+// Draw motion-triggered reality check screen
+void drawMotionRCUI() {
+  ui.begin(MOTION_RC_LAYOUT);
+  if (motionRCEnabled) {
+    ui.set(MOTION_STATE, "ON");
+  } else {
+    ui.set(MOTION_STATE, "OFF");
+    ui.setColor(MOTION_STATE, RED, BLACK);
   }
-  
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(CYAN);
-  M5.Display.setCursor(5, 95);
-  M5.Display.println("A: +  B: -  (0-100%)");
-  M5.Display.setCursor(5, 108);
-  M5.Display.println("PWR: Save");
+  ui.setf(MOTION_RATE, "Max %d, +1 per %lu min", MOTION_RC_BURST, MOTION_RC_REFILL_MS / 60000);
+  ui.end();
+}
+
+constexpr LayoutOp NIGHT_SLEEP_OPS[] = {
+  LTEXT(5, 2, 2, YELLOW, "NIGHT SLEEP"),
+  LTEXT(5, 28, 1, WHITE, "Deep sleep between REM cues:"),
+  LFIELD(60, 45, 3, GREEN, 0, 3),
+  LTEXT(5, 80, 1, CYAN, "Saves battery, but movement"),
+  LTEXT(5, 92, 1, CYAN, "isn't logged while asleep"),
+  LTEXT(5, 112, 1, WHITE, "A/B: Toggle  PWR: Save")
+};
+constexpr Layout NIGHT_SLEEP_LAYOUT = makeLayout(NIGHT_SLEEP_OPS);
+
+// Draw night deep sleep setting screen
+void drawNightSleepUI() {
+  ui.begin(NIGHT_SLEEP_LAYOUT);
+  if (nightDeepSleep) {
+    ui.set(0, "ON");
+  } else {
+    ui.set(0, "OFF");
+    ui.setColor(0, RED, BLACK);
+  }
+  ui.end();
+}
+
+constexpr LayoutOp NIGHT_SOUND_OPS[] = {
+  LTEXT(5, 2, 2, YELLOW, "NIGHT SOUND"),
+  LTEXT(5, 28, 1, WHITE, "Listen for snoring and noise:"),
+  LFIELD(60, 45, 3, GREEN, 0, 3),
+  LTEXT(5, 80, 1, CYAN, "Sharpens the sleep report and"),
+  LTEXT(5, 92, 1, CYAN, "holds REM cues while it's loud"),
+  LTEXT(5, 112, 1, WHITE, "A/B: Toggle  PWR: Save")
+};
+constexpr Layout NIGHT_SOUND_LAYOUT = makeLayout(NIGHT_SOUND_OPS);
+
+// Draw night sound setting screen
+void drawNightSoundUI() {
+  ui.begin(NIGHT_SOUND_LAYOUT);
+  if (nightSoundEnabled) {
+    ui.set(0, "ON");
+  } else {
+    ui.set(0, "OFF");
+    ui.setColor(0, RED, BLACK);
+  }
+  ui.end();
 }
 
-// Draw clock color editing screen
-void drawClockColorUI() {
-  M5.Display.fillScreen(BLACK);
-  M5.Display.setTextSize(2);
-  M5.Display.setTextColor(YELLOW);
-  M5.Display.setCursor(5, 2);
-  M5.Display.println("CLOCK COLOR");
-  
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(WHITE);
-  M5.Display.setCursor(5, 28);
-  M5.Display.println("Clock display color:");
-  
-  // Show current color name in that color
-  M5.Display.setTextSize(3);
-  M5.Display.setTextColor(CLOCK_COLORS[clockColorIndex]);
-  M5.Display.setCursor(20, 52);
-  M5.Display.println(COLOR_NAMES[clockColorIndex]);
-  
-  // Instructions
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(WHITE);
-  M5.Display.setCursor(5, 95);
-  M5.Display.println("A/B: Change  PWR: Save");
+enum { CO_RC, CO_REM, CO_ALARM };
+constexpr LayoutOp CUE_OUTPUT_OPS[] = {
+  LTEXT(5, 2, 2, YELLOW, "CUE OUTPUT"),
+  LTEXT(5, 30, 2, WHITE, "Reality"),
+  LFIELD(130, 30, 2, WHITE, CO_RC, 5),
+  LTEXT(5, 52, 2, WHITE, "REM cue"),
+  LFIELD(130, 52, 2, WHITE, CO_REM, 5),
+  LTEXT(5, 74, 2, WHITE, "Morning"),
+  LFIELD(130, 74, 2, WHITE, CO_ALARM, 5),
+  LTEXT(5, 100, 1, CYAN, "Light uses the red LED, silently"),
+  LTEXT(5, 118, 1, WHITE, "A: Change  B: Next  PWR: Save")
+};
+constexpr Layout CUE_OUTPUT_LAYOUT = makeLayout(CUE_OUTPUT_OPS);
+
+// Draw cue output setting screen
+void drawCueOutputUI() {
+  ui.begin(CUE_OUTPUT_LAYOUT);
+  for (int i = 0; i < CUE_EVENT_COUNT; i++) ui.set(CO_RC + i, cueOutputName(cueOutput[i]));
+  ui.setColor(CO_RC + cueOutputRow, BLACK, YELLOW);  // Inverted
+  ui.end();
 }
 
-void drawQuietHoursUI() {
+// Draw manual alarm editing screen
+void drawManualAlarmUI() {
   M5.Display.fillScreen(BLACK);
-  M5.Display.setTextSize(2);
-  M5.Display.setTextColor(YELLOW);
-  M5.Display.setCursor(5, 2);
-  M5.Display.println("QUIET HOURS");
-  
   M5.Display.setTextSize(1);
-  M5.Display.setTextColor(WHITE);
-  M5.Display.setCursor(5, 28);
-  M5.Display.println("No alarms between:");
+  M5.Display.setTextColor(YELLOW);
+  M5.Display.setCursor(5, 5);
+  M5.Display.println("MORNING");
+  M5.Display.setCursor(5, 20);
+  M5.Display.println("ALARM");
   
-  // Show start hour (highlight if editing)
+  // Show ON/OFF status
   M5.Display.setTextSize(2);
-  if (editingQHStart) {
-    M5.Display.setTextColor(BLACK, YELLOW);  // Inverted
+  M5.Display.setCursor(10, 40);
+  if (manualAlarmEnabled) {
+    M5.Display.setTextColor(GREEN);
+    M5.Display.println("ENABLED");
+  } else {
+    M5.Display.setTextColor(RED);
+    M5.Display.println("DISABLED");
+  }
+  
+  // Draw large time with highlighting
+  M5.Display.setTextSize(3);
+  M5.Display.setCursor(15, 50);
+  
+  // Hour (green if editing)
+  if (editingMAHour) {
+    M5.Display.setTextColor(GREEN);
   } else {
     M5.Display.setTextColor(WHITE);
   }
-  M5.Display.setCursor(30, 50);
-  M5.Display.printf("%02d:00", quietHoursStart);
+  M5.Display.printf("%02d", manualAlarmHour);
   
   M5.Display.setTextColor(WHITE);
-  M5.Display.setCursor(100, 50);
-  M5.Display.print("-");
+  M5.Display.print(":");
   
-  // Show end hour (highlight if editing)
-  if (!editingQHStart) {
-    M5.Display.setTextColor(BLACK, YELLOW);  // Inverted
+  // Minute (green if editing)
+  if (!editingMAHour) {
+    M5.Display.setTextColor(GREEN);
   } else {
     M5.Display.setTextColor(WHITE);
   }
-  M5.Display.setCursor(130, 50);
-  M5.Display.printf("%02d:00", quietHoursEnd);
+  M5.Display.printf("%02d", manualAlarmMinute);
   
   // Instructions
   M5.Display.setTextSize(1);
-  M5.Display.setTextColor(WHITE);
-  M5.Display.setCursor(5, 80);
-  M5.Display.println("A/B: +/-");
+  M5.Display.setTextColor(CYAN);
   M5.Display.setCursor(5, 95);
-  M5.Display.println("PWR: Switch/Save");
+  M5.Display.println("A:+  B:Switch/Toggle");
+  M5.Display.setCursor(5, 110);
+  M5.Display.println("PWR:Save");
 }
 
-void drawTimeFormatUI() {
-  M5.Display.fillScreen(BLACK);
-  M5.Display.setTextSize(2);
-  M5.Display.setTextColor(YELLOW);
-  M5.Display.setCursor(5, 2);
-  M5.Display.println("TIME FORMAT");
+// Check IMU for activity (shake detection to wake screen)
+void checkIMUActivity() {
+  // Skip IMU checks if "Button Only" mode selected (level 6), except at
+  // night: the night log, smart wake and cue responses all need it
+  bool imuWanted = !(sensitivityLevel == SENSITIVITY_BUTTON_ONLY && !motionRCEnabled) ||
+                   nightModeActive || remCue.isListening();
+  Tasks::setImuEnabled(imuWanted);
+  
+  // Process every sample the sensor task read (every 100ms) since last loop
+  ImuSample sample;
+  while (Tasks::popImu(sample)) {
+    if (!imuWanted) continue;  // IMU disabled - button-only wake
+    processImuSample(sample.data, sample.ms);
+  }
+}
+
+// Every consumer of the 10 Hz stream, for one sample from the sensor task
+void processImuSample(const m5::imu_data_t& data, unsigned long ms) {
+  if (sensitivityLevel == SENSITIVITY_WRIST_RAISE) {
+    processWristRaiseSample(data, ms);
+  } else if (sensitivityLevel != SENSITIVITY_BUTTON_ONLY) {
+    processAccelSample(data.accel.x, data.accel.y, data.accel.z, ms);
+  }
+  if (motionRCEnabled) {
+    processMotionSample(data);
+  }
+  processNightSample(data.accel.x, data.accel.y, data.accel.z);
+}
+
+// The accel-only consumers - night log, smart wake, cue response - which
+// are all the night monitor's FIFO feeds. The gesture detectors need the
+// gyro and only wake the screen, so they wait for the sensor task.
+void processNightSample(float ax, float ay, float az) {
+  if (smartWakeActive && smartWake.update(ax, ay, az)) {
+    smartWakeLight = true;  // Acted on in loop() where the alarm state is known
+  }
+  if (nightModeActive && nightLog.update(ax, ay, az)) {
+    saveNightSession();
+  }
+  if (remCue.isListening() && remCue.update(ax, ay, az)) {
+    logPrintf("REM cue response: %s - level %d, spacing +%d min\n",
+              CueAdapt::responseName(remCue.lastResponse()), remCue.getLevel(), remCue.getExtraMin());
+    TRACE_COUNTER("rem_cue_level", remCue.getLevel());
+    if (remCue.getLevel() != remCueLevel) {
+      remCueLevel = remCue.getLevel();
+      saveREMCueLevel();
+    }
+    // The next cue was queued before the response was known
+    if (scheduler.isScheduled(EVENT_REM_CUE)) {
+      scheduleNextREMCue(TimeBase::epochSec());
+    }
+    if (nightModeActive) saveNightSession();
+  }
+}
+
+// Batch one IMU sample and classify the window every MOTION_RC_HOP samples
+void processMotionSample(const m5::imu_data_t& data) {
+  motionImu.update(data);
+  if (++motionSamplesSinceClassify < MOTION_RC_HOP) {
+    return;
+  }
+  motionSamplesSinceClassify = 0;
+
+  ImuFeatures features;
+  motionImu.getFeatures(features);
+  MotionContext context = motionTrigger.classify(features);
+  if (context != MOTION_NONE) {
+    pendingMotion = context;  // Acted on in loop() where time and mode are known
+  }
+}
+
+// Wrist-raise wake for one IMU sample (gesture instead of shake)
+void processWristRaiseSample(const m5::imu_data_t& data, unsigned long now) {
+  bool raised = wristRaise.update(data.accel.x, data.accel.y, data.accel.z,
+                                  data.gyro.x, data.gyro.y, data.gyro.z, now);
+  if (raised && !screenOn) {
+    Serial.println("IMU: Wrist raise detected - waking screen");
+    wakeScreen();
+  }
+
+  // Keep the screen on while the watch face is held in view
+  if (raised || (screenOn && wristRaise.isInView())) {
+    lastActivityTime = now;
+  }
+}
+
+// Log the current sensitivity level
+void printSensitivity(const char* prefix) {
+  if (sensitivityLevel == SENSITIVITY_BUTTON_ONLY) {
+    logPrintf("%s: Button Only (shake-to-wake DISABLED)\n", prefix);
+  } else if (sensitivityLevel == SENSITIVITY_WRIST_RAISE) {
+    Serial.printf("%s: Wrist Raise (tilt-to-view wake)\n", prefix);
+  } else {
+    Serial.printf("%s: %s (%.2f)\n", prefix, SENSITIVITY_NAMES[sensitivityLevel], SENSITIVITY_VALUES[sensitivityLevel]);
+  }
+}
+
+// Wake-on-shake detection for one accelerometer sample
+void processAccelSample(float ax, float ay, float az, unsigned long now) {
+  // Use current sensitivity setting
+  if (shake.update(ax, ay, az, SENSITIVITY_VALUES[sensitivityLevel])) {
+    // Movement detected - wake screen
+    if (!screenOn) {
+      logPrintf("IMU: Movement detected (sensitivity: %s) - waking screen\n", SENSITIVITY_NAMES[sensitivityLevel]);
+      wakeScreen();
+    }
+    lastActivityTime = now;  // Reset timeout
+  }
+}
+
+// Update screen timeout (turn off screen after inactivity)
+void updateScreenTimeout() {
+  unsigned long now = millis();
   
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(WHITE);
-  M5.Display.setCursor(5, 28);
-  M5.Display.println("Clock display format:");
+  // Don't timeout during alarms, menus or editors that keep the screen awake
+  if (screens.top()->keepAwake) {
+    lastActivityTime = now;
+    if (!screenOn) {
+      wakeScreen();
+    }
+    return;
+  }
   
-  // Show current format
-  M5.Display.setTextSize(3);
-  M5.Display.setTextColor(CYAN);
-  M5.Display.setCursor(40, 52);
-  if (use24HourFormat) {
-    M5.Display.println("24 Hour");
-  } else {
-    M5.Display.println("12 Hour");
+  // The always-on face belongs to the clock; anything pushed over it
+  // (dream journal alarm) gets the full panel back
+  if (AlwaysOn::isActive() && !screens.isTop(&clockScreen)) {
+    wakeScreen();
+  }
+
+  // Skip timeout if Always On mode (0 = never timeout)
+  if (screenTimeoutSeconds == 0) {
+    return;
   }
   
-  // Instructions
-  M5.Display.setTextSize(1);
-  M5.Display.setTextColor(WHITE);
-  M5.Display.setCursor(5, 95);
-  M5.Display.println("A/B: Toggle  PWR: Save");
+  // Check timeout
+  if (screenOn && (now - lastActivityTime > (screenTimeoutSeconds * 1000))) {
+    Serial.println("Screen timeout - sleeping");
+    sleepScreen();
+  }
+}
+
+// Full brightness, leaving the always-on face or panel sleep
+void wakeScreen() {
+  screenOn = true;
+  if (AlwaysOn::isActive()) {
+    AlwaysOn::exit(BRIGHTNESS_VALUES[brightnessLevel]);
+  } else {
+    M5.Display.wakeup();
+    M5.Display.setBrightness(BRIGHTNESS_VALUES[brightnessLevel]);
+  }
+  screens.invalidate();
+  TRACE_INSTANT("screen_wake");
+}
+
+// Always-on face on the clock when enabled, otherwise panel off
+void sleepScreen() {
+  screenOn = false;
+  if (alwaysOnFace && screens.isTop(&clockScreen)) {
+    AlwaysOn::enter(BRIGHTNESS_VALUES[0]);
+    screens.invalidate();
+  } else {
+    M5.Display.sleep();
+    M5.Display.setBrightness(0);
+  }
+  TRACE_INSTANT("screen_sleep");
 }
 
 // Load settings from NVS
@@ -1649,17 +2369,30 @@ void loadSettings() {
   // Load all settings with defaults
   screenTimeoutSeconds = preferences.getInt("timeout", 15);
   sensitivityLevel = preferences.getInt("sensitivity", 2);
+  if (sensitivityLevel < 0 || sensitivityLevel > SENSITIVITY_WRIST_RAISE) sensitivityLevel = 2;
   brightnessLevel = preferences.getInt("brightness", 8);
   clockColorIndex = preferences.getInt("clockColor", 0);
   alarmsPerDay = preferences.getInt("alarmsDay", 12);
   use24HourFormat = preferences.getBool("use24h", true);
+  alwaysOnFace = preferences.getBool("aod", false);
   quietHoursStart = preferences.getInt("quietStart", 23);
   quietHoursEnd = preferences.getInt("quietEnd", 7);
   manualAlarmEnabled = preferences.getBool("manualOn", false);
   manualAlarmHour = preferences.getInt("manualHour", 7);
   manualAlarmMinute = preferences.getInt("manualMin", 0);
-  
-  preferences.end();
+  smartWakeMinutes = preferences.getInt("smartWake", 0);
+  motionRCEnabled = preferences.getBool("motionRC", false);
+  nightDeepSleep = preferences.getBool("nightSleep", false);
+  nightSoundEnabled = preferences.getBool("nightSound", false);
+  remCueLevel = preferences.getInt("remCueLevel", CUE_REM_DEFAULT_LEVEL);
+  cueOutput[CUE_EVENT_REALITY_CHECK] = preferences.getUChar("cueOutRC", CUE_OUT_SOUND);
+  cueOutput[CUE_EVENT_REM] = preferences.getUChar("cueOutREM", CUE_OUT_SOUND);
+  cueOutput[CUE_EVENT_ALARM] = preferences.getUChar("cueOutAlarm", CUE_OUT_SOUND);
+  for (int i = 0; i < CUE_EVENT_COUNT; i++) {
+    if (cueOutput[i] < CUE_OUT_SOUND || cueOutput[i] > CUE_OUT_BOTH) cueOutput[i] = CUE_OUT_SOUND;
+  }
+  int64_t nextAlarm = preferences.getLong64("nextAlarm", 0);
+  if (nextAlarm) scheduler.schedule(EVENT_REALITY_CHECK, nextAlarm);
   
   Serial.println("=== SETTINGS LOADED FROM NVS ===");
   Serial.printf("Screen Timeout: %d sec\n", screenTimeoutSeconds);
@@ -1668,83 +2401,266 @@ void loadSettings() {
   Serial.printf("Clock Color: %s\n", COLOR_NAMES[clockColorIndex]);
   Serial.printf("Alarms/Day: %d\n", alarmsPerDay);
   Serial.printf("Time Format: %s\n", use24HourFormat ? "24h" : "12h");
+  Serial.printf("Always-On Face: %s\n", alwaysOnFace ? "ON" : "OFF");
   Serial.printf("Quiet Hours: %02d:00 - %02d:00\n", quietHoursStart, quietHoursEnd);
   Serial.printf("Manual Alarm: %s at %02d:%02d\n", manualAlarmEnabled ? "ON" : "OFF", manualAlarmHour, manualAlarmMinute);
+  Serial.printf("Smart Wake: %d min\n", smartWakeMinutes);
+  Serial.printf("Motion RC: %s\n", motionRCEnabled ? "ON" : "OFF");
+  Serial.printf("Night Sleep: %s\n", nightDeepSleep ? "ON" : "OFF");
+  Serial.printf("Night Sound: %s\n", nightSoundEnabled ? "ON" : "OFF");
+  Serial.printf("REM Cue Level: %d\n", remCueLevel);
+  Serial.printf("Cue Output: RC %s, REM %s, Morning %s\n", cueOutputName(cueOutput[CUE_EVENT_REALITY_CHECK]),
+                cueOutputName(cueOutput[CUE_EVENT_REM]), cueOutputName(cueOutput[CUE_EVENT_ALARM]));
 }
 
 // Save settings to NVS
 void saveSettings() {
-  preferences.begin("lucidwatch", false);
-  
-  preferences.putInt("timeout", screenTimeoutSeconds);
-  preferences.putInt("sensitivity", sensitivityLevel);
-  preferences.putInt("brightness", brightnessLevel);
-  preferences.putInt("clockColor", clockColorIndex);
-  preferences.putInt("alarmsDay", alarmsPerDay);
-  preferences.putBool("use24h", use24HourFormat);
-  preferences.putInt("quietStart", quietHoursStart);
-  preferences.putInt("quietEnd", quietHoursEnd);
-  preferences.putBool("manualOn", manualAlarmEnabled);
-  preferences.putInt("manualHour", manualAlarmHour);
-  preferences.putInt("manualMin", manualAlarmMinute);
-  
-  preferences.end();
+  writeSettings(preferences);
   
   Serial.println("Settings saved to NVS");
 }
 
-// Gentle REM Beep - soft tones to trigger lucidity without waking
-void gentleREMBeep() {
-  Serial.println("REM Cue - Gentle beep");
-  
-  // 3 soft ascending tones
-  for (int i = 0; i < 3; i++) {
-    ledcWriteTone(BUZZER_CHANNEL, 800 + (i * 100));  // 800Hz, 900Hz, 1000Hz
-    ledcWrite(BUZZER_CHANNEL, 64);  // Very soft volume (25%)
-    delay(200);
-    ledcWrite(BUZZER_CHANNEL, 0);  // Off
-    delay(250);
+// Every setting key; the caller opens the namespace
+void writeSettings(Preferences& prefs) {
+  prefs.putInt("timeout", screenTimeoutSeconds);
+  prefs.putInt("sensitivity", sensitivityLevel);
+  prefs.putInt("brightness", brightnessLevel);
+  prefs.putInt("clockColor", clockColorIndex);
+  prefs.putInt("alarmsDay", alarmsPerDay);
+  prefs.putBool("use24h", use24HourFormat);
+  prefs.putBool("aod", alwaysOnFace);
+  prefs.putInt("quietStart", quietHoursStart);
+  prefs.putInt("quietEnd", quietHoursEnd);
+  prefs.putBool("manualOn", manualAlarmEnabled);
+  prefs.putInt("manualHour", manualAlarmHour);
+  prefs.putInt("manualMin", manualAlarmMinute);
+  prefs.putInt("smartWake", smartWakeMinutes);
+  prefs.putBool("motionRC", motionRCEnabled);
+  prefs.putBool("nightSleep", nightDeepSleep);
+  prefs.putBool("nightSound", nightSoundEnabled);
+  prefs.putUChar("cueOutRC", cueOutput[CUE_EVENT_REALITY_CHECK]);
+  prefs.putUChar("cueOutREM", cueOutput[CUE_EVENT_REM]);
+  prefs.putUChar("cueOutAlarm", cueOutput[CUE_EVENT_ALARM]);
+}
+
+// Only the alarm key, so a reschedule doesn't rewrite every setting
+void saveNextAlarm() {
+  preferences.putLong64("nextAlarm", scheduler.dueOf(EVENT_REALITY_CHECK));
+}
+
+// Only the learned cue level, written when a response changes it
+void saveREMCueLevel() {
+  preferences.putInt("remCueLevel", remCueLevel);
+}
+
+// Seal the night session so a reset or deep sleep resumes from here
+void saveNightSession() {
+  nightSession.nextCueSec = scheduler.dueOf(EVENT_REM_CUE);
+  nightSession.cueLevel = remCue.getLevel();
+  nightSession.cueExtraMin = remCue.getExtraMin();
+  nightSessionSeal(nightSession, nightLog.checksum());
+}
+
+// Night mode with the screen off and nothing to listen for: deep sleep
+// until just before the next timed event. Button A wakes early; either way
+// setup() finds the session and goes back to the night screen.
+void nightDeepSleepIfIdle(int64_t nowSec) {
+  if (!nightModeActive || screenOn || alarmActive || !screens.isTop(&nightScreen)) return;
+  if (smartWakeActive || remCue.isListening() || Tasks::isCueActive() || Tasks::isLightActive()) return;
+
+  int64_t wakeSec = nowSec + NIGHT_SLEEP_MAX_SEC;
+  int64_t dueSec;
+  if (scheduler.nextDeadline(dueSec) && dueSec - NIGHT_SLEEP_LEAD_SEC < wakeSec) {
+    wakeSec = dueSec - NIGHT_SLEEP_LEAD_SEC;
   }
+  if (wakeSec - nowSec < NIGHT_SLEEP_MIN_SEC) return;
+
+  nightSession.sleeps++;
+  saveNightSession();
+  logPrintf("Night deep sleep: %ld s\n", (long)(wakeSec - nowSec));
+  Serial.flush();
+
+  gpio_hold_en((gpio_num_t)POWER_HOLD_PIN);
+  gpio_deep_sleep_hold_en();
+  esp_sleep_enable_ext0_wakeup((gpio_num_t)WAKE_BUTTON_PIN, 0);
+  esp_sleep_enable_timer_wakeup((uint64_t)(wakeSec - nowSec) * 1000000ULL);
+  esp_deep_sleep_start();
 }
 
-// Check Night Mode and trigger REM cues
-void checkNightMode() {
-  if (!nightModeActive) return;
-  
-  unsigned long now = millis();
-  unsigned long elapsed = now - sleepStartTime;
-  
-  // Start REM cues after 4.5 hours (270 minutes)
-  const unsigned long FIRST_REM_WINDOW = 270UL * 60 * 1000;  // 4h 30min
-  
-  if (elapsed < FIRST_REM_WINDOW) {
-    return;  // Too early, still in deep sleep
+// Night mode, screen off, nothing to listen for: light-sleep while the IMU
+// fills its FIFO, then feed the batch through processNightSample() (accel
+// only, so no wrist-raise, shake or motion checks). Returns to the loop for the next timed event,
+// significant movement, a button, or after NIGHT_MONITOR_SPAN_SEC so the
+// sensor task can resync the clock (light sleep runs the timer off the
+// less accurate RTC slow clock).
+// Light sleep from nowUs (esp_timer) until just before the next timed event
+uint32_t nightMonitorSleepMs(int64_t nowUs) {
+  int64_t dueSec = 0;
+  bool haveDeadline = scheduler.nextDeadline(dueSec);
+  int64_t dueUs = nowUs + (dueSec - TimeBase::epochSec()) * 1000000LL;
+  return NightMonitor::sleepMs(nowUs, haveDeadline, dueUs);
+}
+
+void runNightMonitor() {
+  if (!nightModeActive || screenOn || alarmActive || !screens.isTop(&nightScreen)) return;
+  if (smartWakeActive || remCue.isListening() || Tasks::isCueActive() || Tasks::isLightActive()) return;
+  if ((long)(millis() - nightMonitorAwakeUntil) < 0) return;
+
+  int64_t startUs = esp_timer_get_time();
+  if (nightMonitorSleepMs(startUs) == 0) return;
+
+  // Take what the sensor task queued so the FIFO batches follow on
+  checkIMUActivity();
+  if (!Tasks::parkSensor(SENSOR_PERIOD_MS * 2)) {
+    nightMonitorAwakeUntil = millis() + NIGHT_MONITOR_RESYNC_HOLD_MS;  // Mid resync
+    return;
   }
-  
-  // Window 1: 4.5h - 5.75h (8 min intervals)
-  // Window 2: 6h - 7.25h (7 min intervals)
-  
-  unsigned long cueInterval;
-  if (elapsed < 345UL * 60 * 1000) {  // Before 5h 45min
-    cueInterval = 8UL * 60 * 1000;  // 8 minutes
-  } else {
-    cueInterval = 7UL * 60 * 1000;  // 7 minutes
+  if (!ImuFifo::begin()) {
+    Tasks::unparkSensor();
+    nightMonitorAwakeUntil = millis() + NIGHT_MONITOR_MOVE_HOLD_MS;
+    Serial.println("Night monitor: IMU FIFO unavailable");
+    return;
   }
-  
-  // Trigger cue if interval has passed
-  if (now - lastREMCue >= cueInterval) {
-    gentleREMBeep();
-    lastREMCue = now;
+  TRACE_BEGIN("night_monitor");
+  Serial.flush();
+
+  gpio_wakeup_enable((gpio_num_t)WAKE_BUTTON_PIN, GPIO_INTR_LOW_LEVEL);
+  gpio_wakeup_enable((gpio_num_t)PWR_BUTTON_PIN, GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+
+  unsigned long holdMs = NIGHT_MONITOR_RESYNC_HOLD_MS;
+  int batches = 0;
+  nightMonitor.beginBatch();
+  for (;;) {
+    int64_t nowUs = esp_timer_get_time();
+    if (nowUs - startUs >= NIGHT_MONITOR_SPAN_SEC * 1000000LL) break;
+    uint32_t sleepMs = nightMonitorSleepMs(nowUs);
+    if (sleepMs == 0) break;
+
+    esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+    esp_light_sleep_start();
+    bool button = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO;
+
+    // Oldest first
+    int n = ImuFifo::read(monitorX, monitorY, monitorZ, IMU_FIFO_MAX_SAMPLES);
+    nightMonitor.beginBatch();
+    for (int i = 0; i < n; i++) {
+      processNightSample(monitorX[i], monitorY[i], monitorZ[i]);
+      nightMonitor.addSample(monitorX[i], monitorY[i], monitorZ[i]);
+    }
+    batches++;
+    if (nightSoundActive) nightSoundPoll(true);
+
+    if (button) {
+      holdMs = NIGHT_MONITOR_BUTTON_HOLD_MS;
+      if (digitalRead(WAKE_BUTTON_PIN) == LOW) wakeScreen();
+      break;
+    }
+    if (nightMonitor.movementWake()) {
+      holdMs = NIGHT_MONITOR_MOVE_HOLD_MS;
+      break;
+    }
+    if (screenOn || alarmActive || remCue.isListening()) break;
+  }
+
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+  gpio_wakeup_disable((gpio_num_t)WAKE_BUTTON_PIN);
+  gpio_wakeup_disable((gpio_num_t)PWR_BUTTON_PIN);
+  ImuFifo::end();
+  Tasks::unparkSensor();
+  nightMonitorAwakeUntil = millis() + holdMs;
+  TRACE_END("night_monitor");
+  logPrintf("Night monitor: %d batches over %ld s, last %u/%u moving\n", batches,
+            (long)((esp_timer_get_time() - startUs) / 1000000), nightMonitor.getBatchMoves(),
+            nightMonitor.getBatchSamples());
+}
+
+// Mic on for the night; windows are queued by nightSoundPoll()
+void nightSoundStart() {
+  micTakeI2s();
+  {
+    MemExemptScope exempt(MEM_EXEMPT_MIC);
+    nightSoundActive = M5.Mic.begin();
   }
+  if (!nightSoundActive) {
+    Serial.println("Night sound: mic unavailable");
+    if (!MemoStore::isRecording()) micRelease();
+  }
+  nightSound.reset();
+  soundWindowQueued = false;
+  lastNoiseSec = 0;
+}
+
+void nightSoundStop() {
+  if (!nightSoundActive) return;
+  if (!micWaitIdle(MIC_DRAIN_TIMEOUT_MS)) Serial.println("Night sound: mic stalled");
+  if (!MemoStore::isRecording()) micRelease();
+  nightSoundActive = false;
+}
+
+// Queue a window once a second and score it when the mic is done. wait:
+// record one now and block until it's scored (night monitor, ~260 ms).
+// Windows overlapping a cue would only hear the buzzer, so none are taken.
+void nightSoundPoll(bool wait) {
+  if (Tasks::isCueActive()) return;
+  if (!soundWindowQueued) {
+    if (!wait && millis() - lastSoundWindow < SOUND_PERIOD_MS) return;
+    if (!M5.Mic.record(soundPcm, SOUND_WINDOW_SAMPLES, SOUND_SAMPLE_RATE)) return;
+    soundWindowQueued = true;
+    lastSoundWindow = millis();
+  }
+  if (wait) {
+    if (!micWaitIdle(MIC_DRAIN_TIMEOUT_MS)) return;  // Stalled: try again next poll
+  } else if (M5.Mic.isRecording()) {
+    return;
+  }
+  soundWindowQueued = false;
+
+  SoundEvent event = nightSound.process(soundPcm, nightSoundFrame);
+  nightLog.addSound(event);
+  TRACE_COUNTER("sound_db", nightSoundFrame.levelDb);
+  if (event != SOUND_QUIET) {
+    if (event == SOUND_NOISE) lastNoiseSec = TimeBase::epochSec();
+    logPrintf("Night sound: %s, %u dB (floor %u)\n", SoundFeatures::eventName(event),
+              nightSoundFrame.levelDb, nightSoundFrame.floorDb);
+  }
+}
+
+// Gentle REM Beep - soft tones to trigger lucidity without waking
+void gentleREMBeep() {
+  Serial.println("REM Cue - Gentle beep");
+  
+  // 3 soft ascending tones, played by the audio task so the UI keeps running
+  playEventCue(CUE_EVENT_ALARM, CUE_REM_WAVE, CUE_LIGHT_ALARM);
+}
+
+// Night-mode REM cue at the learned level; the movement that follows it
+// adjusts the level and spacing (see cue_adapt.h)
+void playREMCue() {
+  const CuePattern& pattern = remCue.startCue();
+  nightLog.markCue();
+  Serial.printf("REM Cue - level %d\n", remCue.getLevel());
+  playEventCue(CUE_EVENT_REM, pattern, CUE_LIGHT_REM_LEVELS[remCue.getLevel()]);
+}
+
+// Next REM cue while night mode lasts
+// Window 1: 4.5h - 5.75h (8 min intervals)
+// Window 2: from 5.75h (7 min intervals)
+// plus any back-off after a cue that woke the sleeper
+void scheduleNextREMCue(int64_t nowSec) {
+  int64_t elapsedMin = (nowSec - nightSession.startSec) / 60;
+  int interval = (elapsedMin < LATE_REM_WINDOW_MIN ? 8 : 7) + remCue.getExtraMin();
+  scheduler.schedule(EVENT_REM_CUE, nowSec + interval * 60);
 }
 
 // Draw Night Mode UI
 void drawNightModeUI() {
   M5.Display.fillScreen(BLACK);
   
-  unsigned long elapsed = millis() - sleepStartTime;
-  unsigned long hours = elapsed / (60UL * 60 * 1000);
-  unsigned long minutes = (elapsed / (60UL * 1000)) % 60;
+  int64_t elapsed = TimeBase::epochSec() - nightSession.startSec;
+  if (elapsed < 0) elapsed = 0;
+  unsigned long hours = (unsigned long)(elapsed / 3600);
+  unsigned long minutes = (unsigned long)(elapsed / 60 % 60);
   
   // Title
   M5.Display.setTextSize(2);
@@ -1773,11 +2689,8 @@ void drawNightModeUI() {
   M5.Display.setTextSize(1);
   M5.Display.setTextColor(GREEN);
   M5.Display.setCursor(15, 105);
-  if (elapsed < 270UL * 60 * 1000) {
-    M5.Display.println("Deep Sleep Phase");
-  } else {
-    M5.Display.println("REM Cue Active");
-  }
+  static const char* STAGE_NAMES[] = {"Deep", "Light", "Awake", "No data"};
+  M5.Display.printf("%s - %u cues", STAGE_NAMES[nightLog.lastSleepStage()], nightLog.getHeader().cues);
   
   // Exit instruction
   M5.Display.setTextSize(1);
@@ -1786,6 +2699,62 @@ void drawNightModeUI() {
   M5.Display.println("PWR: Exit & Wake");
 }
 
+// Draw the sleep report: hypnogram of one stored night plus totals
+void drawSleepReportUI() {
+  M5.Display.fillScreen(BLACK);
+  M5.Display.setTextSize(1);
+  M5.Display.setTextColor(YELLOW);
+  M5.Display.setCursor(5, 4);
+  if (!reportLoaded) {
+    M5.Display.println("SLEEP REPORT");
+    M5.Display.setTextColor(WHITE);
+    M5.Display.setCursor(5, 40);
+    M5.Display.println("No nights recorded yet.");
+    M5.Display.setCursor(5, 55);
+    M5.Display.println("Use Night Mode to record one.");
+    return;
+  }
+
+  int32_t startOfDay = (int32_t)(reportHeader.startSec % 86400);
+  uint32_t minutes = (uint32_t)reportHeader.epochs * reportHeader.epochSec / 60;
+  M5.Display.printf("%s  %02ld:%02ld  %luh %02lum", reportAge == 0 ? "LAST NIGHT" : "EARLIER",
+                    (long)(startOfDay / 3600), (long)(startOfDay / 60 % 60),
+                    (unsigned long)(minutes / 60), (unsigned long)(minutes % 60));
+
+  // One fillRect per run of equal columns
+  static const int BAR_HEIGHT[] = {0, 64, 40, 16, 4};  // By stage + 1: deep, light, awake, unsampled
+  static const int BAR_COLOR[] = {BLACK, BLUE, CYAN, ORANGE, DARKGREY};
+  int run = 0;
+  for (int c = 1; c <= REPORT_COLUMNS; c++) {
+    if (c < REPORT_COLUMNS &&
+        (reportColumns[c] & REPORT_STAGE_MASK) == (reportColumns[run] & REPORT_STAGE_MASK)) continue;
+    int stage = reportColumns[run] & REPORT_STAGE_MASK;
+    if (stage) M5.Display.fillRect(run, REPORT_TOP, c - run, BAR_HEIGHT[stage], BAR_COLOR[stage]);
+    run = c;
+  }
+  for (int c = 0; c < REPORT_COLUMNS; c++) {
+    if (reportColumns[c] & REPORT_CUE_BIT) M5.Display.drawFastVLine(c, REPORT_CUE_Y, 4, YELLOW);
+  }
+
+  int total = reportHeader.epochs - reportStageEpochs[SLEEP_UNKNOWN];
+  if (total == 0) total = 1;
+  M5.Display.setCursor(5, 95);
+  M5.Display.setTextColor(BLUE);
+  M5.Display.printf("Deep %d%%  ", reportStageEpochs[SLEEP_DEEP] * 100 / total);
+  M5.Display.setTextColor(CYAN);
+  M5.Display.printf("Light %d%%  ", reportStageEpochs[SLEEP_LIGHT] * 100 / total);
+  M5.Display.setTextColor(ORANGE);
+  M5.Display.printf("Awake %d%%", reportStageEpochs[SLEEP_WAKE] * 100 / total);
+  M5.Display.setTextColor(WHITE);
+  M5.Display.setCursor(5, 108);
+  M5.Display.printf("Woke %dx   ", reportWakeups);
+  M5.Display.setTextColor(YELLOW);
+  M5.Display.printf("REM cues %u", reportHeader.cues);
+  M5.Display.setTextColor(DARKGREY);
+  M5.Display.setCursor(5, 122);
+  M5.Display.println("A: older  B: newer  PWR: exit");
+}
+
 // Draw Dream Journal UI
 void drawDreamJournalUI() {
   M5.Display.fillScreen(BLACK);
@@ -1808,9 +2777,363 @@ void drawDreamJournalUI() {
   M5.Display.setCursor(5, 100);
   M5.Display.println("last night?");
   
-  // Instruction
+  // Instruction, or the memo being recorded
   M5.Display.setTextSize(1);
   M5.Display.setTextColor(WHITE);
   M5.Display.setCursor(10, 125);
-  M5.Display.println("Press any button");
+  if (MemoStore::isRecording()) {
+    M5.Display.setTextColor(RED);
+    M5.Display.printf("REC %lus / %ds  A:Stop", (unsigned long)(MemoStore::recordedSamples() / MEMO_SAMPLE_RATE),
+                      (int)(memoMaxSamples / MEMO_SAMPLE_RATE));
+  } else if (memoSavedSlot >= 0) {
+    M5.Display.println("Memo saved  B:Done");
+  } else {
+    M5.Display.println("A:Record memo  B:Done");
+  }
+}
+
+// Serial console - one command per line
+void handleSerialCommand() {
+  static char cmd[32];
+  static int cmdLen = 0;
+
+  while (Serial.available() > 0) {
+    char c = (char)Serial.read();
+    if (c != '\n' && c != '\r') {
+      if (cmdLen < (int)sizeof(cmd) - 1) cmd[cmdLen++] = c;
+      continue;
+    }
+    if (cmdLen == 0) continue;
+    cmd[cmdLen] = '\0';
+    cmdLen = 0;
+    MemExemptScope exempt(MEM_EXEMPT_CONSOLE);  // Dumps and benches may allocate
+
+    if (strcmp(cmd, "nights") == 0) {
+      NightStore::dump();
+    } else if (strcmp(cmd, "memos") == 0) {
+      MemoStore::dump();
+    } else if (strncmp(cmd, "cue ", 4) == 0) {
+      const CuePattern* pattern = cueByName(cmd + 4);
+      if (pattern) {
+        if (pattern->voice == CUE_VOICE_LIGHT) {
+          Tasks::playLight(*pattern);
+        } else {
+          Tasks::playCue(*pattern);
+        }
+        Serial.printf("Cue: %s, %lu ms\n", pattern->name, (unsigned long)cueDurationMs(*pattern));
+      } else {
+        Serial.printf("No cue named %s\n", cmd + 4);
+      }
+    } else
+#ifdef LUCID_PROFILE
+    if (strcmp(cmd, "prof") == 0) {
+      Profiler::dump();
+    } else if (strcmp(cmd, "prof reset") == 0) {
+      Profiler::reset();
+      Serial.println("Profiler reset");
+    } else if (strcmp(cmd, "tasks") == 0) {
+      Tasks::dump();
+    } else if (strcmp(cmd, "mem") == 0) {
+      MemStats::dump();
+    } else
+#endif
+#ifdef LUCID_PCPROF_HZ
+    if (strcmp(cmd, "pcprof") == 0) {
+      PcProf::dump();
+    } else if (strcmp(cmd, "pcprof reset") == 0) {
+      PcProf::reset();
+      Serial.println("PC profiler reset");
+    } else
+#endif
+#ifdef LUCID_TRACE
+    if (strcmp(cmd, "trace") == 0) {
+      Trace::dump();
+    } else if (strcmp(cmd, "trace stream on") == 0) {
+      Trace::setStreaming(true);
+      Serial.println("Trace streaming on");
+    } else if (strcmp(cmd, "trace stream off") == 0) {
+      Trace::setStreaming(false);
+      Serial.println("Trace streaming off");
+    } else
+#endif
+#ifdef LUCID_BENCH
+    if (strcmp(cmd, "bench") == 0) {
+      runBenchmarks();
+      M5.Display.clear();
+    } else
+#endif
+    {
+      Serial.printf("Unknown command: %s\n", cmd);
+    }
+  }
+}
+
+#ifdef LUCID_PROFILE
+// Draw profiler screen (mean / p99 / max per loop stage, in microseconds)
+void drawDebugUI() {
+  M5.Display.fillScreen(BLACK);
+  M5.Display.setTextSize(1);
+  M5.Display.setTextColor(YELLOW);
+  M5.Display.setCursor(5, 2);
+  M5.Display.println("PROFILER (us)   mean    p99    max");
+
+  uint32_t cpm = Profiler::cyclesPerMicro();
+  M5.Display.setTextColor(WHITE);
+  for (int i = 0; i < STAGE_COUNT; i++) {
+    M5.Display.setCursor(5, 16 + (i * 11));
+    M5.Display.printf("%-14s%7lu%7lu%7lu", Profiler::stageName(i),
+                      (unsigned long)(Profiler::meanCycles(i) / cpm),
+                      (unsigned long)(Profiler::percentileCycles(i, 99) / cpm),
+                      (unsigned long)(Profiler::get(i).maxCycles / cpm));
+  }
+
+  // Heap headroom and any allocation made from loop(): red once one lands
+  // past the warm-up
+  M5.Display.setTextColor(MemStats::getSteadyFailures() ? RED : MemStats::getLoopAllocs() ? YELLOW : GREEN);
+  M5.Display.setCursor(5, 106);
+  M5.Display.printf("heap %luk min %luk  loop allocs %lu",
+                    (unsigned long)(ESP.getFreeHeap() / 1024), (unsigned long)(ESP.getMinFreeHeap() / 1024),
+                    (unsigned long)MemStats::getLoopAllocs());
+
+  M5.Display.setTextColor(CYAN);
+  M5.Display.setCursor(5, 122);
+  M5.Display.println("A:Reset  B:Dump  PWR:Exit");
+}
+#endif
+
+#ifdef LUCID_BENCH
+// Synthetic wrist trace: gravity on Z, slow sway, a sharp bump every 64 samples
+static m5::imu_data_t syntheticImuSample(int i) {
+  m5::imu_data_t d = {};
+  float t = i * 0.1f;
+  d.accel.x = 0.05f * sinf(t * 0.7f);
+  d.accel.y = 0.05f * cosf(t * 0.5f);
+  d.accel.z = 1.0f + ((i % 64 == 0) ? 1.5f : 0.0f);
+  d.gyro.x = 20.0f * sinf(t);
+  d.gyro.y = 10.0f * cosf(t * 1.3f);
+  d.gyro.z = (i % 97 == 0) ? 250.0f : 5.0f;
+  return d;
+}
+
+// Audio task cost of rendering a whole wave or clip cue, per sample
+static uint32_t waveRenderCyclesPerSample(const CuePattern& pattern) {
+  static uint8_t block[WAVE_HALF_SAMPLES];
+  WaveSynth synth;
+  uint32_t samples = 0;
+  synth.start(pattern);
+  uint32_t start = Profiler::cycles();
+  while (!synth.done()) samples += synth.render(block, WAVE_HALF_SAMPLES);
+  return (Profiler::cycles() - start) / (samples ? samples : 1);
+}
+
+// Benchmark suite - results printed as JSON lines over serial
+void runBenchmarks() {
+  static IMU benchImu;
+  static Settings benchSettings;
+  static Alarm benchAlarm(&benchSettings);
+
+  Serial.println("=== BENCHMARKS ===");
+  Bench::begin();
+
+  // Drawing routines (real panel). They cycle the values they draw, so put
+  // those back afterwards rather than re-reading NVS.
+  int savedMenu = menuSelection;
+  bool savedEditingHour = editingHour;
+  int savedCheck = currentRealityCheck;
+  int savedSensitivity = sensitivityLevel;
+  int savedBrightness = brightnessLevel;
+  Bench::run("draw_menu", [](int i) { menuSelection = i % MENU_ITEMS; drawMenuUI(); }, 50);
+  Bench::run("draw_time_set", [](int i) { editingHour = (i & 1); drawTimeSetUI(); }, 50);
+  Bench::run("draw_reality_check", [](int i) { currentRealityCheck = i % 9; drawRealityCheckUI(); }, 45);
+  Bench::run("draw_night_mode", [](int) { drawNightModeUI(); }, 50);
+  Bench::run("draw_dream_journal", [](int) { drawDreamJournalUI(); }, 50);
+  Bench::run("draw_sensitivity", [](int i) { sensitivityLevel = i % 8; drawSensitivityUI(); }, 48);
+  Bench::run("draw_brightness", [](int i) { brightnessLevel = i % 11; drawBrightnessUI(); }, 44);
+  // Layout renderer: full repaint (screen entry) vs an unchanged 200 ms frame
+  Bench::run("draw_brightness_full", [](int i) { ui.invalidate(); brightnessLevel = i % 11; drawBrightnessUI(); }, 44);
+  Bench::run("draw_brightness_idle", [](int) { drawBrightnessUI(); }, 44);
+  menuSelection = savedMenu;
+  editingHour = savedEditingHour;
+  currentRealityCheck = savedCheck;
+  sensitivityLevel = savedSensitivity;
+  brightnessLevel = savedBrightness;
+  screens.invalidate();
+
+  // Scheduling: one reschedule per simulated hour over a week, on a private
+  // scheduler - polling the live one at 2024 times would hand back every
+  // pending event as missed. Only the interval and the heap insert are
+  // timed; scheduleNextAlarmFrom() also logs.
+  static const int64_t BENCH_EPOCH = 1704067200;  // 2024-01-01 00:00
+  static EventScheduler benchScheduler;
+  Bench::run("schedule_next_alarm", [](int i) {
+    int64_t nowSec = BENCH_EPOCH + i * 3600;
+    benchScheduler.schedule(EVENT_REALITY_CHECK, nowSec + nextAlarmIntervalMin(alarmsPerDay) * 60);
+  }, 24 * 7);
+
+  // Alarm trigger path: evaluate every simulated minute over a week
+  benchScheduler.clear();
+  benchScheduler.schedule(EVENT_REALITY_CHECK, BENCH_EPOCH + nextAlarmIntervalMin(alarmsPerDay) * 60);
+  Bench::run("alarm_trigger_week", [](int i) {
+    int64_t nowSec = BENCH_EPOCH + i * 60;
+    TimedEvent event;
+    if (benchScheduler.poll(nowSec, EVENT_BIT(EVENT_REALITY_CHECK), event) != SCHED_NONE) {
+      benchScheduler.schedule(EVENT_REALITY_CHECK, nowSec + nextAlarmIntervalMin(alarmsPerDay) * 60);
+    }
+  }, 1440 * 7);
+
+  // IMU detectors over a synthetic trace
+  Bench::run("imu_should_trigger_rc", [](int i) {
+    benchImu.update(syntheticImuSample(i));
+    benchImu.shouldTriggerRC();
+  }, 1000);
+  Bench::run("imu_legacy_sqrt_per_detector", [](int i) {
+    // Reference: the old per-call path took sqrt for each of the three detectors
+    m5::imu_data_t d = syntheticImuSample(i);
+    volatile float a1 = sqrtf(d.accel.x * d.accel.x + d.accel.y * d.accel.y + d.accel.z * d.accel.z);
+    volatile float a2 = sqrtf(d.accel.x * d.accel.x + d.accel.y * d.accel.y + d.accel.z * d.accel.z);
+    volatile float g1 = sqrtf(d.gyro.x * d.gyro.x + d.gyro.y * d.gyro.y + d.gyro.z * d.gyro.z);
+    (void)a1; (void)a2; (void)g1;
+  }, 1000);
+  Bench::run("imu_batch_features_32", [](int i) {
+    // One call covers IMU_BATCH_SIZE samples; divide by 32 for per-sample cost
+    static ImuBatch benchBatch;
+    static ImuFeatures benchFeatures;
+    if (i == 0) {
+      imuBatchClear(benchBatch);
+      for (int k = 0; k < IMU_BATCH_SIZE; k++) {
+        m5::imu_data_t d = syntheticImuSample(k);
+        imuBatchPush(benchBatch, d.accel.x, d.accel.y, d.accel.z, d.gyro.x, d.gyro.y, d.gyro.z);
+      }
+    }
+    imuComputeFeatures(benchBatch, benchFeatures);
+  }, 200);
+  Bench::run("imu_wake_on_shake", [](int i) {
+    static ShakeDetector benchShake;
+    m5::imu_data_t d = syntheticImuSample(i);
+    benchShake.update(d.accel.x, d.accel.y, d.accel.z, SENSITIVITY_VALUES[sensitivityLevel]);
+  }, 1000);
+  Bench::run("imu_wrist_raise", [](int i) {
+    static WristRaise benchWrist;
+    m5::imu_data_t d = syntheticImuSample(i);
+    benchWrist.update(d.accel.x, d.accel.y, d.accel.z, d.gyro.x, d.gyro.y, d.gyro.z, i * 100UL);
+  }, 1000);
+  Bench::run("night_monitor_batch_100", [](int) {
+    // One 10 s FIFO drain; divide by 100 for per-sample cost
+    static NightMonitor benchMonitor;
+    benchMonitor.beginBatch();
+    for (int k = 0; k < 100; k++) {
+      m5::imu_data_t d = syntheticImuSample(k);
+      benchMonitor.addSample(d.accel.x, d.accel.y, d.accel.z);
+    }
+  }, 100);
+
+  // Dream memo codec on a synthetic voice-like signal (two formants under
+  // a syllable envelope), 64 ms chunks as the mic delivers them
+  static int16_t benchPcm[MEMO_CHUNK_SAMPLES];
+  for (int k = 0; k < MEMO_CHUNK_SAMPLES; k++) {
+    float t = k / (float)MEMO_SAMPLE_RATE;
+    float envelope = 0.5f + 0.5f * sinf(2 * PI * 4 * t);
+    benchPcm[k] = (int16_t)(envelope * (6000 * sinf(2 * PI * 220 * t) + 2500 * sinf(2 * PI * 1400 * t)));
+  }
+  Bench::run("adpcm_encode_512", [](int) {
+    static AdpcmEncoder benchEncoder;
+    benchEncoder.encode(benchPcm, MEMO_CHUNK_SAMPLES, memoCodes);
+  }, 200);
+  {
+    AdpcmEncoder encoder;
+    AdpcmDecoder decoder;
+    static int16_t decoded[MEMO_CHUNK_SAMPLES];
+    double signal = 0, noise = 0;
+    for (int round = 0; round < 8; round++) {
+      encoder.encode(benchPcm, MEMO_CHUNK_SAMPLES, memoCodes);
+      decoder.decode(memoCodes, MEMO_CHUNK_SAMPLES / 2, decoded);
+      for (int k = 0; k < MEMO_CHUNK_SAMPLES; k++) {
+        double e = benchPcm[k] - decoded[k];
+        signal += (double)benchPcm[k] * benchPcm[k];
+        noise += e * e;
+      }
+    }
+    uint32_t memoBytes = sizeof(MemoHeader) + MEMO_MAX_SEC * MEMO_SAMPLE_RATE / 2;
+    logPrintf("{\"bench_adpcm\":{\"ratio\":%.2f,\"snr_db\":%.1f,\"memo_max_bytes\":%lu}}\n",
+              (MEMO_MAX_SEC * MEMO_SAMPLE_RATE * 2.0f) / memoBytes, 10 * log10(signal / (noise > 0 ? noise : 1)),
+              (unsigned long)memoBytes);
+  }
+
+  // Night sound: one window of synthetic room noise with a snore-like hum
+  for (int k = 0; k < SOUND_WINDOW_SAMPLES; k++) {
+    float t = k / (float)SOUND_SAMPLE_RATE;
+    soundPcm[k] = (int16_t)(200 + 1500 * sinf(2 * PI * 125 * t) + 900 * sinf(2 * PI * 250 * t) + (int)(esp_random() % 129) - 64);
+  }
+  Bench::run("sound_window_2048", [](int) {
+    static SoundFeatures benchSound;
+    static SoundFrame benchFrame;
+    benchSound.process(soundPcm, benchFrame);
+  }, 20);
+  {
+    SoundFeatures sound;
+    SoundFrame frame;
+    uint32_t start = Profiler::cycles();
+    for (int k = 0; k < 8; k++) sound.process(soundPcm, frame);
+    uint32_t perWindow = (Profiler::cycles() - start) / 8;
+    // Each window covers 256 ms, so per second of audio is x3.9; at one
+    // window a second the duty-cycled cost is perWindow cycles per second
+    logPrintf("{\"bench_sound\":{\"cycles_per_window\":%lu,\"cycles_per_audio_s\":%lu,\"cpu_share_pct\":%.3f}}\n",
+              (unsigned long)perWindow,
+              (unsigned long)((uint64_t)perWindow * SOUND_SAMPLE_RATE / SOUND_WINDOW_SAMPLES),
+              perWindow / (Profiler::cyclesPerMicro() * 1e6f) * 100);
+  }
+
+  // Reality check trigger path: ambient lookup plus queueing the cue
+  Bench::run("ambient_db_2048", [](int) { volatile uint8_t db = ChirpAdapt::ambientDb(soundPcm, SOUND_WINDOW_SAMPLES); (void)db; }, 20);
+  Bench::run("chirp_level_select", [](int i) { volatile int level = ChirpAdapt::levelFor(30 + i % 50); (void)level; }, 100);
+
+  // Wave playback: one half ring of rendering, then the REM wave cue for
+  // real (audible) so the ISR counts its own cycles per sample. Those
+  // exclude interrupt entry and exit, a few hundred cycles more.
+  Bench::run("wave_render_256", [](int) {
+    static WaveSynth benchSynth;
+    static uint8_t benchWave[WAVE_HALF_SAMPLES];
+    if (benchSynth.done()) benchSynth.start(CUE_REM_WAVE);
+    benchSynth.render(benchWave, WAVE_HALF_SAMPLES);
+  }, 40);
+  {
+    uint32_t waveCycles = waveRenderCyclesPerSample(CUE_REM_WAVE);
+    uint32_t clipCycles = waveRenderCyclesPerSample(CUE_CHIME);
+    WavePlayer::resetStats();
+    Tasks::playCue(CUE_REM_WAVE);
+    delay(50);
+    while (Tasks::isCueActive()) delay(10);
+    WaveStats stats;
+    WavePlayer::stats(stats);
+    uint32_t isrMean = stats.samples ? (uint32_t)(stats.cyclesTotal / stats.samples) : 0;
+    logPrintf("{\"bench_wave\":{\"isr_cycles_mean\":%lu,\"isr_cycles_max\":%lu,\"samples\":%lu,"
+              "\"underruns\":%lu,\"render_cycles_per_sample\":%lu,\"clip_cycles_per_sample\":%lu,"
+              "\"cpu_share_pct\":%.2f}}\n",
+              (unsigned long)isrMean, (unsigned long)stats.cyclesMax, (unsigned long)stats.samples,
+              (unsigned long)stats.underruns, (unsigned long)waveCycles, (unsigned long)clipCycles,
+              (float)(isrMean + waveCycles) * WAVE_SAMPLE_RATE / (Profiler::cyclesPerMicro() * 1e6f) * 100);
+  }
+
+  // Night energy, modelled: the loop awake all night vs the monitor, awake
+  // for ~22 cue responses (16 s each) and ~20 rollovers (60 s each) in 8 h
+  float loopMa = nightMeanCurrentMa(1.0f);
+  float monitorMa = nightMeanCurrentMa((22 * 16 + 20 * 60) / (8 * 3600.0f));
+  logPrintf("{\"bench_energy\":{\"night_loop_ma\":%.2f,\"night_monitor_ma\":%.2f,"
+            "\"night_loop_mah_8h\":%.1f,\"night_monitor_mah_8h\":%.1f,\"battery_mah\":%.0f}}\n",
+            loopMa, monitorMa, loopMa * 8, monitorMa * 8, POWER_BATTERY_MAH);
+
+  // Persistence (real NVS - kept short to limit flash wear). The settings
+  // go to a scratch namespace, cleared afterwards, so the live ones are
+  // never rewritten; the legacy Settings namespace isn't read by the firmware.
+  benchSettings.begin();
+  Bench::run("settings_save", [](int) { benchSettings.save(); }, 10);
+  static Preferences benchPrefs;
+  benchPrefs.begin("lucidbench", false);
+  Bench::run("save_settings_main", [](int) { writeSettings(benchPrefs); }, 10);
+  benchPrefs.clear();
+  benchPrefs.end();
+
+  Bench::end();
+  Serial.println("=== BENCHMARKS DONE ===");
 }
+#endif
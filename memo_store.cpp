@@ -0,0 +1,181 @@
+#include "memo_store.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "memstats.h"
+
+#define MEMO_FREE_MARGIN 16384  // Left for nights and LittleFS metadata
+
+static bool mounted = false;
+static File recording;
+static int recordingSlot = -1;
+static MemoHeader recordingHeader;
+static uint32_t recordingMax = 0;
+
+static void slotPath(int slot, char* path, size_t size) {
+    snprintf(path, size, MEMO_STORE_DIR "/%02d.ima", slot);
+}
+
+static bool headerValid(const MemoHeader& header) {
+    return header.magic == MEMO_MAGIC && header.version == MEMO_VERSION &&
+           header.samples > 0 && header.bytes == header.samples / 2;
+}
+
+static bool readSlotHeader(int slot, MemoHeader& header) {
+    MemExemptScope exempt(MEM_EXEMPT_FILE);
+    char path[24];
+    slotPath(slot, path, sizeof(path));
+    if (!LittleFS.exists(path)) return false;
+    File file = LittleFS.open(path, FILE_READ);
+    if (!file) return false;
+    bool ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) && headerValid(header);
+    file.close();
+    return ok;
+}
+
+// Valid slots, oldest first
+static int sortedSlots(int* slots) {
+    int64_t starts[MEMO_STORE_SLOTS];
+    int count = 0;
+    if (!mounted) return 0;
+    for (int slot = 0; slot < MEMO_STORE_SLOTS; slot++) {
+        MemoHeader header;
+        if (slot == recordingSlot || !readSlotHeader(slot, header)) continue;
+        int i = count++;
+        while (i > 0 && starts[i - 1] > header.startSec) {
+            starts[i] = starts[i - 1];
+            slots[i] = slots[i - 1];
+            i--;
+        }
+        starts[i] = header.startSec;
+        slots[i] = slot;
+    }
+    return count;
+}
+
+void MemoStore::begin(bool fsMounted) {
+    mounted = fsMounted;
+    if (mounted) LittleFS.mkdir(MEMO_STORE_DIR);
+}
+
+uint32_t MemoStore::start(int64_t startSec) {
+    MemExemptScope exempt(MEM_EXEMPT_FILE);
+    if (!mounted || recording) return 0;
+
+    // First empty slot, else the oldest memo
+    int target = -1;
+    int64_t oldest = 0;
+    for (int slot = 0; slot < MEMO_STORE_SLOTS; slot++) {
+        MemoHeader existing;
+        if (!readSlotHeader(slot, existing)) {
+            target = slot;
+            break;
+        }
+        if (target < 0 || existing.startSec < oldest) {
+            target = slot;
+            oldest = existing.startSec;
+        }
+    }
+
+    char path[24];
+    slotPath(target, path, sizeof(path));
+    LittleFS.remove(path);  // Its space counts as free below
+    size_t used = LittleFS.usedBytes();
+    size_t total = LittleFS.totalBytes();
+    size_t room = total > used + MEMO_FREE_MARGIN + sizeof(MemoHeader) ?
+                  total - used - MEMO_FREE_MARGIN - sizeof(MemoHeader) : 0;
+    recordingMax = (uint32_t)MEMO_MAX_SEC * MEMO_SAMPLE_RATE;
+    if (room * 2 < recordingMax) recordingMax = room * 2;
+    if (recordingMax < MEMO_MIN_SAMPLES) {
+        Serial.println("Memo: flash full");
+        return 0;
+    }
+
+    recording = LittleFS.open(path, FILE_WRITE);
+    if (!recording) return 0;
+    recordingSlot = target;
+    recordingHeader.magic = MEMO_MAGIC;
+    recordingHeader.version = MEMO_VERSION;
+    recordingHeader.reserved = 0;
+    recordingHeader.sampleRate = MEMO_SAMPLE_RATE;
+    recordingHeader.startSec = startSec;
+    recordingHeader.samples = 0;  // Placeholder until finish()
+    recordingHeader.bytes = 0;
+    if (recording.write((const uint8_t*)&recordingHeader, sizeof(recordingHeader)) != sizeof(recordingHeader)) {
+        finish();
+        return 0;
+    }
+    return recordingMax;
+}
+
+bool MemoStore::append(const uint8_t* codes, uint32_t bytes) {
+    MemExemptScope exempt(MEM_EXEMPT_FILE);
+    if (!recording) return false;
+    if ((recordingHeader.bytes + bytes) * 2 > recordingMax) return false;
+    if (recording.write(codes, bytes) != bytes) return false;
+    recordingHeader.bytes += bytes;
+    recordingHeader.samples = recordingHeader.bytes * 2;
+    return true;
+}
+
+int MemoStore::finish() {
+    MemExemptScope exempt(MEM_EXEMPT_FILE);
+    if (!recording) return -1;
+    bool ok = recordingHeader.samples >= MEMO_MIN_SAMPLES && recording.seek(0) &&
+              recording.write((const uint8_t*)&recordingHeader, sizeof(recordingHeader)) == sizeof(recordingHeader);
+    recording.close();
+
+    int slot = recordingSlot;
+    recordingSlot = -1;
+    char path[24];
+    slotPath(slot, path, sizeof(path));
+    if (!ok) {
+        LittleFS.remove(path);
+        return -1;
+    }
+    logPrintf("Memo saved to slot %d: %lu samples, %lu bytes\n", slot,
+              (unsigned long)recordingHeader.samples, (unsigned long)recordingHeader.bytes);
+    return slot;
+}
+
+bool MemoStore::isRecording() {
+    return (bool)recording;
+}
+
+uint32_t MemoStore::recordedSamples() {
+    return recordingHeader.samples;
+}
+
+int MemoStore::count() {
+    int slots[MEMO_STORE_SLOTS];
+    return sortedSlots(slots);
+}
+
+// {"memo":{...header...}}, then the ADPCM codes as hex lines
+void MemoStore::dump() {
+    MemExemptScope exempt(MEM_EXEMPT_FILE);
+    int slots[MEMO_STORE_SLOTS];
+    int count = sortedSlots(slots);
+    for (int i = 0; i < count; i++) {
+        char path[24];
+        slotPath(slots[i], path, sizeof(path));
+        File file = LittleFS.open(path, FILE_READ);
+        MemoHeader header;
+        if (!file || file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) || !headerValid(header)) continue;
+
+        logPrintf("{\"memo\":{\"slot\":%d,\"start\":%lu,\"rate\":%u,\"samples\":%lu,\"bytes\":%lu}}\n",
+                  slots[i], (unsigned long)header.startSec, header.sampleRate,
+                  (unsigned long)header.samples, (unsigned long)header.bytes);
+        uint8_t chunk[MEMO_DUMP_BYTES_PER_LINE];
+        char hex[MEMO_DUMP_BYTES_PER_LINE * 2 + 1];
+        uint32_t left = header.bytes;
+        while (left > 0) {
+            int n = file.read(chunk, left < MEMO_DUMP_BYTES_PER_LINE ? left : MEMO_DUMP_BYTES_PER_LINE);
+            if (n <= 0) break;
+            for (int k = 0; k < n; k++) snprintf(hex + k * 2, 3, "%02x", chunk[k]);
+            logPrintf("{\"memo_data\":\"%s\"}\n", hex);
+            left -= n;
+        }
+        file.close();
+    }
+    logPrintf("{\"memos_end\":%d}\n", count);
+}
@@ -0,0 +1,53 @@
+#ifndef MEMO_STORE_H
+#define MEMO_STORE_H
+
+#include <stdint.h>
+
+// Dream memos
+// Voice recordings from the dream journal screen, IMA-ADPCM (adpcm.h) at
+// MEMO_SAMPLE_RATE, one LittleFS file per memo in MEMO_STORE_SLOTS fixed
+// slots; a new memo takes an empty slot or replaces the oldest. Memos are
+// written as they are recorded: start() writes a placeholder header,
+// append() the codes, finish() the real header. A memo cut short by a reset
+// keeps the placeholder (no samples) and its slot counts as empty.
+// 45 s is 180 KB, so the ring takes about 1.1 MB of the 1.4 MB partition.
+// File I/O allocates, so this only runs on the dream journal screen and on
+// the `memos` serial command.
+
+#define MEMO_STORE_DIR "/memos"
+#define MEMO_STORE_SLOTS 6
+#define MEMO_SAMPLE_RATE 8000
+#define MEMO_MAX_SEC 45
+#define MEMO_MIN_SAMPLES (MEMO_SAMPLE_RATE / 2)  // Shorter is a mis-press
+#define MEMO_MAGIC 0x314D574CUL  // "LWM1"
+#define MEMO_VERSION 1
+#define MEMO_DUMP_BYTES_PER_LINE 64
+
+// In front of the ADPCM codes, little-endian, 24 bytes
+struct MemoHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t reserved;
+    uint16_t sampleRate;
+    int64_t startSec;   // Local epoch seconds when recording began
+    uint32_t samples;
+    uint32_t bytes;     // ADPCM data that follows, samples / 2
+};
+
+class MemoStore {
+public:
+    static void begin(bool mounted);  // After NightStore::begin() mounted LittleFS
+
+    // New memo in the next slot; returns the samples it may hold (limited
+    // by MEMO_MAX_SEC and free space), 0 if it can't record
+    static uint32_t start(int64_t startSec);
+    static bool append(const uint8_t* codes, uint32_t bytes);
+    static int finish();   // Slot saved, or -1 (too short or write error)
+    static bool isRecording();
+    static uint32_t recordedSamples();
+
+    static int count();
+    static void dump();   // Every memo, oldest first, for tools/memos_to_wav.py
+};
+
+#endif
@@ -0,0 +1,147 @@
+#include "memstats.h"
+#include <Arduino.h>
+#include <stdarg.h>
+#include "tasks.h"
+
+void logPrintf(const char* fmt, ...) {
+    char line[LOG_LINE_MAX];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    if (len < 0) return;
+    if (len >= (int)sizeof(line)) len = sizeof(line) - 1;
+    Serial.write((const uint8_t*)line, len);
+}
+
+#ifdef LUCID_PROFILE
+
+#include <atomic>
+
+static std::atomic<uint32_t> allocsTotal(0);
+static std::atomic<uint32_t> allocsAtBoot(0);
+static std::atomic<uint32_t> loopAllocs(0);
+static std::atomic<bool> inLoop(false);
+static TaskHandle_t loopTask = NULL;
+static void* lastLoopCaller = NULL;
+static uint32_t heapAtBoot = 0;
+static uint32_t loopAllocsReported = 0;
+
+// Loop task only
+static int exempt = MEM_EXEMPT_NONE;
+static uint32_t exemptAllocs[MEM_EXEMPT_COUNT];
+static uint32_t iterationAllocs = 0;
+static uint32_t loopIterations = 0;
+static uint32_t steadyFailures = 0;
+static const char* const EXEMPT_NAMES[MEM_EXEMPT_COUNT] = {"file", "mic", "console"};
+
+static inline void noteAlloc(void* caller) {
+    allocsTotal.fetch_add(1, std::memory_order_relaxed);
+    if (inLoop.load(std::memory_order_relaxed) && xTaskGetCurrentTaskHandle() == loopTask) {
+        if (exempt != MEM_EXEMPT_NONE) {
+            exemptAllocs[exempt]++;
+            return;
+        }
+        loopAllocs.fetch_add(1, std::memory_order_relaxed);
+        iterationAllocs++;
+        lastLoopCaller = caller;
+    }
+}
+
+// Linked in place of the real allocator via -Wl,--wrap=<fn>
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    noteAlloc(__builtin_return_address(0));
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    noteAlloc(__builtin_return_address(0));
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    noteAlloc(__builtin_return_address(0));
+    return __real_realloc(ptr, size);
+}
+}
+
+void MemStats::bootComplete() {
+    loopTask = xTaskGetCurrentTaskHandle();
+    allocsAtBoot.store(allocsTotal.load());
+    heapAtBoot = ESP.getFreeHeap();
+}
+
+void MemStats::loopBegin() {
+    iterationAllocs = 0;
+    inLoop.store(true, std::memory_order_relaxed);
+}
+
+void MemStats::loopEnd() {
+    inLoop.store(false, std::memory_order_relaxed);
+
+    // Steady state: no iteration may allocate outside an exempt scope.
+    // Logged the first time, then each time the count doubles.
+    if (++loopIterations > MEM_STEADY_AFTER_LOOPS && iterationAllocs) {
+        steadyFailures++;
+        if (!(steadyFailures & (steadyFailures - 1))) {
+            logPrintf("ASSERT: loop() iteration %lu made %lu heap allocation(s), last from %p\n",
+                      (unsigned long)loopIterations, (unsigned long)iterationAllocs, lastLoopCaller);
+        }
+    }
+
+    // Flag the first allocation, then each time the count doubles
+    uint32_t n = loopAllocs.load(std::memory_order_relaxed);
+    if (n > loopAllocsReported && n >= loopAllocsReported * 2) {
+        logPrintf("WARNING: %lu heap allocation(s) in loop(), last from %p\n",
+                  (unsigned long)n, lastLoopCaller);
+        loopAllocsReported = n;
+    }
+}
+
+uint32_t MemStats::getLoopAllocs() {
+    return loopAllocs.load(std::memory_order_relaxed);
+}
+
+uint32_t MemStats::getSteadyFailures() {
+    return steadyFailures;
+}
+
+int MemStats::setExempt(int why) {
+    int previous = exempt;
+    exempt = why;
+    return previous;
+}
+
+void MemStats::dump() {
+    logPrintf("{\"mem\":{\"heap_free\":%lu,\"heap_min_free\":%lu,\"heap_largest\":%lu,\"heap_at_boot\":%lu,"
+              "\"allocs_boot\":%lu,\"allocs_since_boot\":%lu,\"allocs_loop\":%lu,\"last_loop_caller\":\"%p\","
+              "\"loop_iterations\":%lu,\"steady_alloc_iterations\":%lu,\"exempt\":{",
+              (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap(),
+              (unsigned long)ESP.getMaxAllocHeap(), (unsigned long)heapAtBoot,
+              (unsigned long)allocsAtBoot.load(), (unsigned long)(allocsTotal.load() - allocsAtBoot.load()),
+              (unsigned long)loopAllocs.load(), lastLoopCaller, (unsigned long)loopIterations,
+              (unsigned long)steadyFailures);
+    for (int i = 0; i < MEM_EXEMPT_COUNT; i++) {
+        logPrintf("%s\"%s\":%lu", i ? "," : "", EXEMPT_NAMES[i], (unsigned long)exemptAllocs[i]);
+    }
+    logPrintf("},\"stack_free\":{");
+    for (int i = 0; i < TASK_COUNT; i++) {
+        logPrintf("%s\"%s\":%lu", i ? "," : "", Tasks::name(i), (unsigned long)Tasks::stackFree(i));
+    }
+    logPrintf("}}}\n");
+}
+
+#else
+void MemStats::bootComplete() {}
+void MemStats::loopBegin() {}
+void MemStats::loopEnd() {}
+uint32_t MemStats::getLoopAllocs() { return 0; }
+uint32_t MemStats::getSteadyFailures() { return 0; }
+int MemStats::setExempt(int) { return MEM_EXEMPT_NONE; }
+void MemStats::dump() {}
+#endif
@@ -0,0 +1,63 @@
+#ifndef MEMSTATS_H
+#define MEMSTATS_H
+
+#include <stdint.h>
+
+// Heap and stack headroom
+// After setup() the firmware does not use the heap: buffers are static,
+// fixed-capacity, or on the stack, and NVS stays open from setup(). Profile
+// builds wrap malloc/calloc/realloc at link time (see platformio.ini) and
+// count any allocation made while loop() runs, keeping the caller address
+// of the last one for addr2line.
+//
+// The known exceptions are driver calls that allocate internally; each is
+// wrapped in a MemExemptScope so its allocations are counted under its
+// reason instead:
+//   file    - LittleFS opens (night and memo saves, sleep report, dumps)
+//   mic     - M5.Mic.begin() installing the I2S driver (memos, ambient
+//             check, night sound)
+//   console - serial commands (dumps, bench), debugging only
+// Once MEM_STEADY_AFTER_LOOPS iterations have run, every loop() iteration
+// must make no other allocation; one that does is logged as an ASSERT with
+// its caller and counted in the `mem` dump. tools/tests/alloc_test.cpp
+// holds the modules loop() drives to the same rule on a host.
+
+#define MEM_STEADY_AFTER_LOOPS 50   // Warm-up: first draws, lazy driver init
+
+enum MemExempt {
+    MEM_EXEMPT_NONE = -1,
+    MEM_EXEMPT_FILE,
+    MEM_EXEMPT_MIC,
+    MEM_EXEMPT_CONSOLE,
+    MEM_EXEMPT_COUNT
+};
+
+// Longest line logPrintf() formats; longer output is truncated
+#define LOG_LINE_MAX 192
+
+// Serial.printf without the heap. Arduino's printf mallocs a buffer for any
+// line of 64+ characters, so use this for long log lines and JSON dumps.
+void logPrintf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+class MemStats {
+public:
+    static void bootComplete();  // End of setup(): record heap baseline
+    static void loopBegin();
+    static void loopEnd();
+    static uint32_t getLoopAllocs();   // Not counting exempt ones
+    static uint32_t getSteadyFailures();  // Steady-state iterations that allocated
+    static int setExempt(int why);     // Loop task; returns the reason it replaces
+    static void dump();          // One JSON line: heap, allocations, stacks
+};
+
+// Allocations in this scope count under why, not against loop()
+class MemExemptScope {
+private:
+    int previous;
+
+public:
+    explicit MemExemptScope(MemExempt why) : previous(MemStats::setExempt(why)) {}
+    ~MemExemptScope() { MemStats::setExempt(previous); }
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include "motion_trigger.h"
+
+MotionTrigger::MotionTrigger() {
+    wasStill = false;
+    tokens = MOTION_RC_BURST;
+    lastRefillTime = 0;
+    started = false;
+}
+
+void MotionTrigger::reset(unsigned long now) {
+    wasStill = false;
+    tokens = MOTION_RC_BURST;
+    lastRefillTime = now;
+    started = true;
+}
+
+MotionContext MotionTrigger::classify(const ImuFeatures& f) {
+    if (f.samples < IMU_BATCH_SIZE) return MOTION_NONE;
+
+    bool still = f.accelMagSqVar < MOTION_STILL_VAR && f.jerkSum < MOTION_STILL_JERK;
+    bool previouslyStill = wasStill;
+    wasStill = still;
+
+    // Instantaneous contexts fire regardless of what came before
+    if (f.accelMagSqMin < MOTION_FREE_FALL_MAG_SQ) return MOTION_FREE_FALL;
+    if (f.gyroMagSqMax > MOTION_SPIN_DPS * MOTION_SPIN_DPS) return MOTION_SPIN;
+
+    // Transitions out of stillness
+    if (!previouslyStill || still) return MOTION_NONE;
+
+    if (f.gravityCrossings >= MOTION_WALK_CROSSINGS && f.accelMagSqVar > MOTION_WALK_VAR) {
+        return MOTION_WALK_START;
+    }
+    if (f.jerkSum > MOTION_STAND_UP_JERK) {
+        return MOTION_STAND_UP;
+    }
+    return MOTION_NONE;
+}
+
+void MotionTrigger::refill(unsigned long now) {
+    if (!started) {
+        reset(now);
+        return;
+    }
+    while (tokens < MOTION_RC_BURST && now - lastRefillTime >= MOTION_RC_REFILL_MS) {
+        tokens++;
+        lastRefillTime += MOTION_RC_REFILL_MS;
+    }
+    if (tokens >= MOTION_RC_BURST) {
+        lastRefillTime = now;  // Full bucket doesn't bank refill time
+    }
+}
+
+bool MotionTrigger::tryConsumeToken(unsigned long now) {
+    refill(now);
+    if (tokens == 0) return false;
+    tokens--;
+    return true;
+}
+
+const char* MotionTrigger::contextName(MotionContext context) {
+    switch (context) {
+        case MOTION_STAND_UP: return "stand-up";
+        case MOTION_WALK_START: return "walk start";
+        case MOTION_SPIN: return "spin";
+        case MOTION_FREE_FALL: return "free-fall";
+        default: return "none";
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef MOTION_TRIGGER_H
+#define MOTION_TRIGGER_H
+
+#include "config.h"
+#include "imu_kernels.h"
+
+// Motion-context reality check trigger
+// Classifies batched IMU features into motion contexts and rate limits the
+// resulting reality checks with a token bucket. Quiet hours are left to the
+// caller, which owns the clock. No Arduino dependencies, so
+// tools/tests/motion_trigger_test.cpp runs it on a host.
+
+enum MotionContext {
+    MOTION_NONE,
+    MOTION_STAND_UP,
+    MOTION_WALK_START,
+    MOTION_SPIN,
+    MOTION_FREE_FALL
+};
+
+class MotionTrigger {
+private:
+    bool wasStill;
+    int tokens;
+    unsigned long lastRefillTime;
+    bool started;
+
+    void refill(unsigned long now);
+
+public:
+    MotionTrigger();
+    void reset(unsigned long now);
+    MotionContext classify(const ImuFeatures& features);
+    bool tryConsumeToken(unsigned long now);
+    int getTokens() { return tokens; }
+    static const char* contextName(MotionContext context);
+};
+
+#endif
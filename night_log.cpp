@@ -0,0 +1,189 @@
+#include "night_log.h"
+#include "sound_features.h"
+#include <string.h>
+
+void NightRecorder::begin(int64_t startSec) {
+    memset(&header, 0, sizeof(header));
+    header.magic = NIGHT_LOG_MAGIC;
+    header.version = NIGHT_LOG_VERSION;
+    header.epochSec = NIGHT_EPOCH_SEC;
+    header.startSec = startSec;
+    bitPos = 0;
+    primed = false;
+    epochSamples = 0;
+    epochMoves = 0;
+    epochCue = false;
+    epochNoise = 0;
+    epochSnore = 0;
+    memset(recent, 0, sizeof(recent));
+    lastActivity = 0;
+    lastStage = SLEEP_DEEP;
+}
+
+void NightRecorder::resume(int64_t nowSec) {
+    primed = false;
+    epochSamples = 0;
+    epochMoves = 0;
+    epochCue = false;
+    epochNoise = 0;
+    epochSnore = 0;
+    memset(recent, 0, sizeof(recent));
+
+    int64_t due = (nowSec - header.startSec) / NIGHT_EPOCH_SEC;
+    while (header.epochs < due && !isFull()) {
+        writeEpoch(0, SLEEP_UNKNOWN, false);
+    }
+}
+
+uint32_t NightRecorder::checksum() {
+    uint32_t crc = nightCrc32(0, &header, sizeof(header));
+    crc = nightCrc32(crc, data, header.bytes);
+    crc = nightCrc32(crc, &bitPos, sizeof(bitPos));
+    crc = nightCrc32(crc, &lastActivity, sizeof(lastActivity));
+    return nightCrc32(crc, &lastStage, sizeof(lastStage));
+}
+
+void NightRecorder::markCue() {
+    epochCue = true;
+}
+
+void NightRecorder::addSound(uint8_t event) {
+    if (event == SOUND_NOISE && epochNoise < 255) epochNoise++;
+    if (event == SOUND_SNORE && epochSnore < 255) epochSnore++;
+}
+
+bool NightRecorder::update(float ax, float ay, float az) {
+    if (isFull()) return false;
+
+    if (primed) {
+        float dx = ax - lastX;
+        float dy = ay - lastY;
+        float dz = az - lastZ;
+        if (dx * dx + dy * dy + dz * dz > NIGHT_MOVE_G2) epochMoves++;
+    }
+    lastX = ax;
+    lastY = ay;
+    lastZ = az;
+    primed = true;
+
+    if (++epochSamples < NIGHT_EPOCH_SAMPLES) return false;
+    closeEpoch();
+    return true;
+}
+
+void NightRecorder::writeBits(uint32_t value, int count) {
+    while (count-- > 0) {
+        uint8_t mask = 0x80 >> (bitPos & 7);
+        if ((value >> count) & 1) {
+            data[bitPos >> 3] |= mask;
+        } else {
+            data[bitPos >> 3] &= ~mask;
+        }
+        bitPos++;
+    }
+}
+
+void NightRecorder::closeEpoch() {
+    uint16_t activity = epochMoves;
+    uint32_t score = (4 * activity + 2 * recent[0] + recent[1] + recent[2]) / 8;
+    uint8_t stage = activity >= NIGHT_WAKE_MOVES ? SLEEP_WAKE
+                  : score >= NIGHT_LIGHT_SCORE ? SLEEP_LIGHT : SLEEP_DEEP;
+    if (stage == SLEEP_DEEP && epochNoise >= NIGHT_NOISE_SECONDS) stage = SLEEP_LIGHT;
+    if (stage == SLEEP_WAKE && epochSnore >= NIGHT_SNORE_SECONDS) stage = SLEEP_LIGHT;
+
+    writeEpoch(activity, stage, epochCue);
+    recent[2] = recent[1];
+    recent[1] = recent[0];
+    recent[0] = activity;
+    epochSamples = 0;
+    epochMoves = 0;
+    epochCue = false;
+    epochNoise = 0;
+    epochSnore = 0;
+}
+
+void NightRecorder::writeEpoch(uint16_t activity, uint8_t stage, bool cue) {
+    if (activity == lastActivity && stage == lastStage && !cue) {
+        writeBits(1, 1);
+    } else {
+        int32_t delta = (int32_t)activity - lastActivity;
+        uint32_t v = (delta >= 0 ? (uint32_t)delta * 2 : (uint32_t)(-delta) * 2 - 1) + 1;
+        int n = 31 - __builtin_clz(v);
+        writeBits(cue ? 1 : 0, 2);  // 0, cue
+        writeBits(stage, 2);
+        writeBits(0, n);
+        writeBits(v, n + 1);
+    }
+
+    if (cue) header.cues++;
+    header.epochs++;
+    header.bytes = (bitPos + 7) / 8;
+    lastActivity = activity;
+    lastStage = stage;
+}
+
+bool nightHeaderValid(const NightHeader& header) {
+    return header.magic == NIGHT_LOG_MAGIC && header.version == NIGHT_LOG_VERSION &&
+           header.epochs <= NIGHT_MAX_EPOCHS && header.bytes <= NIGHT_LOG_BYTES;
+}
+
+NightReader::NightReader(const NightHeader& header, const uint8_t* data) {
+    this->data = data;
+    bitCount = (uint32_t)header.bytes * 8;
+    bitPos = 0;
+    remaining = nightHeaderValid(header) ? header.epochs : 0;
+    activity = 0;
+    stage = SLEEP_DEEP;
+}
+
+int NightReader::readBit() {
+    if (bitPos >= bitCount) return -1;
+    int bit = (data[bitPos >> 3] >> (7 - (bitPos & 7))) & 1;
+    bitPos++;
+    return bit;
+}
+
+uint32_t NightReader::readBits(int count) {
+    uint32_t value = 0;
+    while (count-- > 0) {
+        int bit = readBit();
+        if (bit < 0) return 0;
+        value = (value << 1) | bit;
+    }
+    return value;
+}
+
+bool NightReader::next(NightEpoch& epoch) {
+    if (remaining == 0) return false;
+    int repeat = readBit();
+    if (repeat < 0) return false;
+
+    epoch.cue = false;
+    if (!repeat) {
+        epoch.cue = readBits(1);
+        stage = readBits(2);
+        int n = 0;
+        int bit;
+        while ((bit = readBit()) == 0 && n < 31) n++;
+        if (bit < 0) return false;
+        uint32_t v = (1UL << n) | readBits(n);
+        uint32_t zz = v - 1;
+        int32_t delta = (zz & 1) ? -(int32_t)((zz + 1) / 2) : (int32_t)(zz / 2);
+        activity += delta;
+    }
+    epoch.activity = activity;
+    epoch.stage = stage;
+    remaining--;
+    return true;
+}
+
+// CRC-32 (IEEE), bitwise: only run when night mode saves its session
+uint32_t nightCrc32(uint32_t crc, const void* data, uint32_t length) {
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    while (length--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
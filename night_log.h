@@ -0,0 +1,129 @@
+#ifndef NIGHT_LOG_H
+#define NIGHT_LOG_H
+
+#include <stdint.h>
+
+// Night epoch record
+// Night mode splits the 10 Hz IMU stream into 30 s epochs. Each epoch keeps
+// its activity (samples that moved more than NIGHT_MOVE_G2 since the one
+// before), whether a REM cue fired in it, and a sleep stage inferred from
+// recent activity:
+//   wake  - NIGHT_WAKE_MOVES or more in the epoch
+//   light - weighted activity of this and the 3 epochs before it
+//           (4:2:1:1, in eighths) of NIGHT_LIGHT_SCORE or more
+//   deep  - otherwise
+// Actigraphy can't tell REM from light sleep, so there is no REM stage.
+// With night sound on (sound_features.h) two corrections follow: deep
+// becomes light with NIGHT_NOISE_SECONDS of noise in the epoch (noise
+// arouses), and wake becomes light with NIGHT_SNORE_SECONDS of snoring
+// (snorers are asleep, however much they move).
+// Time the watch wasn't sampling (deep sleep between cues, a reset) is
+// filled with "unknown" epochs so the record stays aligned to the clock.
+//
+// Epochs are bit-packed, MSB first:
+//   1                       same activity and stage as the last epoch, no cue
+//   0 cue(1) stage(2) d     d = Elias gamma of zigzag(activity delta) + 1
+// A still night costs about one bit per epoch; the worst case is 25 bits,
+// so NIGHT_LOG_BYTES holds NIGHT_MAX_EPOCHS. No Arduino dependencies;
+// tools/tests/night_session_test.cpp runs it on a host, and
+// tools/nights_to_csv.py implements the same decoder.
+
+#define NIGHT_EPOCH_SAMPLES 300   // 30 s at 10 Hz
+#define NIGHT_EPOCH_SEC 30
+#define NIGHT_MAX_EPOCHS 1440     // 12 h; recording stops after that
+#define NIGHT_LOG_BYTES 4512      // NIGHT_MAX_EPOCHS * 25 bits, rounded up
+#define NIGHT_MOVE_G2 0.0025f     // (0.05 g)^2 between consecutive samples
+#define NIGHT_WAKE_MOVES 30
+#define NIGHT_LIGHT_SCORE 2
+#define NIGHT_NOISE_SECONDS 3
+#define NIGHT_SNORE_SECONDS 5
+#define NIGHT_LOG_MAGIC 0x314E574CUL  // "LWN1"
+#define NIGHT_LOG_VERSION 1
+
+enum SleepStage : uint8_t {
+    SLEEP_DEEP,
+    SLEEP_LIGHT,
+    SLEEP_WAKE,
+    SLEEP_UNKNOWN  // Not sampled
+};
+
+struct NightEpoch {
+    uint16_t activity;
+    uint8_t stage;  // SleepStage
+    bool cue;
+};
+
+// Stored in front of the packed epochs, little-endian, 24 bytes
+struct NightHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t epochSec;
+    uint16_t epochs;
+    int64_t startSec;   // Local epoch seconds of the first epoch
+    uint16_t bytes;     // Packed epoch data that follows
+    uint16_t cues;
+    uint32_t reserved;
+};
+
+class NightRecorder {
+private:
+    NightHeader header;
+    uint8_t data[NIGHT_LOG_BYTES];
+    uint32_t bitPos;
+    float lastX;
+    float lastY;
+    float lastZ;
+    bool primed;
+    int epochSamples;
+    uint16_t epochMoves;
+    bool epochCue;
+    uint8_t epochNoise;  // Sound windows (seconds) classed as noise
+    uint8_t epochSnore;
+    uint16_t recent[3];  // Activity of the previous epochs, newest first
+    uint16_t lastActivity;
+    uint8_t lastStage;
+
+    void writeBits(uint32_t value, int count);
+    void writeEpoch(uint16_t activity, uint8_t stage, bool cue);
+    void closeEpoch();
+
+public:
+    // No constructor: the recorder lives in RTC memory across resets and
+    // deep sleep (see night_session.h), so call begin() or resume()
+    void begin(int64_t startSec);
+    void resume(int64_t nowSec);  // Drop the partial epoch, mark the gap unknown
+    uint32_t checksum();          // Over everything but the partial epoch
+
+    // Feed one sample (accel in g). True when an epoch closes.
+    bool update(float ax, float ay, float az);
+    void markCue();  // A REM cue fired in the current epoch
+    void addSound(uint8_t event);  // One second's SoundEvent
+
+    bool isFull() { return header.epochs >= NIGHT_MAX_EPOCHS; }
+    SleepStage lastSleepStage() { return (SleepStage)lastStage; }
+    const NightHeader& getHeader() { return header; }
+    const uint8_t* getData() { return data; }
+};
+
+// Decodes a stored night one epoch at a time
+class NightReader {
+private:
+    const uint8_t* data;
+    uint32_t bitCount;
+    uint32_t bitPos;
+    uint16_t remaining;
+    uint16_t activity;
+    uint8_t stage;
+
+    int readBit();
+    uint32_t readBits(int count);
+
+public:
+    NightReader(const NightHeader& header, const uint8_t* data);
+    bool next(NightEpoch& epoch);  // False at the end or on corrupt data
+};
+
+bool nightHeaderValid(const NightHeader& header);
+uint32_t nightCrc32(uint32_t crc, const void* data, uint32_t length);
+
+#endif
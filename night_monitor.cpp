@@ -0,0 +1,53 @@
+#include "night_monitor.h"
+
+NightMonitor::NightMonitor() {
+    reset();
+}
+
+void NightMonitor::reset() {
+    lastX = 0;
+    lastY = 0;
+    lastZ = 0;
+    primed = false;
+    batchMoves = 0;
+    batchSamples = 0;
+}
+
+uint32_t NightMonitor::sleepMs(int64_t nowUs, bool haveDeadline, int64_t dueUs) {
+    int64_t sleepUs = (int64_t)NIGHT_MONITOR_PERIOD_MS * 1000;
+    if (haveDeadline) {
+        int64_t untilDue = dueUs - nowUs - (int64_t)NIGHT_MONITOR_LEAD_MS * 1000;
+        if (untilDue < sleepUs) sleepUs = untilDue;
+    }
+    if (sleepUs < (int64_t)NIGHT_MONITOR_MIN_SLEEP_MS * 1000) return 0;
+    return (uint32_t)(sleepUs / 1000);
+}
+
+// Movement carries over from the previous batch, so the first sample of a
+// batch is compared with the last one of the batch before
+void NightMonitor::beginBatch() {
+    batchMoves = 0;
+    batchSamples = 0;
+}
+
+void NightMonitor::addSample(float ax, float ay, float az) {
+    if (primed) {
+        float dx = ax - lastX;
+        float dy = ay - lastY;
+        float dz = az - lastZ;
+        if (dx * dx + dy * dy + dz * dz > NIGHT_MONITOR_MOVE_G2) batchMoves++;
+    }
+    lastX = ax;
+    lastY = ay;
+    lastZ = az;
+    primed = true;
+    batchSamples++;
+}
+
+float nightMeanCurrentMa(float awakeFraction) {
+    if (awakeFraction < 0) awakeFraction = 0;
+    if (awakeFraction > 1) awakeFraction = 1;
+    float awake = POWER_CPU_ACTIVE_MA + POWER_IMU_FULL_MA;
+    float monitor = POWER_LIGHT_SLEEP_MA + POWER_IMU_ACCEL_MA;
+    return POWER_BOARD_MA + awakeFraction * awake + (1 - awakeFraction) * monitor;
+}
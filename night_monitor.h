@@ -0,0 +1,68 @@
+#ifndef NIGHT_MONITOR_H
+#define NIGHT_MONITOR_H
+
+#include <stdint.h>
+
+// Night monitor
+// Between REM cues the night screen is off and loop() only waits. Instead
+// the IMU samples accelerometer-only at 10 Hz into its own FIFO while the
+// CPU light-sleeps (RAM, tasks and the night log stay put). Every
+// NIGHT_MONITOR_PERIOD_MS, or earlier for the next timed event, the CPU
+// drains the FIFO into the night log and goes back to sleep. Significant
+// movement - NIGHT_MONITOR_WAKE_MOVES samples in one batch that moved more
+// than NIGHT_MONITOR_MOVE_G2 - hands the night back to the normal loop for
+// a while, so cue responses and smart wake see the full sensor stream.
+//
+// The ESP32's ULP coprocessor would be the textbook way to do this, but the
+// IMU is on GPIO21/22, which aren't RTC IO, so the ULP can't reach it; the
+// IMU FIFO does the buffering instead. No Arduino dependencies;
+// tools/tests/night_monitor_test.cpp runs the wake decisions and the
+// energy model on a host.
+
+#define NIGHT_MONITOR_PERIOD_MS 10000    // 100 samples; the FIFO holds 170
+#define NIGHT_MONITOR_LEAD_MS 1000       // Awake this long before an event
+#define NIGHT_MONITOR_MIN_SLEEP_MS 200   // Not worth entering light sleep
+#define NIGHT_MONITOR_SPAN_SEC 600       // Back to the loop to resync the clock
+#define NIGHT_MONITOR_MOVE_G2 0.0025f    // (0.05 g)^2 between consecutive samples
+#define NIGHT_MONITOR_WAKE_MOVES 20      // In one batch: rolling over, getting up
+
+// Energy model (mA at the battery), from datasheet figures; the report is a
+// comparison, not a measurement
+#define POWER_CPU_ACTIVE_MA 30.0f     // 240 MHz, radios off, loop() running
+#define POWER_LIGHT_SLEEP_MA 0.8f     // RAM retained, RTC timer
+#define POWER_IMU_FULL_MA 3.7f        // Accel and gyro
+#define POWER_IMU_ACCEL_MA 0.45f      // Accel only (gyro in standby)
+#define POWER_BOARD_MA 1.5f           // Regulator, RTC, PMIC, screen off
+#define POWER_BATTERY_MAH 200.0f
+
+class NightMonitor {
+private:
+    float lastX;
+    float lastY;
+    float lastZ;
+    bool primed;
+    uint16_t batchMoves;
+    uint16_t batchSamples;
+
+public:
+    NightMonitor();
+    void reset();
+
+    // How long to sleep from nowUs: the period, cut short to wake
+    // NIGHT_MONITOR_LEAD_MS before dueUs. 0 means stay awake.
+    static uint32_t sleepMs(int64_t nowUs, bool haveDeadline, int64_t dueUs);
+
+    // One FIFO drain: beginBatch(), addSample() per sample (accel in g),
+    // then movementWake() tells whether to hand back to the loop
+    void beginBatch();
+    void addSample(float ax, float ay, float az);
+    bool movementWake() const { return batchMoves >= NIGHT_MONITOR_WAKE_MOVES; }
+    uint16_t getBatchMoves() const { return batchMoves; }
+    uint16_t getBatchSamples() const { return batchSamples; }
+};
+
+// Mean battery current of a night spent awakeFraction in the normal loop
+// (full IMU) and the rest in the monitor (accel-only IMU, light sleep)
+float nightMeanCurrentMa(float awakeFraction);
+
+#endif
@@ -0,0 +1,23 @@
+#include "night_session.h"
+#include <stddef.h>
+
+static uint32_t sessionCrc(const NightSession& session) {
+    return nightCrc32(0, &session, offsetof(NightSession, crc));
+}
+
+void nightSessionSeal(NightSession& session, uint32_t logCrc) {
+    session.magic = NIGHT_SESSION_MAGIC;
+    session.logCrc = logCrc;
+    session.crc = sessionCrc(session);
+}
+
+bool nightSessionValid(const NightSession& session, int64_t nowSec) {
+    if (session.magic != NIGHT_SESSION_MAGIC || session.crc != sessionCrc(session)) return false;
+    return nowSec >= session.startSec - NIGHT_SESSION_SKEW_SEC &&
+           nowSec - session.startSec <= NIGHT_SESSION_MAX_SEC;
+}
+
+void nightSessionClear(NightSession& session) {
+    session.magic = 0;
+    session.crc = 0;
+}
@@ -0,0 +1,37 @@
+#ifndef NIGHT_SESSION_H
+#define NIGHT_SESSION_H
+
+#include <stdint.h>
+#include "night_log.h"
+
+// Night session
+// What night mode needs to carry on after a brownout, watchdog reset or
+// deep sleep: when the night started, the pending REM cue and the cue
+// controller's state, all keyed to the wall clock (TimeBase::epochSec), plus
+// a checksum of the night log. It lives with the NightRecorder in
+// RTC_NOINIT memory, which keeps its contents through every reset except
+// power loss; the CRC tells a live session from leftover or random bytes.
+// A log that fails logCrc is restarted without ending the session.
+// No Arduino dependencies; tools/tests/night_session_test.cpp puts both
+// through power-on garbage, resets, deep sleep and flipped bits on a host.
+
+#define NIGHT_SESSION_MAGIC 0x4E534553UL  // "SESN"
+#define NIGHT_SESSION_MAX_SEC (16 * 3600L)  // Older than this is abandoned
+#define NIGHT_SESSION_SKEW_SEC 120          // Clock may read this much early after a reset
+
+struct NightSession {
+    int64_t startSec;     // Night mode entered, local epoch seconds
+    int64_t nextCueSec;   // Pending REM cue, 0 = none
+    uint32_t magic;
+    uint32_t logCrc;      // NightRecorder::checksum() when sealed
+    uint8_t cueLevel;     // CueAdapt state
+    uint8_t cueExtraMin;
+    uint16_t sleeps;      // Deep sleep cycles so far
+    uint32_t crc;         // Over every field above
+};
+
+void nightSessionSeal(NightSession& session, uint32_t logCrc);
+bool nightSessionValid(const NightSession& session, int64_t nowSec);
+void nightSessionClear(NightSession& session);
+
+#endif
@@ -0,0 +1,141 @@
+#include "night_store.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "memstats.h"
+
+static bool mounted = false;
+
+static void slotPath(int slot, char* path, size_t size) {
+    snprintf(path, size, NIGHT_STORE_DIR "/%02d.bin", slot);
+}
+
+static bool readHeader(File& file, NightHeader& header) {
+    return file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) && nightHeaderValid(header);
+}
+
+static bool readSlotHeader(int slot, NightHeader& header) {
+    MemExemptScope exempt(MEM_EXEMPT_FILE);
+    char path[24];
+    slotPath(slot, path, sizeof(path));
+    if (!LittleFS.exists(path)) return false;
+    File file = LittleFS.open(path, FILE_READ);
+    if (!file) return false;
+    bool ok = readHeader(file, header);
+    file.close();
+    return ok;
+}
+
+// Valid slots, newest first
+static int sortedSlots(int* slots) {
+    int64_t starts[NIGHT_STORE_SLOTS];
+    int count = 0;
+    if (!mounted) return 0;
+    for (int slot = 0; slot < NIGHT_STORE_SLOTS; slot++) {
+        NightHeader header;
+        if (!readSlotHeader(slot, header)) continue;
+        int i = count++;
+        while (i > 0 && starts[i - 1] < header.startSec) {
+            starts[i] = starts[i - 1];
+            slots[i] = slots[i - 1];
+            i--;
+        }
+        starts[i] = header.startSec;
+        slots[i] = slot;
+    }
+    return count;
+}
+
+bool NightStore::begin() {
+    mounted = LittleFS.begin(true);
+    if (!mounted) {
+        Serial.println("Warning: LittleFS mount failed - nights won't be kept");
+        return false;
+    }
+    LittleFS.mkdir(NIGHT_STORE_DIR);
+    return true;
+}
+
+bool NightStore::save(const NightHeader& header, const uint8_t* data) {
+    MemExemptScope exempt(MEM_EXEMPT_FILE);
+    if (!mounted || header.epochs < NIGHT_MIN_EPOCHS) return false;
+
+    // First empty slot, else the oldest night
+    int target = -1;
+    int64_t oldest = 0;
+    for (int slot = 0; slot < NIGHT_STORE_SLOTS; slot++) {
+        NightHeader existing;
+        if (!readSlotHeader(slot, existing)) {
+            target = slot;
+            break;
+        }
+        if (target < 0 || existing.startSec < oldest) {
+            target = slot;
+            oldest = existing.startSec;
+        }
+    }
+
+    char path[24];
+    slotPath(target, path, sizeof(path));
+    File file = LittleFS.open(path, FILE_WRITE);
+    if (!file) return false;
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              file.write(data, header.bytes) == header.bytes;
+    file.close();
+    if (!ok) LittleFS.remove(path);  // Never leave a torn night behind
+    logPrintf("Night saved to slot %d: %u epochs, %u bytes, %u cues\n",
+              target, header.epochs, header.bytes, header.cues);
+    return ok;
+}
+
+bool NightStore::load(int slot, NightHeader& header, uint8_t* data) {
+    MemExemptScope exempt(MEM_EXEMPT_FILE);
+    if (!mounted || slot < 0 || slot >= NIGHT_STORE_SLOTS) return false;
+    char path[24];
+    slotPath(slot, path, sizeof(path));
+    File file = LittleFS.open(path, FILE_READ);
+    if (!file) return false;
+    bool ok = readHeader(file, header) && file.read(data, header.bytes) == header.bytes;
+    file.close();
+    return ok;
+}
+
+int NightStore::find(int age) {
+    int slots[NIGHT_STORE_SLOTS];
+    int count = sortedSlots(slots);
+    return (age >= 0 && age < count) ? slots[age] : -1;
+}
+
+int NightStore::count() {
+    int slots[NIGHT_STORE_SLOTS];
+    return sortedSlots(slots);
+}
+
+// {"night":{...header...}}, then the packed epochs as hex lines
+void NightStore::dump() {
+    MemExemptScope exempt(MEM_EXEMPT_FILE);
+    int slots[NIGHT_STORE_SLOTS];
+    int count = sortedSlots(slots);
+    for (int i = count - 1; i >= 0; i--) {
+        char path[24];
+        slotPath(slots[i], path, sizeof(path));
+        File file = LittleFS.open(path, FILE_READ);
+        NightHeader header;
+        if (!file || !readHeader(file, header)) continue;
+
+        logPrintf("{\"night\":{\"slot\":%d,\"start\":%lu,\"epoch_s\":%u,\"epochs\":%u,\"bytes\":%u,\"cues\":%u}}\n",
+                  slots[i], (unsigned long)header.startSec, header.epochSec, header.epochs,
+                  header.bytes, header.cues);
+        uint8_t chunk[NIGHT_DUMP_BYTES_PER_LINE];
+        char hex[NIGHT_DUMP_BYTES_PER_LINE * 2 + 1];
+        int left = header.bytes;
+        while (left > 0) {
+            int n = file.read(chunk, left < NIGHT_DUMP_BYTES_PER_LINE ? left : NIGHT_DUMP_BYTES_PER_LINE);
+            if (n <= 0) break;
+            for (int k = 0; k < n; k++) snprintf(hex + k * 2, 3, "%02x", chunk[k]);
+            logPrintf("{\"night_data\":\"%s\"}\n", hex);
+            left -= n;
+        }
+        file.close();
+    }
+    logPrintf("{\"nights_end\":%d}\n", count);
+}
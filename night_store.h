@@ -0,0 +1,29 @@
+#ifndef NIGHT_STORE_H
+#define NIGHT_STORE_H
+
+#include "night_log.h"
+
+// Stored nights
+// One LittleFS file per night (NightHeader + packed epochs, see
+// night_log.h) in NIGHT_STORE_SLOTS fixed slots; a new night takes an
+// empty slot or replaces the oldest. A still night is ~0.2 KB and a
+// restless one under 2 KB, so a month fits easily in the data partition.
+// File I/O allocates, so this only runs when night mode ends, when the
+// sleep report opens and on the `nights` serial command.
+
+#define NIGHT_STORE_DIR "/nights"
+#define NIGHT_STORE_SLOTS 32
+#define NIGHT_MIN_EPOCHS 20        // Under 10 min isn't a night worth keeping
+#define NIGHT_DUMP_BYTES_PER_LINE 64
+
+class NightStore {
+public:
+    static bool begin();  // Mount LittleFS, formatting it on first use
+    static bool save(const NightHeader& header, const uint8_t* data);
+    static bool load(int slot, NightHeader& header, uint8_t* data);  // data holds NIGHT_LOG_BYTES
+    static int find(int age);  // Slot of the age-th newest night (0 = last), -1 if none
+    static int count();
+    static void dump();        // Every night, oldest first, for tools/nights_to_csv.py
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "pcprof.h"
+
+#ifdef LUCID_PCPROF_HZ
+
+#include <Arduino.h>
+#include <freertos/xtensa_context.h>
+#include "memstats.h"
+
+struct CoreTable {
+    PcSample slots[PCPROF_SLOTS];
+    uint32_t samples;
+    uint32_t dropped;  // Table full along the probe sequence
+    uint32_t nested;   // Timer fired inside another ISR; no task frame to read
+};
+
+static DRAM_ATTR CoreTable tables[portNUM_PROCESSORS];
+static DRAM_ATTR volatile bool paused = false;
+static uint32_t rateHz = 0;
+static hw_timer_t* timers[portNUM_PROCESSORS];
+
+// FreeRTOS port internals: the TCB starts with pxTopOfStack, and on entry to
+// a non-nested interrupt the port stores the interrupted task's exception
+// frame (XtExcFrame) there before switching to the ISR stack.
+extern "C" void* volatile pxCurrentTCB[portNUM_PROCESSORS];
+extern "C" uint32_t port_interruptNesting[portNUM_PROCESSORS];
+
+static void IRAM_ATTR sampleIsr() {
+    int core = xPortGetCoreID();
+    CoreTable& t = tables[core];
+    if (paused) return;
+    t.samples++;
+
+    if (port_interruptNesting[core] > 1 || !pxCurrentTCB[core]) {
+        t.nested++;
+        return;
+    }
+    uint8_t* frame = *(uint8_t* volatile*)pxCurrentTCB[core];
+    uint32_t pc = *(uint32_t*)(frame + XT_STK_PC);
+    uint32_t a0 = *(uint32_t*)(frame + XT_STK_A0);
+    // a0 holds the return address with the caller's window size in the top
+    // two bits; put back the instruction-bus region bits
+    uint32_t caller = (a0 & 0x3FFFFFFF) | 0x40000000;
+
+    uint32_t h = ((pc >> 2) ^ (caller << 3)) * 2654435761u;
+    for (int probe = 0; probe < PCPROF_PROBES; probe++) {
+        PcSample& s = t.slots[(h + probe) & (PCPROF_SLOTS - 1)];
+        if (s.count == 0) {
+            s.pc = pc;
+            s.caller = caller;
+            s.count = 1;
+            return;
+        }
+        if (s.pc == pc && s.caller == caller) {
+            s.count++;
+            return;
+        }
+    }
+    t.dropped++;
+}
+
+// Interrupts are routed to the core that attaches them
+static void startTimer(int core) {
+    hw_timer_t* timer = timerBegin(PCPROF_TIMER_BASE + core, 80, true);  // 1 MHz tick
+    timerAttachInterrupt(timer, sampleIsr, true);
+    timerAlarmWrite(timer, 1000000UL / rateHz, true);
+    timerAlarmEnable(timer);
+    timers[core] = timer;
+}
+
+static void startOnCore0(void*) {
+    startTimer(0);
+    vTaskDelete(NULL);
+}
+
+void PcProf::begin(uint32_t hz) {
+    rateHz = hz;
+    reset();
+    startTimer(xPortGetCoreID());
+    xTaskCreatePinnedToCore(startOnCore0, "pcprof", 2048, NULL, 1, NULL, 0);
+}
+
+void PcProf::reset() {
+    paused = true;
+    memset(tables, 0, sizeof(tables));
+    paused = false;
+}
+
+// One header line, one line per (core, pc, caller), one footer line
+void PcProf::dump() {
+    paused = true;
+    logPrintf("{\"pcprof_begin\":{\"hz\":%lu,\"cores\":[", (unsigned long)rateHz);
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        logPrintf("%s{\"samples\":%lu,\"dropped\":%lu,\"nested\":%lu}", c ? "," : "",
+                  (unsigned long)tables[c].samples, (unsigned long)tables[c].dropped,
+                  (unsigned long)tables[c].nested);
+    }
+    logPrintf("]}}\n");
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        for (int i = 0; i < PCPROF_SLOTS; i++) {
+            const PcSample& s = tables[c].slots[i];
+            if (s.count == 0) continue;
+            logPrintf("{\"pcprof\":[%d,\"0x%08lx\",\"0x%08lx\",%lu]}\n", c,
+                      (unsigned long)s.pc, (unsigned long)s.caller, (unsigned long)s.count);
+        }
+    }
+    logPrintf("{\"pcprof_end\":true}\n");
+    paused = false;
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef PCPROF_H
+#define PCPROF_H
+
+#include <stdint.h>
+
+// Statistical PC profiler
+// Build with -DLUCID_PCPROF_HZ=<rate> (m5stick-c-plus2-pcprof env). A
+// hardware timer on each core interrupts at that rate and the ISR records
+// the interrupted program counter and its caller in a fixed per-core hash
+// table. This finds hotspots the stage timers can't see, such as inside
+// M5GFX text rendering or the I2C drivers. The `pcprof` serial command dumps
+// the table; tools/pcprof_fold.py symbolizes it against the firmware ELF into
+// folded stacks for flamegraph.pl / speedscope.
+
+#define PCPROF_SLOTS 512     // Per core, power of two
+#define PCPROF_PROBES 8      // Linear probe limit before a sample is dropped
+#define PCPROF_TIMER_BASE 2  // Hardware timers 2 and 3 (group 1)
+
+struct PcSample {
+    uint32_t pc;
+    uint32_t caller;
+    uint32_t count;
+};
+
+class PcProf {
+public:
+    static void begin(uint32_t hz);  // From setup(); starts a timer on each core
+    static void reset();
+    static void dump();              // JSON lines, see tools/pcprof_fold.py
+};
+
+#endif
@@ -0,0 +1,122 @@
+#include "profiler.h"
+
+#ifdef LUCID_PROFILE
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "memstats.h"
+#define PROFILE_PRINTF logPrintf
+#else
+#include <chrono>
+#include <stdio.h>
+#define PROFILE_PRINTF printf
+#endif
+
+StageStats Profiler::stats[STAGE_COUNT];
+
+static const char* STAGE_NAMES[STAGE_COUNT] = {
+    "m5_update",
+    "imu",
+    "screen_timeout",
+    "events",
+    "rtc_read",
+    "render",
+    "input",
+    "loop"
+};
+
+uint32_t Profiler::cycles() {
+#ifdef ARDUINO
+    return ESP.getCycleCount();
+#else
+    // Host build: nanoseconds stand in for CPU cycles
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+#endif
+}
+
+uint32_t Profiler::cyclesPerMicro() {
+#ifdef ARDUINO
+    return getCpuFrequencyMhz();
+#else
+    return 1000;
+#endif
+}
+
+// Bucket = 2 * floor(log2(cycles)) + the bit below the leading one
+int Profiler::bucketFor(uint32_t cycles) {
+    if (cycles < 2) return 0;
+    int msb = 31 - __builtin_clz(cycles);
+    int half = (cycles >> (msb - 1)) & 1;
+    return msb * 2 + half;
+}
+
+uint32_t Profiler::bucketUpperBound(int bucket) {
+    if (bucket < 2) return 1;
+    int msb = bucket / 2;
+    uint64_t base = 1ULL << msb;
+    uint64_t upper = (bucket & 1) ? (base << 1) - 1 : base + (base >> 1) - 1;
+    return upper > 0xFFFFFFFFULL ? 0xFFFFFFFFUL : (uint32_t)upper;
+}
+
+void Profiler::record(int stage, uint32_t cycles) {
+    StageStats& s = stats[stage];
+    if (s.count == 0 || cycles < s.minCycles) s.minCycles = cycles;
+    if (cycles > s.maxCycles) s.maxCycles = cycles;
+    s.count++;
+    s.totalCycles += cycles;
+    s.buckets[bucketFor(cycles)]++;
+}
+
+void Profiler::reset() {
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        stats[i] = StageStats();
+    }
+}
+
+const StageStats& Profiler::get(int stage) {
+    return stats[stage];
+}
+
+uint32_t Profiler::meanCycles(int stage) {
+    const StageStats& s = stats[stage];
+    if (s.count == 0) return 0;
+    return (uint32_t)(s.totalCycles / s.count);
+}
+
+// Upper bound of the bucket holding the requested percentile, clamped to max
+uint32_t Profiler::percentileCycles(int stage, int percent) {
+    const StageStats& s = stats[stage];
+    if (s.count == 0) return 0;
+
+    uint32_t target = (uint32_t)(((uint64_t)s.count * percent + 99) / 100);
+    uint32_t seen = 0;
+    for (int b = 0; b < PROFILE_BUCKETS; b++) {
+        seen += s.buckets[b];
+        if (seen >= target) {
+            uint32_t upper = bucketUpperBound(b);
+            return upper < s.maxCycles ? upper : s.maxCycles;
+        }
+    }
+    return s.maxCycles;
+}
+
+const char* Profiler::stageName(int stage) {
+    return (stage >= 0 && stage < STAGE_COUNT) ? STAGE_NAMES[stage] : "?";
+}
+
+// One JSON object per dump so runs can be diffed across firmware versions
+void Profiler::dump() {
+    uint32_t cpm = cyclesPerMicro();
+    PROFILE_PRINTF("{\"profile\":{\"cycles_per_us\":%lu,\"stages\":[", (unsigned long)cpm);
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        const StageStats& s = stats[i];
+        PROFILE_PRINTF("%s{\"name\":\"%s\",\"count\":%lu,\"min\":%lu,\"mean\":%lu,\"p99\":%lu,\"max\":%lu}",
+                       i ? "," : "", STAGE_NAMES[i], (unsigned long)s.count,
+                       (unsigned long)s.minCycles, (unsigned long)meanCycles(i),
+                       (unsigned long)percentileCycles(i, 99), (unsigned long)s.maxCycles);
+    }
+    PROFILE_PRINTF("]}}\n");
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+// Per-stage loop() profiler
+// Build with -DLUCID_PROFILE to enable. Without it every PROFILE_* macro
+// compiles to nothing and no profiler state is linked in.
+
+enum ProfileStage {
+    STAGE_M5_UPDATE,
+    STAGE_IMU,
+    STAGE_SCREEN_TIMEOUT,
+    STAGE_EVENTS,
+    STAGE_RTC_READ,
+    STAGE_RENDER,
+    STAGE_INPUT,
+    STAGE_LOOP,
+    STAGE_COUNT
+};
+
+// Histogram buckets: two per power of two, covering the full 32-bit cycle range
+#define PROFILE_BUCKETS 64
+
+struct StageStats {
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+    uint32_t buckets[PROFILE_BUCKETS];
+};
+
+class Profiler {
+private:
+    static StageStats stats[STAGE_COUNT];
+
+    static int bucketFor(uint32_t cycles);
+    static uint32_t bucketUpperBound(int bucket);
+
+public:
+    static uint32_t cycles();
+    static uint32_t cyclesPerMicro();
+    static void record(int stage, uint32_t cycles);
+    static void reset();
+    static const StageStats& get(int stage);
+    static uint32_t meanCycles(int stage);
+    static uint32_t percentileCycles(int stage, int percent);
+    static const char* stageName(int stage);
+    static void dump();
+};
+
+#ifdef LUCID_PROFILE
+#define PROFILE_BEGIN(stage) uint32_t _prof_start_##stage = Profiler::cycles()
+#define PROFILE_END(stage) Profiler::record(stage, Profiler::cycles() - _prof_start_##stage)
+#else
+#define PROFILE_BEGIN(stage) do {} while (0)
+#define PROFILE_END(stage) do {} while (0)
+#endif
+
+#endif
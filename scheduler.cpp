@@ -0,0 +1,167 @@
+#include "scheduler.h"
+
+struct KindRule {
+    uint8_t priority;
+    int32_t staleS;
+};
+
+static const KindRule RULES[EVENT_KIND_COUNT] = {
+    {2, 10 * 60},  // EVENT_REALITY_CHECK
+    {3, 30 * 60},  // EVENT_MORNING_ALARM
+    {1, 2 * 60},   // EVENT_REM_CUE
+    {2, 30 * 60},  // EVENT_WAKE_WINDOW
+};
+
+EventScheduler::EventScheduler() {
+    clear();
+}
+
+void EventScheduler::clear() {
+    count = 0;
+    lastFireSec = 0;
+}
+
+uint8_t EventScheduler::priorityOf(uint8_t kind) {
+    return kind < EVENT_KIND_COUNT ? RULES[kind].priority : 0;
+}
+
+int32_t EventScheduler::staleLimitS(uint8_t kind) {
+    return kind < EVENT_KIND_COUNT ? RULES[kind].staleS : 0;
+}
+
+int64_t EventScheduler::nextDaily(int64_t afterSec, int32_t secOfDay) {
+    int64_t due = afterSec - afterSec % 86400 + secOfDay;
+    return due > afterSec ? due : due + 86400;
+}
+
+bool EventScheduler::checkIntervalRange(int perDay, int& minMin, int& maxMin) {
+    if (perDay <= 0) return false;
+    int avg = SCHED_AWAKE_MIN / perDay;
+    int spread = avg * SCHED_CHECK_SPREAD_PCT / 100;
+    minMin = avg - spread;
+    maxMin = avg + spread;
+    return true;
+}
+
+// Earlier first; equal times by priority
+bool EventScheduler::before(const TimedEvent& a, const TimedEvent& b) {
+    if (a.dueSec != b.dueSec) return a.dueSec < b.dueSec;
+    return a.priority > b.priority;
+}
+
+void EventScheduler::siftUp(int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!before(heap[i], heap[parent])) break;
+        TimedEvent t = heap[i];
+        heap[i] = heap[parent];
+        heap[parent] = t;
+        i = parent;
+    }
+}
+
+void EventScheduler::siftDown(int i) {
+    for (;;) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < count && before(heap[left], heap[smallest])) smallest = left;
+        if (right < count && before(heap[right], heap[smallest])) smallest = right;
+        if (smallest == i) break;
+        TimedEvent t = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = t;
+        i = smallest;
+    }
+}
+
+void EventScheduler::removeAt(int i) {
+    heap[i] = heap[--count];
+    if (i < count) {
+        siftDown(i);
+        siftUp(i);
+    }
+}
+
+int EventScheduler::find(uint8_t kind) {
+    for (int i = 0; i < count; i++) {
+        if (heap[i].kind == kind) return i;
+    }
+    return -1;
+}
+
+void EventScheduler::insert(int64_t dueSec, uint8_t kind) {
+    int i = find(kind);
+    if (i >= 0) removeAt(i);
+    if (count >= SCHED_CAPACITY) return;  // One per kind, so never
+    heap[count].dueSec = dueSec;
+    heap[count].kind = kind;
+    heap[count].priority = priorityOf(kind);
+    siftUp(count++);
+}
+
+// Don't ask for a reality check just before or while the dream journal
+// alarm is waking the user
+void EventScheduler::applyMorningGuard() {
+    int rc = find(EVENT_REALITY_CHECK);
+    int morning = find(EVENT_MORNING_ALARM);
+    if (rc < 0 || morning < 0) return;
+    int64_t gap = heap[rc].dueSec - heap[morning].dueSec;
+    if (gap > -SCHED_MORNING_GUARD_S && gap < SCHED_MORNING_GUARD_S) {
+        insert(heap[morning].dueSec + SCHED_MORNING_GUARD_S, EVENT_REALITY_CHECK);
+    }
+}
+
+void EventScheduler::schedule(uint8_t kind, int64_t dueSec) {
+    if (kind >= EVENT_KIND_COUNT) return;
+    insert(dueSec, kind);
+    applyMorningGuard();
+}
+
+void EventScheduler::cancel(uint8_t kind) {
+    int i = find(kind);
+    if (i >= 0) removeAt(i);
+}
+
+bool EventScheduler::isScheduled(uint8_t kind) {
+    return find(kind) >= 0;
+}
+
+int64_t EventScheduler::dueOf(uint8_t kind) {
+    int i = find(kind);
+    return i >= 0 ? heap[i].dueSec : 0;
+}
+
+bool EventScheduler::nextDeadline(int64_t& dueSec) {
+    if (count == 0) return false;
+    dueSec = heap[0].dueSec;
+    return true;
+}
+
+SchedResult EventScheduler::poll(int64_t nowSec, uint32_t allowedKinds, TimedEvent& event) {
+    // Missed events first, whatever is allowed
+    for (int i = 0; i < count; i++) {
+        int64_t late = nowSec - heap[i].dueSec;
+        if (late > staleLimitS(heap[i].kind) || -late > SCHED_MAX_AHEAD_S) {
+            event = heap[i];
+            removeAt(i);
+            return SCHED_MISSED;
+        }
+    }
+
+    if (count == 0 || heap[0].dueSec > nowSec) return SCHED_NONE;
+    if (nowSec - lastFireSec < SCHED_MIN_GAP_S) return SCHED_NONE;
+
+    // Highest priority among the due events that may fire now
+    int pick = -1;
+    for (int i = 0; i < count; i++) {
+        if (heap[i].dueSec > nowSec || !(allowedKinds & EVENT_BIT(heap[i].kind))) continue;
+        if (pick < 0 || heap[i].priority > heap[pick].priority) pick = i;
+    }
+    if (pick < 0) return SCHED_NONE;
+
+    event = heap[pick];
+    removeAt(pick);
+    lastFireSec = nowSec;
+    return SCHED_FIRE;
+}
@@ -0,0 +1,93 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+// Timed event scheduler
+// Random reality checks, the morning alarm, the start of its smart wake
+// window (see smart_wake.h) and night-mode REM cues share one
+// min-heap ordered by due time (local epoch seconds, see timebase.h), at
+// most one event per kind. Collision rules:
+//   - a reality check within SCHED_MORNING_GUARD_S of the morning alarm is
+//     moved to just after it
+//   - events fire at least SCHED_MIN_GAP_S apart; when two are due together
+//     the higher priority goes first and the other waits
+//   - an event overdue by more than its kind's stale limit (watch off, clock
+//     set forward) or more than SCHED_MAX_AHEAD_S away (clock set back) is
+//     handed back as missed so the owner can reschedule it
+// The caller passes which kinds may fire right now (e.g. no reality checks
+// in a menu); blocked events stay queued until they fire or go stale.
+// nextDeadline() is the earliest wake-up power management has to honour.
+// No Arduino dependencies; tools/tests/scheduler_test.cpp checks these rules
+// against random schedules on a host.
+
+#define SCHED_CAPACITY 8
+#define SCHED_MORNING_GUARD_S (20 * 60)
+#define SCHED_MIN_GAP_S 60
+#define SCHED_MAX_AHEAD_S (24 * 3600 + 3600)
+#define SCHED_AWAKE_MIN 960          // Reality checks spread over 16 waking hours
+#define SCHED_CHECK_SPREAD_PCT 30    // Intervals vary +/-30% around the mean
+
+enum EventKind : uint8_t {
+    EVENT_REALITY_CHECK,
+    EVENT_MORNING_ALARM,
+    EVENT_REM_CUE,
+    EVENT_WAKE_WINDOW,
+    EVENT_KIND_COUNT
+};
+
+#define EVENT_BIT(kind) (1u << (kind))
+
+enum SchedResult {
+    SCHED_NONE,
+    SCHED_FIRE,
+    SCHED_MISSED
+};
+
+struct TimedEvent {
+    int64_t dueSec;
+    uint8_t kind;      // EventKind
+    uint8_t priority;  // Higher fires first
+};
+
+class EventScheduler {
+private:
+    TimedEvent heap[SCHED_CAPACITY];
+    int count;
+    int64_t lastFireSec;
+
+    static bool before(const TimedEvent& a, const TimedEvent& b);
+    void siftUp(int i);
+    void siftDown(int i);
+    void removeAt(int i);
+    int find(uint8_t kind);
+    void insert(int64_t dueSec, uint8_t kind);
+    void applyMorningGuard();
+
+public:
+    EventScheduler();
+    void clear();
+
+    // Adds the event, replacing any pending one of the same kind
+    void schedule(uint8_t kind, int64_t dueSec);
+    void cancel(uint8_t kind);
+    bool isScheduled(uint8_t kind);
+    int64_t dueOf(uint8_t kind);   // 0 when not scheduled
+    bool nextDeadline(int64_t& dueSec);
+    int size() { return count; }
+
+    // At most one event per call; it is removed from the queue
+    SchedResult poll(int64_t nowSec, uint32_t allowedKinds, TimedEvent& event);
+
+    static uint8_t priorityOf(uint8_t kind);
+    static int32_t staleLimitS(uint8_t kind);
+
+    // First time after afterSec that the local clock reads secOfDay
+    static int64_t nextDaily(int64_t afterSec, int32_t secOfDay);
+
+    // Range (minutes) to draw the next reality check interval from at
+    // perDay checks a day. False for 0: reality checks are off.
+    static bool checkIntervalRange(int perDay, int& minMin, int& maxMin);
+};
+
+#endif
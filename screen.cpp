@@ -0,0 +1,75 @@
+#include "screen.h"
+#include "trace.h"
+
+ScreenStack::ScreenStack() {
+    depth = 0;
+    lastRender = 0;
+    dirty = true;
+    onTransition = 0;
+}
+
+void ScreenStack::setTransitionHook(void (*hook)()) {
+    onTransition = hook;
+}
+
+void ScreenStack::transition() {
+    if (onTransition) onTransition();
+    dirty = true;
+}
+
+void ScreenStack::setRoot(const Screen* root) {
+    popToRoot();
+    stack[0] = root;
+    depth = 1;
+    transition();
+    if (root->enter) root->enter();
+}
+
+void ScreenStack::push(const Screen* screen) {
+    if (depth >= SCREEN_STACK_DEPTH) return;  // Deeper nesting is a bug; stay put
+    stack[depth++] = screen;
+    TRACE_INSTANT(screen->name);
+    transition();
+    if (screen->enter) screen->enter();
+}
+
+void ScreenStack::pop() {
+    if (depth <= 1) return;  // Root stays
+    const Screen* leaving = stack[--depth];
+    if (leaving->exit) leaving->exit();
+    TRACE_INSTANT(stack[depth - 1]->name);
+    transition();  // Uncovered screen keeps its state, just redraws
+}
+
+void ScreenStack::popToRoot() {
+    while (depth > 1) pop();
+}
+
+const Screen* ScreenStack::top() {
+    return stack[depth - 1];
+}
+
+bool ScreenStack::isTop(const Screen* screen) {
+    return depth > 0 && stack[depth - 1] == screen;
+}
+
+void ScreenStack::tick(unsigned long now) {
+    const Screen* screen = stack[depth - 1];
+    if (screen->tick) screen->tick(now);
+}
+
+void ScreenStack::render(unsigned long now) {
+    const Screen* screen = stack[depth - 1];
+    if (screen->render && (dirty || now - lastRender >= screen->renderIntervalMs)) {
+        TRACE_BEGIN("render");
+        screen->render();
+        TRACE_END("render");
+        lastRender = now;
+        dirty = false;
+    }
+}
+
+void ScreenStack::input() {
+    const Screen* screen = stack[depth - 1];
+    if (screen->input) screen->input();
+}
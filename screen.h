@@ -0,0 +1,48 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+
+// Screen stack
+// Every UI state is a Screen with its own handlers. loop() only talks to the
+// screen on top of the stack, so there is no per-iteration mode/flag chain and
+// no way to be in two editing states at once. Any handler may be null.
+struct Screen {
+    const char* name;
+    unsigned long renderIntervalMs;  // Redraw period while on top
+    bool keepAwake;                  // Hold off the screen timeout
+    bool allowAlarms;                // Reality checks / morning alarm may interrupt
+    void (*enter)();                 // Pushed
+    void (*exit)();                  // Popped
+    void (*render)();
+    void (*input)();                 // Button handling, once per loop
+    void (*tick)(unsigned long now); // Timers, once per loop
+};
+
+#define SCREEN_STACK_DEPTH 6
+
+class ScreenStack {
+private:
+    const Screen* stack[SCREEN_STACK_DEPTH];
+    int depth;
+    unsigned long lastRender;
+    bool dirty;
+    void (*onTransition)();
+
+    void transition();
+
+public:
+    ScreenStack();
+    void setTransitionHook(void (*hook)());
+    void setRoot(const Screen* root);
+    void push(const Screen* screen);
+    void pop();
+    void popToRoot();
+    const Screen* top();
+    bool isTop(const Screen* screen);
+    int getDepth() { return depth; }
+    void invalidate() { dirty = true; }
+    void tick(unsigned long now);    // Top screen only, in this order each loop
+    void render(unsigned long now);
+    void input();
+};
+
+#endif
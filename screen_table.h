@@ -0,0 +1,57 @@
+// Screen table and menu, one row per entry (X-macros)
+// main.cpp expands the SCREEN rows into its Screen definitions and the
+// MENU_ITEM rows into MENU[]; tools/tests/screen_test.cpp expands the same
+// rows to walk the menu on a host. Define SCREEN and/or MENU_ITEM before
+// including - rows for an undefined macro are skipped - so there is no
+// include guard.
+//
+//   SCREEN(var, name, renderMs, keepAwake, allowAlarms, enter, exit, render, input, tick)
+//   MENU_ITEM(label, var) - in display order, opening the screen var
+
+#ifdef SCREEN
+SCREEN(clockScreen,         "Clock",         RENDER_MS, false, true,  NULL,              NULL,             clockRender,         clockInput,         clockTick)
+SCREEN(menuScreen,          "Menu",          200,       true,  false, menuEnter,         NULL,             drawMenuUI,          menuInput,          NULL)
+SCREEN(timeSetScreen,       "Set Time",      200,       true,  false, timeSetEnter,      NULL,             drawTimeSetUI,       timeSetInput,       NULL)
+SCREEN(realityCheckScreen,  "Reality Check", 200,       true,  false, NULL,              NULL,             drawRealityCheckUI,  realityCheckInput,  realityCheckTick)
+SCREEN(nightScreen,         "Night Mode",    1000,      false, false, nightEnter,        nightExit,        drawNightModeUI,     nightInput,         NULL)
+SCREEN(dreamJournalScreen,  "Dream Journal", 200,       false, false, dreamJournalEnter, dreamJournalExit, drawDreamJournalUI,  dreamJournalInput,  dreamJournalTick)
+SCREEN(alarmsPerDayScreen,  "Alarms/Day",    200,       true,  true,  NULL,              NULL,             drawAlarmsPerDayUI,  alarmsPerDayInput,  NULL)
+SCREEN(manualAlarmScreen,   "Morning Alarm", 200,       true,  true,  manualAlarmEnter,  NULL,             drawManualAlarmUI,   manualAlarmInput,   NULL)
+SCREEN(smartWakeScreen,     "Smart Wake",    200,       true,  true,  NULL,              NULL,             drawSmartWakeUI,     smartWakeInput,     NULL)
+SCREEN(screenTimeoutScreen, "Timeout",       200,       true,  true,  NULL,              NULL,             drawScreenTimeoutUI, screenTimeoutInput, NULL)
+SCREEN(sensitivityScreen,   "Shake Sense",   200,       true,  true,  NULL,              NULL,             drawSensitivityUI,   sensitivityInput,   NULL)
+SCREEN(brightnessScreen,    "Brightness",    200,       true,  true,  NULL,              NULL,             drawBrightnessUI,    brightnessInput,    NULL)
+SCREEN(clockColorScreen,    "Clock Color",   200,       true,  true,  NULL,              NULL,             drawClockColorUI,    clockColorInput,    NULL)
+SCREEN(quietHoursScreen,    "Quiet Hours",   200,       false, true,  quietHoursEnter,   NULL,             drawQuietHoursUI,    quietHoursInput,    NULL)
+SCREEN(timeFormatScreen,    "Time Format",   200,       false, true,  NULL,              NULL,             drawTimeFormatUI,    timeFormatInput,    NULL)
+SCREEN(alwaysOnScreen,      "Always-On",     200,       true,  true,  NULL,              NULL,             drawAlwaysOnUI,      alwaysOnInput,      NULL)
+SCREEN(testRCScreen,        "Test RC",       200,       false, true,  testRCEnter,       NULL,             drawRealityCheckUI,  testRCInput,        NULL)
+SCREEN(motionRCScreen,      "Motion RC",     200,       true,  true,  NULL,              NULL,             drawMotionRCUI,      motionRCInput,      NULL)
+SCREEN(nightSleepScreen,    "Night Sleep",   200,       true,  true,  NULL,              NULL,             drawNightSleepUI,    nightSleepInput,    NULL)
+SCREEN(nightSoundScreen,    "Night Sound",   200,       true,  true,  NULL,              NULL,             drawNightSoundUI,    nightSoundInput,    NULL)
+SCREEN(cueOutputScreen,     "Cue Output",    200,       true,  true,  cueOutputEnter,    NULL,             drawCueOutputUI,     cueOutputInput,     NULL)
+SCREEN(sleepReportScreen,   "Sleep Report",  1000,      true,  true,  sleepReportEnter,  NULL,             drawSleepReportUI,   sleepReportInput,   NULL)
+#ifdef LUCID_PROFILE
+SCREEN(debugScreen,         "Profiler",      500,       true,  false, NULL,              NULL,             drawDebugUI,         debugInput,         NULL)
+#endif
+#endif
+
+#ifdef MENU_ITEM
+MENU_ITEM("Set Time",       timeSetScreen)
+MENU_ITEM("Morning Alarm",  manualAlarmScreen)
+MENU_ITEM("Smart Wake",     smartWakeScreen)
+MENU_ITEM("Alarms/Day",     alarmsPerDayScreen)
+MENU_ITEM("Quiet Hours",    quietHoursScreen)
+MENU_ITEM("12/24 Format",   timeFormatScreen)
+MENU_ITEM("Screen Timeout", screenTimeoutScreen)
+MENU_ITEM("Always-On Face", alwaysOnScreen)
+MENU_ITEM("Shake Sense",    sensitivityScreen)
+MENU_ITEM("Brightness",     brightnessScreen)
+MENU_ITEM("Clock Color",    clockColorScreen)
+MENU_ITEM("Test RC",        testRCScreen)  // Reality Check test
+MENU_ITEM("Motion RC",      motionRCScreen)
+MENU_ITEM("Night Sleep",    nightSleepScreen)
+MENU_ITEM("Night Sound",    nightSoundScreen)
+MENU_ITEM("Cue Output",     cueOutputScreen)
+MENU_ITEM("Sleep Report",   sleepReportScreen)
+#endif
@@ -1,4 +1,5 @@
 #include "settings.h"
+#include <stdio.h>
 
 Settings::Settings() {
     checksPerDay = DEFAULT_CHECKS_PER_DAY;
@@ -21,31 +22,33 @@ void Settings::begin() {
 
 void Settings::load() {
     checksPerDay = prefs.getInt(NVS_CHECKS_PER_DAY, DEFAULT_CHECKS_PER_DAY);
-    lastAlarmTime = prefs.getULong(NVS_LAST_ALARM, 0);
-    nextAlarmTime = prefs.getULong(NVS_NEXT_ALARM, 0);
+    lastAlarmTime = prefs.getLong64(NVS_LAST_ALARM, 0);
+    nextAlarmTime = prefs.getLong64(NVS_NEXT_ALARM, 0);
     imuEnabled = prefs.getBool(NVS_IMU_ENABLED, false);
     quietHoursEnabled = prefs.getBool(NVS_QUIET_HOURS, true);
     brightness = prefs.getInt(NVS_BRIGHTNESS, DEFAULT_BRIGHTNESS);
     checkCount = prefs.getInt(NVS_CHECK_COUNT, 0);
     
     for (int i = 0; i < RC_TYPE_COUNT; i++) {
-        String key = String(NVS_RC_ENABLED) + String(i);
-        rcEnabled[i] = prefs.getBool(key.c_str(), true);
+        char key[16];
+        snprintf(key, sizeof(key), "%s%d", NVS_RC_ENABLED, i);
+        rcEnabled[i] = prefs.getBool(key, true);
     }
 }
 
 void Settings::save() {
     prefs.putInt(NVS_CHECKS_PER_DAY, checksPerDay);
-    prefs.putULong(NVS_LAST_ALARM, lastAlarmTime);
-    prefs.putULong(NVS_NEXT_ALARM, nextAlarmTime);
+    prefs.putLong64(NVS_LAST_ALARM, lastAlarmTime);
+    prefs.putLong64(NVS_NEXT_ALARM, nextAlarmTime);
     prefs.putBool(NVS_IMU_ENABLED, imuEnabled);
     prefs.putBool(NVS_QUIET_HOURS, quietHoursEnabled);
     prefs.putInt(NVS_BRIGHTNESS, brightness);
     prefs.putInt(NVS_CHECK_COUNT, checkCount);
     
     for (int i = 0; i < RC_TYPE_COUNT; i++) {
-        String key = String(NVS_RC_ENABLED) + String(i);
-        prefs.putBool(key.c_str(), rcEnabled[i]);
+        char key[16];
+        snprintf(key, sizeof(key), "%s%d", NVS_RC_ENABLED, i);
+        prefs.putBool(key, rcEnabled[i]);
     }
 }
 
@@ -56,12 +59,12 @@ void Settings::setChecksPerDay(int checks) {
     save();
 }
 
-void Settings::setLastAlarmTime(unsigned long time) {
+void Settings::setLastAlarmTime(int64_t time) {
     lastAlarmTime = time;
     save();
 }
 
-void Settings::setNextAlarmTime(unsigned long time) {
+void Settings::setNextAlarmTime(int64_t time) {
     nextAlarmTime = time;
     save();
 }
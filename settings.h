@@ -10,8 +10,8 @@ private:
     
 public:
     int checksPerDay;
-    unsigned long lastAlarmTime;
-    unsigned long nextAlarmTime;
+    int64_t lastAlarmTime;  // Local epoch seconds (TimeBase::epochSec)
+    int64_t nextAlarmTime;
     bool imuEnabled;
     bool rcEnabled[RC_TYPE_COUNT];
     bool quietHoursEnabled;
@@ -23,8 +23,8 @@ public:
     void load();
     void save();
     void setChecksPerDay(int checks);
-    void setLastAlarmTime(unsigned long time);
-    void setNextAlarmTime(unsigned long time);
+    void setLastAlarmTime(int64_t time);
+    void setNextAlarmTime(int64_t time);
     void setImuEnabled(bool enabled);
     void setRCEnabled(int type, bool enabled);
     void setQuietHours(bool enabled);
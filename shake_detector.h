@@ -0,0 +1,36 @@
+#ifndef SHAKE_DETECTOR_H
+#define SHAKE_DETECTOR_H
+
+#include <math.h>
+
+// Wake-on-shake detector behind the Light Tap .. Very Hard sensitivity levels
+// Fires when any accelerometer axis moves more than the threshold (g) between
+// consecutive samples. Its only state is the previous sample, so the
+// benchmark and tools/wrist_replay.cpp run their own copies.
+
+class ShakeDetector {
+private:
+    float lastX;
+    float lastY;
+    float lastZ;
+
+public:
+    ShakeDetector() : lastX(0), lastY(0), lastZ(0) {}
+
+    // Start from a known sample (otherwise the first one reads as a shake)
+    void reset(float ax, float ay, float az) {
+        lastX = ax;
+        lastY = ay;
+        lastZ = az;
+    }
+
+    // Feed one sample (accel in g). Returns true on a shake.
+    bool update(float ax, float ay, float az, float threshold) {
+        bool moved = fabsf(ax - lastX) > threshold || fabsf(ay - lastY) > threshold ||
+                     fabsf(az - lastZ) > threshold;
+        reset(ax, ay, az);
+        return moved;
+    }
+};
+
+#endif
@@ -0,0 +1,39 @@
+#include "smart_wake.h"
+
+SmartWake::SmartWake() {
+    reset();
+}
+
+void SmartWake::reset() {
+    lastX = 0;
+    lastY = 0;
+    lastZ = 0;
+    primed = false;
+    epochSamples = 0;
+    epochMoves = 0;
+    history = 0;
+    light = false;
+}
+
+bool SmartWake::update(float ax, float ay, float az) {
+    if (primed) {
+        float dx = ax - lastX;
+        float dy = ay - lastY;
+        float dz = az - lastZ;
+        if (dx * dx + dy * dy + dz * dz > SMART_WAKE_MOVE_G2) epochMoves++;
+    }
+    lastX = ax;
+    lastY = ay;
+    lastZ = az;
+    primed = true;
+
+    if (++epochSamples < SMART_WAKE_EPOCH_SAMPLES) return false;
+
+    bool active = epochMoves >= SMART_WAKE_EPOCH_ACTIVE;
+    history = ((history << 1) | (active ? 1 : 0)) & ((1 << SMART_WAKE_HISTORY) - 1);
+    epochSamples = 0;
+    epochMoves = 0;
+
+    light = __builtin_popcount(history) >= SMART_WAKE_ACTIVE_EPOCHS;
+    return light;
+}
@@ -0,0 +1,43 @@
+#ifndef SMART_WAKE_H
+#define SMART_WAKE_H
+
+#include <stdint.h>
+
+// Smart wake window
+// Actigraphy on the 10 Hz IMU stream during the minutes before the morning
+// alarm. Each epoch of SMART_WAKE_EPOCH_SAMPLES counts the samples whose
+// acceleration changed by more than SMART_WAKE_MOVE_G2 since the previous
+// one. Deep sleep is close to motionless; light sleep shows short bursts
+// (turning over, limb movement). Light sleep is reported when at least
+// SMART_WAKE_ACTIVE_EPOCHS of the last SMART_WAKE_HISTORY epochs were
+// active. O(1) per sample, a few bytes of state. No Arduino dependencies;
+// tools/tests/smart_wake_test.cpp replays synthetic night traces through
+// it on a host.
+
+#define SMART_WAKE_EPOCH_SAMPLES 300  // 30 s at 10 Hz
+#define SMART_WAKE_MOVE_G2 0.0025f    // (0.05 g)^2 between consecutive samples
+#define SMART_WAKE_EPOCH_ACTIVE 3     // Moving samples that make an epoch active
+#define SMART_WAKE_HISTORY 4          // Epochs considered (2 min)
+#define SMART_WAKE_ACTIVE_EPOCHS 2
+
+class SmartWake {
+private:
+    float lastX;
+    float lastY;
+    float lastZ;
+    bool primed;
+    int epochSamples;
+    int epochMoves;
+    uint8_t history;  // Bit per epoch, newest in bit 0
+    bool light;
+
+public:
+    SmartWake();
+    void reset();
+
+    // Feed one sample (accel in g). True when an epoch closes in light sleep.
+    bool update(float ax, float ay, float az);
+    bool isLightSleep() { return light; }
+};
+
+#endif
@@ -0,0 +1,64 @@
+#include "softclock.h"
+
+#define US_PER_SEC 1000000LL
+#define PPB 1000000000LL
+
+SoftClock::SoftClock() {
+    anchor.epochSec = 0;
+    anchor.timerUs = 0;
+    anchor.driftPpb = 0;
+    anchor.lastErrorUs = 0;
+    anchor.state = CLOCK_ANCHOR_NONE;
+    anchor.resyncs = 0;
+}
+
+void SoftClock::sync(int64_t epochSec, int64_t timerUs, bool atEdge) {
+    if (atEdge && anchor.state == CLOCK_ANCHOR_EDGE) {
+        int64_t error = nowUs(anchor, timerUs) - epochSec * US_PER_SEC;
+        int64_t elapsed = timerUs - anchor.timerUs;
+        if (error > -SOFTCLOCK_STEP_US && error < SOFTCLOCK_STEP_US && elapsed > 0) {
+            // Clock ahead: the timer runs fast, take some time away. Half
+            // the measured correction so a noisy edge can't swing it far.
+            int64_t drift = anchor.driftPpb - error * PPB / elapsed / 2;
+            if (drift > SOFTCLOCK_MAX_DRIFT_PPB) drift = SOFTCLOCK_MAX_DRIFT_PPB;
+            if (drift < -SOFTCLOCK_MAX_DRIFT_PPB) drift = -SOFTCLOCK_MAX_DRIFT_PPB;
+            anchor.driftPpb = (int32_t)drift;
+            anchor.lastErrorUs = (int32_t)error;
+            anchor.resyncs++;
+        }
+    }
+    anchor.epochSec = epochSec;
+    anchor.timerUs = timerUs;
+    anchor.state = atEdge ? CLOCK_ANCHOR_EDGE : CLOCK_ANCHOR_COARSE;
+}
+
+bool SoftClock::resyncDue(int64_t timerUs) {
+    if (anchor.state != CLOCK_ANCHOR_EDGE) return true;
+    int64_t interval = anchor.resyncs ? SOFTCLOCK_RESYNC_S : SOFTCLOCK_FIRST_RESYNC_S;
+    return timerUs - anchor.timerUs >= interval * US_PER_SEC;
+}
+
+void SoftClock::markCoarse() {
+    if (anchor.state == CLOCK_ANCHOR_EDGE) anchor.state = CLOCK_ANCHOR_COARSE;
+}
+
+int64_t SoftClock::edgeTimerUs(int64_t epochSec) {
+    int64_t wall = (epochSec - anchor.epochSec) * US_PER_SEC;
+    return anchor.timerUs + wall - wall * anchor.driftPpb / PPB;
+}
+
+int64_t SoftClock::nowUs(const ClockAnchor& a, int64_t timerUs) {
+    int64_t elapsed = timerUs - a.timerUs;
+    return a.epochSec * US_PER_SEC + elapsed + elapsed * a.driftPpb / PPB;
+}
+
+// Days from civil date (proleptic Gregorian), 1970-01-01 = 0
+int64_t SoftClock::toEpoch(int year, int month, int day, int hours, int minutes, int seconds) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yoe = year - era * 400;
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int64_t days = (int64_t)era * 146097 + doe - 719468;
+    return days * 86400 + hours * 3600 + minutes * 60 + seconds;
+}
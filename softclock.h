@@ -0,0 +1,60 @@
+#ifndef SOFTCLOCK_H
+#define SOFTCLOCK_H
+
+#include <stdint.h>
+
+// Software wall clock
+// The BM8563 is only read to resync. In between, wall time is the anchor (an
+// RTC second edge and the esp_timer time it was seen) plus elapsed esp_timer
+// time, corrected by the rate difference learned from successive resyncs.
+// Times are the RTC's local time as seconds / microseconds since 1970-01-01.
+// No Arduino dependencies; tools/tests/softclock_test.cpp replays a week of
+// resyncs against a simulated RTC.
+
+#define SOFTCLOCK_FIRST_RESYNC_S 300  // Early resync to learn the drift
+#define SOFTCLOCK_RESYNC_S 1800
+#define SOFTCLOCK_STEP_US 500000      // Larger errors mean the RTC was set
+#define SOFTCLOCK_MAX_DRIFT_PPB 200000
+
+enum ClockAnchorState : uint32_t {
+    CLOCK_ANCHOR_NONE,
+    CLOCK_ANCHOR_COARSE,  // Plain read, up to 1 s early; resync at once
+    CLOCK_ANCHOR_EDGE     // Seconds rollover seen within a few ms
+};
+
+// Plain words so it can be published through a SeqSnapshot
+struct ClockAnchor {
+    int64_t epochSec;     // RTC second that started at timerUs
+    int64_t timerUs;
+    int32_t driftPpb;     // esp_timer slow vs the RTC by this much (+ = add time)
+    int32_t lastErrorUs;  // Soft clock minus RTC at the last edge resync
+    uint32_t state;       // ClockAnchorState
+    uint32_t resyncs;
+};
+
+class SoftClock {
+private:
+    ClockAnchor anchor;
+
+public:
+    SoftClock();
+
+    // New anchor. atEdge: epochSec has just started (edge detected), so the
+    // error of the old anchor is measured and folded into the drift. A
+    // coarse sync (atEdge false, e.g. after the RTC was set) only anchors.
+    void sync(int64_t epochSec, int64_t timerUs, bool atEdge);
+    bool resyncDue(int64_t timerUs);
+
+    // The timer went through light sleep, where it runs off the RTC slow
+    // clock: keep the time, but resync at once and don't learn drift from it
+    void markCoarse();
+
+    // esp_timer time at which the RTC should reach epochSec
+    int64_t edgeTimerUs(int64_t epochSec);
+    const ClockAnchor& getAnchor() { return anchor; }
+
+    static int64_t nowUs(const ClockAnchor& a, int64_t timerUs);
+    static int64_t toEpoch(int year, int month, int day, int hours, int minutes, int seconds);
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "sound_features.h"
+
+#define COEFF_SHIFT 14
+#define FLOOR_RISE_WINDOWS (60 / SOUND_FLOOR_RISE_DB)
+
+// 2 cos(2 pi k / 256) in Q14 for k = 4, 8, 16, 32, 64 (125 Hz to 2 kHz)
+static const int32_t BAND_COEFF[SOUND_BANDS] = {32610, 32138, 30274, 23170, 0};
+
+SoundFeatures::SoundFeatures() {
+    reset();
+}
+
+void SoundFeatures::reset() {
+    floorDb = 0;
+    primed = false;
+    windowsSinceRise = 0;
+}
+
+// 10 log10(x) = 3.0103 log2(x); log2 from the top bit plus 8 bits of
+// mantissa (linear, within 0.3 dB)
+uint8_t SoundFeatures::powerDb(uint64_t meanSquare) {
+    if (meanSquare <= 1) return 0;
+    int msb = 63;
+    while (!(meanSquare >> msb)) msb--;
+    uint32_t mantissa = msb >= 8 ? (uint32_t)(meanSquare >> (msb - 8)) & 0xFF
+                                 : (uint32_t)(meanSquare << (8 - msb)) & 0xFF;
+    uint32_t log2Q8 = ((uint32_t)msb << 8) | mantissa;
+    return (uint8_t)((log2Q8 * 771) >> 16);  // 3.0103 in Q8
+}
+
+SoundEvent SoundFeatures::process(const int16_t* pcm, SoundFrame& frame) {
+    uint64_t energy = 0;
+    uint64_t bandPower[SOUND_BANDS] = {0};
+
+    for (int block = 0; block < SOUND_WINDOW_SAMPLES; block += SOUND_BLOCK_SAMPLES) {
+        const int16_t* x = pcm + block;
+        int32_t sum = 0;
+        for (int i = 0; i < SOUND_BLOCK_SAMPLES; i++) sum += x[i];
+        int32_t dc = sum / SOUND_BLOCK_SAMPLES;
+
+        int32_t s1[SOUND_BANDS] = {0};
+        int32_t s2[SOUND_BANDS] = {0};
+        for (int i = 0; i < SOUND_BLOCK_SAMPLES; i++) {
+            int32_t v = x[i] - dc;
+            energy += (uint64_t)((int64_t)v * v);
+            for (int b = 0; b < SOUND_BANDS; b++) {
+                int32_t s = v + (int32_t)(((int64_t)BAND_COEFF[b] * s1[b]) >> COEFF_SHIFT) - s2[b];
+                s2[b] = s1[b];
+                s1[b] = s;
+            }
+        }
+        // |X|^2; a tone of amplitude A in the bin gives (A N / 2)^2
+        for (int b = 0; b < SOUND_BANDS; b++) {
+            int64_t a = s1[b];
+            int64_t c = s2[b];
+            int64_t p = a * a + c * c - ((BAND_COEFF[b] * a >> COEFF_SHIFT) * c);
+            if (p > 0) bandPower[b] += (uint64_t)p;
+        }
+    }
+
+    // Mean square, so the bands read like the level (A^2 / 2 for a tone)
+    const int blocks = SOUND_WINDOW_SAMPLES / SOUND_BLOCK_SAMPLES;
+    frame.levelDb = powerDb(energy / SOUND_WINDOW_SAMPLES);
+    for (int b = 0; b < SOUND_BANDS; b++) {
+        frame.bandDb[b] = powerDb(2 * bandPower[b] / blocks / (SOUND_BLOCK_SAMPLES * SOUND_BLOCK_SAMPLES));
+    }
+
+    if (!primed || frame.levelDb < floorDb) {
+        floorDb = frame.levelDb;
+        primed = true;
+        windowsSinceRise = 0;
+    } else if (++windowsSinceRise >= FLOOR_RISE_WINDOWS) {
+        floorDb++;
+        windowsSinceRise = 0;
+    }
+    frame.floorDb = floorDb;
+
+    int above = frame.levelDb - floorDb;
+    int low = frame.bandDb[0] > frame.bandDb[1] ? frame.bandDb[0] : frame.bandDb[1];
+    int high = frame.bandDb[3] > frame.bandDb[4] ? frame.bandDb[3] : frame.bandDb[4];
+    bool lowDominated = low - high >= SOUND_LOW_DOMINANCE_DB;
+
+    SoundEvent event = SOUND_QUIET;
+    if (above >= SOUND_LOUD_DB || (above >= SOUND_NOISE_DB && !lowDominated)) {
+        event = SOUND_NOISE;
+    } else if (above >= SOUND_SNORE_DB && lowDominated) {
+        event = SOUND_SNORE;
+    }
+    frame.event = event;
+    return event;
+}
+
+const char* SoundFeatures::eventName(SoundEvent event) {
+    switch (event) {
+        case SOUND_SNORE: return "snore";
+        case SOUND_NOISE: return "noise";
+        default: return "quiet";
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef SOUND_FEATURES_H
+#define SOUND_FEATURES_H
+
+#include <stdint.h>
+
+// Night sound features
+// Once a second the mic records a SOUND_WINDOW_SAMPLES window (a quarter of
+// the second, so the DSP runs at a 25% duty cycle). Each window gives:
+//   level  - mean power in dB re 1 LSB^2, after removing the mic's DC offset
+//   bands  - Goertzel power at 125, 250, 500, 1000 and 2000 Hz, same scale,
+//            over 32 ms blocks (31 Hz bins) averaged across the window
+// and is classified against a noise floor that follows the quietest
+// windows (drops at once, rises SOUND_FLOOR_RISE_DB a minute):
+//   noise - SOUND_LOUD_DB over the floor, or SOUND_NOISE_DB over it and
+//           not dominated by the low bands (traffic, voices, a door)
+//   snore - SOUND_SNORE_DB over the floor with the 125/250 Hz bands at
+//           least SOUND_LOW_DOMINANCE_DB above 1/2 kHz
+//   quiet - anything else
+// Fixed point throughout (int32 filters, int64 power, integer log). No
+// Arduino dependencies; tools/tests/sound_features_test.cpp runs it on a
+// host against synthetic windows or a WAV recording.
+
+#define SOUND_SAMPLE_RATE 8000
+#define SOUND_WINDOW_SAMPLES 2048   // 256 ms
+#define SOUND_BLOCK_SAMPLES 256     // Goertzel block
+#define SOUND_BANDS 5
+#define SOUND_SNORE_DB 8
+#define SOUND_NOISE_DB 15
+#define SOUND_LOUD_DB 25
+#define SOUND_LOW_DOMINANCE_DB 6
+#define SOUND_FLOOR_RISE_DB 2       // Per minute (60 windows)
+
+enum SoundEvent : uint8_t {
+    SOUND_QUIET,
+    SOUND_SNORE,
+    SOUND_NOISE
+};
+
+struct SoundFrame {
+    uint8_t levelDb;
+    uint8_t bandDb[SOUND_BANDS];
+    uint8_t floorDb;
+    uint8_t event;  // SoundEvent
+};
+
+class SoundFeatures {
+private:
+    uint8_t floorDb;
+    bool primed;
+    uint8_t windowsSinceRise;
+
+public:
+    SoundFeatures();
+    void reset();
+
+    // One window of SOUND_WINDOW_SAMPLES; fills frame, returns its event
+    SoundEvent process(const int16_t* pcm, SoundFrame& frame);
+
+    static uint8_t powerDb(uint64_t meanSquare);
+    static const char* eventName(SoundEvent event);
+};
+
+#endif
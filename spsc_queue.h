@@ -0,0 +1,126 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// Lock-free hand-off between exactly one producer and one consumer task.
+// Neither side ever blocks or takes a lock, so the audio task can't be held
+// up by the UI drawing to the panel. Portable C++11 atomics, so
+// tools/tests/spsc_queue_test.cpp races them between host threads.
+
+// Fixed-size ring; N must be a power of two. One slot stays empty.
+template <typename T, uint32_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+
+private:
+    T items[N];
+    std::atomic<uint32_t> head;  // Next slot to write (producer)
+    std::atomic<uint32_t> tail;  // Next slot to read (consumer)
+    std::atomic<uint32_t> dropped;
+
+public:
+    SpscQueue() : head(0), tail(0), dropped(0) {}
+
+    // Producer only. Returns false (and counts a drop) when full.
+    bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t next = (h + 1) & (N - 1);
+        if (next == tail.load(std::memory_order_acquire)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        items[h] = item;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Returns false when empty.
+    bool pop(T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[t];
+        tail.store((t + 1) & (N - 1), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+
+    uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+// Whether an SpscQueue's consumer still has work, for the producer to ask.
+// A plain flag the consumer clears when it runs dry races with a producer
+// setting it for a new item; here the producer counts what it sent and the
+// consumer, once idle, publishes the count it had seen before its last
+// drain. Anything sent after that drain keeps the two apart, so active()
+// holds from mark() until the consumer has taken the item.
+class SpscActivity {
+private:
+    std::atomic<uint32_t> marked;   // Producer
+    std::atomic<uint32_t> settled;  // Consumer
+    uint32_t drained;               // Consumer only: marked as of its last drain
+
+public:
+    SpscActivity() : marked(0), settled(0), drained(0) {}
+
+    void mark() { marked.fetch_add(1, std::memory_order_release); }   // Producer, after push()
+    void beginDrain() { drained = marked.load(std::memory_order_acquire); }  // Consumer, before pop()
+    void idle() { settled.store(drained, std::memory_order_release); }  // Consumer, out of work
+    bool active() const {
+        return marked.load(std::memory_order_acquire) != settled.load(std::memory_order_acquire);
+    }
+};
+
+// Single-writer, many-reader snapshot (seqlock). The writer never waits;
+// readers retry in the rare case they overlap a publish. The payload is
+// copied through relaxed atomic words so concurrent access is well defined.
+template <typename T>
+class SeqSnapshot {
+    static_assert(sizeof(T) % sizeof(uint32_t) == 0, "SeqSnapshot payload must be a whole number of words");
+
+private:
+    static const int WORDS = sizeof(T) / sizeof(uint32_t);
+    std::atomic<uint32_t> seq;  // Odd while a publish is in progress
+    std::atomic<uint32_t> words[WORDS];
+
+public:
+    SeqSnapshot() : seq(0) {
+        for (int i = 0; i < WORDS; i++) words[i].store(0, std::memory_order_relaxed);
+    }
+
+    // Writer only
+    void publish(const T& value) {
+        uint32_t raw[WORDS];
+        memcpy(raw, &value, sizeof(T));
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int i = 0; i < WORDS; i++) words[i].store(raw[i], std::memory_order_relaxed);
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    T read() const {
+        uint32_t raw[WORDS];
+        uint32_t before, after;
+        do {
+            before = seq.load(std::memory_order_acquire);
+            for (int i = 0; i < WORDS; i++) raw[i] = words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        T value;
+        memcpy(&value, raw, sizeof(T));
+        return value;
+    }
+
+    uint32_t version() const { return seq.load(std::memory_order_acquire) >> 1; }
+};
+
+#endif
@@ -0,0 +1,455 @@
+#include "tasks.h"
+#include "config.h"
+#include "spsc_queue.h"
+#include "softclock.h"
+#include "memstats.h"
+#include "trace.h"
+#include "wave_synth.h"
+#include "wave_player.h"
+#include <driver/ledc.h>
+
+struct CueCommand {
+    const CuePattern* pattern;  // NULL = stop
+};
+
+struct RtcCommand {
+    int8_t hours;
+    int8_t minutes;
+    int8_t seconds;
+};
+
+// Sensor -> UI
+static SpscQueue<ImuSample, IMU_QUEUE_SIZE> imuQueue;
+static SeqSnapshot<ClockAnchor> clockAnchor;
+// UI -> sensor / audio
+static SpscQueue<RtcCommand, RTC_QUEUE_SIZE> rtcQueue;
+static SpscQueue<CueCommand, CUE_QUEUE_SIZE> cueQueue;
+static SpscQueue<CueCommand, CUE_QUEUE_SIZE> lightQueue;
+
+static std::atomic<bool> imuEnabled(true);
+static std::atomic<bool> parkRequested(false);
+static std::atomic<bool> sensorParked(false);
+static SpscActivity cueActivity;
+static SpscActivity lightActivity;
+
+// Sensor task only after begin()
+static SoftClock softClock;
+static std::atomic<uint32_t> rtcReads(0);
+static std::atomic<uint32_t> rtcWindowMisses(0);
+
+static TaskHandle_t audioHandle = NULL;
+static TaskHandle_t lightHandle = NULL;
+static TaskHandle_t sensorHandle = NULL;
+static TaskHandle_t uiHandle = NULL;
+
+#ifdef LUCID_PROFILE
+static std::atomic<uint32_t> busyMicros[TASK_COUNT];
+#endif
+
+static int64_t readRtcEpoch() {
+    auto dt = M5.Rtc.getDateTime();
+    rtcReads.fetch_add(1, std::memory_order_relaxed);
+    return SoftClock::toEpoch(dt.date.year, dt.date.month, dt.date.date,
+                              dt.time.hours, dt.time.minutes, dt.time.seconds);
+}
+
+// Poll the RTC until its seconds roll over, for at most maxMs. The edge is
+// put halfway between the last read that saw the old second and the end of
+// the first read that saw the new one.
+static bool syncToRtcEdge(uint32_t maxMs) {
+    int64_t start = esp_timer_get_time();
+    int64_t prevStart = start;
+    int64_t prevSec = readRtcEpoch();
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(RTC_EDGE_POLL_MS));
+        int64_t readStart = esp_timer_get_time();
+        int64_t sec = readRtcEpoch();
+        int64_t readEnd = esp_timer_get_time();
+        if (sec != prevSec) {
+            softClock.sync(sec, (prevStart + readEnd) / 2, true);
+            clockAnchor.publish(softClock.getAnchor());
+            return true;
+        }
+        if (readEnd - start >= (int64_t)maxMs * 1000) return false;
+        prevStart = readStart;
+    }
+}
+
+// Sleep until just before the predicted rollover and catch it in a short
+// window; a full second of polling only without an edge anchor or when the
+// prediction was off.
+static void resyncClock() {
+    TRACE_BEGIN("rtc_sync");
+    bool caught = false;
+    if (softClock.getAnchor().state == CLOCK_ANCHOR_EDGE) {
+        int64_t now = esp_timer_get_time();
+        int64_t next = SoftClock::nowUs(softClock.getAnchor(), now) / 1000000 + 1;
+        int64_t waitUs = softClock.edgeTimerUs(next) - now - RTC_EDGE_GUARD_MS * 1000;
+        if (waitUs > 0) vTaskDelay(pdMS_TO_TICKS(waitUs / 1000));
+        caught = syncToRtcEdge(2 * RTC_EDGE_GUARD_MS);
+        if (!caught) rtcWindowMisses.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!caught) syncToRtcEdge(RTC_EDGE_FULL_MS);
+    TRACE_END("rtc_sync");
+}
+
+// Off the bus until unparked; the UI may light-sleep meanwhile
+static void parkUntilReleased(TickType_t& wake) {
+    sensorParked.store(true);
+    while (parkRequested.load()) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    sensorParked.store(false);
+    softClock.markCoarse();
+    wake = xTaskGetTickCount();
+}
+
+static void sensorTask(void*) {
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(SENSOR_PERIOD_MS));
+        if (parkRequested.load()) parkUntilReleased(wake);
+        TASK_BUSY_BEGIN();
+
+        // Clock writes from the UI go through here so the bus has one owner
+        RtcCommand cmd;
+        while (rtcQueue.pop(cmd)) {
+            auto t = M5.Rtc.getTime();
+            t.hours = cmd.hours;
+            t.minutes = cmd.minutes;
+            t.seconds = cmd.seconds;
+            M5.Rtc.setTime(&t);
+            // New time shows at once; the edge resync below refines it
+            softClock.sync(readRtcEpoch(), esp_timer_get_time(), false);
+            clockAnchor.publish(softClock.getAnchor());
+        }
+
+        if (imuEnabled.load(std::memory_order_relaxed)) {
+            TRACE_BEGIN("imu_read");
+            if (M5.Imu.update()) {
+                ImuSample sample;
+                sample.data = M5.Imu.getImuData();
+                sample.ms = millis();
+                imuQueue.push(sample);  // UI stalled > 3 s: drop, counted
+            }
+            TRACE_END("imu_read");
+        }
+
+        TASK_BUSY_END(TASK_SENSOR);
+
+        // Mostly sleeping until the seconds edge, so not counted as busy
+        if (softClock.resyncDue(esp_timer_get_time())) {
+            resyncClock();
+        }
+    }
+}
+
+// Most recent command wins; anything queued behind it is stale
+static const CuePattern* latestCue(SpscQueue<CueCommand, CUE_QUEUE_SIZE>& queue, SpscActivity& activity,
+                                   bool& any) {
+    const CuePattern* pattern = NULL;
+    CueCommand cmd;
+    any = false;
+    activity.beginDrain();
+    while (queue.pop(cmd)) {
+        pattern = cmd.pattern;
+        any = true;
+    }
+    return pattern;
+}
+
+// Wave and clip voices: render a half ring ahead of the ISR. Once the
+// synth runs out the rest is silence, and playback stops after the half
+// holding the cue's last sample has played.
+static WaveSynth waveSynth;  // Audio task only
+
+static void fillWave(uint8_t* dst) {
+    TASK_BUSY_BEGIN();
+    int n = waveSynth.done() ? 0 : waveSynth.render(dst, WAVE_HALF_SAMPLES);
+    memset(dst + n, 0, WAVE_HALF_SAMPLES - n);
+    TASK_BUSY_END(TASK_AUDIO);
+}
+
+// NULL when the cue played out, else the command that cut it short
+static const CuePattern* playWave(const CuePattern& pattern) {
+    uint8_t* ring = WavePlayer::buffer();
+    int lastHalf = -1;  // Half holding the cue's last sample, once rendered
+    waveSynth.start(pattern);
+    for (int half = 0; half < 2; half++) {
+        fillWave(ring + half * WAVE_HALF_SAMPLES);
+        if (lastHalf < 0 && waveSynth.done()) lastHalf = half;
+    }
+
+    const CuePattern* next = NULL;
+    WavePlayer::start(audioHandle);
+    for (;;) {
+        bool woken = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WAVE_STALL_MS)) != 0;
+        if (woken) {
+            bool any;
+            next = latestCue(cueQueue, cueActivity, any);
+            if (any) break;
+        }
+        int half = WavePlayer::takeDrained();
+        if (half < 0) {
+            if (!woken) break;  // Timer stopped
+            continue;
+        }
+        if (half == lastHalf) break;
+        fillWave(ring + half * WAVE_HALF_SAMPLES);
+        if (lastHalf < 0 && waveSynth.done()) lastHalf = half;
+    }
+    WavePlayer::stop();
+    return next;
+}
+
+static void audioTask(void*) {
+    WavePlayer::begin();
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        bool any;
+        const CuePattern* pattern = latestCue(cueQueue, cueActivity, any);
+
+        while (pattern) {
+            const CuePattern* playing = pattern;
+            pattern = NULL;
+            TRACE_BEGIN(playing->name);
+
+            if (playing->voice != CUE_VOICE_SQUARE) {
+                pattern = playWave(*playing);
+                TRACE_END(playing->name);
+                continue;
+            }
+
+            for (int i = 0; i < playing->count; i++) {
+                const CueStep& step = playing->steps[i];
+                TASK_BUSY_BEGIN();
+                if (step.freqHz) {
+                    ledcChangeFrequency(BUZZER_CHANNEL, step.freqHz, 8);
+                    ledcWrite(BUZZER_CHANNEL, step.level);
+                } else {
+                    ledcWrite(BUZZER_CHANNEL, 0);
+                }
+                TASK_BUSY_END(TASK_AUDIO);
+
+                // Sleep for the step, but wake at once for a new command
+                if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(step.durationMs))) {
+                    pattern = latestCue(cueQueue, cueActivity, any);
+                    if (any) break;
+                }
+            }
+            ledcWrite(BUZZER_CHANNEL, 0);
+            TRACE_END(playing->name);
+        }
+        cueActivity.idle();
+    }
+}
+
+// Arduino puts LEDC channels 0-7 in the high-speed group
+#define LED_MODE ((ledc_mode_t)(LED_CHANNEL / 8))
+#define LED_INDEX ((ledc_channel_t)(LED_CHANNEL % 8))
+
+// Brightness 0-255 to duty, squared so fades look even to the eye
+static uint32_t ledDuty(uint8_t level) {
+    return ((uint32_t)level * level) >> (16 - LED_RESOLUTION_BITS);
+}
+
+// Each step is one call into the fade engine; the hardware steps the duty
+// while the task sleeps. A new command cuts in at once, though the driver
+// finishes the fade under way before taking the next (within a step).
+static void lightTask(void*) {
+    ledcSetup(LED_CHANNEL, LED_PWM_HZ, LED_RESOLUTION_BITS);
+    ledcAttachPin(LED_PIN, LED_CHANNEL);
+    ledcWrite(LED_CHANNEL, 0);
+    ledc_fade_func_install(0);
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        bool any;
+        const CuePattern* pattern = latestCue(lightQueue, lightActivity, any);
+
+        while (pattern) {
+            const CuePattern* playing = pattern;
+            pattern = NULL;
+            TRACE_BEGIN(playing->name);
+
+            for (int i = 0; i < playing->count; i++) {
+                const CueStep& step = playing->steps[i];
+                TASK_BUSY_BEGIN();
+                if (step.freqHz == CUE_LED_FADE && step.durationMs) {
+                    ledc_set_fade_time_and_start(LED_MODE, LED_INDEX, ledDuty(step.level),
+                                                 step.durationMs, LEDC_FADE_NO_WAIT);
+                } else {
+                    ledc_set_duty_and_update(LED_MODE, LED_INDEX, ledDuty(step.level), 0);
+                }
+                TASK_BUSY_END(TASK_LIGHT);
+
+                if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(step.durationMs))) {
+                    pattern = latestCue(lightQueue, lightActivity, any);
+                    if (any) break;
+                }
+            }
+            ledc_set_duty_and_update(LED_MODE, LED_INDEX, 0, 0);
+            TRACE_END(playing->name);
+        }
+        lightActivity.idle();
+    }
+}
+
+void Tasks::begin() {
+    uiHandle = xTaskGetCurrentTaskHandle();
+
+    // Coarse anchor before anyone reads the clock; the sensor task refines
+    // it to a seconds edge on its first pass
+    softClock.sync(readRtcEpoch(), esp_timer_get_time(), false);
+    clockAnchor.publish(softClock.getAnchor());
+
+    xTaskCreatePinnedToCore(audioTask, "audio", AUDIO_TASK_STACK, NULL,
+                            AUDIO_TASK_PRIORITY, &audioHandle, TASK_CORE_BACKGROUND);
+    xTaskCreatePinnedToCore(lightTask, "light", LIGHT_TASK_STACK, NULL,
+                            LIGHT_TASK_PRIORITY, &lightHandle, TASK_CORE_BACKGROUND);
+    xTaskCreatePinnedToCore(sensorTask, "sensor", SENSOR_TASK_STACK, NULL,
+                            SENSOR_TASK_PRIORITY, &sensorHandle, TASK_CORE_BACKGROUND);
+}
+
+bool Tasks::popImu(ImuSample& sample) {
+    return imuQueue.pop(sample);
+}
+
+void Tasks::setImuEnabled(bool enabled) {
+    imuEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint32_t Tasks::getImuDropped() {
+    return imuQueue.getDropped();
+}
+
+ClockSnapshot Tasks::clock() {
+    ClockAnchor anchor = clockAnchor.read();
+    ClockSnapshot snap;
+    snap.epochUs = SoftClock::nowUs(anchor, esp_timer_get_time());
+    int32_t secOfDay = (int32_t)((snap.epochUs / 1000000) % 86400);
+    snap.hours = secOfDay / 3600;
+    snap.minutes = secOfDay / 60 % 60;
+    snap.seconds = secOfDay % 60;
+    snap.valid = anchor.state != CLOCK_ANCHOR_NONE;
+    return snap;
+}
+
+void Tasks::setTime(int hours, int minutes, int seconds) {
+    RtcCommand cmd = {(int8_t)hours, (int8_t)minutes, (int8_t)seconds};
+    rtcQueue.push(cmd);
+}
+
+void Tasks::playCue(const CuePattern& pattern) {
+    CueCommand cmd = {&pattern};
+    cueQueue.push(cmd);
+    cueActivity.mark();  // Active from here until the audio task has played it
+    if (audioHandle) xTaskNotifyGive(audioHandle);
+}
+
+void Tasks::stopCue() {
+    CueCommand cmd = {NULL};
+    cueQueue.push(cmd);
+    cueActivity.mark();
+    if (audioHandle) xTaskNotifyGive(audioHandle);
+}
+
+bool Tasks::isCueActive() {
+    return cueActivity.active();
+}
+
+void Tasks::playLight(const CuePattern& pattern) {
+    CueCommand cmd = {&pattern};
+    lightQueue.push(cmd);
+    lightActivity.mark();
+    if (lightHandle) xTaskNotifyGive(lightHandle);
+}
+
+void Tasks::stopLight() {
+    CueCommand cmd = {NULL};
+    lightQueue.push(cmd);
+    lightActivity.mark();
+    if (lightHandle) xTaskNotifyGive(lightHandle);
+}
+
+bool Tasks::isLightActive() {
+    return lightActivity.active();
+}
+
+bool Tasks::parkSensor(uint32_t timeoutMs) {
+    parkRequested.store(true);
+    for (uint32_t waited = 0; !sensorParked.load(); waited += SENSOR_PARK_POLL_MS) {
+        if (waited >= timeoutMs) {
+            unparkSensor();
+            return false;
+        }
+        vTaskDelay(pdMS_TO_TICKS(SENSOR_PARK_POLL_MS));
+    }
+    return true;
+}
+
+void Tasks::unparkSensor() {
+    parkRequested.store(false);
+    if (sensorHandle) xTaskNotifyGive(sensorHandle);
+}
+
+const char* Tasks::name(int task) {
+    static const char* NAMES[TASK_COUNT] = {"ui", "sensor", "audio", "light"};
+    return (task >= 0 && task < TASK_COUNT) ? NAMES[task] : "?";
+}
+
+int Tasks::currentId() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (self == uiHandle) return TASK_UI;
+    if (self == sensorHandle) return TASK_SENSOR;
+    if (self == audioHandle) return TASK_AUDIO;
+    if (self == lightHandle) return TASK_LIGHT;
+    return TASK_COUNT;
+}
+
+uint32_t Tasks::stackFree(int task) {
+    TaskHandle_t handles[TASK_COUNT] = {uiHandle, sensorHandle, audioHandle, lightHandle};
+    if (task < 0 || task >= TASK_COUNT || !handles[task]) return 0;
+    return uxTaskGetStackHighWaterMark(handles[task]);
+}
+
+#ifdef LUCID_PROFILE
+void Tasks::addBusy(int task, uint32_t micros) {
+    busyMicros[task].fetch_add(micros, std::memory_order_relaxed);
+}
+
+// CPU share of each task since the previous dump, plus free stack
+void Tasks::dump() {
+    static uint32_t lastBusy[TASK_COUNT];
+    static uint32_t lastDump = 0;
+
+    const int cores[TASK_COUNT] = {1, TASK_CORE_BACKGROUND, TASK_CORE_BACKGROUND, TASK_CORE_BACKGROUND};
+    uint32_t now = micros();
+    uint32_t window = now - lastDump;
+
+    logPrintf("{\"tasks\":{\"window_ms\":%lu,\"imu_dropped\":%lu,\"list\":[",
+              (unsigned long)(window / 1000), (unsigned long)imuQueue.getDropped());
+    for (int i = 0; i < TASK_COUNT; i++) {
+        uint32_t busy = busyMicros[i].load(std::memory_order_relaxed);
+        uint32_t delta = busy - lastBusy[i];
+        lastBusy[i] = busy;
+        unsigned long pctX10 = window ? (unsigned long)((uint64_t)delta * 1000 / window) : 0;
+        logPrintf("%s{\"name\":\"%s\",\"core\":%d,\"cpu_pct\":%lu.%lu,\"stack_free\":%lu}",
+                  i ? "," : "", name(i), cores[i], pctX10 / 10, pctX10 % 10, (unsigned long)stackFree(i));
+    }
+    logPrintf("]}}\n");
+
+    ClockAnchor anchor = clockAnchor.read();
+    uint32_t reads = rtcReads.load(std::memory_order_relaxed);
+    uint32_t uptimeS = (uint32_t)(esp_timer_get_time() / 1000000);
+    logPrintf("{\"clock\":{\"rtc_reads\":%lu,\"rtc_reads_per_hour\":%lu,\"resyncs\":%lu,"
+              "\"window_misses\":%lu,\"last_error_us\":%ld,\"drift_ppb\":%ld}}\n",
+              (unsigned long)reads, (unsigned long)(uptimeS ? (uint64_t)reads * 3600 / uptimeS : 0),
+              (unsigned long)anchor.resyncs, (unsigned long)rtcWindowMisses.load(std::memory_order_relaxed),
+              (long)anchor.lastErrorUs, (long)anchor.driftPpb);
+    lastDump = now;
+}
+#else
+void Tasks::addBusy(int, uint32_t) {}
+void Tasks::dump() {}
+#endif
@@ -0,0 +1,101 @@
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <M5StickCPlus2.h>
+#include "cue.h"
+
+// Task layout
+//   audio  - core 0, highest priority: plays cue patterns on the buzzer
+//            (wave and clip voices through wave_player.h's timer ISR)
+//   light  - core 0: plays light cues on the red LED; each step hands a
+//            fade to the LEDC fade engine and sleeps until the next
+//   sensor - core 0: reads the IMU every SENSOR_PERIOD_MS and resyncs the
+//            software clock from the RTC (see softclock.h)
+//   ui     - the Arduino loop task on core 1: buttons, screens, app logic
+// Tasks only talk through SPSC queues (IMU samples, cue and RTC commands)
+// and a seqlock clock anchor, so a long cue or a slow redraw never stalls
+// another task. After begin() only the sensor task touches the I2C bus,
+// only the audio task touches the buzzer and only the light task the LED -
+// except while the UI has parked the sensor task (night monitor, see
+// night_monitor.h).
+
+#define SENSOR_PERIOD_MS 100
+#define IMU_QUEUE_SIZE 32          // 3.2 s of samples at 100 ms
+#define CUE_QUEUE_SIZE 4
+#define RTC_QUEUE_SIZE 2
+#define RTC_EDGE_POLL_MS 5         // RTC read period while looking for a seconds edge
+#define RTC_EDGE_GUARD_MS 50       // Window either side of the predicted edge
+#define RTC_EDGE_FULL_MS 1100      // Without a prediction
+#define SENSOR_PARK_POLL_MS 5
+
+#define TASK_CORE_BACKGROUND 0     // Arduino loop (UI) runs on core 1
+#define AUDIO_TASK_PRIORITY 5
+#define LIGHT_TASK_PRIORITY 4
+#define SENSOR_TASK_PRIORITY 3
+#define AUDIO_TASK_STACK 2048
+#define LIGHT_TASK_STACK 2048
+#define SENSOR_TASK_STACK 4096
+
+enum TaskId {
+    TASK_UI,
+    TASK_SENSOR,
+    TASK_AUDIO,
+    TASK_LIGHT,
+    TASK_COUNT
+};
+
+struct ImuSample {
+    m5::imu_data_t data;
+    uint32_t ms;  // millis() when read
+};
+
+// Wall clock from the software clock; no I2C
+struct ClockSnapshot {
+    int8_t hours;
+    int8_t minutes;
+    int8_t seconds;
+    int8_t valid;
+    int64_t epochUs;  // Local time, microseconds since 1970
+};
+
+class Tasks {
+public:
+    static void begin();  // Call once from setup() after M5.begin()
+
+    // UI side
+    static bool popImu(ImuSample& sample);
+    static void setImuEnabled(bool enabled);
+    static uint32_t getImuDropped();
+    static ClockSnapshot clock();
+    static void setTime(int hours, int minutes, int seconds);
+    static void playCue(const CuePattern& pattern);  // Replaces any cue playing
+    static void stopCue();
+    static bool isCueActive();
+    static void playLight(const CuePattern& pattern);  // Light cues; replaces any playing
+    static void stopLight();
+    static bool isLightActive();  // The fade engine needs the APB clock: no light sleep
+
+    // Hand the I2C bus to the caller: true once the sensor task is idle
+    // (it may be mid clock resync, hence the timeout). Unparking resyncs
+    // the clock, since the caller may have light-slept in between.
+    static bool parkSensor(uint32_t timeoutMs);
+    static void unparkSensor();
+
+    static const char* name(int task);
+    static int currentId();               // TaskId of the caller, TASK_COUNT if none
+    static uint32_t stackFree(int task);  // High-water mark, bytes never used
+
+    // Per-task CPU use (LUCID_PROFILE)
+    static void addBusy(int task, uint32_t micros);
+    static void dump();
+};
+
+#ifdef LUCID_PROFILE
+#define TASK_BUSY_BEGIN() uint32_t _task_busy_start = micros()
+#define TASK_BUSY_END(task) Tasks::addBusy(task, micros() - _task_busy_start)
+#else
+#define TASK_BUSY_BEGIN() do {} while (0)
+#define TASK_BUSY_END(task) do {} while (0)
+#endif
+
+#endif
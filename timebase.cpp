@@ -0,0 +1,14 @@
+#include "timebase.h"
+#include "tasks.h"
+
+uint64_t TimeBase::monoUs() {
+    return (uint64_t)esp_timer_get_time();
+}
+
+uint64_t TimeBase::monoMs() {
+    return monoUs() / 1000;
+}
+
+int64_t TimeBase::epochSec() {
+    return Tasks::clock().epochUs / 1000000;
+}
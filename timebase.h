@@ -0,0 +1,21 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+
+// Time base
+// Two clocks, and schedulers use one of them rather than millis():
+//   monoUs/monoMs - 64-bit time since boot (esp_timer). Never wraps, so it is
+//                   right for durations; meaningless across a reset.
+//   epochSec      - local wall clock, seconds since 1970 with the RTC's date,
+//                   from the software clock (see tasks.h). Anything that is
+//                   persisted or must survive a reboot is stored as this.
+
+class TimeBase {
+public:
+    static uint64_t monoUs();
+    static uint64_t monoMs();
+    static int64_t epochSec();
+};
+
+#endif
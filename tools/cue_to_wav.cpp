@@ -0,0 +1,242 @@
+// Render LucidWatch cues to WAV files for audition, on a host.
+//
+// Builds against the firmware's own cue tables and wave synth (wave_synth.h),
+// so what you hear is what the timer ISR streams to the buzzer:
+//
+//     g++ -O2 -I. tools/cue_to_wav.cpp wave_synth.cpp cue.cpp cue_clips.cpp adpcm.cpp -o cue_to_wav
+//     ./cue_to_wav rem_wave rem_wave.wav
+//     ./cue_to_wav rem_gentle rem_gentle.wav      # square voice, for comparison
+//
+// Wave and clip cues are written as the duty samples, centred and scaled
+// to 16 bits, at WAVE_SAMPLE_RATE (so the bias ramps show as a slow step
+// at each end). Square cues are ideal PWM square waves at the step's duty,
+// sampled at 48 kHz - what the LEDC tone path plays. Neither models the
+// buzzer itself, which rolls off well below 1 kHz and peaks near 4 kHz.
+//
+// An event can play on the buzzer, the LED or both (Cue Output screen). To
+// check how the two line up, print both timelines as CSV every 10 ms:
+//
+//     ./cue_to_wav --timeline reality_check led_pulse > rc.csv
+//
+// with the buzzer step's frequency and level and the LED brightness, fades
+// interpolated as the LEDC fade engine steps them.
+//
+// To make a clip, record or synthesise a short 8 kHz mono 16-bit WAV and
+//
+//     ./cue_to_wav --encode chime.wav CHIME_CLIP > clip.txt
+//
+// which prints the IMA-ADPCM bytes as a C array for cue_clips.cpp.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "cue.h"
+#include "wave_synth.h"
+#include "adpcm.h"
+
+#define SQUARE_SAMPLE_RATE 48000
+#define TIMELINE_STEP_MS 10
+
+static void put16(FILE* f, uint16_t v) {
+    fputc(v & 0xFF, f);
+    fputc(v >> 8, f);
+}
+
+static void put32(FILE* f, uint32_t v) {
+    put16(f, v & 0xFFFF);
+    put16(f, v >> 16);
+}
+
+static bool writeWav(const char* path, const std::vector<int16_t>& pcm, uint32_t rate) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    uint32_t bytes = (uint32_t)pcm.size() * 2;
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 36 + bytes);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 16);
+    put16(f, 1);          // PCM
+    put16(f, 1);          // Mono
+    put32(f, rate);
+    put32(f, rate * 2);
+    put16(f, 2);
+    put16(f, 16);
+    fwrite("data", 1, 4, f);
+    put32(f, bytes);
+    for (size_t i = 0; i < pcm.size(); i++) put16(f, (uint16_t)pcm[i]);
+    return fclose(f) == 0;
+}
+
+// 16-bit mono PCM only; skips chunks it doesn't need
+static bool readWav(const char* path, std::vector<int16_t>& pcm, uint32_t& rate) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    uint8_t header[12];
+    bool ok = fread(header, 1, 12, f) == 12 && !memcmp(header, "RIFF", 4) && !memcmp(header + 8, "WAVE", 4);
+    uint16_t channels = 0;
+    uint16_t bits = 0;
+    while (ok) {
+        uint8_t chunk[8];
+        if (fread(chunk, 1, 8, f) != 8) {
+            ok = false;
+            break;
+        }
+        uint32_t size = chunk[4] | chunk[5] << 8 | chunk[6] << 16 | (uint32_t)chunk[7] << 24;
+        std::vector<uint8_t> body(size);
+        if (fread(body.data(), 1, size, f) != size) {
+            ok = false;
+            break;
+        }
+        if (!memcmp(chunk, "fmt ", 4) && size >= 16) {
+            channels = body[2] | body[3] << 8;
+            rate = body[4] | body[5] << 8 | body[6] << 16 | (uint32_t)body[7] << 24;
+            bits = body[14] | body[15] << 8;
+        } else if (!memcmp(chunk, "data", 4)) {
+            ok = channels == 1 && bits == 16;
+            pcm.resize(size / 2);
+            for (size_t i = 0; ok && i < pcm.size(); i++) {
+                pcm[i] = (int16_t)(body[2 * i] | body[2 * i + 1] << 8);
+            }
+            break;
+        }
+        if (size & 1) fgetc(f);
+    }
+    fclose(f);
+    return ok;
+}
+
+static void renderWave(const CuePattern& pattern, std::vector<int16_t>& pcm) {
+    WaveSynth synth;
+    synth.start(pattern);
+    uint8_t block[256];
+    int n;
+    while ((n = synth.render(block, sizeof(block))) > 0) {
+        for (int i = 0; i < n; i++) pcm.push_back((int16_t)((block[i] - WAVE_DUTY_MID) * 256));
+    }
+}
+
+static void renderSquare(const CuePattern& pattern, std::vector<int16_t>& pcm) {
+    for (int i = 0; i < pattern.count; i++) {
+        const CueStep& step = pattern.steps[i];
+        uint32_t samples = (uint32_t)step.durationMs * SQUARE_SAMPLE_RATE / 1000;
+        double duty = step.level / 256.0;
+        for (uint32_t k = 0; k < samples; k++) {
+            double cycle = step.freqHz ? k * (double)step.freqHz / SQUARE_SAMPLE_RATE : 0;
+            double high = step.freqHz && cycle - (long)cycle < duty ? 1.0 : 0.0;
+            pcm.push_back((int16_t)((high - duty) * 32767));
+        }
+    }
+}
+
+static int encodeClip(const char* path, const char* name) {
+    std::vector<int16_t> pcm;
+    uint32_t rate = 0;
+    if (!readWav(path, pcm, rate)) {
+        fprintf(stderr, "%s: not a 16-bit mono WAV\n", path);
+        return 1;
+    }
+    if (rate != WAVE_SAMPLE_RATE) {
+        fprintf(stderr, "%s: %u Hz, clips play at %d Hz\n", path, rate, WAVE_SAMPLE_RATE);
+        return 1;
+    }
+    if (pcm.size() & 1) pcm.push_back(0);
+    std::vector<uint8_t> codes(pcm.size() / 2);
+    AdpcmEncoder encoder;
+    encoder.encode(pcm.data(), pcm.size(), codes.data());
+
+    printf("// %s: %.2f s at %d Hz, %u bytes\n", name, pcm.size() / (double)WAVE_SAMPLE_RATE,
+           WAVE_SAMPLE_RATE, (unsigned)codes.size());
+    printf("static const uint8_t %s[] = {", name);
+    for (size_t i = 0; i < codes.size(); i++) {
+        printf("%s0x%02x", i % 16 ? ", " : (i ? ",\n    " : "\n    "), codes[i]);
+    }
+    printf("\n};\n");
+    return 0;
+}
+
+// Buzzer step sounding at ms (NULL once the cue is over)
+static const CueStep* soundAt(const CuePattern& pattern, uint32_t ms) {
+    uint32_t from = 0;
+    for (int i = 0; i < pattern.count; i++) {
+        from += pattern.steps[i].durationMs;
+        if (ms < from) return &pattern.steps[i];
+    }
+    return NULL;
+}
+
+// LED brightness at ms; fades run linearly from the previous step's level
+static int lightAt(const CuePattern& pattern, uint32_t ms) {
+    uint32_t from = 0;
+    int level = 0;
+    for (int i = 0; i < pattern.count; i++) {
+        const CueStep& step = pattern.steps[i];
+        if (ms < from + step.durationMs) {
+            if (step.freqHz != CUE_LED_FADE) return step.level;
+            return level + (step.level - level) * (int)(ms - from) / step.durationMs;
+        }
+        from += step.durationMs;
+        level = step.level;
+    }
+    return 0;
+}
+
+static int printTimeline(const CuePattern* sound, const CuePattern* light) {
+    uint32_t end = 0;
+    if (sound) end = cueDurationMs(*sound);
+    if (light && cueDurationMs(*light) > end) end = cueDurationMs(*light);
+
+    printf("ms,buzzer_hz,buzzer_level,led\n");
+    for (uint32_t ms = 0; ms <= end; ms += TIMELINE_STEP_MS) {
+        const CueStep* step = sound ? soundAt(*sound, ms) : NULL;
+        printf("%u,%u,%u,%d\n", ms, step ? step->freqHz : 0, step ? step->level : 0,
+               light ? lightAt(*light, ms) : 0);
+    }
+    return 0;
+}
+
+static const CuePattern* findCue(const char* name) {
+    const CuePattern* pattern = cueByName(name);
+    if (!pattern) fprintf(stderr, "no cue named %s\n", name);
+    return pattern;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 4 && !strcmp(argv[1], "--encode")) return encodeClip(argv[2], argv[3]);
+    if ((argc == 3 || argc == 4) && !strcmp(argv[1], "--timeline")) {
+        const CuePattern* sound = NULL;
+        const CuePattern* light = NULL;
+        for (int i = 2; i < argc; i++) {
+            const CuePattern* pattern = findCue(argv[i]);
+            if (!pattern) return 1;
+            (pattern->voice == CUE_VOICE_LIGHT ? light : sound) = pattern;
+        }
+        return printTimeline(sound, light);
+    }
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s CUE OUT.wav\n       %s --timeline [SOUND_CUE] [LIGHT_CUE]\n"
+                "       %s --encode IN.wav ARRAY_NAME\n", argv[0], argv[0], argv[0]);
+        return 2;
+    }
+    const CuePattern* pattern = findCue(argv[1]);
+    if (!pattern) return 1;
+    if (pattern->voice == CUE_VOICE_LIGHT) {
+        fprintf(stderr, "%s is a light cue, see --timeline\n", pattern->name);
+        return 1;
+    }
+
+    std::vector<int16_t> pcm;
+    uint32_t rate = WAVE_SAMPLE_RATE;
+    if (pattern->voice == CUE_VOICE_SQUARE) {
+        renderSquare(*pattern, pcm);
+        rate = SQUARE_SAMPLE_RATE;
+    } else {
+        renderWave(*pattern, pcm);
+    }
+    if (!writeWav(argv[2], pcm, rate)) {
+        fprintf(stderr, "cannot write %s\n", argv[2]);
+        return 1;
+    }
+    fprintf(stderr, "%s: %s, %.2f s\n", argv[2], pattern->name, pcm.size() / (double)rate);
+    return 0;
+}
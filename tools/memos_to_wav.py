@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Convert LucidWatch `memos` serial dumps into WAV files.
+
+Send "memos" over serial to print every stored dream memo (memo_store.h),
+then write one 16-bit mono WAV per memo, named after its start time:
+
+    pio device monitor | tee memos.log       # send "memos"
+    tools/memos_to_wav.py memos.log memos/
+
+A 45 s memo is about 180 KB, so the dump takes roughly half a minute per
+memo at 115200 baud. The decoder mirrors AdpcmDecoder in adpcm.cpp.
+"""
+
+import argparse
+import datetime
+import json
+import os
+import struct
+import sys
+import wave
+
+STEPS = (
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767)
+INDEX_ADJUST = (-1, -1, -1, -1, 2, 4, 6, 8)
+
+
+def decode(data):
+    """IMA-ADPCM codes, low nibble first, to a list of 16-bit samples."""
+    predictor, index = 0, 0
+    out = []
+    for byte in data:
+        for code in (byte & 0xF, byte >> 4):
+            step = STEPS[index]
+            diff = step >> 3
+            if code & 4:
+                diff += step
+            if code & 2:
+                diff += step >> 1
+            if code & 1:
+                diff += step >> 2
+            predictor += -diff if code & 8 else diff
+            predictor = max(-32768, min(32767, predictor))
+            index = max(0, min(88, index + INDEX_ADJUST[code & 7]))
+            out.append(predictor)
+    return out
+
+
+def read_memos(lines):
+    """Yield (header, data) for each complete memo in the log."""
+    header, data = None, bytearray()
+    for line in lines:
+        line = line.strip()
+        if not line.startswith('{"memo'):
+            continue
+        try:
+            obj = json.loads(line)
+        except ValueError:
+            continue  # Line mangled by other serial output
+        if "memo" in obj:
+            if header is not None:
+                yield header, bytes(data)
+            header, data = obj["memo"], bytearray()
+        elif "memo_data" in obj and header is not None:
+            data.extend(bytes.fromhex(obj["memo_data"]))
+        elif "memos_end" in obj and header is not None:
+            yield header, bytes(data)
+            header = None
+    if header is not None:
+        yield header, bytes(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", help="serial log containing a memos dump")
+    parser.add_argument("outdir", help="directory for the WAV files")
+    args = parser.parse_args()
+
+    os.makedirs(args.outdir, exist_ok=True)
+    count = 0
+    with open(args.log, errors="replace") as f:
+        for header, data in read_memos(f):
+            if len(data) < header["bytes"]:
+                print("memo in slot %d is truncated (%d of %d bytes)"
+                      % (header["slot"], len(data), header["bytes"]), file=sys.stderr)
+            start = datetime.datetime.fromtimestamp(header["start"], datetime.timezone.utc)
+            path = os.path.join(args.outdir, start.strftime("memo-%Y%m%d-%H%M%S.wav"))
+            samples = decode(data[:header["bytes"]])
+            with wave.open(path, "wb") as w:
+                w.setnchannels(1)
+                w.setsampwidth(2)
+                w.setframerate(header["rate"])
+                w.writeframes(struct.pack("<%dh" % len(samples), *samples))
+            print("%s: %.1f s" % (path, len(samples) / header["rate"]), file=sys.stderr)
+            count += 1
+    if not count:
+        sys.exit("no memo found in " + args.log)
+
+
+if __name__ == "__main__":
+    main()
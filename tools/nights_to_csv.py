@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Convert LucidWatch `nights` serial dumps into CSV.
+
+Send "nights" over serial to print every stored night (night_store.h), then
+convert the log to one CSV row per 30 s epoch:
+
+    pio device monitor | tee nights.log      # send "nights"
+    tools/nights_to_csv.py nights.log > nights.csv
+
+Columns: night (start, local time), epoch, time, activity (moving samples
+out of 300), stage (deep/light/wake as inferred on the watch, unknown while
+it wasn't sampling) and cue (1 if a REM cue played). The decoder mirrors
+NightReader in night_log.cpp.
+"""
+
+import argparse
+import datetime
+import json
+import sys
+
+STAGES = ("deep", "light", "wake", "unknown")
+
+
+class BitReader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def bit(self):
+        if self.pos >= len(self.data) * 8:
+            raise EOFError
+        b = (self.data[self.pos >> 3] >> (7 - (self.pos & 7))) & 1
+        self.pos += 1
+        return b
+
+    def bits(self, count):
+        value = 0
+        for _ in range(count):
+            value = (value << 1) | self.bit()
+        return value
+
+
+def decode(epochs, data):
+    """Yield (activity, stage, cue) for each packed epoch."""
+    reader = BitReader(data)
+    activity, stage = 0, 0
+    for _ in range(epochs):
+        cue = 0
+        if not reader.bit():
+            cue = reader.bit()
+            stage = reader.bits(2)
+            n = 0
+            while not reader.bit():
+                n += 1
+            zz = ((1 << n) | reader.bits(n)) - 1
+            activity += -((zz + 1) // 2) if zz & 1 else zz // 2
+        yield activity, stage, cue
+
+
+def read_nights(lines):
+    """Yield (header, data) for each night in the log."""
+    header, data = None, bytearray()
+    for line in lines:
+        line = line.strip()
+        if not line.startswith('{"night'):
+            continue
+        try:
+            obj = json.loads(line)
+        except ValueError:
+            continue  # Line mangled by other serial output
+        if "night" in obj:
+            if header is not None:
+                yield header, bytes(data)
+            header, data = obj["night"], bytearray()
+        elif "night_data" in obj and header is not None:
+            data.extend(bytes.fromhex(obj["night_data"]))
+        elif "nights_end" in obj and header is not None:
+            yield header, bytes(data)
+            header = None
+    if header is not None:
+        yield header, bytes(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", help="serial log containing a nights dump")
+    args = parser.parse_args()
+
+    nights = 0
+    out = sys.stdout
+    out.write("night,epoch,time,activity,stage,cue\n")
+    with open(args.log, errors="replace") as f:
+        for header, data in read_nights(f):
+            if len(data) < header["bytes"]:
+                print("night %d truncated, skipped" % header["start"], file=sys.stderr)
+                continue
+            nights += 1
+            # The watch keeps local time, so the epoch seconds are read as UTC
+            start = datetime.datetime.fromtimestamp(header["start"], datetime.timezone.utc)
+            night = start.strftime("%Y-%m-%d %H:%M")
+            step = datetime.timedelta(seconds=header["epoch_s"])
+            i = 0
+            try:
+                for i, (activity, stage, cue) in enumerate(decode(header["epochs"], data)):
+                    t = (start + i * step).strftime("%Y-%m-%d %H:%M:%S")
+                    out.write("%s,%d,%s,%d,%s,%d\n" % (night, i, t, activity, STAGES[stage], cue))
+            except (EOFError, IndexError):
+                print("night %s corrupt after epoch %d" % (night, i), file=sys.stderr)
+    if not nights:
+        sys.exit("no nights found in " + args.log)
+    print("%d nights" % nights, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""Turn a LucidWatch `pcprof` serial dump into folded stacks.
+
+Capture the dump from a m5stick-c-plus2-pcprof build, then symbolize it
+against the ELF from the same build:
+
+    pio device monitor | tee pcprof.log      # send "pcprof"
+    tools/pcprof_fold.py pcprof.log .pio/build/m5stick-c-plus2-pcprof/firmware.elf > lucid.folded
+    flamegraph.pl lucid.folded > lucid.svg   # or load lucid.folded in speedscope
+
+Each stack is core;caller;function with its sample count.
+"""
+
+import argparse
+import collections
+import json
+import subprocess
+import sys
+
+
+def read_samples(lines):
+    samples = []
+    for line in lines:
+        line = line.strip()
+        if not line.startswith('{"pcprof'):
+            continue
+        try:
+            obj = json.loads(line)
+        except ValueError:
+            continue  # Line mangled by other serial output
+        if "pcprof_begin" in obj:
+            samples = []  # Keep only the latest dump in the log
+            hdr = obj["pcprof_begin"]
+            for core, stats in enumerate(hdr["cores"]):
+                print("core%d: %d samples at %d Hz, %d dropped, %d in nested ISRs"
+                      % (core, stats["samples"], hdr["hz"], stats["dropped"], stats["nested"]),
+                      file=sys.stderr)
+        elif "pcprof" in obj:
+            core, pc, caller, count = obj["pcprof"]
+            samples.append((core, int(pc, 16), int(caller, 16), count))
+    return samples
+
+
+def symbolize(addresses, elf, addr2line):
+    """Map each address to a function name with a single addr2line call."""
+    addresses = sorted(addresses)
+    if not addresses:
+        return {}
+    out = subprocess.run([addr2line, "-e", elf, "-f", "-C"] + ["0x%08x" % a for a in addresses],
+                         check=True, capture_output=True, text=True).stdout.splitlines()
+    names = {}
+    for i, addr in enumerate(addresses):
+        name = out[2 * i] if 2 * i < len(out) else "??"
+        if name == "??":
+            name = "0x%08x" % addr
+        names[addr] = name.replace(";", ":")
+    return names
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", help="serial log containing a pcprof dump")
+    parser.add_argument("elf", help="firmware.elf from the same build")
+    parser.add_argument("--addr2line", default="xtensa-esp32-elf-addr2line",
+                        help="addr2line for the target (default: %(default)s)")
+    args = parser.parse_args()
+
+    with open(args.log, errors="replace") as f:
+        samples = read_samples(f)
+    if not samples:
+        sys.exit("no pcprof dump found in " + args.log)
+
+    names = symbolize({s[1] for s in samples} | {s[2] for s in samples}, args.elf, args.addr2line)
+
+    folded = collections.Counter()
+    for core, pc, caller, count in samples:
+        folded["core%d;%s;%s" % (core, names[caller], names[pc])] += count
+    for stack, count in folded.most_common():
+        print("%s %d" % (stack, count))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,115 @@
+#ifndef HOST_M5STICKCPLUS2_H
+#define HOST_M5STICKCPLUS2_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Host stand-in for the parts of M5StickCPlus2.h the host-built modules
+// use (layout.cpp, aod.cpp, imu.cpp). The display draws nothing; it counts
+// calls, the pixels filled and the characters printed, so tests can see what
+// a frame cost, and keeps the last panel commands sent. The IMU hands back
+// whatever sample was last set, and millis() is a counter the test moves.
+// Never on the firmware's include path - only tools/tests is.
+
+#define BLACK 0x0000
+#define WHITE 0xFFFF
+#define RED 0xF800
+#define GREEN 0x07E0
+#define YELLOW 0xFFE0
+#define CYAN 0x07FF
+
+#define HOST_DISPLAY_LOG 32
+
+struct HostDisplay {
+    uint32_t calls;
+    uint32_t fills;
+    uint64_t pixelsFilled;
+    uint32_t prints;
+    uint64_t charsPrinted;
+    uint8_t brightness;
+    bool asleep;
+    bool writing;                      // Between startWrite() and endWrite()
+    uint16_t log[HOST_DISPLAY_LOG];    // Commands (0x100 | cmd) and data bytes
+    int logged;
+
+    HostDisplay() { resetCounts(); brightness = 0; asleep = false; writing = false; }
+    void resetCounts() { calls = fills = prints = 0; pixelsFilled = charsPrinted = 0; logged = 0; }
+
+    int width() const { return 240; }
+    int height() const { return 135; }
+    void fillScreen(uint16_t) { fillRect(0, 0, width(), height(), 0); }
+    void fillRect(int, int, int w, int h, uint16_t) {
+        calls++;
+        fills++;
+        pixelsFilled += (uint64_t)w * h;
+    }
+    void setTextSize(uint8_t) { calls++; }
+    void setTextColor(uint16_t) { calls++; }
+    void setTextColor(uint16_t, uint16_t) { calls++; }
+    void setCursor(int, int) { calls++; }
+    void print(const char* text) {
+        calls++;
+        prints++;
+        charsPrinted += strlen(text);
+    }
+    void setBrightness(uint8_t level) { calls++; brightness = level; }
+    void sleep() { calls++; asleep = true; }
+    void wakeup() { calls++; asleep = false; }
+
+    void startWrite() { writing = true; }
+    void endWrite() { writing = false; }
+    void writeCommand(uint8_t cmd) { record(0x100 | cmd); }
+    void writeData(uint8_t data) { record(data); }
+    void record(uint16_t word) {
+        calls++;
+        if (logged < HOST_DISPLAY_LOG) log[logged++] = word;
+    }
+};
+
+namespace m5 {
+struct imu_3d_t {
+    float x, y, z;
+};
+struct imu_data_t {
+    uint32_t usec;
+    imu_3d_t accel;
+    imu_3d_t gyro;
+    imu_3d_t mag;
+};
+}
+
+struct HostImu {
+    m5::imu_data_t data;
+    bool update() { return true; }
+    m5::imu_data_t getImuData() const { return data; }
+};
+
+struct HostM5 {
+    HostDisplay Display;
+    HostImu Imu;
+};
+
+// One instance across translation units, as the firmware's global
+inline HostM5& hostM5() {
+    static HostM5 m5;
+    return m5;
+}
+#define M5 hostM5()
+
+inline unsigned long& hostMillis() {
+    static unsigned long ms;
+    return ms;
+}
+inline unsigned long millis() { return hostMillis(); }
+
+inline uint32_t& hostCpuMhz() {
+    static uint32_t mhz = 240;
+    return mhz;
+}
+inline uint32_t getCpuFrequencyMhz() { return hostCpuMhz(); }
+inline bool setCpuFrequencyMhz(uint32_t mhz) {
+    hostCpuMhz() = mhz;
+    return true;
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Host stand-in for Arduino's Preferences, over a simulated NVS partition
+// shared by every instance (settings.cpp, the host benchmarks). Writes
+// follow NVS: putting the value already stored writes nothing; anything
+// else writes a fresh 32-byte entry, plus one per 32 bytes of payload for
+// blobs. hostNvs() counts the puts and the entries written, so a bench can
+// report flash wear per save. Never on the firmware's include path.
+
+#define HOST_NVS_ENTRIES 128
+#define HOST_NVS_KEY_CHARS 16     // NVS limit, terminator included
+#define HOST_NVS_VALUE_BYTES 64
+#define HOST_NVS_ENTRY_BYTES 32
+
+struct HostNvsEntry {
+    char ns[HOST_NVS_KEY_CHARS];
+    char key[HOST_NVS_KEY_CHARS];
+    uint8_t type;
+    uint8_t len;
+    uint8_t value[HOST_NVS_VALUE_BYTES];
+};
+
+struct HostNvs {
+    HostNvsEntry entries[HOST_NVS_ENTRIES];
+    int count;
+    uint32_t puts;
+    uint32_t entriesWritten;
+
+    void resetCounts() { puts = entriesWritten = 0; }
+};
+
+inline HostNvs& hostNvs() {
+    static HostNvs nvs;
+    return nvs;
+}
+
+class Preferences {
+private:
+    char ns[HOST_NVS_KEY_CHARS];
+    bool open;
+    bool readOnly;
+
+    enum { T_U8 = 1, T_I32, T_U32, T_I64, T_BLOB };
+
+    HostNvsEntry* find(const char* key) {
+        HostNvs& nvs = hostNvs();
+        for (int i = 0; i < nvs.count; i++) {
+            if (!strcmp(nvs.entries[i].ns, ns) && !strcmp(nvs.entries[i].key, key)) return &nvs.entries[i];
+        }
+        return NULL;
+    }
+
+    size_t put(const char* key, uint8_t type, const void* value, size_t len) {
+        if (!open || readOnly || strlen(key) >= HOST_NVS_KEY_CHARS || len > HOST_NVS_VALUE_BYTES) return 0;
+        HostNvs& nvs = hostNvs();
+        nvs.puts++;
+        HostNvsEntry* e = find(key);
+        if (e && e->type == type && e->len == len && !memcmp(e->value, value, len)) return len;
+        if (!e) {
+            if (nvs.count >= HOST_NVS_ENTRIES) return 0;
+            e = &nvs.entries[nvs.count++];
+            strcpy(e->ns, ns);
+            strcpy(e->key, key);
+        }
+        e->type = type;
+        e->len = (uint8_t)len;
+        memcpy(e->value, value, len);
+        nvs.entriesWritten += 1 + (type == T_BLOB ? (len + HOST_NVS_ENTRY_BYTES - 1) / HOST_NVS_ENTRY_BYTES : 0);
+        return len;
+    }
+
+    bool get(const char* key, uint8_t type, void* value, size_t len) {
+        HostNvsEntry* e = open ? find(key) : NULL;
+        if (!e || e->type != type || e->len != len) return false;
+        memcpy(value, e->value, len);
+        return true;
+    }
+
+public:
+    Preferences() : open(false), readOnly(false) { ns[0] = '\0'; }
+
+    bool begin(const char* name, bool readOnlyMode = false) {
+        if (strlen(name) >= HOST_NVS_KEY_CHARS) return false;
+        strcpy(ns, name);
+        open = true;
+        readOnly = readOnlyMode;
+        return true;
+    }
+    void end() { open = false; }
+
+    bool clear() {
+        if (!open || readOnly) return false;
+        HostNvs& nvs = hostNvs();
+        int kept = 0;
+        for (int i = 0; i < nvs.count; i++) {
+            if (strcmp(nvs.entries[i].ns, ns)) nvs.entries[kept++] = nvs.entries[i];
+        }
+        nvs.count = kept;
+        return true;
+    }
+    bool isKey(const char* key) { return open && find(key); }
+
+    size_t putUChar(const char* key, uint8_t value) { return put(key, T_U8, &value, sizeof(value)); }
+    size_t putBool(const char* key, bool value) { return putUChar(key, value ? 1 : 0); }
+    size_t putInt(const char* key, int32_t value) { return put(key, T_I32, &value, sizeof(value)); }
+    size_t putUInt(const char* key, uint32_t value) { return put(key, T_U32, &value, sizeof(value)); }
+    size_t putLong64(const char* key, int64_t value) { return put(key, T_I64, &value, sizeof(value)); }
+    size_t putBytes(const char* key, const void* value, size_t len) { return put(key, T_BLOB, value, len); }
+
+    uint8_t getUChar(const char* key, uint8_t fallback = 0) {
+        uint8_t v;
+        return get(key, T_U8, &v, sizeof(v)) ? v : fallback;
+    }
+    bool getBool(const char* key, bool fallback = false) { return getUChar(key, fallback ? 1 : 0) != 0; }
+    int32_t getInt(const char* key, int32_t fallback = 0) {
+        int32_t v;
+        return get(key, T_I32, &v, sizeof(v)) ? v : fallback;
+    }
+    uint32_t getUInt(const char* key, uint32_t fallback = 0) {
+        uint32_t v;
+        return get(key, T_U32, &v, sizeof(v)) ? v : fallback;
+    }
+    int64_t getLong64(const char* key, int64_t fallback = 0) {
+        int64_t v;
+        return get(key, T_I64, &v, sizeof(v)) ? v : fallback;
+    }
+    size_t getBytes(const char* key, void* buf, size_t maxLen) {
+        HostNvsEntry* e = open ? find(key) : NULL;
+        if (!e || e->type != T_BLOB || e->len > maxLen) return 0;
+        memcpy(buf, e->value, e->len);
+        return e->len;
+    }
+};
+
+#endif
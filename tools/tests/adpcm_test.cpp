@@ -0,0 +1,221 @@
+// IMA-ADPCM memo codec: WAV round trips, the memo format and throughput
+//
+//     g++ -O1 -I. -Itools/tests tools/tests/adpcm_test.cpp adpcm.cpp
+//     ./a.out [recording.wav]
+//
+// Each WAV (16-bit mono; the synthetic ones are written to $TMPDIR first, a
+// recording can be named on the command line) is encoded in MEMO_CHUNK
+// pieces as the mic delivers them, laid out as a memo file and decoded
+// again. Checks the SNR each signal should reach, that chunking doesn't
+// change the codes, and the 4:1 ratio; reports encode and decode speed.
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include "check.h"
+#include "wav.h"
+#include "adpcm.h"
+#include "memo_store.h"
+
+#define MEMO_CHUNK 512        // As MEMO_CHUNK_SAMPLES in main.cpp
+#define BENCH_SECONDS 600     // Audio pushed through each end for timing
+
+static double nowSec() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Two formants under a syllable envelope, as the on-device bench uses
+static Pcm voice(int seconds) {
+    Pcm pcm(seconds * MEMO_SAMPLE_RATE);
+    for (size_t k = 0; k < pcm.size(); k++) {
+        double t = k / (double)MEMO_SAMPLE_RATE;
+        double envelope = 0.5 + 0.5 * sin(2 * M_PI * 4 * t);
+        pcm[k] = (int16_t)(envelope * (6000 * sin(2 * M_PI * 220 * t) + 2500 * sin(2 * M_PI * 1400 * t)));
+    }
+    return pcm;
+}
+
+static Pcm tone(int seconds, double hz, double amplitude) {
+    Pcm pcm(seconds * MEMO_SAMPLE_RATE);
+    for (size_t k = 0; k < pcm.size(); k++) pcm[k] = (int16_t)(amplitude * sin(2 * M_PI * hz * k / MEMO_SAMPLE_RATE));
+    return pcm;
+}
+
+// A quiet room: mic hiss around a DC offset
+static Pcm hiss(int seconds) {
+    Pcm pcm(seconds * MEMO_SAMPLE_RATE);
+    srand(46);
+    for (size_t k = 0; k < pcm.size(); k++) pcm[k] = (int16_t)(-300 + rand() % 201 - 100);
+    return pcm;
+}
+
+// Full-scale square: the predictor has to clamp, not wrap
+static Pcm square(int seconds) {
+    Pcm pcm(seconds * MEMO_SAMPLE_RATE);
+    for (size_t k = 0; k < pcm.size(); k++) pcm[k] = (k / 20) % 2 ? 32767 : -32768;
+    return pcm;
+}
+
+static double snrDb(const Pcm& in, const Pcm& out) {
+    double signal = 0, noise = 0;
+    for (size_t k = 0; k < in.size(); k++) {
+        double e = in[k] - out[k];
+        signal += (double)in[k] * in[k];
+        noise += e * e;
+    }
+    return 10 * log10(signal / (noise > 0 ? noise : 1));
+}
+
+// Encodes as main.cpp's memo loop does, into a memo file image
+static std::vector<uint8_t> recordMemo(const Pcm& pcm) {
+    size_t samples = pcm.size() & ~(size_t)1;
+    MemoHeader header = {};
+    header.magic = MEMO_MAGIC;
+    header.version = MEMO_VERSION;
+    header.sampleRate = MEMO_SAMPLE_RATE;
+    header.startSec = 1700000000;
+    header.samples = samples;
+    header.bytes = samples / 2;
+    std::vector<uint8_t> file(sizeof(header) + header.bytes);
+    memcpy(&file[0], &header, sizeof(header));
+
+    AdpcmEncoder encoder;
+    uint8_t* codes = &file[sizeof(header)];
+    for (size_t at = 0; at < samples; at += MEMO_CHUNK) {
+        size_t n = samples - at < MEMO_CHUNK ? samples - at : MEMO_CHUNK;
+        codes += encoder.encode(&pcm[at], n, codes);
+    }
+    return file;
+}
+
+// As tools/memos_to_wav.py reads one back
+static bool playMemo(const std::vector<uint8_t>& file, Pcm& pcm) {
+    MemoHeader header;
+    if (file.size() < sizeof(header)) return false;
+    memcpy(&header, &file[0], sizeof(header));
+    if (header.magic != MEMO_MAGIC || header.bytes != header.samples / 2 ||
+        file.size() != sizeof(header) + header.bytes) {
+        return false;
+    }
+    AdpcmDecoder decoder;
+    pcm.resize(header.samples);
+    return decoder.decode(&file[sizeof(header)], header.bytes, &pcm[0]) == header.samples;
+}
+
+// Round trip through a WAV file: decodable, 4:1, and at least minSnrDb
+static void roundTrip(const char* name, const char* path, double minSnrDb) {
+    Pcm pcm;
+    uint32_t rate = 0;
+    if (!CHECK(readWav(path, pcm, rate))) {
+        printf("  %s: can't read %s\n", name, path);
+        return;
+    }
+    pcm.resize(pcm.size() & ~(size_t)1);
+    std::vector<uint8_t> memo = recordMemo(pcm);
+    Pcm decoded;
+    CHECK(playMemo(memo, decoded));
+    CHECK_EQ(decoded.size(), pcm.size());
+    size_t codeBytes = memo.size() - sizeof(MemoHeader);
+    CHECK_EQ(codeBytes * 4, pcm.size() * 2);
+
+    // One call over the whole signal gives the same codes as the chunks
+    std::vector<uint8_t> whole(pcm.size() / 2);
+    AdpcmEncoder encoder;
+    encoder.encode(&pcm[0], pcm.size(), &whole[0]);
+    CHECK(!memcmp(&whole[0], &memo[sizeof(MemoHeader)], whole.size()));
+
+    double snr = snrDb(pcm, decoded);
+    if (!CHECK(snr >= minSnrDb)) printf("  %s: SNR %.1f dB, want %.0f\n", name, snr, minSnrDb);
+    printf("  %-10s %6.1f s at %5lu Hz  SNR %5.1f dB  ratio %.2f:1 with header\n", name,
+           pcm.size() / (double)(rate ? rate : 1), (unsigned long)rate, snr,
+           pcm.size() * 2.0 / memo.size());
+}
+
+static void testFormat() {
+    // The layout memo_store.h documents and memos_to_wav.py parses
+    CHECK_EQ(sizeof(MemoHeader), 24);
+    CHECK_EQ(offsetof(MemoHeader, sampleRate), 6);
+    CHECK_EQ(offsetof(MemoHeader, startSec), 8);
+    CHECK_EQ(offsetof(MemoHeader, samples), 16);
+    CHECK_EQ(offsetof(MemoHeader, bytes), 20);
+
+    // Low nibble first: a step up then back down
+    int16_t pcm[4] = {1000, 1000, -1000, -1000};
+    uint8_t codes[2];
+    AdpcmEncoder encoder;
+    CHECK_EQ(encoder.encode(pcm, 4, codes), 2);
+    CHECK_EQ(codes[0] & 0x8, 0);
+    CHECK_EQ(codes[1] & 0x80, 0x80);
+
+    // A full memo stays 4:1 with the header counted
+    uint32_t maxBytes = sizeof(MemoHeader) + MEMO_MAX_SEC * MEMO_SAMPLE_RATE / 2;
+    CHECK(MEMO_MAX_SEC * MEMO_SAMPLE_RATE * 2.0 / maxBytes > 3.99);
+}
+
+static void testStreams(const char* recording) {
+    const char* tmp = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+    struct Fixture {
+        const char* name;
+        Pcm pcm;
+        double minSnrDb;
+    } fixtures[] = {
+        {"voice", voice(10), 24},
+        {"tone_1k", tone(5, 1000, 8000), 18},
+        {"tone_3k", tone(5, 3000, 8000), 12},
+        {"hiss", hiss(5), 20},
+        {"square", square(2), 5},   // A wrapped predictor goes negative
+    };
+    printf("adpcm round trips:\n");
+    for (size_t i = 0; i < sizeof(fixtures) / sizeof(fixtures[0]); i++) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/adpcm_test_%s.wav", tmp, fixtures[i].name);
+        CHECK(writeWav(path, fixtures[i].pcm, MEMO_SAMPLE_RATE));
+        roundTrip(fixtures[i].name, path, fixtures[i].minSnrDb);
+        remove(path);
+    }
+    // A real recording: no SNR bar, it's there to listen to and measure
+    if (recording) roundTrip("recording", recording, 0);
+}
+
+static void testThroughput() {
+    Pcm pcm = voice(10);
+    std::vector<uint8_t> codes(pcm.size() / 2);
+    Pcm decoded(pcm.size());
+    int rounds = BENCH_SECONDS / 10;
+
+    AdpcmEncoder encoder;
+    double start = nowSec();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t at = 0; at < pcm.size(); at += MEMO_CHUNK) {
+            size_t n = pcm.size() - at < MEMO_CHUNK ? pcm.size() - at : MEMO_CHUNK;
+            encoder.encode(&pcm[at], n, &codes[at / 2]);
+        }
+    }
+    double encodeSec = nowSec() - start;
+
+    AdpcmDecoder decoder;
+    start = nowSec();
+    for (int r = 0; r < rounds; r++) decoder.decode(&codes[0], codes.size(), &decoded[0]);
+    double decodeSec = nowSec() - start;
+
+    double samples = (double)rounds * pcm.size();
+    printf("adpcm throughput (%d s of audio):\n", BENCH_SECONDS);
+    printf("  encode %7.1f Msamples/s  %8.0fx real time\n", samples / encodeSec / 1e6,
+           BENCH_SECONDS / encodeSec);
+    printf("  decode %7.1f Msamples/s  %8.0fx real time\n", samples / decodeSec / 1e6,
+           BENCH_SECONDS / decodeSec);
+    CHECK(snrDb(pcm, decoded) >= 24);  // The timed loops did the work
+    CHECK(BENCH_SECONDS / encodeSec > 1);
+}
+
+int main(int argc, char** argv) {
+    testFormat();
+    testStreams(argc > 1 ? argv[1] : NULL);
+    testThroughput();
+    return checkSummary("adpcm_test");
+}
@@ -0,0 +1,253 @@
+// Steady-state allocations: none after warm-up
+//
+//     g++ -I. -Itools/tests tools/tests/alloc_test.cpp scheduler.cpp screen.cpp night_log.cpp layout.cpp
+//
+// malloc, calloc, realloc and free are replaced with counting versions over
+// glibc's (operator new goes through malloc), the host equivalent of the
+// profile build's --wrap. A stand-in loop() then drives the modules loop()
+// keeps on the heap-free path - the scheduler, the screen stack, the layout
+// renderer (into tools/tests/M5StickCPlus2.h's counting display), the night
+// log and the SPSC queues - for two simulated days at 10 Hz. After
+// MEM_STEADY_AFTER_LOOPS iterations, as MemStats does on the watch, any
+// allocation fails the test and its caller is printed for addr2line.
+
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+#include "memstats.h"
+#include "scheduler.h"
+#include "screen.h"
+#include "layout.h"
+#include "night_log.h"
+#include "spsc_queue.h"
+#include <M5StickCPlus2.h>
+
+#define LOOP_MS 100
+#define DAY_LOOPS (24 * 3600 * 1000 / LOOP_MS)
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+
+static bool counting = false;
+static uint32_t allocs = 0;
+static void* lastCaller = NULL;
+
+static void counted(void* caller) {
+    if (!counting) return;
+    allocs++;
+    lastCaller = caller;
+}
+
+extern "C" void* malloc(size_t size) {
+    counted(__builtin_return_address(0));
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    counted(__builtin_return_address(0));
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    counted(__builtin_return_address(0));
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void* ptr) {
+    __libc_free(ptr);
+}
+
+// The sensor and audio tasks' traffic, as tasks.cpp
+struct ImuSample {
+    float x, y, z;
+    uint32_t ms;
+};
+
+struct CueCommand {
+    const void* pattern;
+};
+
+struct ClockAnchor {
+    int64_t epochUs;
+    int64_t timerUs;
+};
+
+static SpscQueue<ImuSample, 32> imuQueue;
+static SpscQueue<CueCommand, 4> cueQueue;
+static SpscActivity cueActivity;
+static SeqSnapshot<ClockAnchor> clockAnchor;
+
+// A clock face, a menu and a value editor on the screen stack
+static const LayoutOp CLOCK_OPS[] = {
+    LFIELD(20, 40, 4, WHITE, 0, 8),
+    LFIELD(20, 80, 2, GREEN, 1, 10),
+    LTEXT(20, 110, 1, WHITE, "next check"),
+    LFIELD(90, 110, 1, YELLOW, 2, 12),
+};
+static const Layout CLOCK_LAYOUT = makeLayout(CLOCK_OPS);
+
+static const LayoutOp MENU_OPS[] = {
+    LTEXT(10, 10, 2, CYAN, "Menu"),
+    LFIELD(10, 40, 2, WHITE, 0, 16),
+    LFIELD(10, 70, 2, WHITE, 1, 16),
+};
+static const Layout MENU_LAYOUT = makeLayout(MENU_OPS);
+
+static LayoutRenderer renderer;
+static ScreenStack screens;
+static EventScheduler scheduler;
+static NightRecorder nightLog;
+
+static int64_t nowSec;
+static int64_t loops;
+static int menuIndex;
+static float batteryVolts = 4.1f;
+static int handoffErrors;   // Stale clock anchors, undrained cues
+
+static void renderClock() {
+    renderer.begin(CLOCK_LAYOUT);
+    int secOfDay = (int)(nowSec % 86400);
+    renderer.setf(0, "%02d:%02d:%02d", secOfDay / 3600, secOfDay / 60 % 60, secOfDay % 60);
+    renderer.setf(1, "%.2fV %d%%", batteryVolts, (int)(batteryVolts * 100 - 320));
+    int64_t due = scheduler.dueOf(EVENT_REALITY_CHECK);
+    renderer.setf(2, "in %lld min", (long long)(due ? (due - nowSec) / 60 : 0));
+    if (batteryVolts < 3.5f) renderer.setColor(1, RED, BLACK);
+    renderer.end();
+}
+
+static void renderMenu() {
+    static const char* const ITEMS[] = {"Set Time", "Alarms/Day", "Night Mode", "Sleep Report"};
+    renderer.begin(MENU_LAYOUT);
+    renderer.setf(0, "> %s", ITEMS[menuIndex % 4]);
+    renderer.set(1, ITEMS[(menuIndex + 1) % 4]);
+    renderer.end();
+}
+
+static void tickMenu(unsigned long) {
+    if (loops % 20 == 0) menuIndex++;
+}
+
+static void invalidateRenderer() {
+    renderer.invalidate();
+}
+
+static const Screen CLOCK_SCREEN = {"clock", 1000, false, true, NULL, NULL, renderClock, NULL, NULL};
+static const Screen MENU_SCREEN = {"menu", 200, true, false, NULL, NULL, renderMenu, NULL, tickMenu};
+static const Screen EDIT_SCREEN = {"edit", 200, true, false, NULL, NULL, renderMenu, NULL, NULL};
+
+// Wrist movement with the odd rollover, and what the mic would report
+static uint32_t noiseState = 34;
+
+static float jitter() {
+    noiseState = noiseState * 1664525 + 1013904223;
+    return ((noiseState >> 8) / (float)(1 << 24) - 0.5f) * 0.02f;
+}
+
+static void scheduleCheck() {
+    scheduler.schedule(EVENT_REALITY_CHECK, nowSec + 30 * 60 + (int64_t)(noiseState % (60 * 60)));
+}
+
+// One pass of the firmware's loop(): drain the sensor queue into the night
+// log, run due events, hand cues to the audio side, then the screen stack
+static void loopOnce() {
+    nowSec = 1700000000 + loops * LOOP_MS / 1000;
+
+    // Sensor task side: a sample a loop, the clock anchor now and then
+    ImuSample sample = {jitter(), jitter(), 1.0f + jitter(), (uint32_t)(loops * LOOP_MS)};
+    if (loops % 3000 < 40) sample.x += (loops & 1) ? 0.4f : -0.4f;
+    imuQueue.push(sample);
+    if (loops % 50 == 0) clockAnchor.publish(ClockAnchor{nowSec * 1000000, loops * LOOP_MS * 1000});
+
+    ImuSample in;
+    while (imuQueue.pop(in)) {
+        if (nightLog.update(in.x, in.y, in.z) && nightLog.isFull()) {
+            // A night's worth: decode it as the sleep report does, then start over
+            NightReader reader(nightLog.getHeader(), nightLog.getData());
+            NightEpoch epoch;
+            int epochs = 0;
+            while (reader.next(epoch)) epochs++;
+            CHECK_EQ(epochs, NIGHT_MAX_EPOCHS);
+            CHECK(nightLog.checksum() != 0);
+            nightLog.begin(nowSec);
+        }
+    }
+    if (loops % 10 == 0) nightLog.addSound((loops / 10) % 97 == 0 ? 1 : 0);
+    ClockAnchor anchor = clockAnchor.read();
+    handoffErrors += anchor.epochUs > nowSec * 1000000;
+
+    TimedEvent event;
+    uint32_t allowed = screens.top()->allowAlarms ? 0xFFFFFFFF : EVENT_BIT(EVENT_MORNING_ALARM);
+    SchedResult result = scheduler.poll(nowSec, allowed, event);
+    if (result != SCHED_NONE) {
+        if (event.kind == EVENT_REALITY_CHECK) {
+            scheduleCheck();
+            nightLog.markCue();
+            cueQueue.push(CueCommand{&event});
+            cueActivity.mark();
+        } else if (event.kind == EVENT_MORNING_ALARM) {
+            scheduler.schedule(EVENT_MORNING_ALARM, EventScheduler::nextDaily(nowSec, 7 * 3600));
+        }
+    }
+    int64_t deadline;
+    scheduler.nextDeadline(deadline);
+
+    // Audio task side
+    CueCommand cue;
+    cueActivity.beginDrain();
+    while (cueQueue.pop(cue)) {}
+    cueActivity.idle();
+    handoffErrors += cueActivity.active();
+
+    // Menu in and out every few minutes, an editor on top now and then
+    int64_t phase = loops % 3000;
+    if (phase == 100) screens.push(&MENU_SCREEN);
+    if (phase == 200 && loops % 9000 == 200) screens.push(&EDIT_SCREEN);
+    if (phase == 300) screens.popToRoot();
+    batteryVolts = 3.3f + (loops % 100000) / 100000.0f;
+
+    screens.tick(loops * LOOP_MS);
+    screens.input();
+    screens.render(loops * LOOP_MS);
+    loops++;
+}
+
+int main() {
+    screens.setTransitionHook(invalidateRenderer);
+    screens.setRoot(&CLOCK_SCREEN);
+    nowSec = 1700000000;
+    nightLog.begin(nowSec);
+    scheduleCheck();
+    scheduler.schedule(EVENT_MORNING_ALARM, EventScheduler::nextDaily(nowSec, 7 * 3600));
+    printf("steady state allocations:\n");   // stdout's buffer, before counting
+
+    while (loops < MEM_STEADY_AFTER_LOOPS) loopOnce();
+    M5.Display.resetCounts();
+    counting = true;
+    while (loops < 2 * DAY_LOOPS) loopOnce();
+    counting = false;
+
+    uint32_t steady = allocs;
+    printf("  %lld loops, %u allocations after warm-up", (long long)(loops - MEM_STEADY_AFTER_LOOPS), steady);
+    if (steady) printf(" (last from %p; addr2line -e the binary)", lastCaller);
+    printf("\n  display: %u prints, %llu chars, %u fills, %llu pixels\n", M5.Display.prints,
+           (unsigned long long)M5.Display.charsPrinted, M5.Display.fills,
+           (unsigned long long)M5.Display.pixelsFilled);
+    CHECK_EQ(steady, 0);
+    CHECK(M5.Display.prints > 2 * 86400);   // The clock redrew every second
+    CHECK_EQ(imuQueue.getDropped(), 0);
+    CHECK_EQ(handoffErrors, 0);
+
+    // The counter is live: an allocation here is seen
+    counting = true;
+    void* volatile p = malloc(16);
+    free(p);
+    int* volatile q = new int(3);
+    delete q;
+    counting = false;
+    CHECK_EQ(allocs - steady, 2);
+    return checkSummary("alloc_test");
+}
@@ -0,0 +1,166 @@
+// AlwaysOn: the panel commands, redraws, and what the face costs against
+// switching the panel off
+//
+//     g++ -I. -Itools/tests tools/tests/aod_test.cpp aod.cpp night_monitor.cpp
+//
+// enter() and exit() run against the host display in
+// tools/tests/M5StickCPlus2.h, which keeps the commands sent. The energy
+// run compares aodMeanCurrentMa() for the panel on, the face (idle +
+// partial mode, lowest backlight step, 100 ms polls) and the panel off after
+// the timeout, for the face alone and for a day of checking the time.
+
+#include <math.h>
+#include "check.h"
+#include "aod.h"
+#include "config.h"
+#include "night_monitor.h"
+#include <M5StickCPlus2.h>
+
+// ST7789, as aod.cpp
+#define CMD(c) (0x100 | (c))
+#define PTLON 0x12
+#define NORON 0x13
+#define PTLAR 0x30
+#define IDMOFF 0x38
+#define IDMON 0x39
+
+// main.cpp's BRIGHTNESS_VALUES: the lowest step and the default (level 8)
+#define BACKLIGHT_MIN 25
+#define BACKLIGHT_DEFAULT 225
+
+static void testCommands() {
+    setCpuFrequencyMhz(240);
+    M5.Display.resetCounts();
+    CHECK(!AlwaysOn::isActive());
+    AlwaysOn::exit(BACKLIGHT_DEFAULT);             // Not active: nothing sent
+    CHECK_EQ(M5.Display.calls, 0);
+
+    AlwaysOn::enter(BACKLIGHT_MIN);
+    CHECK(AlwaysOn::isActive());
+    static const uint16_t ENTER[] = {
+        CMD(PTLAR), (AOD_PANEL_ROW0 + AOD_X) >> 8, (AOD_PANEL_ROW0 + AOD_X) & 0xFF,
+        (AOD_PANEL_ROW0 + AOD_X + AOD_WIDTH - 1) >> 8, (AOD_PANEL_ROW0 + AOD_X + AOD_WIDTH - 1) & 0xFF,
+        CMD(PTLON), CMD(IDMON),
+    };
+    CHECK_EQ(M5.Display.logged, sizeof(ENTER) / sizeof(ENTER[0]));
+    for (int i = 0; i < M5.Display.logged; i++) CHECK_EQ(M5.Display.log[i], ENTER[i]);
+    CHECK(!M5.Display.writing);
+    CHECK_EQ(M5.Display.brightness, BACKLIGHT_MIN);
+    CHECK_EQ(getCpuFrequencyMhz(), CLOCK_FREQUENCY);
+    CHECK_EQ(M5.Display.fills, 1);                 // Cleared before the band is set
+
+    // The band is centred on the panel's 320 rows, so mirroring can't move it
+    CHECK_EQ(AOD_PANEL_ROW0 + AOD_X + AOD_PANEL_ROW0 + AOD_X + AOD_WIDTH, 320);
+
+    // Entering twice changes nothing
+    M5.Display.resetCounts();
+    AlwaysOn::enter(BACKLIGHT_DEFAULT);
+    CHECK_EQ(M5.Display.calls, 0);
+    CHECK_EQ(M5.Display.brightness, BACKLIGHT_MIN);
+
+    M5.Display.resetCounts();
+    AlwaysOn::exit(BACKLIGHT_DEFAULT);
+    CHECK(!AlwaysOn::isActive());
+    CHECK_EQ(M5.Display.logged, 2);
+    CHECK_EQ(M5.Display.log[0], CMD(IDMOFF));
+    CHECK_EQ(M5.Display.log[1], CMD(NORON));
+    CHECK_EQ(M5.Display.brightness, BACKLIGHT_DEFAULT);
+    CHECK_EQ(getCpuFrequencyMhz(), 240);           // The clock it had before
+}
+
+static void testRedraw() {
+    CHECK(!AlwaysOn::needsRedraw(7, 30));          // Not active
+    AlwaysOn::enter(BACKLIGHT_MIN);
+    CHECK(AlwaysOn::needsRedraw(7, 30));           // First frame
+    CHECK(!AlwaysOn::needsRedraw(7, 30));
+    CHECK(AlwaysOn::needsRedraw(7, 31));
+    CHECK(AlwaysOn::needsRedraw(8, 31));
+    CHECK(!AlwaysOn::needsRedraw(8, 31));
+    // A whole day of 100 ms polls: one redraw a minute
+    int redraws = 0;
+    for (int poll = 0; poll < 24 * 36000; poll++) {
+        int minuteOfDay = poll / 600;
+        redraws += AlwaysOn::needsRedraw(minuteOfDay / 60, minuteOfDay % 60);
+    }
+    CHECK_EQ(redraws, 24 * 60);
+    AlwaysOn::exit(BACKLIGHT_DEFAULT);
+
+    // Re-entering redraws at once, even in the same minute
+    AlwaysOn::enter(BACKLIGHT_MIN);
+    CHECK(AlwaysOn::needsRedraw(23, 59));
+    AlwaysOn::exit(BACKLIGHT_DEFAULT);
+}
+
+static void testModel() {
+    float off = aodMeanCurrentMa(AOD_PANEL_OFF, BACKLIGHT_DEFAULT, AOD_AWAKE_DELAY_MS);
+    float face = aodMeanCurrentMa(AOD_PANEL_FACE, BACKLIGHT_MIN, AOD_LOOP_DELAY_MS);
+    float on = aodMeanCurrentMa(AOD_PANEL_ON, BACKLIGHT_DEFAULT, AOD_AWAKE_DELAY_MS);
+
+    // Panel off ignores the backlight; everything else grows with it
+    CHECK_EQ(off, aodMeanCurrentMa(AOD_PANEL_OFF, 0, AOD_AWAKE_DELAY_MS));
+    CHECK(fabsf(aodMeanCurrentMa(AOD_PANEL_ON, 255, 10) - aodMeanCurrentMa(AOD_PANEL_ON, 0, 10) -
+                POWER_BACKLIGHT_FULL_MA) < 0.001f);
+    // Slower polls only ever save
+    CHECK(aodMeanCurrentMa(AOD_PANEL_FACE, BACKLIGHT_MIN, 1000) < face);
+    CHECK(face < aodMeanCurrentMa(AOD_PANEL_FACE, BACKLIGHT_MIN, AOD_AWAKE_DELAY_MS));
+    // Never below the floor of board, IMU and the idle CPU
+    CHECK(aodMeanCurrentMa(AOD_PANEL_FACE, 0, 1000000) > POWER_BOARD_MA + POWER_IMU_FULL_MA + POWER_CPU_SLOW_IDLE_MA);
+    CHECK(face < on / 2);
+    // Panel off leaves the CPU at full clock polling every 10 ms, which
+    // costs more than the face's panel and backlight: the face comes out
+    // ahead of it
+    CHECK(face < off);
+}
+
+// A waking day: the screen on for checks of the time (onFraction), the
+// rest timed out to the face or to panel off
+static float dayMa(float onFraction, bool alwaysOn) {
+    float on = aodMeanCurrentMa(AOD_PANEL_ON, BACKLIGHT_DEFAULT, AOD_AWAKE_DELAY_MS);
+    float rest = alwaysOn ? aodMeanCurrentMa(AOD_PANEL_FACE, BACKLIGHT_MIN, AOD_LOOP_DELAY_MS)
+                          : aodMeanCurrentMa(AOD_PANEL_OFF, 0, AOD_AWAKE_DELAY_MS);
+    return onFraction * on + (1 - onFraction) * rest;
+}
+
+static void testReport() {
+    struct Mode {
+        const char* name;
+        AodPanelMode mode;
+        uint8_t backlight;
+        uint32_t pollMs;
+    } modes[] = {
+        {"panel on", AOD_PANEL_ON, BACKLIGHT_DEFAULT, AOD_AWAKE_DELAY_MS},
+        {"full panel, min backlight", AOD_PANEL_ON, BACKLIGHT_MIN, AOD_AWAKE_DELAY_MS},
+        {"face, 10 ms polls", AOD_PANEL_FACE, BACKLIGHT_MIN, AOD_AWAKE_DELAY_MS},
+        {"face", AOD_PANEL_FACE, BACKLIGHT_MIN, AOD_LOOP_DELAY_MS},
+        {"panel off", AOD_PANEL_OFF, 0, AOD_AWAKE_DELAY_MS},
+    };
+    printf("screen timeout energy (model):\n");
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        float ma = aodMeanCurrentMa(modes[i].mode, modes[i].backlight, modes[i].pollMs);
+        printf("  %-26s %5.2f mA, %4.1f h per charge\n", modes[i].name, ma, POWER_BATTERY_MAH / ma);
+    }
+    // Each step of the face saves something on the way down from the panel
+    // on at its lowest backlight
+    for (size_t i = 2; i < 4; i++) {
+        CHECK(aodMeanCurrentMa(modes[i].mode, modes[i].backlight, modes[i].pollMs) <
+              aodMeanCurrentMa(modes[i - 1].mode, modes[i - 1].backlight, modes[i - 1].pollMs));
+    }
+
+    printf("a waking day, screen on for time checks:\n");
+    for (int pct = 2; pct <= 10; pct += 4) {
+        float withFace = dayMa(pct / 100.0f, true);
+        float panelOff = dayMa(pct / 100.0f, false);
+        printf("  on %2d%%: face %.2f mA (%.1f h), panel off %.2f mA (%.1f h), face costs %+.0f%%\n", pct,
+               withFace, POWER_BATTERY_MAH / withFace, panelOff, POWER_BATTERY_MAH / panelOff,
+               (withFace / panelOff - 1) * 100);
+        CHECK(withFace < panelOff);
+    }
+}
+
+int main() {
+    testCommands();
+    testRedraw();
+    testModel();
+    testReport();
+    return checkSummary("aod_test");
+}
@@ -0,0 +1,18 @@
+#!/bin/sh
+# Host benchmarks, from the repo root:
+#
+#     tools/tests/bench.sh > bench-host.jsonl
+#     tools/tests/bench.sh my_trace.csv         # replay another wrist trace
+#
+# Builds tools/tests/bench_host.cpp at -O2 with the firmware's Bench runner
+# (bench.cpp under LUCID_BENCH) and prints one JSON line per benchmark, as
+# the bench build does over serial. Exits non-zero if the build fails.
+
+CXX=${CXX:-g++}
+OUT=${TMPDIR:-/tmp}/lucid-host-tests
+FLAGS="-std=gnu++11 -O2 -pthread -Wall -Wextra -I. -Itools/tests -DLUCID_PROFILE -DLUCID_BENCH"
+
+mkdir -p "$OUT"
+$CXX $FLAGS tools/tests/bench_host.cpp bench.cpp profiler.cpp scheduler.cpp layout.cpp imu.cpp motion_trigger.cpp \
+    imu_kernels.cpp wrist_raise.cpp night_monitor.cpp aod.cpp settings.cpp -o "$OUT/bench_host" || exit 1
+exec "$OUT/bench_host" "$@"
@@ -0,0 +1,312 @@
+// Host benchmarks: the bench build's suite, minus the hardware
+//
+//     tools/tests/bench.sh > bench-host.jsonl
+//     tools/tests/bench.sh tools/wrist_trace.csv   # trace to replay (the default)
+//
+// Runs the firmware's Bench runner (bench.cpp) over the modules that build
+// on a host, printing the same JSON lines as the watch; cycles are host
+// nanoseconds (cycles_per_us 1000), so compare host runs with host runs.
+// Drawing goes to the counting display in tools/tests/M5StickCPlus2.h and
+// settings to the simulated NVS in tools/tests/Preferences.h, so besides
+// time the run reports what each frame drew and what each save wrote.
+// Scheduling runs over simulated weeks, and the IMU detectors over the
+// synthetic trace the watch uses and a recorded wrist trace.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "bench.h"
+#include "scheduler.h"
+#include "layout.h"
+#include "imu.h"
+#include "imu_kernels.h"
+#include "motion_trigger.h"
+#include "shake_detector.h"
+#include "wrist_raise.h"
+#include "night_monitor.h"
+#include "aod.h"
+#include "settings.h"
+#include <M5StickCPlus2.h>
+#include <Preferences.h>
+
+#define SHAKE_NORMAL 0.50f   // main.cpp's SENSITIVITY_VALUES[2]
+
+// As runBenchmarks() in main.cpp: gravity on Z, slow sway, a sharp bump
+// every 64 samples
+static m5::imu_data_t syntheticImuSample(int i) {
+    m5::imu_data_t d = {};
+    float t = i * 0.1f;
+    d.accel.x = 0.05f * sinf(t * 0.7f);
+    d.accel.y = 0.05f * cosf(t * 0.5f);
+    d.accel.z = 1.0f + ((i % 64 == 0) ? 1.5f : 0.0f);
+    d.gyro.x = 20.0f * sinf(t);
+    d.gyro.y = 10.0f * cosf(t * 1.3f);
+    d.gyro.z = (i % 97 == 0) ? 250.0f : 5.0f;
+    return d;
+}
+
+// Display: the brightness editor's shape - a title, a bar and a value
+enum { FIELD_VALUE, FIELD_BAR, FIELD_HINT };
+static const LayoutOp BRIGHTNESS_OPS[] = {
+    LTEXT(10, 5, 2, YELLOW, "BRIGHTNESS"),
+    LFIELD(10, 40, 3, GREEN, FIELD_VALUE, 4),
+    LFIELD(10, 75, 2, WHITE, FIELD_BAR, 11),
+    LFIELD(5, 115, 1, CYAN, FIELD_HINT, 20),
+};
+static const Layout BRIGHTNESS_LAYOUT = makeLayout(BRIGHTNESS_OPS);
+static LayoutRenderer ui;
+
+static void drawBrightness(int level) {
+    static const char BAR[] = "##########";
+    ui.begin(BRIGHTNESS_LAYOUT);
+    ui.setf(FIELD_VALUE, "%d%%", level * 10);
+    ui.setf(FIELD_BAR, "[%.*s]", level, BAR);
+    ui.set(FIELD_HINT, "A:+ B:- PWR:Save");
+    ui.end();
+}
+
+// What the display did per frame over one Bench::run
+static void displayLine(const char* name, int frames) {
+    HostDisplay& d = M5.Display;
+    printf("{\"bench_display\":{\"name\":\"%s\",\"frames\":%d,\"calls_per_frame\":%.1f,\"fills_per_frame\":%.1f,"
+           "\"pixels_per_frame\":%.0f,\"chars_per_frame\":%.1f}}\n",
+           name, frames, d.calls / (float)frames, d.fills / (float)frames, d.pixelsFilled / (float)frames,
+           d.charsPrinted / (float)frames);
+    d.resetCounts();
+}
+
+static void benchDisplay() {
+    M5.Display.resetCounts();
+    Bench::run("draw_brightness_full", [](int i) { ui.invalidate(); drawBrightness(i % 11); }, 440);
+    displayLine("draw_brightness_full", 440);
+    Bench::run("draw_brightness", [](int i) { drawBrightness(i % 11); }, 440);
+    displayLine("draw_brightness", 440);
+    Bench::run("draw_brightness_idle", [](int) { drawBrightness(5); }, 440);
+    displayLine("draw_brightness_idle", 440);
+}
+
+// Scheduling: as the watch, on a private scheduler over simulated weeks
+static const int64_t BENCH_EPOCH = 1704067200;  // 2024-01-01 00:00
+static EventScheduler benchScheduler;
+
+static int nextCheckMin() {
+    int minMin, maxMin;
+    EventScheduler::checkIntervalRange(12, minMin, maxMin);
+    return minMin + rand() % (maxMin - minMin + 1);
+}
+
+static void benchScheduling() {
+    srand(27);
+    Bench::run("schedule_next_alarm", [](int i) {
+        int64_t nowSec = BENCH_EPOCH + i * 3600;
+        benchScheduler.schedule(EVENT_REALITY_CHECK, nowSec + nextCheckMin() * 60);
+    }, 24 * 7);
+
+    benchScheduler.clear();
+    benchScheduler.schedule(EVENT_REALITY_CHECK, BENCH_EPOCH + nextCheckMin() * 60);
+    Bench::run("alarm_trigger_week", [](int i) {
+        int64_t nowSec = BENCH_EPOCH + i * 60;
+        TimedEvent event;
+        if (benchScheduler.poll(nowSec, EVENT_BIT(EVENT_REALITY_CHECK), event) != SCHED_NONE) {
+            benchScheduler.schedule(EVENT_REALITY_CHECK, nowSec + nextCheckMin() * 60);
+        }
+    }, 1440 * 7);
+
+    // Every kind at once: checks, the morning alarm and its window, REM
+    // cues through the night, polled every second for four weeks
+    benchScheduler.clear();
+    Bench::run("scheduler_all_kinds_4w", [](int i) {
+        int64_t nowSec = BENCH_EPOCH + i;
+        if (!benchScheduler.isScheduled(EVENT_REALITY_CHECK)) {
+            benchScheduler.schedule(EVENT_REALITY_CHECK, nowSec + nextCheckMin() * 60);
+        }
+        if (!benchScheduler.isScheduled(EVENT_MORNING_ALARM)) {
+            int64_t alarm = EventScheduler::nextDaily(nowSec, 7 * 3600);
+            benchScheduler.schedule(EVENT_MORNING_ALARM, alarm);
+            benchScheduler.schedule(EVENT_WAKE_WINDOW, alarm - 30 * 60);
+        }
+        int32_t secOfDay = (int32_t)(nowSec % 86400);
+        if (secOfDay < 7 * 3600 && !benchScheduler.isScheduled(EVENT_REM_CUE)) {
+            benchScheduler.schedule(EVENT_REM_CUE, nowSec + 20 * 60);
+        }
+        TimedEvent event;
+        benchScheduler.poll(nowSec, 0xFFFFFFFF, event);
+        int64_t deadline;
+        benchScheduler.nextDeadline(deadline);
+    }, 28 * 86400);
+}
+
+// IMU detectors
+static IMU benchImu;
+static ShakeDetector benchShake;
+static WristRaise benchWrist;
+static NightMonitor benchMonitor;
+static MotionTrigger benchMotion;
+
+struct TraceSample {
+    unsigned long ms;
+    m5::imu_data_t d;
+};
+static std::vector<TraceSample> trace;
+
+static bool readTrace(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        TraceSample s = {};
+        if (sscanf(line, "%lu,%f,%f,%f,%f,%f,%f", &s.ms, &s.d.accel.x, &s.d.accel.y, &s.d.accel.z,
+                   &s.d.gyro.x, &s.d.gyro.y, &s.d.gyro.z) == 7) {
+            trace.push_back(s);
+        }
+    }
+    fclose(f);
+    return !trace.empty();
+}
+
+static void benchImuDetectors(const char* tracePath) {
+    Bench::run("imu_should_trigger_rc", [](int i) {
+        hostMillis() = i * 100UL;
+        benchImu.update(syntheticImuSample(i));
+        benchImu.shouldTriggerRC();
+    }, 10000);
+    Bench::run("imu_batch_features_32", [](int i) {
+        // One call covers IMU_BATCH_SIZE samples; divide by 32 for per-sample cost
+        static ImuBatch batch;
+        static ImuFeatures features;
+        if (i == 0) {
+            imuBatchClear(batch);
+            for (int k = 0; k < IMU_BATCH_SIZE; k++) {
+                m5::imu_data_t d = syntheticImuSample(k);
+                imuBatchPush(batch, d.accel.x, d.accel.y, d.accel.z, d.gyro.x, d.gyro.y, d.gyro.z);
+            }
+        }
+        imuComputeFeatures(batch, features);
+    }, 2000);
+    Bench::run("imu_wake_on_shake", [](int i) {
+        m5::imu_data_t d = syntheticImuSample(i);
+        benchShake.update(d.accel.x, d.accel.y, d.accel.z, SHAKE_NORMAL);
+    }, 10000);
+    Bench::run("imu_wrist_raise", [](int i) {
+        m5::imu_data_t d = syntheticImuSample(i);
+        benchWrist.update(d.accel.x, d.accel.y, d.accel.z, d.gyro.x, d.gyro.y, d.gyro.z, i * 100UL);
+    }, 10000);
+    Bench::run("night_monitor_batch_100", [](int) {
+        // One 10 s FIFO drain; divide by 100 for per-sample cost
+        benchMonitor.beginBatch();
+        for (int k = 0; k < 100; k++) {
+            m5::imu_data_t d = syntheticImuSample(k);
+            benchMonitor.addSample(d.accel.x, d.accel.y, d.accel.z);
+        }
+    }, 1000);
+
+    // The recorded trace through what processImuSample() in main.cpp runs
+    // on each sample - shake wake, wrist raise, and the motion classifier
+    // every MOTION_RC_HOP samples; one iteration is one replay
+    if (!readTrace(tracePath)) {
+        printf("{\"bench_trace\":{\"path\":\"%s\",\"samples\":0}}\n", tracePath);
+        return;
+    }
+    static int shakes;
+    static int raises;
+    static int motions;
+    Bench::run("imu_trace_replay", [](int) {
+        shakes = raises = motions = 0;
+        for (size_t k = 0; k < trace.size(); k++) {
+            const m5::imu_data_t& d = trace[k].d;
+            hostMillis() = trace[k].ms;
+            benchImu.update(d);
+            if (k % MOTION_RC_HOP == MOTION_RC_HOP - 1) {
+                ImuFeatures features;
+                benchImu.getFeatures(features);
+                motions += benchMotion.classify(features) != MOTION_NONE;
+            }
+            shakes += benchShake.update(d.accel.x, d.accel.y, d.accel.z, SHAKE_NORMAL);
+            raises += benchWrist.update(d.accel.x, d.accel.y, d.accel.z, d.gyro.x, d.gyro.y, d.gyro.z, trace[k].ms);
+        }
+    }, 20);
+    printf("{\"bench_trace\":{\"path\":\"%s\",\"samples\":%u,\"seconds\":%.0f,\"shakes\":%d,\"raises\":%d,"
+           "\"motions\":%d}}\n",
+           tracePath, (unsigned)trace.size(), trace.back().ms / 1000.0, shakes, raises, motions);
+}
+
+// Persistence: settings saves on the simulated NVS
+static Settings benchSettings;
+static Preferences benchPrefs;
+
+// The keys writeSettings() in main.cpp puts, with the values varying
+static void writeSettings(Preferences& prefs, int v) {
+    prefs.putInt("timeout", 15);
+    prefs.putInt("sensitivity", 2);
+    prefs.putInt("brightness", 8);
+    prefs.putInt("clockColor", v % 8);
+    prefs.putInt("alarmsDay", 12);
+    prefs.putBool("use24h", true);
+    prefs.putBool("aod", false);
+    prefs.putInt("quietStart", 1);
+    prefs.putInt("quietEnd", 7);
+    prefs.putBool("manualOn", false);
+    prefs.putInt("manualHour", 7);
+    prefs.putInt("manualMin", 0);
+    prefs.putInt("smartWake", 30);
+    prefs.putBool("motionRC", true);
+    prefs.putBool("nightSleep", false);
+    prefs.putBool("nightSound", false);
+    prefs.putUChar("cueOutRC", 0);
+    prefs.putUChar("cueOutREM", 0);
+    prefs.putUChar("cueOutAlarm", 0);
+}
+
+static void nvsLine(const char* name, int saves) {
+    HostNvs& nvs = hostNvs();
+    printf("{\"bench_nvs\":{\"name\":\"%s\",\"saves\":%d,\"puts_per_save\":%.1f,\"entries_per_save\":%.2f,"
+           "\"bytes_per_save\":%.0f}}\n",
+           name, saves, nvs.puts / (float)saves, nvs.entriesWritten / (float)saves,
+           nvs.entriesWritten * HOST_NVS_ENTRY_BYTES / (float)saves);
+    nvs.resetCounts();
+}
+
+static void benchPersistence() {
+    benchSettings.begin();
+    benchSettings.save();
+    hostNvs().resetCounts();
+    Bench::run("settings_save", [](int) { benchSettings.save(); }, 100);
+    nvsLine("settings_save", 100);
+    Bench::run("settings_save_changed", [](int) {
+        benchSettings.checkCount++;
+        benchSettings.save();
+    }, 100);
+    nvsLine("settings_save_changed", 100);
+
+    benchPrefs.begin("lucidbench", false);
+    writeSettings(benchPrefs, 0);
+    hostNvs().resetCounts();
+    Bench::run("save_settings_main", [](int) { writeSettings(benchPrefs, 0); }, 100);
+    nvsLine("save_settings_main", 100);
+    Bench::run("save_settings_main_changed", [](int i) { writeSettings(benchPrefs, i + 1); }, 100);
+    nvsLine("save_settings_main_changed", 100);
+    Bench::run("save_next_alarm", [](int i) { benchPrefs.putLong64("nextAlarm", BENCH_EPOCH + i * 3600); }, 100);
+    nvsLine("save_next_alarm", 100);
+    benchPrefs.clear();
+    benchPrefs.end();
+}
+
+int main(int argc, char** argv) {
+    Bench::begin();
+    benchDisplay();
+    benchScheduling();
+    benchImuDetectors(argc > 1 ? argv[1] : "tools/wrist_trace.csv");
+    benchPersistence();
+
+    // The energy models, as the watch prints them
+    float loopMa = nightMeanCurrentMa(1.0f);
+    float monitorMa = nightMeanCurrentMa((22 * 16 + 20 * 60) / (8 * 3600.0f));
+    printf("{\"bench_energy\":{\"night_loop_ma\":%.2f,\"night_monitor_ma\":%.2f,\"aod_face_ma\":%.2f,"
+           "\"panel_off_ma\":%.2f,\"battery_mah\":%.0f}}\n",
+           loopMa, monitorMa, aodMeanCurrentMa(AOD_PANEL_FACE, 25, AOD_LOOP_DELAY_MS),
+           aodMeanCurrentMa(AOD_PANEL_OFF, 0, AOD_AWAKE_DELAY_MS), POWER_BATTERY_MAH);
+    Bench::end();
+    return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+
+// Minimal assertions for the host tests (tools/tests/run.sh)
+// A failed check prints file:line and the expression, and the test carries
+// on so one run shows every failure; main() ends with
+// `return checkSummary("name");`, non-zero if anything failed.
+
+static int checksRun = 0;
+static int checksFailed = 0;
+
+static inline bool checkTrue(bool ok, const char* expr, const char* file, int line) {
+    checksRun++;
+    if (!ok) {
+        checksFailed++;
+        printf("%s:%d: CHECK(%s) failed\n", file, line, expr);
+    }
+    return ok;
+}
+
+static inline bool checkEq(long long a, long long b, const char* exprA, const char* exprB,
+                           const char* file, int line) {
+    checksRun++;
+    if (a != b) {
+        checksFailed++;
+        printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", file, line, exprA, exprB, a, b);
+    }
+    return a == b;
+}
+
+static inline int checkSummary(const char* name) {
+    printf("%s: %d checks, %d failed\n", name, checksRun, checksFailed);
+    return checksFailed ? 1 : 0;
+}
+
+#define CHECK(cond) checkTrue((cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQ(a, b) checkEq((long long)(a), (long long)(b), #a, #b, __FILE__, __LINE__)
+
+#endif
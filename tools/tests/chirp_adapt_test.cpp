@@ -0,0 +1,129 @@
+// ChirpAdapt: ambient level from a mic clip, and the chirp level it picks
+//
+//     g++ -I. -Itools/tests tools/tests/chirp_adapt_test.cpp chirp_adapt.cpp sound_features.cpp cue.cpp cue_clips.cpp
+//     ./a.out [ambient.wav ...]
+//
+// The clips are SOUND_WINDOW_SAMPLES of room sound as the mic records them
+// before a check - broadband noise over the PDM mic's DC offset - written
+// to WAV and read back, at levels either side of each boundary in the
+// chirp_adapt.h table. Recordings (8 kHz, 16-bit) named on the command line
+// are run a window at a time and the chirp each would get is printed.
+
+#include <math.h>
+#include <stdlib.h>
+#include "check.h"
+#include "wav.h"
+#include "chirp_adapt.h"
+#include "sound_features.h"
+
+static const uint8_t BOUNDARY_DB[] = {40, 50, 60, 70};
+
+static uint32_t noiseState = 48;
+
+static double noise() {
+    double sum = 0;
+    for (int i = 0; i < 4; i++) {
+        noiseState = noiseState * 1664525 + 1013904223;
+        sum += (noiseState >> 8) / (double)(1 << 24) - 0.5;
+    }
+    return sum * sqrt(3.0);  // Unit RMS
+}
+
+// Room noise at levelDb (dB re 1 LSB^2) around a DC offset
+static Pcm clip(double levelDb, double dc) {
+    Pcm pcm(SOUND_WINDOW_SAMPLES);
+    double rms = sqrt(pow(10, levelDb / 10));
+    for (size_t k = 0; k < pcm.size(); k++) pcm[k] = (int16_t)lrint(dc + rms * noise());
+    return pcm;
+}
+
+static void testBoundaries() {
+    CHECK_EQ(ChirpAdapt::levelFor(0), 0);
+    for (int level = 0; level < CUE_CHIRP_LEVEL_COUNT - 1; level++) {
+        CHECK_EQ(ChirpAdapt::levelFor(BOUNDARY_DB[level] - 1), level);
+        CHECK_EQ(ChirpAdapt::levelFor(BOUNDARY_DB[level]), level + 1);
+    }
+    CHECK_EQ(ChirpAdapt::levelFor(255), CUE_CHIRP_LEVEL_COUNT - 1);
+
+    // The table gets louder with each row: more duty-weighted time on
+    uint32_t lastEnergy = 0;
+    for (int level = 0; level < CUE_CHIRP_LEVEL_COUNT; level++) {
+        const CuePattern& p = CUE_CHIRP_LEVELS[level];
+        uint32_t energy = 0;
+        for (int i = 0; i < p.count; i++) {
+            if (p.steps[i].freqHz) energy += p.steps[i].level * p.steps[i].durationMs;
+        }
+        if (!CHECK(energy > lastEnergy)) printf("  %s is no louder than the row below\n", p.name);
+        lastEnergy = energy;
+    }
+    CHECK(&CUE_CHIRP_LEVELS[CUE_CHIRP_DEFAULT_LEVEL] == &CUE_REALITY_CHECK);
+}
+
+static void testDcRemoval() {
+    // Silence at any offset is 0 dB
+    Pcm flat(SOUND_WINDOW_SAMPLES, -300);
+    CHECK_EQ(ChirpAdapt::ambientDb(&flat[0], flat.size()), 0);
+    Pcm pinned(SOUND_WINDOW_SAMPLES, 32767);
+    CHECK_EQ(ChirpAdapt::ambientDb(&pinned[0], pinned.size()), 0);
+    CHECK_EQ(ChirpAdapt::ambientDb(&flat[0], 0), 0);
+    CHECK_EQ(ChirpAdapt::ambientDb(&flat[0], 1), 0);
+
+    // The same room reads the same whatever the mic's offset
+    for (int dc = -4000; dc <= 4000; dc += 1000) {
+        noiseState = 48;
+        Pcm pcm = clip(45, dc);
+        int db = ChirpAdapt::ambientDb(&pcm[0], pcm.size());
+        if (!CHECK(abs(db - 45) <= 1)) printf("  offset %d: %d dB\n", dc, db);
+    }
+}
+
+// Clips either side of each boundary, through a WAV file as a recording
+// would come in, pick the row on their side
+static void testClips() {
+    const char* tmp = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+    char path[256];
+    snprintf(path, sizeof(path), "%s/chirp_adapt_test.wav", tmp);
+    printf("chirp levels by ambient clip:\n");
+    for (int b = 0; b < CUE_CHIRP_LEVEL_COUNT - 1; b++) {
+        for (int side = -1; side <= 1; side += 2) {
+            double levelDb = BOUNDARY_DB[b] + side * 2;
+            CHECK(writeWav(path, clip(levelDb, -300), SOUND_SAMPLE_RATE));
+            Pcm pcm;
+            uint32_t rate = 0;
+            if (!CHECK(readWav(path, pcm, rate))) continue;
+            uint8_t db = ChirpAdapt::ambientDb(&pcm[0], pcm.size());
+            int level = ChirpAdapt::levelFor(db);
+            CHECK(abs(db - levelDb) <= 1);
+            if (!CHECK_EQ(level, side < 0 ? b : b + 1)) printf("  %.0f dB clip read %d dB\n", levelDb, db);
+            printf("  %2.0f dB room -> %2d dB -> %s\n", levelDb, db, CUE_CHIRP_LEVELS[level].name);
+        }
+    }
+    remove(path);
+}
+
+// Recordings: a window every second, as the check would sample them
+static void replay(const char* path) {
+    Pcm pcm;
+    uint32_t rate = 0;
+    if (!CHECK(readWav(path, pcm, rate)) || !CHECK_EQ(rate, SOUND_SAMPLE_RATE)) {
+        printf("  %s: want 8 kHz 16-bit WAV\n", path);
+        return;
+    }
+    int counts[CUE_CHIRP_LEVEL_COUNT] = {0};
+    for (size_t at = 0; at + SOUND_WINDOW_SAMPLES <= pcm.size(); at += SOUND_SAMPLE_RATE) {
+        counts[ChirpAdapt::levelFor(ChirpAdapt::ambientDb(&pcm[at], SOUND_WINDOW_SAMPLES))]++;
+    }
+    printf("%s:", path);
+    for (int level = 0; level < CUE_CHIRP_LEVEL_COUNT; level++) {
+        printf(" %s %d", CUE_CHIRP_LEVELS[level].name, counts[level]);
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    testBoundaries();
+    testDcRemoval();
+    testClips();
+    for (int i = 1; i < argc; i++) replay(argv[i]);
+    return checkSummary("chirp_adapt_test");
+}
@@ -0,0 +1,167 @@
+// CueAdapt: the response classes, nudge, back-off and spacing, and replayed
+// nights
+//
+//     g++ -I. -Itools/tests tools/tests/cue_adapt_test.cpp cue_adapt.cpp cue.cpp cue_clips.cpp
+//
+// Each cue is answered with a synthetic response trace: CUE_RESPONSE_SAMPLES
+// accelerometer samples of which the first `moves` step by 0.1 g. The
+// replayed nights put a model sleeper behind the traces - unnoticed below
+// their threshold level, stirring at it, waking a few levels above - and
+// check the controller settles where the cues are perceived.
+
+#include "check.h"
+#include "cue_adapt.h"
+
+// One cue and its response window; returns the response class
+static CueResponse cue(CueAdapt& adapt, int moves) {
+    const CuePattern& pattern = adapt.startCue();
+    CHECK(&pattern == &CUE_REM_LEVELS[adapt.getLevel()]);
+    CHECK(adapt.isListening());
+    float x = 0;
+    int closedAt = -1;
+    for (int i = 0; i < CUE_RESPONSE_SAMPLES; i++) {
+        if (i > 0 && i <= moves) x += (i & 1) ? 0.1f : -0.1f;
+        if (adapt.update(x, 0.0f, 1.0f) && closedAt < 0) closedAt = i;
+    }
+    CHECK_EQ(closedAt, CUE_RESPONSE_SAMPLES - 1);
+    CHECK(!adapt.isListening());
+    return adapt.lastResponse();
+}
+
+static void testResponses() {
+    CueAdapt adapt;
+    CHECK_EQ(adapt.getLevel(), CUE_REM_DEFAULT_LEVEL);
+    CHECK_EQ(adapt.getExtraMin(), 0);
+    CHECK(!adapt.update(0, 0, 1));  // Not listening
+
+    // None (short of the stir count): kept until CUE_NUDGE_AFTER in a row
+    adapt.begin(3);
+    for (int i = 1; i < CUE_NUDGE_AFTER; i++) CHECK_EQ(cue(adapt, CUE_STIR_MOVES - 1), CUE_RESPONSE_NONE);
+    CHECK_EQ(adapt.getLevel(), 3);
+    CHECK_EQ(cue(adapt, 0), CUE_RESPONSE_NONE);
+    CHECK_EQ(adapt.getLevel(), 4);
+    CHECK_EQ(adapt.getExtraMin(), 0);
+
+    // Stir: level kept, and it breaks a run of unanswered cues
+    adapt.begin(3);
+    for (int i = 1; i < CUE_NUDGE_AFTER; i++) cue(adapt, 0);
+    CHECK_EQ(cue(adapt, CUE_STIR_MOVES), CUE_RESPONSE_STIR);
+    CHECK_EQ(cue(adapt, CUE_AROUSAL_MOVES - 1), CUE_RESPONSE_STIR);
+    CHECK_EQ(adapt.getLevel(), 3);
+    for (int i = 1; i < CUE_NUDGE_AFTER; i++) cue(adapt, 0);
+    CHECK_EQ(adapt.getLevel(), 3);
+
+    // Arousal: back off and space the next cue out
+    adapt.begin(5);
+    CHECK_EQ(cue(adapt, CUE_AROUSAL_MOVES), CUE_RESPONSE_AROUSAL);
+    CHECK_EQ(adapt.getLevel(), 5 - CUE_BACKOFF_LEVELS);
+    CHECK_EQ(adapt.getExtraMin(), CUE_BACKOFF_MIN);
+    CHECK_EQ(cue(adapt, CUE_RESPONSE_SAMPLES - 1), CUE_RESPONSE_AROUSAL);
+}
+
+static void testClamps() {
+    CueAdapt adapt;
+
+    // Back-off stops at level 0
+    adapt.begin(1);
+    cue(adapt, CUE_AROUSAL_MOVES);
+    CHECK_EQ(adapt.getLevel(), 0);
+    cue(adapt, CUE_AROUSAL_MOVES);
+    CHECK_EQ(adapt.getLevel(), 0);
+
+    // Extra minutes stop at CUE_MAX_EXTRA_MIN
+    for (int i = 0; i < CUE_MAX_EXTRA_MIN; i++) cue(adapt, CUE_AROUSAL_MOVES);
+    CHECK_EQ(adapt.getExtraMin(), CUE_MAX_EXTRA_MIN);
+
+    // The nudge stops at the top level
+    adapt.begin(CUE_REM_LEVEL_COUNT - 1);
+    for (int i = 0; i < 4 * CUE_NUDGE_AFTER; i++) cue(adapt, 0);
+    CHECK_EQ(adapt.getLevel(), CUE_REM_LEVEL_COUNT - 1);
+
+    // begin() takes a learned level and a resumed night's spacing, and
+    // falls back on anything out of range
+    adapt.begin(-1);
+    CHECK_EQ(adapt.getLevel(), CUE_REM_DEFAULT_LEVEL);
+    adapt.begin(CUE_REM_LEVEL_COUNT);
+    CHECK_EQ(adapt.getLevel(), CUE_REM_DEFAULT_LEVEL);
+    adapt.begin(2, 7);
+    CHECK_EQ(adapt.getLevel(), 2);
+    CHECK_EQ(adapt.getExtraMin(), 7);
+    adapt.begin(2, CUE_MAX_EXTRA_MIN + 1);
+    CHECK_EQ(adapt.getExtraMin(), 0);
+
+    // begin() mid-window drops the window
+    adapt.startCue();
+    adapt.begin(2);
+    CHECK(!adapt.isListening());
+    CHECK(!adapt.update(0, 0, 1));
+}
+
+// A minute comes off the spacing after every calm cue, down to zero
+static void testDecay() {
+    CueAdapt adapt;
+    adapt.begin(5);
+    cue(adapt, CUE_AROUSAL_MOVES);
+    cue(adapt, CUE_AROUSAL_MOVES);
+    CHECK_EQ(adapt.getExtraMin(), 2 * CUE_BACKOFF_MIN);
+    int extra = adapt.getExtraMin();
+    for (int i = 0; i < 2 * CUE_BACKOFF_MIN + 3; i++) {
+        cue(adapt, i % 2 ? CUE_STIR_MOVES : 0);
+        extra = extra > 0 ? extra - 1 : 0;
+        CHECK_EQ(adapt.getExtraMin(), extra);
+    }
+    CHECK_EQ(adapt.getExtraMin(), 0);
+
+    // A new night starts without it; the level carries over
+    cue(adapt, CUE_AROUSAL_MOVES);
+    int learned = adapt.getLevel();
+    adapt.begin(learned);
+    CHECK_EQ(adapt.getLevel(), learned);
+    CHECK_EQ(adapt.getExtraMin(), 0);
+}
+
+// The model sleeper: moves for a cue at `level`
+static int sleeperMoves(int level, int threshold) {
+    if (level < threshold) return 0;                                 // Not perceived
+    if (level < threshold + 3) return CUE_STIR_MOVES + 2 * (level - threshold);
+    return CUE_AROUSAL_MOVES + 5;                                    // Woken
+}
+
+static void testReplayedNights() {
+    // Each sleeper, from each starting level, over a few 15-cue nights
+    for (int threshold = 0; threshold < CUE_REM_LEVEL_COUNT; threshold++) {
+        for (int start = 0; start < CUE_REM_LEVEL_COUNT; start++) {
+            CueAdapt adapt;
+            int learned = start;
+            int lastNightStirs = 0;
+            int lastNightArousals = 0;
+            for (int night = 0; night < 4; night++) {
+                adapt.begin(learned);
+                lastNightStirs = 0;
+                lastNightArousals = 0;
+                for (int c = 0; c < 15; c++) {
+                    CueResponse r = cue(adapt, sleeperMoves(adapt.getLevel(), threshold));
+                    lastNightStirs += r == CUE_RESPONSE_STIR;
+                    lastNightArousals += r == CUE_RESPONSE_AROUSAL;
+                    CHECK(adapt.getExtraMin() <= CUE_MAX_EXTRA_MIN);
+                }
+                learned = adapt.getLevel();
+            }
+            // Settled: most cues perceived, none waking the sleeper
+            bool settled = lastNightStirs >= 12 && lastNightArousals == 0;
+            if (!CHECK(settled)) {
+                printf("  threshold %d from %d: %d stirs, %d arousals, level %d\n", threshold, start,
+                       lastNightStirs, lastNightArousals, learned);
+            }
+            CHECK(learned >= threshold && learned < threshold + 3);
+        }
+    }
+}
+
+int main() {
+    testResponses();
+    testClamps();
+    testDecay();
+    testReplayedNights();
+    return checkSummary("cue_adapt_test");
+}
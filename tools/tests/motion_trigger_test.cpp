@@ -0,0 +1,142 @@
+// MotionTrigger: context classification and the reality check rate limit
+//
+//     g++ -I. -Itools/tests tools/tests/motion_trigger_test.cpp motion_trigger.cpp imu_kernels.cpp
+
+#include "check.h"
+#include "motion_trigger.h"
+
+#define MINUTE_MS (60UL * 1000)
+
+static ImuFeatures stillWindow() {
+    ImuFeatures f = {};
+    f.samples = IMU_BATCH_SIZE;
+    f.accelMagSqMean = 1.0f;
+    f.accelMagSqVar = 0.0005f;
+    f.accelMagSqMin = 0.98f;
+    f.accelMagSqMax = 1.02f;
+    f.gyroMagSqMean = 4.0f;
+    f.gyroMagSqMax = 25.0f;
+    f.jerkSum = 0.01f;
+    return f;
+}
+
+static ImuFeatures walkWindow() {
+    ImuFeatures f = stillWindow();
+    f.accelMagSqVar = 0.08f;
+    f.accelMagSqMin = 0.6f;
+    f.accelMagSqMax = 1.6f;
+    f.jerkSum = 0.6f;
+    f.gravityCrossings = 10;
+    return f;
+}
+
+static void testClassify() {
+    MotionTrigger trigger;
+    ImuFeatures still = stillWindow();
+    ImuFeatures walk = walkWindow();
+
+    // Walking only counts as a start after stillness
+    CHECK_EQ(trigger.classify(walk), MOTION_NONE);
+    CHECK_EQ(trigger.classify(still), MOTION_NONE);
+    CHECK_EQ(trigger.classify(walk), MOTION_WALK_START);
+    CHECK_EQ(trigger.classify(walk), MOTION_NONE);
+
+    ImuFeatures standUp = still;
+    standUp.accelMagSqVar = 0.01f;
+    standUp.jerkSum = 1.5f;
+    CHECK_EQ(trigger.classify(still), MOTION_NONE);
+    CHECK_EQ(trigger.classify(standUp), MOTION_STAND_UP);
+
+    // Instantaneous contexts don't need stillness first
+    ImuFeatures spin = walk;
+    spin.gyroMagSqMax = MOTION_SPIN_DPS * MOTION_SPIN_DPS * 1.5f;
+    CHECK_EQ(trigger.classify(spin), MOTION_SPIN);
+    ImuFeatures fall = walk;
+    fall.accelMagSqMin = 0.02f;
+    CHECK_EQ(trigger.classify(fall), MOTION_FREE_FALL);
+
+    // A part-filled batch is never classified
+    ImuFeatures partial = fall;
+    partial.samples = IMU_BATCH_SIZE - 1;
+    CHECK_EQ(trigger.classify(partial), MOTION_NONE);
+}
+
+static void testBurstAndRefill() {
+    MotionTrigger trigger;
+    unsigned long t = 1000;
+    trigger.reset(t);
+    for (int i = 0; i < MOTION_RC_BURST; i++) CHECK(trigger.tryConsumeToken(t));
+    CHECK(!trigger.tryConsumeToken(t));
+
+    // One token per refill period, not before
+    CHECK(!trigger.tryConsumeToken(t + MOTION_RC_REFILL_MS - 1));
+    CHECK(trigger.tryConsumeToken(t + MOTION_RC_REFILL_MS));
+    CHECK(!trigger.tryConsumeToken(t + MOTION_RC_REFILL_MS + 1));
+
+    // A long gap refills to the burst size and no further
+    t += 10 * MOTION_RC_REFILL_MS;
+    for (int i = 0; i < MOTION_RC_BURST; i++) CHECK(trigger.tryConsumeToken(t));
+    CHECK(!trigger.tryConsumeToken(t));
+}
+
+// A full bucket doesn't bank refill time: the next token comes a whole
+// period after the bucket was last full, however long it sat idle
+static void testNoBanking() {
+    MotionTrigger trigger;
+    unsigned long full = MOTION_RC_REFILL_MS - MINUTE_MS;
+    trigger.reset(0);
+    CHECK(trigger.tryConsumeToken(full));
+    CHECK_EQ(trigger.getTokens(), MOTION_RC_BURST - 1);
+    CHECK(trigger.tryConsumeToken(full + 2 * MINUTE_MS));
+    CHECK(!trigger.tryConsumeToken(full + 2 * MINUTE_MS));
+    CHECK(!trigger.tryConsumeToken(full + MOTION_RC_REFILL_MS - 1));
+    CHECK(trigger.tryConsumeToken(full + MOTION_RC_REFILL_MS));
+}
+
+// The first use starts the bucket full, whatever millis() reads
+static void testLazyStart() {
+    MotionTrigger trigger;
+    unsigned long t = 7UL * 24 * 60 * MINUTE_MS;
+    for (int i = 0; i < MOTION_RC_BURST; i++) CHECK(trigger.tryConsumeToken(t));
+    CHECK(!trigger.tryConsumeToken(t));
+}
+
+// A fidgety wearer: a context every classify hop (1.6 s) for a waking day.
+// The reality checks that get through must stay within the bucket's bound.
+static void testDayLongLimit() {
+    MotionTrigger trigger;
+    ImuFeatures still = stillWindow();
+    ImuFeatures walk = walkWindow();
+    unsigned long start = 0;
+    unsigned long day = 16 * 60 * MINUTE_MS;
+    unsigned long hop = MOTION_RC_HOP * 100;
+    unsigned long lastFire = 0;
+    unsigned long minGap = day;
+    int contexts = 0;
+    int fired = 0;
+
+    trigger.reset(start);
+    for (unsigned long t = start; t < start + day; t += hop) {
+        bool walking = (t / hop) & 1;
+        if (trigger.classify(walking ? walk : still) == MOTION_NONE) continue;
+        contexts++;
+        if (!trigger.tryConsumeToken(t)) continue;
+        if (fired > MOTION_RC_BURST && t - lastFire < minGap) minGap = t - lastFire;
+        lastFire = t;
+        fired++;
+    }
+    CHECK(contexts > 10000);
+    CHECK_EQ(fired, MOTION_RC_BURST + day / MOTION_RC_REFILL_MS);
+    // Once the burst is spent, refilled checks are a refill period apart,
+    // give or take the wait for the next context (every other hop)
+    CHECK(minGap + 2 * hop > MOTION_RC_REFILL_MS);
+}
+
+int main() {
+    testClassify();
+    testBurstAndRefill();
+    testNoBanking();
+    testLazyStart();
+    testDayLongLimit();
+    return checkSummary("motion_trigger_test");
+}
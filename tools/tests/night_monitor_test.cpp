@@ -0,0 +1,231 @@
+// NightMonitor: sleep lengths, movement wakes and a night's energy
+//
+//     g++ -I. -Itools/tests tools/tests/night_monitor_test.cpp night_monitor.cpp
+//
+// The unit cases pin sleepMs() to its lead, minimum and period edges and
+// movementWake() across FIFO batches. The night run mirrors
+// runNightMonitor() in main.cpp over 8 h of synthetic wrist movement with
+// REM cues, counts the time awake in the loop against the time light
+// sleeping, and compares the modelled current with the loop awake all night
+// as it was before the monitor.
+
+#include <math.h>
+#include "check.h"
+#include "night_monitor.h"
+
+#define MS 1000LL                  // esp_timer microseconds
+#define NIGHT_MS (8 * 3600 * 1000LL)
+#define SAMPLE_MS 100              // 10 Hz, as the FIFO
+
+// As main.cpp
+#define MOVE_HOLD_MS 60000
+#define RESYNC_HOLD_MS 3000
+#define CUE_LISTEN_MS 15000        // CUE_RESPONSE_SAMPLES at 10 Hz
+
+static void testSleepMs() {
+    const int64_t now = 5000000 * MS;
+    const int64_t lead = NIGHT_MONITOR_LEAD_MS * MS;
+
+    CHECK_EQ(NightMonitor::sleepMs(now, false, 0), NIGHT_MONITOR_PERIOD_MS);
+    CHECK_EQ(NightMonitor::sleepMs(now, true, now + 3600000 * MS), NIGHT_MONITOR_PERIOD_MS);
+    // Period edge: the deadline only shortens the sleep once it's closer
+    CHECK_EQ(NightMonitor::sleepMs(now, true, now + lead + NIGHT_MONITOR_PERIOD_MS * MS), NIGHT_MONITOR_PERIOD_MS);
+    CHECK_EQ(NightMonitor::sleepMs(now, true, now + lead + NIGHT_MONITOR_PERIOD_MS * MS - MS),
+             NIGHT_MONITOR_PERIOD_MS - 1);
+    // Lead edge: wakes NIGHT_MONITOR_LEAD_MS ahead of the event
+    CHECK_EQ(NightMonitor::sleepMs(now, true, now + lead + 4321 * MS), 4321);
+    CHECK_EQ(NightMonitor::sleepMs(now, true, now + lead + 4321 * MS + 999), 4321);  // Rounds down
+    // Minimum edge: shorter sleeps aren't worth it
+    CHECK_EQ(NightMonitor::sleepMs(now, true, now + lead + NIGHT_MONITOR_MIN_SLEEP_MS * MS),
+             NIGHT_MONITOR_MIN_SLEEP_MS);
+    CHECK_EQ(NightMonitor::sleepMs(now, true, now + lead + NIGHT_MONITOR_MIN_SLEEP_MS * MS - 1), 0);
+    CHECK_EQ(NightMonitor::sleepMs(now, true, now + lead), 0);
+    CHECK_EQ(NightMonitor::sleepMs(now, true, now - 60000 * MS), 0);  // Overdue
+    // The FIFO holds a full period
+    CHECK(NIGHT_MONITOR_PERIOD_MS / SAMPLE_MS < 170);
+}
+
+// A drain whose first `moving` samples each step 0.1 g ((0.1)^2 > MOVE_G2),
+// the rest held still; the arm swings back the other way next time
+static void batch(NightMonitor& m, int samples, int moving) {
+    static float x = 0;
+    static float step = 0.1f;
+    m.beginBatch();
+    for (int i = 0; i < samples; i++) {
+        if (i < moving) x += step;
+        m.addSample(x, 0.0f, 1.0f);
+    }
+    step = -step;
+}
+
+static void testMovementWake() {
+    NightMonitor m;
+
+    // Still: no moves, however long
+    batch(m, 100, 0);
+    CHECK_EQ(m.getBatchMoves(), 0);
+    CHECK_EQ(m.getBatchSamples(), 100);
+    CHECK(!m.movementWake());
+
+    // Small jitter under the threshold isn't movement
+    m.beginBatch();
+    for (int i = 0; i < 100; i++) m.addSample(0.01f * (i & 1), 0.02f * (i & 1), 1.0f);
+    CHECK_EQ(m.getBatchMoves(), 0);
+
+    // One short of the wake count, then the wake count, in one batch
+    batch(m, 100, NIGHT_MONITOR_WAKE_MOVES - 1);
+    CHECK_EQ(m.getBatchMoves(), NIGHT_MONITOR_WAKE_MOVES - 1);
+    CHECK(!m.movementWake());
+    batch(m, 100, NIGHT_MONITOR_WAKE_MOVES);
+    CHECK(m.movementWake());
+
+    // Counts don't carry over: two half batches of movement don't wake
+    batch(m, 100, NIGHT_MONITOR_WAKE_MOVES / 2);
+    CHECK(!m.movementWake());
+    batch(m, 100, NIGHT_MONITOR_WAKE_MOVES / 2);
+    CHECK(!m.movementWake());
+
+    // But the sample before a batch does: a turn between two drains shows
+    // as a move on the first sample of the next
+    batch(m, 10, 0);
+    m.beginBatch();
+    m.addSample(0.3f, 0.0f, 0.95f);
+    CHECK_EQ(m.getBatchMoves(), 1);
+
+    // After reset() the first sample has nothing to compare with
+    m.reset();
+    m.beginBatch();
+    m.addSample(0.3f, 0.0f, 0.95f);
+    CHECK_EQ(m.getBatchMoves(), 0);
+    CHECK_EQ(m.getBatchSamples(), 1);
+}
+
+static void testCurrentModel() {
+    float awake = nightMeanCurrentMa(1.0f);
+    float asleep = nightMeanCurrentMa(0.0f);
+    CHECK(fabsf(awake - (POWER_BOARD_MA + POWER_CPU_ACTIVE_MA + POWER_IMU_FULL_MA)) < 0.001f);
+    CHECK(fabsf(asleep - (POWER_BOARD_MA + POWER_LIGHT_SLEEP_MA + POWER_IMU_ACCEL_MA)) < 0.001f);
+    CHECK(fabsf(nightMeanCurrentMa(0.5f) - (awake + asleep) / 2) < 0.001f);
+    CHECK_EQ(nightMeanCurrentMa(2.0f), awake);   // Clamped
+    CHECK_EQ(nightMeanCurrentMa(-1.0f), asleep);
+}
+
+// Wrist movement over the night: still with sensor noise, and a rollover
+// (6 s of large changes) every rolloverEveryMs
+static uint32_t noiseState = 45;
+
+static float jitter() {
+    noiseState = noiseState * 1664525 + 1013904223;
+    return ((noiseState >> 8) / (float)(1 << 24) - 0.5f) * 0.01f;
+}
+
+static void wrist(int64_t ms, int64_t rolloverEveryMs, float& x, float& y, float& z) {
+    int64_t into = ms % rolloverEveryMs;
+    bool rolling = ms > rolloverEveryMs / 2 && into < 6000;
+    float roll = rolling ? (into / SAMPLE_MS % 2 ? 0.4f : -0.4f) : 0.0f;
+    x = roll + jitter();
+    y = jitter();
+    z = 1.0f + jitter();
+}
+
+struct NightResult {
+    int64_t awakeMs;
+    int64_t asleepMs;
+    int sessions;
+    int moveWakes;
+    int cues;
+    int maxBatch;
+};
+
+// runNightMonitor() and the loop around it; cues every cueEveryMs from 3 h
+static NightResult simulateNight(int64_t rolloverEveryMs, int64_t cueEveryMs) {
+    NightResult r = {};
+    NightMonitor monitor;
+    int64_t now = 0;
+    int64_t awakeUntil = 0;
+    int64_t nextCue = 3 * 3600 * 1000LL;
+
+    while (now < NIGHT_MS) {
+        if (nextCue <= now) {
+            r.cues++;
+            r.awakeMs += CUE_LISTEN_MS;   // Cue plays, response listened for
+            now += CUE_LISTEN_MS;
+            nextCue += cueEveryMs;
+            continue;
+        }
+        if (now < awakeUntil) {
+            int64_t until = awakeUntil < nextCue ? awakeUntil : nextCue;
+            r.awakeMs += until - now;
+            now = until;
+            continue;
+        }
+        if (NightMonitor::sleepMs(now * MS, true, nextCue * MS) == 0) {
+            r.awakeMs += nextCue - now;   // Too close to the cue to sleep
+            now = nextCue;
+            continue;
+        }
+
+        r.sessions++;
+        int64_t start = now;
+        int64_t holdMs = RESYNC_HOLD_MS;
+        for (;;) {
+            if (now - start >= NIGHT_MONITOR_SPAN_SEC * 1000LL) break;
+            uint32_t sleepMs = NightMonitor::sleepMs(now * MS, true, nextCue * MS);
+            if (sleepMs == 0) break;
+            int64_t until = now + sleepMs;
+            monitor.beginBatch();
+            for (int64_t t = (now / SAMPLE_MS + 1) * SAMPLE_MS; t <= until; t += SAMPLE_MS) {
+                float x, y, z;
+                wrist(t, rolloverEveryMs, x, y, z);
+                monitor.addSample(x, y, z);
+            }
+            r.asleepMs += sleepMs;
+            now = until;
+            if (monitor.getBatchSamples() > r.maxBatch) r.maxBatch = monitor.getBatchSamples();
+            if (monitor.movementWake()) {
+                r.moveWakes++;
+                holdMs = MOVE_HOLD_MS;
+                break;
+            }
+        }
+        awakeUntil = now + holdMs;
+    }
+    return r;
+}
+
+static void testNightEnergy() {
+    struct Case {
+        const char* name;
+        int64_t rolloverEveryMs;
+        int64_t cueEveryMs;
+    } cases[] = {
+        {"quiet sleeper", 40 * 60000LL, 20 * 60000LL},
+        {"restless", 10 * 60000LL, 20 * 60000LL},
+        {"cue every 7 min", 40 * 60000LL, 7 * 60000LL},
+    };
+    float loopMa = nightMeanCurrentMa(1.0f);
+    printf("night energy, 8 h (loop awake all night: %.2f mA, %.0f mAh, %.1f nights per charge):\n",
+           loopMa, loopMa * 8, POWER_BATTERY_MAH / (loopMa * 8));
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        NightResult r = simulateNight(cases[i].rolloverEveryMs, cases[i].cueEveryMs);
+        float awakeFraction = r.awakeMs / (float)(r.awakeMs + r.asleepMs);
+        float monitorMa = nightMeanCurrentMa(awakeFraction);
+        printf("  %-16s awake %4.1f%% (%2d cues, %2d movement wakes, %3d sessions)  %.2f mA, %.1f mAh, %.1f nights\n",
+               cases[i].name, awakeFraction * 100, r.cues, r.moveWakes, r.sessions, monitorMa, monitorMa * 8,
+               POWER_BATTERY_MAH / (monitorMa * 8));
+
+        CHECK(r.awakeMs + r.asleepMs >= NIGHT_MS);
+        CHECK(r.maxBatch <= NIGHT_MONITOR_PERIOD_MS / SAMPLE_MS);  // Fits the FIFO
+        CHECK(r.moveWakes > 0);                                    // Rollovers hand back to the loop
+        CHECK(awakeFraction < 0.15f);
+        CHECK(monitorMa < loopMa / 4);
+    }
+}
+
+int main() {
+    testSleepMs();
+    testMovementWake();
+    testCurrentModel();
+    testNightEnergy();
+    return checkSummary("night_monitor_test");
+}
@@ -0,0 +1,329 @@
+// Night session and log in RTC_NOINIT memory: cold boot, warm reset,
+// corruption and resuming mid-night
+//
+//     g++ -I. -Itools/tests tools/tests/night_session_test.cpp night_session.cpp night_log.cpp
+//
+// The session and the NightRecorder sit in one block standing in for
+// RTC_NOINIT memory: filled with garbage for a power-on, left alone for a
+// reset or deep sleep, bit-flipped for corruption. nightEnter() and
+// saveNightSession() mirror main.cpp. Every night is decoded back with
+// NightReader and compared epoch by epoch with what was fed in.
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "check.h"
+#include "night_session.h"
+#include "sound_features.h"
+
+#define FIRST_REM_CUE_SEC (270 * 60)  // As main.cpp
+
+// RTC_NOINIT_ATTR in main.cpp
+struct NoInit {
+    NightSession session;
+    NightRecorder log;
+};
+static NoInit rtc;
+
+// RAM: lost on every reset
+static int64_t clockSec;
+static int64_t pendingCueSec;
+static bool logRestarted;
+static float lastZ;
+
+static void powerOn(uint32_t seed) {
+    srand(seed);
+    uint8_t* p = (uint8_t*)&rtc;
+    for (size_t i = 0; i < sizeof(rtc); i++) p[i] = rand();
+}
+
+static void saveNightSession() {
+    rtc.session.nextCueSec = pendingCueSec;
+    rtc.session.cueLevel = 3;
+    rtc.session.cueExtraMin = 7;
+    nightSessionSeal(rtc.session, rtc.log.checksum());
+}
+
+// main.cpp nightEnter(); true if it resumed
+static bool nightEnter() {
+    bool resumed = nightSessionValid(rtc.session, clockSec);
+    logRestarted = false;
+    if (resumed) {
+        if (rtc.session.logCrc != rtc.log.checksum()) {
+            logRestarted = true;
+            rtc.log.begin(rtc.session.startSec);
+        }
+        rtc.log.resume(clockSec);
+        pendingCueSec = rtc.session.nextCueSec;
+    } else {
+        rtc.session.startSec = clockSec;
+        rtc.session.sleeps = 0;
+        rtc.log.begin(clockSec);
+        pendingCueSec = clockSec + FIRST_REM_CUE_SEC;
+    }
+    saveNightSession();
+    return resumed;
+}
+
+// Expected epochs, built with the staging rules in night_log.h
+struct Expect {
+    std::vector<NightEpoch> epochs;
+    uint16_t recent[3];
+
+    void clear() {
+        epochs.clear();
+        memset(recent, 0, sizeof(recent));
+    }
+
+    void gap(int64_t count) {
+        NightEpoch e = {0, SLEEP_UNKNOWN, false};
+        for (int64_t i = 0; i < count; i++) epochs.push_back(e);
+        memset(recent, 0, sizeof(recent));
+    }
+
+    void epoch(uint16_t moves, bool cue) {
+        uint32_t score = (4 * moves + 2 * recent[0] + recent[1] + recent[2]) / 8;
+        uint8_t stage = moves >= NIGHT_WAKE_MOVES ? SLEEP_WAKE : score >= NIGHT_LIGHT_SCORE ? SLEEP_LIGHT : SLEEP_DEEP;
+        NightEpoch e = {moves, stage, cue};
+        epochs.push_back(e);
+        recent[2] = recent[1];
+        recent[1] = recent[0];
+        recent[0] = moves;
+    }
+};
+
+// One 30 s epoch of samples with exactly `moves` movements (the first
+// sample after begin() or resume() only primes), sealing as main.cpp does
+// when it closes. Stops early, as a reset would, after `cutAfter` samples.
+static bool feedEpoch(uint16_t moves, bool cue, int cutAfter = NIGHT_EPOCH_SAMPLES) {
+    for (int i = 0; i < NIGHT_EPOCH_SAMPLES; i++) {
+        if (i == cutAfter) return false;
+        if (i == NIGHT_EPOCH_SAMPLES / 2 && cue) rtc.log.markCue();
+        if (i >= NIGHT_EPOCH_SAMPLES - moves) lastZ = lastZ > 1.05f ? 1.0f : 1.1f;
+        if (rtc.log.update(0, 0, lastZ)) saveNightSession();
+        clockSec += i % 10 == 9;
+    }
+    return true;
+}
+
+static uint32_t epochSeed = 1;
+
+static uint16_t randomMoves() {
+    epochSeed = epochSeed * 1103515245u + 12345u;
+    uint32_t r = (epochSeed >> 8) % 100;
+    return r < 70 ? 0 : r < 90 ? (epochSeed >> 16) % 8 : (epochSeed >> 16) % 200;
+}
+
+// Runs `count` whole epochs from an epoch boundary
+static void runEpochs(Expect& expect, int count) {
+    for (int i = 0; i < count && !rtc.log.isFull(); i++) {
+        uint16_t moves = randomMoves();
+        bool cue = i % 37 == 5;
+        feedEpoch(moves, cue);
+        expect.epoch(moves, cue);
+    }
+}
+
+// Decodes the log and compares it with expect
+static void checkLog(const Expect& expect) {
+    const NightHeader& header = rtc.log.getHeader();
+    CHECK(nightHeaderValid(header));
+    CHECK_EQ(header.epochs, expect.epochs.size());
+    NightReader reader(header, rtc.log.getData());
+    NightEpoch e;
+    size_t i = 0;
+    int wrong = 0;
+    int cues = 0;
+    while (reader.next(e)) {
+        if (i < expect.epochs.size()) {
+            const NightEpoch& x = expect.epochs[i];
+            wrong += e.stage != x.stage || e.cue != x.cue || (x.stage != SLEEP_UNKNOWN && e.activity != x.activity);
+            cues += x.cue;
+        }
+        i++;
+    }
+    CHECK_EQ(i, expect.epochs.size());
+    CHECK_EQ(wrong, 0);
+    CHECK_EQ(header.cues, cues);
+}
+
+// Power-on garbage is never taken for a session
+static void testColdBoot() {
+    int accepted = 0;
+    for (uint32_t seed = 1; seed <= 2000; seed++) {
+        powerOn(seed);
+        // Even with the magic and a plausible start in place
+        if (seed & 1) {
+            rtc.session.magic = NIGHT_SESSION_MAGIC;
+            rtc.session.startSec = 1700000000;
+        }
+        accepted += nightSessionValid(rtc.session, 1700000000 + 3600);
+    }
+    CHECK_EQ(accepted, 0);
+    memset(&rtc, 0, sizeof(rtc));
+    CHECK(!nightSessionValid(rtc.session, 0));
+    memset(&rtc, 0xff, sizeof(rtc));
+    CHECK(!nightSessionValid(rtc.session, -1));
+
+    // So night mode starts a fresh night and log
+    powerOn(99);
+    clockSec = 1700000000;
+    CHECK(!nightEnter());
+    CHECK_EQ(rtc.session.startSec, clockSec);
+    CHECK_EQ(pendingCueSec, clockSec + FIRST_REM_CUE_SEC);
+    CHECK_EQ(rtc.log.getHeader().epochs, 0);
+    Expect expect;
+    expect.clear();
+    runEpochs(expect, 20);
+    checkLog(expect);
+}
+
+// Resets and deep sleeps mid-night keep every sealed epoch, drop the
+// partial one and fill the time away with unknown epochs
+static void testWarmResets() {
+    powerOn(7);
+    clockSec = 1700003000;
+    CHECK(!nightEnter());
+    int64_t start = rtc.session.startSec;
+    int64_t firstCue = pendingCueSec;
+    Expect expect;
+    expect.clear();
+    runEpochs(expect, 40);
+
+    // Reset part way into an epoch, back 8 s later
+    feedEpoch(25, true, 137);
+    clockSec += 8;
+    pendingCueSec = 0;
+    CHECK(nightEnter());
+    CHECK(!logRestarted);
+    CHECK_EQ(rtc.session.startSec, start);
+    CHECK_EQ(pendingCueSec, firstCue);
+    CHECK_EQ(rtc.session.cueLevel, 3);
+    CHECK_EQ(rtc.session.cueExtraMin, 7);
+    expect.gap((clockSec - start) / NIGHT_EPOCH_SEC - (int64_t)expect.epochs.size());
+    checkLog(expect);
+
+    // Deep sleep between cues: 47 minutes off, sleeps counted
+    int64_t phase = (clockSec - start) % NIGHT_EPOCH_SEC;
+    clockSec += NIGHT_EPOCH_SEC - phase;  // Back on an epoch boundary
+    runEpochs(expect, 30);
+    rtc.session.sleeps++;
+    saveNightSession();
+    clockSec += 47 * 60;
+    CHECK(nightEnter());
+    CHECK_EQ(rtc.session.sleeps, 1);
+    expect.gap((clockSec - start) / NIGHT_EPOCH_SEC - (int64_t)expect.epochs.size());
+    runEpochs(expect, 30);
+    checkLog(expect);
+    CHECK_EQ(rtc.log.getHeader().epochs, (clockSec - start) / NIGHT_EPOCH_SEC);
+
+    // Reset after the night's last epoch: the log stops growing at its cap
+    expect.gap((start + NIGHT_MAX_EPOCHS * NIGHT_EPOCH_SEC - clockSec) / NIGHT_EPOCH_SEC);
+    clockSec = start + NIGHT_MAX_EPOCHS * NIGHT_EPOCH_SEC + 600;
+    CHECK(nightEnter());
+    CHECK(rtc.log.isFull());
+    feedEpoch(3, false);
+    CHECK_EQ(rtc.log.getHeader().epochs, NIGHT_MAX_EPOCHS);
+    CHECK_EQ(expect.epochs.size(), NIGHT_MAX_EPOCHS);
+    checkLog(expect);
+}
+
+// A flipped bit in the session ends it; one in the log restarts the log
+// but keeps the night and its cue timing
+static void testCorruption() {
+    int sessionKept = 0;
+    int logKept = 0;
+    int logCaught = 0;
+    for (uint32_t bit = 0; bit < 8 * offsetof(NightSession, crc) + 32; bit += 3) {
+        powerOn(bit);
+        clockSec = 1700100000;
+        nightEnter();
+        Expect expect;
+        expect.clear();
+        runEpochs(expect, 12);
+        ((uint8_t*)&rtc.session)[bit / 8] ^= 1 << (bit % 8);
+        clockSec += 5;
+        sessionKept += nightSessionValid(rtc.session, clockSec);
+        CHECK(!nightEnter());
+    }
+    CHECK_EQ(sessionKept, 0);
+
+    for (uint32_t i = 0; i < 200; i++) {
+        powerOn(1000 + i);
+        clockSec = 1700200000;
+        nightEnter();
+        int64_t firstCue = pendingCueSec;
+        Expect expect;
+        expect.clear();
+        runEpochs(expect, 60);
+        uint32_t bytes = rtc.log.getHeader().bytes;
+        // Packed data, or the header itself
+        uint8_t* target = i % 4 ? (uint8_t*)rtc.log.getData() : (uint8_t*)&rtc.log.getHeader();
+        uint32_t span = i % 4 ? bytes : sizeof(NightHeader);
+        target[(i * 7919) % span] ^= 1 << (i % 8);
+        clockSec += 5;
+        pendingCueSec = 0;
+        CHECK(nightEnter());
+        logKept += !logRestarted;
+        logCaught += logRestarted;
+        // The night and its cue timing carry on over a log of unknowns
+        CHECK_EQ(rtc.session.startSec, 1700200000);
+        CHECK_EQ(pendingCueSec, firstCue);
+        Expect unknown;
+        unknown.clear();
+        unknown.gap((clockSec - 1700200000) / NIGHT_EPOCH_SEC);
+        checkLog(unknown);
+    }
+    CHECK_EQ(logKept, 0);
+    CHECK_EQ(logCaught, 200);
+}
+
+// The wall clock decides whether a sealed session is still tonight's
+static void testStaleness() {
+    powerOn(5);
+    clockSec = 1700300000;
+    nightEnter();
+    int64_t start = rtc.session.startSec;
+    CHECK(nightSessionValid(rtc.session, start + NIGHT_SESSION_MAX_SEC));
+    CHECK(!nightSessionValid(rtc.session, start + NIGHT_SESSION_MAX_SEC + 1));
+    CHECK(nightSessionValid(rtc.session, start - NIGHT_SESSION_SKEW_SEC));
+    CHECK(!nightSessionValid(rtc.session, start - NIGHT_SESSION_SKEW_SEC - 1));
+
+    // A reset the next evening starts a new night
+    clockSec = start + 20 * 3600;
+    CHECK(!nightEnter());
+    CHECK_EQ(rtc.session.startSec, clockSec);
+
+    // Exiting night mode clears it
+    nightSessionClear(rtc.session);
+    CHECK(!nightSessionValid(rtc.session, clockSec));
+}
+
+// Sound only changes stages, and only where night_log.h says
+static void testSoundStages() {
+    powerOn(11);
+    clockSec = 1700400000;
+    nightEnter();
+    for (int i = 0; i < NIGHT_NOISE_SECONDS; i++) rtc.log.addSound(SOUND_NOISE);
+    feedEpoch(0, false);
+    CHECK_EQ(rtc.log.lastSleepStage(), SLEEP_LIGHT);
+    feedEpoch(0, false);
+    feedEpoch(0, false);
+    feedEpoch(0, false);
+    CHECK_EQ(rtc.log.lastSleepStage(), SLEEP_DEEP);
+    for (int i = 0; i < NIGHT_SNORE_SECONDS; i++) rtc.log.addSound(SOUND_SNORE);
+    feedEpoch(NIGHT_WAKE_MOVES, false);
+    CHECK_EQ(rtc.log.lastSleepStage(), SLEEP_LIGHT);
+    feedEpoch(NIGHT_WAKE_MOVES, false);
+    CHECK_EQ(rtc.log.lastSleepStage(), SLEEP_WAKE);
+}
+
+int main() {
+    testColdBoot();
+    testWarmResets();
+    testCorruption();
+    testStaleness();
+    testSoundStages();
+    return checkSummary("night_session_test");
+}
@@ -0,0 +1,50 @@
+#!/bin/sh
+# Build and run the host tests, from the repo root:
+#
+#     tools/tests/run.sh            # all of them
+#     tools/tests/run.sh scheduler  # just scheduler_test
+#
+# Each test links the firmware modules it covers, built for the host with
+# the warnings the firmware should stay clean under. Exits non-zero if any
+# test fails to build or fails a check.
+
+CXX=${CXX:-g++}
+OUT=${TMPDIR:-/tmp}/lucid-host-tests
+FLAGS="-std=gnu++11 -O1 -g -pthread -Wall -Wextra -I. -Itools/tests"
+ONLY=$1
+FAILED=0
+
+mkdir -p "$OUT"
+
+# run_test NAME SOURCES... - tools/tests/NAME_test.cpp plus the modules it covers
+run_test() {
+    name=$1
+    shift
+    if [ -n "$ONLY" ] && [ "$ONLY" != "$name" ]; then
+        return
+    fi
+    if ! $CXX $FLAGS "tools/tests/${name}_test.cpp" "$@" -o "$OUT/${name}_test"; then
+        echo "${name}_test: build failed"
+        FAILED=1
+    elif ! "$OUT/${name}_test"; then
+        FAILED=1
+    fi
+}
+
+run_test adpcm adpcm.cpp
+run_test alloc scheduler.cpp screen.cpp night_log.cpp layout.cpp
+run_test aod aod.cpp night_monitor.cpp
+run_test chirp_adapt chirp_adapt.cpp sound_features.cpp cue.cpp cue_clips.cpp
+run_test cue_adapt cue_adapt.cpp cue.cpp cue_clips.cpp
+run_test motion_trigger motion_trigger.cpp imu_kernels.cpp
+run_test night_monitor night_monitor.cpp
+run_test night_session night_session.cpp night_log.cpp
+run_test scheduler scheduler.cpp
+run_test screen screen.cpp
+run_test smart_wake smart_wake.cpp scheduler.cpp
+run_test softclock softclock.cpp
+run_test sound_features sound_features.cpp
+run_test spsc_queue
+run_test timebase softclock.cpp scheduler.cpp
+
+exit $FAILED
@@ -0,0 +1,286 @@
+// EventScheduler: collision rules, and random schedules against a model
+//
+//     g++ -I. -Itools/tests tools/tests/scheduler_test.cpp scheduler.cpp
+//
+// The fixed cases pin each rule in scheduler.h down. The random run drives
+// the queue with schedules, cancels, blocked kinds, clock jumps and polls,
+// mirrors it with a plain per-kind table, and after every step checks the
+// properties the firmware relies on.
+
+#include <stdlib.h>
+#include "check.h"
+#include "scheduler.h"
+
+#define ALL_KINDS (EVENT_BIT(EVENT_KIND_COUNT) - 1)
+#define RANDOM_STEPS 200000
+
+static const int64_t T0 = 1700000000;  // Any local epoch second
+
+static void testPriorityAndGap() {
+    EventScheduler s;
+    s.schedule(EVENT_REM_CUE, T0);
+    s.schedule(EVENT_WAKE_WINDOW, T0);
+    s.schedule(EVENT_MORNING_ALARM, T0);
+    s.schedule(EVENT_REALITY_CHECK, T0 - 3 * SCHED_MORNING_GUARD_S);
+    TimedEvent e;
+
+    CHECK_EQ(s.poll(T0 - 3 * SCHED_MORNING_GUARD_S - 1, ALL_KINDS, e), SCHED_NONE);
+    CHECK_EQ(s.poll(T0 - 3 * SCHED_MORNING_GUARD_S, ALL_KINDS, e), SCHED_FIRE);
+    CHECK_EQ(e.kind, EVENT_REALITY_CHECK);
+
+    // All three due together: by priority, SCHED_MIN_GAP_S apart
+    CHECK_EQ(s.poll(T0, ALL_KINDS, e), SCHED_FIRE);
+    CHECK_EQ(e.kind, EVENT_MORNING_ALARM);
+    CHECK_EQ(s.poll(T0 + SCHED_MIN_GAP_S - 1, ALL_KINDS, e), SCHED_NONE);
+    CHECK_EQ(s.poll(T0 + SCHED_MIN_GAP_S, ALL_KINDS, e), SCHED_FIRE);
+    CHECK_EQ(e.kind, EVENT_WAKE_WINDOW);
+    CHECK_EQ(s.poll(T0 + SCHED_MIN_GAP_S, ALL_KINDS, e), SCHED_NONE);
+    CHECK_EQ(s.poll(T0 + 2 * SCHED_MIN_GAP_S, ALL_KINDS, e), SCHED_FIRE);
+    CHECK_EQ(e.kind, EVENT_REM_CUE);
+    CHECK_EQ(s.size(), 0);
+}
+
+// A blocked kind waits without holding up others, and goes stale on its
+// kind's limit
+static void testBlockedAndStale() {
+    EventScheduler s;
+    s.schedule(EVENT_REALITY_CHECK, T0);
+    s.schedule(EVENT_REM_CUE, T0 + 10);
+    TimedEvent e;
+    uint32_t nightOnly = EVENT_BIT(EVENT_REM_CUE) | EVENT_BIT(EVENT_MORNING_ALARM);
+
+    CHECK_EQ(s.poll(T0 + 10, nightOnly, e), SCHED_FIRE);
+    CHECK_EQ(e.kind, EVENT_REM_CUE);
+    int64_t stale = T0 + EventScheduler::staleLimitS(EVENT_REALITY_CHECK);
+    CHECK_EQ(s.poll(stale, nightOnly, e), SCHED_NONE);
+    CHECK_EQ(s.poll(stale + 1, nightOnly, e), SCHED_MISSED);
+    CHECK_EQ(e.kind, EVENT_REALITY_CHECK);
+    CHECK_EQ(e.dueSec, T0);
+
+    // Missed is reported whatever is allowed, and ahead of due events
+    s.schedule(EVENT_MORNING_ALARM, T0 + 5000);
+    s.schedule(EVENT_REM_CUE, T0 + 9000);
+    CHECK_EQ(s.poll(T0 + 9000, ALL_KINDS, e), SCHED_MISSED);
+    CHECK_EQ(e.kind, EVENT_MORNING_ALARM);
+    CHECK_EQ(s.poll(T0 + 9000, 0, e), SCHED_NONE);
+    CHECK_EQ(s.poll(T0 + 9000, ALL_KINDS, e), SCHED_FIRE);
+
+    // Clock set back: too far ahead is missed too
+    s.schedule(EVENT_REALITY_CHECK, T0 + 20000);
+    CHECK_EQ(s.poll(T0 + 20000 - SCHED_MAX_AHEAD_S, ALL_KINDS, e), SCHED_NONE);
+    CHECK_EQ(s.poll(T0 + 20000 - SCHED_MAX_AHEAD_S - 1, ALL_KINDS, e), SCHED_MISSED);
+    CHECK_EQ(s.size(), 0);
+}
+
+static void testMorningGuard() {
+    EventScheduler s;
+    int64_t morning = T0 + 8 * 3600;
+    s.schedule(EVENT_MORNING_ALARM, morning);
+
+    // Either side of the alarm, inside the guard: just after it
+    s.schedule(EVENT_REALITY_CHECK, morning - SCHED_MORNING_GUARD_S + 1);
+    CHECK_EQ(s.dueOf(EVENT_REALITY_CHECK), morning + SCHED_MORNING_GUARD_S);
+    s.schedule(EVENT_REALITY_CHECK, morning + SCHED_MORNING_GUARD_S - 1);
+    CHECK_EQ(s.dueOf(EVENT_REALITY_CHECK), morning + SCHED_MORNING_GUARD_S);
+    // At the edges: left alone
+    s.schedule(EVENT_REALITY_CHECK, morning - SCHED_MORNING_GUARD_S);
+    CHECK_EQ(s.dueOf(EVENT_REALITY_CHECK), morning - SCHED_MORNING_GUARD_S);
+
+    // Moving the alarm onto a pending check moves the check
+    s.schedule(EVENT_MORNING_ALARM, morning - SCHED_MORNING_GUARD_S - 5);
+    CHECK_EQ(s.dueOf(EVENT_REALITY_CHECK), morning - 5);
+    CHECK_EQ(s.size(), 2);
+}
+
+static void testNextDeadline() {
+    EventScheduler s;
+    int64_t due;
+    CHECK(!s.nextDeadline(due));
+    s.schedule(EVENT_REM_CUE, T0 + 50);
+    s.schedule(EVENT_REALITY_CHECK, T0 + 20);
+    s.schedule(EVENT_WAKE_WINDOW, T0 + 90);
+    CHECK(s.nextDeadline(due));
+    CHECK_EQ(due, T0 + 20);
+    s.cancel(EVENT_REALITY_CHECK);
+    CHECK(s.nextDeadline(due));
+    CHECK_EQ(due, T0 + 50);
+    s.schedule(EVENT_REM_CUE, T0 + 100);  // Replaces
+    CHECK(s.nextDeadline(due));
+    CHECK_EQ(due, T0 + 90);
+    CHECK_EQ(s.size(), 2);
+    s.schedule(EVENT_KIND_COUNT, T0);     // Unknown kinds are ignored
+    CHECK_EQ(s.size(), 2);
+}
+
+// The model: each kind's due time, or 0
+struct Model {
+    int64_t due[EVENT_KIND_COUNT];
+    int64_t lastFire;
+};
+
+static void modelSchedule(Model& m, uint8_t kind, int64_t dueSec) {
+    m.due[kind] = dueSec;
+    int64_t rc = m.due[EVENT_REALITY_CHECK];
+    int64_t morning = m.due[EVENT_MORNING_ALARM];
+    if (rc && morning && rc - morning > -SCHED_MORNING_GUARD_S && rc - morning < SCHED_MORNING_GUARD_S) {
+        m.due[EVENT_REALITY_CHECK] = morning + SCHED_MORNING_GUARD_S;
+    }
+}
+
+static bool isStale(uint8_t kind, int64_t dueSec, int64_t now) {
+    int64_t late = now - dueSec;
+    return late > EventScheduler::staleLimitS(kind) || -late > SCHED_MAX_AHEAD_S;
+}
+
+// scheduleNextAlarmFrom() in main.cpp: the next check from the interval
+// range, or none at all with reality checks off
+static void scheduleCheck(EventScheduler& s, int64_t now, int perDay) {
+    int minMin, maxMin;
+    if (!EventScheduler::checkIntervalRange(perDay, minMin, maxMin)) {
+        s.cancel(EVENT_REALITY_CHECK);
+        return;
+    }
+    s.schedule(EVENT_REALITY_CHECK, now + (minMin + rand() % (maxMin - minMin + 1)) * 60);
+}
+
+static void testChecksPerDay() {
+    int minMin = -1, maxMin = -1;
+    CHECK(!EventScheduler::checkIntervalRange(0, minMin, maxMin));
+    CHECK(!EventScheduler::checkIntervalRange(-1, minMin, maxMin));
+    CHECK_EQ(minMin, -1);
+    for (int perDay = 1; perDay <= 20; perDay++) {
+        CHECK(EventScheduler::checkIntervalRange(perDay, minMin, maxMin));
+        int avg = SCHED_AWAKE_MIN / perDay;
+        CHECK(minMin > 0 && minMin <= avg && maxMin >= avg);
+        CHECK_EQ(minMin + maxMin, 2 * avg);
+        CHECK_EQ(maxMin - avg, avg * SCHED_CHECK_SPREAD_PCT / 100);
+    }
+
+    // Turned off with a check pending: it's dropped, and a week of polls
+    // (and reboots, which reschedule whatever isn't saved) never fires one
+    srand(40);
+    EventScheduler s;
+    scheduleCheck(s, T0, 12);
+    CHECK(s.isScheduled(EVENT_REALITY_CHECK));
+    scheduleCheck(s, T0, 0);
+    CHECK(!s.isScheduled(EVENT_REALITY_CHECK));
+    s.schedule(EVENT_MORNING_ALARM, EventScheduler::nextDaily(T0, 7 * 3600));
+    int checks = 0;
+    int mornings = 0;
+    for (int64_t now = T0; now < T0 + 7 * 86400; now += 60) {
+        if (now % 86400 == 0 && !s.isScheduled(EVENT_REALITY_CHECK)) scheduleCheck(s, now, 0);
+        TimedEvent e;
+        if (s.poll(now, ALL_KINDS, e) == SCHED_NONE) continue;
+        checks += e.kind == EVENT_REALITY_CHECK;
+        if (e.kind == EVENT_MORNING_ALARM) {
+            mornings++;
+            s.schedule(EVENT_MORNING_ALARM, EventScheduler::nextDaily(now, 7 * 3600));
+        }
+    }
+    CHECK_EQ(checks, 0);
+    CHECK_EQ(mornings, 7);
+    int64_t deadline;
+    CHECK(s.nextDeadline(deadline) && deadline == s.dueOf(EVENT_MORNING_ALARM));
+
+    // And back on: checks resume at the new rate
+    int64_t now = T0 + 7 * 86400;
+    scheduleCheck(s, now, 20);
+    int64_t due = s.dueOf(EVENT_REALITY_CHECK);
+    CHECK(due >= now + 34 * 60 && due <= now + 62 * 60);
+}
+
+static void testRandom() {
+    EventScheduler s;
+    Model m = {};
+    int64_t now = T0;
+    uint32_t fails = 0;
+    uint32_t fired = 0;
+    uint32_t missed = 0;
+    uint32_t outOfOrder = 0;
+    uint32_t gapViolations = 0;
+    uint32_t guardViolations = 0;
+    srand(40);
+
+    for (int step = 0; step < RANDOM_STEPS; step++) {
+        int op = rand() % 16;
+        uint8_t kind = rand() % EVENT_KIND_COUNT;
+        if (op < 4) {
+            // Mostly soon, sometimes far either way
+            int64_t due = now + (rand() % 8 ? rand() % 1800 - 60 : rand() % (2 * SCHED_MAX_AHEAD_S) - SCHED_MAX_AHEAD_S / 2);
+            if (due == 0) due = 1;
+            s.schedule(kind, due);
+            modelSchedule(m, kind, due);
+        } else if (op < 5) {
+            s.cancel(kind);
+            m.due[kind] = 0;
+        } else if (op < 6) {
+            now += rand() % 2 ? 3600 : -3600;  // Clock set
+        } else {
+            now += rand() % 90;
+            uint32_t allowed = rand() % 3 ? ALL_KINDS : (uint32_t)rand() & ALL_KINDS;
+            TimedEvent e;
+            SchedResult r = s.poll(now, allowed, e);
+
+            bool anyStale = false;
+            for (int k = 0; k < EVENT_KIND_COUNT; k++) anyStale |= m.due[k] && isStale(k, m.due[k], now);
+            if (r == SCHED_MISSED) {
+                missed++;
+                fails += !(m.due[e.kind] == e.dueSec && isStale(e.kind, e.dueSec, now));
+                m.due[e.kind] = 0;
+            } else if (r == SCHED_FIRE) {
+                fired++;
+                fails += !(m.due[e.kind] == e.dueSec && e.dueSec <= now && (allowed & EVENT_BIT(e.kind)));
+                fails += anyStale;
+                gapViolations += m.lastFire && now - m.lastFire < SCHED_MIN_GAP_S;
+                // Nothing else due and allowed outranks it
+                for (int k = 0; k < EVENT_KIND_COUNT; k++) {
+                    if (k == e.kind || !m.due[k] || m.due[k] > now || !(allowed & EVENT_BIT(k))) continue;
+                    outOfOrder += EventScheduler::priorityOf(k) > e.priority;
+                }
+                m.due[e.kind] = 0;
+                m.lastFire = now;
+            } else {
+                fails += anyStale;
+                // Nothing fires only inside the gap, or with nothing due and allowed
+                if (!m.lastFire || now - m.lastFire >= SCHED_MIN_GAP_S) {
+                    for (int k = 0; k < EVENT_KIND_COUNT; k++) {
+                        fails += m.due[k] && m.due[k] <= now && (allowed & EVENT_BIT(k));
+                    }
+                }
+            }
+        }
+
+        // The queue matches the model
+        int count = 0;
+        int64_t earliest = 0;
+        for (int k = 0; k < EVENT_KIND_COUNT; k++) {
+            fails += s.dueOf(k) != m.due[k] || s.isScheduled(k) != (m.due[k] != 0);
+            if (!m.due[k]) continue;
+            count++;
+            if (!earliest || m.due[k] < earliest) earliest = m.due[k];
+        }
+        int64_t deadline = 0;
+        fails += s.size() != count || s.nextDeadline(deadline) != (count > 0) || deadline != earliest;
+        int64_t rc = m.due[EVENT_REALITY_CHECK];
+        int64_t morning = m.due[EVENT_MORNING_ALARM];
+        guardViolations += rc && morning && rc - morning > -SCHED_MORNING_GUARD_S && rc - morning < SCHED_MORNING_GUARD_S;
+    }
+
+    CHECK_EQ(fails, 0);
+    CHECK_EQ(outOfOrder, 0);
+    CHECK_EQ(gapViolations, 0);
+    CHECK_EQ(guardViolations, 0);
+    // The run reached every outcome
+    CHECK(fired > 1000);
+    CHECK(missed > 1000);
+}
+
+int main() {
+    testPriorityAndGap();
+    testBlockedAndStale();
+    testMorningGuard();
+    testNextDeadline();
+    testChecksPerDay();
+    testRandom();
+    return checkSummary("scheduler_test");
+}
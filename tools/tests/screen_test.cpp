@@ -0,0 +1,219 @@
+// Screen stack and the firmware's screen table (screen_table.h)
+//
+//     g++ -I. -Itools/tests tools/tests/screen_test.cpp screen.cpp
+//
+// Walks the menu the way the buttons do - clock, menu, each item and back -
+// and checks the stack, the enter/exit/transition order and which screens
+// hold off the timeout (keepAwake) or let alarms interrupt (allowAlarms).
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "screen.h"
+
+// The table's rows, without the firmware's handlers
+struct Row {
+    const char* var;
+    const char* name;
+    bool keepAwake;
+    bool allowAlarms;
+};
+
+static const Row ROWS[] = {
+#define SCREEN(var, name, renderMs, keepAwake, allowAlarms, ...) {#var, name, keepAwake, allowAlarms},
+#include "screen_table.h"
+#undef SCREEN
+};
+static const int ROW_COUNT = sizeof(ROWS) / sizeof(ROWS[0]);
+
+struct MenuRow {
+    const char* label;
+    const char* var;
+};
+
+static const MenuRow MENU_ROWS[] = {
+#define MENU_ITEM(label, var) {label, #var},
+#include "screen_table.h"
+#undef MENU_ITEM
+};
+static const int MENU_COUNT = sizeof(MENU_ROWS) / sizeof(MENU_ROWS[0]);
+
+// Screens that hold off the timeout: the menu, the reality check and the
+// value editors. Quiet Hours, 12/24 and Test RC time out like the clock,
+// as they did before the screen stack; so do night mode and the dream
+// journal, which run for hours.
+static const char* const KEEP_AWAKE[] = {
+    "menuScreen", "timeSetScreen", "realityCheckScreen", "alarmsPerDayScreen",
+    "manualAlarmScreen", "smartWakeScreen", "screenTimeoutScreen", "sensitivityScreen",
+    "brightnessScreen", "clockColorScreen", "alwaysOnScreen", "motionRCScreen",
+    "nightSleepScreen", "nightSoundScreen", "cueOutputScreen", "sleepReportScreen",
+};
+
+// Screens no reality check or alarm may interrupt
+static const char* const NO_ALARMS[] = {
+    "menuScreen", "timeSetScreen", "realityCheckScreen", "nightScreen", "dreamJournalScreen",
+};
+
+// Enter/exit/transition log, and the stack under test for the handlers
+static std::vector<std::string> events;
+static ScreenStack* current;
+static int renders;
+
+static void logEnter() { events.push_back(std::string("enter ") + current->top()->name); }
+static void logExit() { events.push_back("exit"); }
+static void logTransition() { events.push_back("transition"); }
+static void countRender() { renders++; }
+
+static bool listed(const char* const* list, int count, const char* var) {
+    for (int i = 0; i < count; i++) {
+        if (!strcmp(list[i], var)) return true;
+    }
+    return false;
+}
+
+// A live Screen per row, with logging handlers in place of the firmware's
+static std::vector<Screen> buildScreens() {
+    std::vector<Screen> screens;
+    for (int i = 0; i < ROW_COUNT; i++) {
+        Screen s = {ROWS[i].name, 200, ROWS[i].keepAwake, ROWS[i].allowAlarms,
+                    logEnter, logExit, countRender, NULL, NULL};
+        screens.push_back(s);
+    }
+    return screens;
+}
+
+static int rowOf(const char* var) {
+    for (int i = 0; i < ROW_COUNT; i++) {
+        if (!strcmp(ROWS[i].var, var)) return i;
+    }
+    return -1;
+}
+
+static void testTable() {
+    int keepAwakeCount = sizeof(KEEP_AWAKE) / sizeof(KEEP_AWAKE[0]);
+    int noAlarmCount = sizeof(NO_ALARMS) / sizeof(NO_ALARMS[0]);
+    for (int i = 0; i < ROW_COUNT; i++) {
+        const Row& row = ROWS[i];
+        if (!CHECK_EQ(row.keepAwake, listed(KEEP_AWAKE, keepAwakeCount, row.var))) printf("  %s\n", row.var);
+        if (!CHECK_EQ(row.allowAlarms, !listed(NO_ALARMS, noAlarmCount, row.var))) printf("  %s\n", row.var);
+        for (int j = i + 1; j < ROW_COUNT; j++) CHECK(strcmp(row.name, ROWS[j].name) != 0);
+    }
+    // Every listed screen is in the table
+    for (int i = 0; i < keepAwakeCount; i++) CHECK(rowOf(KEEP_AWAKE[i]) >= 0);
+    for (int i = 0; i < noAlarmCount; i++) CHECK(rowOf(NO_ALARMS[i]) >= 0);
+
+    // Each menu item opens a screen in the table, and no two the same one
+    for (int i = 0; i < MENU_COUNT; i++) {
+        CHECK(rowOf(MENU_ROWS[i].var) >= 0);
+        for (int j = i + 1; j < MENU_COUNT; j++) CHECK(strcmp(MENU_ROWS[i].var, MENU_ROWS[j].var) != 0);
+    }
+}
+
+static void testMenuWalk() {
+    std::vector<Screen> screens = buildScreens();
+    const Screen* clock = &screens[rowOf("clockScreen")];
+    const Screen* menu = &screens[rowOf("menuScreen")];
+    ScreenStack stack;
+    current = &stack;
+    stack.setTransitionHook(logTransition);
+
+    stack.setRoot(clock);
+    CHECK_EQ(stack.getDepth(), 1);
+    CHECK(!stack.top()->keepAwake);
+    CHECK(stack.top()->allowAlarms);
+
+    stack.push(menu);
+    CHECK(stack.isTop(menu));
+    CHECK(stack.top()->keepAwake);
+
+    for (int i = 0; i < MENU_COUNT; i++) {
+        const Screen* item = &screens[rowOf(MENU_ROWS[i].var)];
+        events.clear();
+        stack.push(item);
+        CHECK_EQ(stack.getDepth(), 3);
+        CHECK(stack.isTop(item));
+        // The hook runs before enter, so enter sees the new screen on top
+        CHECK_EQ(events.size(), 2u);
+        CHECK(events[0] == "transition");
+        CHECK(events[1] == std::string("enter ") + item->name);
+        if (!CHECK_EQ(stack.top()->keepAwake, listed(KEEP_AWAKE, sizeof(KEEP_AWAKE) / sizeof(KEEP_AWAKE[0]),
+                                                      MENU_ROWS[i].var))) {
+            printf("  %s\n", MENU_ROWS[i].label);
+        }
+
+        events.clear();
+        stack.pop();
+        CHECK(stack.isTop(menu));
+        CHECK_EQ(events.size(), 2u);
+        CHECK(events[0] == "exit");
+        CHECK(events[1] == "transition");
+    }
+
+    // The root stays put
+    stack.popToRoot();
+    CHECK(stack.isTop(clock));
+    events.clear();
+    stack.pop();
+    CHECK(stack.isTop(clock));
+    CHECK(events.empty());
+}
+
+// Alarms and night mode push over whatever is showing; the stack caps
+// nesting rather than overrunning
+static void testDepthAndPopToRoot() {
+    std::vector<Screen> screens = buildScreens();
+    const Screen* clock = &screens[rowOf("clockScreen")];
+    ScreenStack stack;
+    current = &stack;
+    stack.setTransitionHook(logTransition);
+    stack.setRoot(clock);
+
+    for (int i = 1; i < SCREEN_STACK_DEPTH; i++) stack.push(&screens[i]);
+    CHECK_EQ(stack.getDepth(), SCREEN_STACK_DEPTH);
+    const Screen* top = stack.top();
+    events.clear();
+    stack.push(&screens[rowOf("realityCheckScreen")]);
+    CHECK_EQ(stack.getDepth(), SCREEN_STACK_DEPTH);
+    CHECK(stack.top() == top);
+    CHECK(events.empty());
+
+    stack.popToRoot();
+    CHECK_EQ(stack.getDepth(), 1);
+    int exits = 0;
+    for (size_t i = 0; i < events.size(); i++) exits += events[i] == "exit";
+    CHECK_EQ(exits, SCREEN_STACK_DEPTH - 1);
+}
+
+// A transition repaints at once; otherwise the top screen redraws on its period
+static void testRender() {
+    std::vector<Screen> screens = buildScreens();
+    Screen slow = screens[rowOf("nightScreen")];
+    slow.renderIntervalMs = 1000;
+    ScreenStack stack;
+    current = &stack;
+    stack.setRoot(&screens[rowOf("clockScreen")]);
+
+    renders = 0;
+    stack.push(&slow);
+    stack.render(5000);
+    CHECK_EQ(renders, 1);
+    stack.render(5500);
+    CHECK_EQ(renders, 1);
+    stack.render(6000);
+    CHECK_EQ(renders, 2);
+    stack.invalidate();
+    stack.render(6001);
+    CHECK_EQ(renders, 3);
+    stack.pop();
+    stack.render(6002);
+    CHECK_EQ(renders, 4);
+}
+
+int main() {
+    testTable();
+    testMenuWalk();
+    testDepthAndPopToRoot();
+    testRender();
+    return checkSummary("screen_test");
+}
@@ -0,0 +1,200 @@
+// SmartWake: light sleep detection, and the wake window against the alarm
+//
+//     g++ -I. -Itools/tests tools/tests/smart_wake_test.cpp smart_wake.cpp scheduler.cpp
+//
+// Epochs are built from synthetic wrist traces: still with sensor jitter
+// (deep sleep), or with a few 0.1 g movements (an active epoch). The window
+// runs mirror runTimedEvents() in main.cpp - EVENT_WAKE_WINDOW opens the
+// window, light sleep rings the alarm early, EVENT_MORNING_ALARM rings it
+// at the set time - over random nights, and check it never rings late or
+// before the window.
+
+#include <stdlib.h>
+#include "check.h"
+#include "smart_wake.h"
+#include "scheduler.h"
+
+#define SAMPLES_PER_SEC 10
+#define WINDOW_MIN 30
+
+static const int64_t T0 = 1700000000;  // Any local epoch second
+
+static uint32_t noiseState = 41;
+
+static float jitter() {
+    noiseState = noiseState * 1664525 + 1013904223;
+    return ((noiseState >> 8) / (float)(1 << 24) - 0.5f) * 0.01f;
+}
+
+// One sample: still, or stepping 0.1 g (a move) when moving
+static bool sample(SmartWake& wake, bool moving) {
+    static float x = 0;
+    if (moving) x = x > 0 ? -0.05f : 0.05f;
+    return wake.update(x + jitter(), jitter(), 1.0f + jitter());
+}
+
+// One epoch with `moves` moving samples spread through it; returns what
+// the closing sample returned
+static bool epoch(SmartWake& wake, int moves) {
+    int closedEarly = 0;
+    bool light = false;
+    for (int i = 0; i < SMART_WAKE_EPOCH_SAMPLES; i++) {
+        bool moving = moves > 0 && i % (SMART_WAKE_EPOCH_SAMPLES / moves) == 1 &&
+                      i / (SMART_WAKE_EPOCH_SAMPLES / moves) < moves;
+        light = sample(wake, moving);
+        if (i < SMART_WAKE_EPOCH_SAMPLES - 1) closedEarly += light;
+    }
+    CHECK_EQ(closedEarly, 0);
+    return light;
+}
+
+#define ACTIVE SMART_WAKE_EPOCH_ACTIVE
+#define STILL 0
+
+static void testDeepSleep() {
+    SmartWake wake;
+    // Two hours motionless: never light
+    int fired = 0;
+    for (int e = 0; e < 240; e++) fired += epoch(wake, STILL);
+    CHECK_EQ(fired, 0);
+    CHECK(!wake.isLightSleep());
+
+    // A twitch now and then (short of an active epoch) doesn't count either
+    for (int e = 0; e < 40; e++) fired += epoch(wake, ACTIVE - 1);
+    CHECK_EQ(fired, 0);
+
+    // Nor does one active epoch on its own
+    fired += epoch(wake, ACTIVE);
+    for (int e = 0; e < 8; e++) fired += epoch(wake, STILL);
+    CHECK_EQ(fired, 0);
+}
+
+static void testActiveEpochs() {
+    // Two active epochs inside the last four: light
+    SmartWake wake;
+    CHECK(!epoch(wake, ACTIVE));
+    CHECK(!epoch(wake, STILL));
+    CHECK(!epoch(wake, STILL));
+    CHECK(epoch(wake, ACTIVE));
+    CHECK(wake.isLightSleep());
+    CHECK(!epoch(wake, STILL));    // The first has dropped out
+    CHECK(!wake.isLightSleep());
+
+    // Back to back: light until both have dropped out
+    wake.reset();
+    CHECK(!epoch(wake, ACTIVE));
+    CHECK(epoch(wake, ACTIVE + 10));
+    CHECK(epoch(wake, STILL));
+    CHECK(epoch(wake, STILL));
+    CHECK(!epoch(wake, STILL));
+
+    // Four epochs apart is too far
+    wake.reset();
+    CHECK(!epoch(wake, ACTIVE));
+    for (int e = 0; e < SMART_WAKE_HISTORY - 1; e++) CHECK(!epoch(wake, STILL));
+    CHECK(!epoch(wake, ACTIVE));
+}
+
+// reset() between nights (main.cpp calls it as the window opens): what
+// the last window saw doesn't carry into the next
+static void testResetBetweenNights() {
+    SmartWake wake;
+    epoch(wake, STILL);
+    epoch(wake, ACTIVE);
+    CHECK(!wake.isLightSleep());
+    epoch(wake, ACTIVE);
+    CHECK(wake.isLightSleep());
+
+    wake.reset();
+    CHECK(!wake.isLightSleep());
+    CHECK(!epoch(wake, ACTIVE));   // Would have been light with the old history
+
+    // A part-filled epoch doesn't carry over either
+    wake.reset();
+    int closes = 0;
+    for (int i = 0; i < SMART_WAKE_EPOCH_SAMPLES - 1; i++) closes += sample(wake, i < 10);
+    wake.reset();
+    epoch(wake, ACTIVE);
+    for (int i = 0; i < SMART_WAKE_EPOCH_SAMPLES - 1; i++) closes += sample(wake, false);
+    CHECK_EQ(closes, 0);
+    CHECK(!sample(wake, false));   // Closes the second epoch: one active
+}
+
+// A night's last hour: the window opens WINDOW_MIN before the alarm; the
+// sleeper is in light sleep (active epochs) from lightFromSec, if ever.
+// Returns when the alarm rang.
+static int64_t wakeWindowRun(int64_t alarmSec, int64_t lightFromSec, int64_t& windowSec) {
+    EventScheduler scheduler;
+    SmartWake wake;
+    bool active = false;
+    bool light = false;
+    scheduler.schedule(EVENT_MORNING_ALARM, alarmSec);
+    scheduler.schedule(EVENT_WAKE_WINDOW, alarmSec - WINDOW_MIN * 60);
+    uint32_t allowed = EVENT_BIT(EVENT_MORNING_ALARM) | EVENT_BIT(EVENT_REM_CUE) | EVENT_BIT(EVENT_WAKE_WINDOW);
+    windowSec = 0;
+
+    for (int64_t now = alarmSec - 3600; now < alarmSec + 3600; now++) {
+        // A second of samples; light sleep moves a few times an epoch
+        for (int i = 0; i < SAMPLES_PER_SEC; i++) {
+            bool moving = lightFromSec && now >= lightFromSec && (now * SAMPLES_PER_SEC + i) % 60 == 7;
+            bool closed = sample(wake, moving);
+            if (active && closed) light = true;
+        }
+        if (light) return now;
+
+        TimedEvent event;
+        if (scheduler.poll(now, allowed, event) != SCHED_FIRE) continue;
+        if (event.kind == EVENT_WAKE_WINDOW) {
+            wake.reset();
+            active = true;
+            windowSec = now;
+        } else if (event.kind == EVENT_MORNING_ALARM) {
+            return now;
+        }
+    }
+    return 0;
+}
+
+static void testWakeWindow() {
+    const int64_t alarm = T0 + 7 * 3600;
+    int64_t window;
+
+    // Deep sleep through the window: rings at the set time
+    CHECK_EQ(wakeWindowRun(alarm, 0, window), alarm);
+    CHECK_EQ(window, alarm - WINDOW_MIN * 60);
+
+    // Light sleep inside the window: early, within a few epochs
+    int64_t rang = wakeWindowRun(alarm, alarm - 20 * 60, window);
+    CHECK(rang >= alarm - 20 * 60);
+    CHECK(rang <= alarm - 20 * 60 + 3 * SMART_WAKE_EPOCH_SAMPLES / SAMPLES_PER_SEC);
+
+    // Light sleep before the window opened only counts once it's open
+    rang = wakeWindowRun(alarm, alarm - 50 * 60, window);
+    CHECK(rang >= window + SMART_WAKE_ACTIVE_EPOCHS * SMART_WAKE_EPOCH_SAMPLES / SAMPLES_PER_SEC);
+    CHECK(rang < alarm);
+
+    // Light sleep in the last minute: the alarm itself wins
+    CHECK_EQ(wakeWindowRun(alarm, alarm - 20, window), alarm);
+
+    // Random nights: never late, never before the window
+    srand(41);
+    int early = 0;
+    for (int night = 0; night < 200; night++) {
+        int64_t light = rand() % 3 ? alarm - 3600 + rand() % 5400 : 0;
+        rang = wakeWindowRun(alarm, light, window);
+        if (!CHECK(rang <= alarm && rang >= window)) {
+            printf("  night %d: light from %lld, rang %lld (alarm %lld)\n", night, (long long)light,
+                   (long long)rang, (long long)alarm);
+        }
+        early += rang < alarm;
+    }
+    CHECK(early > 50);
+}
+
+int main() {
+    testDeepSleep();
+    testActiveEpochs();
+    testResetBetweenNights();
+    testWakeWindow();
+    return checkSummary("smart_wake_test");
+}
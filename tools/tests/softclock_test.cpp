@@ -0,0 +1,247 @@
+// SoftClock: edge resyncs, drift learning and the I2C cost over a week
+//
+//     g++ -I. -Itools/tests tools/tests/softclock_test.cpp softclock.cpp
+//
+// A simulated BM8563 ticks true time; the simulated esp_timer runs off it
+// by a few tens of ppm, as the crystal does. resyncClock() and
+// syncToRtcEdge() from tasks.cpp are mirrored against it, so the week-long
+// runs report what the sensor task would: RTC reads per hour and how far
+// the soft clock strays from the RTC between resyncs.
+
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+#include "check.h"
+#include "softclock.h"
+
+#define US_PER_SEC 1000000LL
+#define HOUR_S 3600
+#define WEEK_S (7 * 24 * HOUR_S)
+
+// As tasks.h
+#define RTC_EDGE_POLL_MS 5
+#define RTC_EDGE_GUARD_MS 50
+#define RTC_EDGE_FULL_MS 1100
+
+#define RTC_READ_US 400      // One getDateTime() at 400 kHz
+#define SETTLE_S (6 * HOUR_S)
+
+// The RTC and a timer that runs ppm fast (negative: slow) against it
+struct Sim {
+    double trueUs;     // Since the RTC read baseEpoch + phase
+    double timerUs;
+    double ppm;
+    int64_t baseEpoch;
+    double phaseUs;    // Of the RTC second at trueUs 0
+    uint32_t reads;
+    uint32_t windowMisses;
+    SoftClock clock;
+
+    Sim(double ppmFast, double phase)
+        : trueUs(0), timerUs(1234567), ppm(ppmFast),
+          baseEpoch(SoftClock::toEpoch(2024, 3, 1, 8, 0, 0)), phaseUs(phase),
+          reads(0), windowMisses(0) {}
+
+    int64_t timer() { return (int64_t)timerUs; }
+
+    void advance(double timerDeltaUs) {
+        timerUs += timerDeltaUs;
+        trueUs += timerDeltaUs / (1 + ppm * 1e-6);
+    }
+
+    // RTC local time in microseconds
+    double rtcUs() { return baseEpoch * (double)US_PER_SEC + phaseUs + trueUs; }
+
+    // The register snapshot is taken mid-transfer
+    int64_t readRtcEpoch() {
+        advance(RTC_READ_US / 2);
+        int64_t sec = (int64_t)floor(rtcUs() / US_PER_SEC);
+        advance(RTC_READ_US / 2);
+        reads++;
+        return sec;
+    }
+
+    bool syncToRtcEdge(uint32_t maxMs) {
+        int64_t start = timer();
+        int64_t prevStart = start;
+        int64_t prevSec = readRtcEpoch();
+        for (;;) {
+            advance(RTC_EDGE_POLL_MS * 1000);
+            int64_t readStart = timer();
+            int64_t sec = readRtcEpoch();
+            int64_t readEnd = timer();
+            if (sec != prevSec) {
+                clock.sync(sec, (prevStart + readEnd) / 2, true);
+                return true;
+            }
+            if (readEnd - start >= (int64_t)maxMs * 1000) return false;
+            prevStart = readStart;
+        }
+    }
+
+    void resyncClock() {
+        bool caught = false;
+        if (clock.getAnchor().state == CLOCK_ANCHOR_EDGE) {
+            int64_t now = timer();
+            int64_t next = SoftClock::nowUs(clock.getAnchor(), now) / US_PER_SEC + 1;
+            int64_t waitUs = clock.edgeTimerUs(next) - now - RTC_EDGE_GUARD_MS * 1000;
+            if (waitUs > 0) advance(waitUs / 1000 * 1000);  // Whole ticks
+            caught = syncToRtcEdge(2 * RTC_EDGE_GUARD_MS);
+            if (!caught) windowMisses++;
+        }
+        if (!caught) syncToRtcEdge(RTC_EDGE_FULL_MS);
+    }
+
+    double errorUs() { return SoftClock::nowUs(clock.getAnchor(), timer()) - rtcUs(); }
+};
+
+struct WeekReport {
+    double readsPerHour;
+    double maxErrorMs;       // Settled: SETTLE_S after boot and after a step
+    double learnedPpm;       // Timer fast by, as the clock learned it
+    uint32_t windowMisses;   // After SETTLE_S
+};
+
+// A week with the sensor task's resync check once a second. stepPpm, from
+// stepAtS on, models a temperature change.
+static WeekReport runWeek(double ppm, double phaseUs, double stepPpm = 0, int stepAtS = WEEK_S) {
+    Sim sim(ppm, phaseUs);
+    WeekReport report = {0, 0, 0, 0};
+    sim.clock.sync(sim.readRtcEpoch(), sim.timer(), false);  // Tasks::begin()
+    uint32_t missesAtSettle = 0;
+    for (int s = 0; s < WEEK_S; s++) {
+        if (s == stepAtS) sim.ppm = stepPpm;
+        if (s == SETTLE_S) missesAtSettle = sim.windowMisses;
+        if (sim.clock.resyncDue(sim.timer())) sim.resyncClock();
+        sim.advance(US_PER_SEC);
+        double error = fabs(sim.errorUs()) / 1000;
+        bool settling = s < SETTLE_S || (s >= stepAtS && s < stepAtS + SETTLE_S);
+        if (!settling && error > report.maxErrorMs) report.maxErrorMs = error;
+    }
+    report.readsPerHour = sim.reads / (WEEK_S / (double)HOUR_S);
+    report.learnedPpm = -sim.clock.getAnchor().driftPpb / 1000.0;
+    report.windowMisses = sim.windowMisses - missesAtSettle;
+    return report;
+}
+
+static void checkWeek(const char* name, double ppm, double stepPpm = 0, int stepAtS = WEEK_S) {
+    double finalPpm = stepAtS < WEEK_S ? stepPpm : ppm;
+    for (int phase = 0; phase < 4; phase++) {
+        WeekReport r = runWeek(ppm, phase * 250000.0 + 1234, finalPpm, stepAtS);
+        if (phase == 0) {
+            printf("  %-22s %5.1f RTC reads/h, max error %5.2f ms, learned %+6.2f ppm\n",
+                   name, r.readsPerHour, r.maxErrorMs, r.learnedPpm);
+        }
+        // Two resyncs an hour, each ~10 reads across its 100 ms window,
+        // against 360000 an hour for a read every loop() pass
+        CHECK(r.readsPerHour < 30);
+        CHECK(r.maxErrorMs < 10);
+        CHECK(fabs(r.learnedPpm - finalPpm) < 3);
+        CHECK_EQ(r.windowMisses, 0);
+    }
+}
+
+// Learning only from edge-to-edge resyncs
+static void testSyncRules() {
+    int64_t t0 = 5 * US_PER_SEC;
+    int64_t e0 = SoftClock::toEpoch(2024, 6, 30, 23, 59, 0);
+
+    SoftClock clock;
+    CHECK(clock.resyncDue(0));
+    clock.sync(e0, t0, false);
+    CHECK_EQ(clock.getAnchor().state, CLOCK_ANCHOR_COARSE);
+    CHECK(clock.resyncDue(t0));
+
+    // Coarse to edge anchors without learning
+    clock.sync(e0 + 1, t0 + 700000, true);
+    CHECK_EQ(clock.getAnchor().state, CLOCK_ANCHOR_EDGE);
+    CHECK_EQ(clock.getAnchor().driftPpb, 0);
+    CHECK_EQ(clock.getAnchor().resyncs, 0);
+
+    // First resync after SOFTCLOCK_FIRST_RESYNC_S, later ones SOFTCLOCK_RESYNC_S
+    int64_t t1 = t0 + 700000;
+    CHECK(!clock.resyncDue(t1 + SOFTCLOCK_FIRST_RESYNC_S * US_PER_SEC - 1));
+    CHECK(clock.resyncDue(t1 + SOFTCLOCK_FIRST_RESYNC_S * US_PER_SEC));
+
+    // The next edge 3 ms early on the timer over 300 s: the timer runs
+    // 10 ppm slow and half of that is learned
+    clock.sync(e0 + 301, t1 + 300 * US_PER_SEC - 3000, true);
+    CHECK_EQ(clock.getAnchor().resyncs, 1);
+    CHECK_EQ(clock.getAnchor().lastErrorUs, -3000);
+    CHECK_EQ(clock.getAnchor().driftPpb, 5000);
+    int64_t t3 = clock.getAnchor().timerUs;
+    CHECK(!clock.resyncDue(t3 + SOFTCLOCK_RESYNC_S * US_PER_SEC - 1));
+    CHECK(clock.resyncDue(t3 + SOFTCLOCK_RESYNC_S * US_PER_SEC));
+
+    // An error of SOFTCLOCK_STEP_US or more is the RTC being set: anchor only
+    ClockAnchor before = clock.getAnchor();
+    clock.sync(e0 + 3600, t3 + 10 * US_PER_SEC, true);
+    CHECK_EQ(clock.getAnchor().driftPpb, before.driftPpb);
+    CHECK_EQ(clock.getAnchor().resyncs, before.resyncs);
+    CHECK_EQ(clock.getAnchor().epochSec, e0 + 3600);
+
+    // After light sleep: resync at once, and the next edge only anchors
+    int64_t t4 = clock.getAnchor().timerUs;
+    clock.markCoarse();
+    CHECK(clock.resyncDue(t4));
+    CHECK_EQ(clock.getAnchor().epochSec, e0 + 3600);
+    clock.sync(e0 + 3601, t4 + 900000, true);
+    CHECK_EQ(clock.getAnchor().resyncs, before.resyncs);
+    CHECK_EQ(clock.getAnchor().driftPpb, before.driftPpb);
+
+    // Drift is clamped, however short the interval (0.4 s late over 1 s)
+    SoftClock fast;
+    fast.sync(e0, 0, true);
+    fast.sync(e0 + 1, US_PER_SEC + 400000, true);
+    CHECK_EQ(fast.getAnchor().driftPpb, -SOFTCLOCK_MAX_DRIFT_PPB);
+}
+
+// edgeTimerUs() inverts nowUs() for any learned drift (to second order)
+static void testEdgePrediction() {
+    int64_t e0 = SoftClock::toEpoch(2030, 1, 1, 0, 0, 0);
+    int64_t offsets[] = {0, 20000, 100000, -100000, 400000};
+    for (unsigned i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        // Two edges 1000 s apart, the second offsets[i] late on the timer
+        SoftClock clock;
+        clock.sync(e0, 0, true);
+        clock.sync(e0 + 1000, 1000 * US_PER_SEC + offsets[i], true);
+        const ClockAnchor& a = clock.getAnchor();
+        CHECK_EQ(a.driftPpb, -(offsets[i] * 1000000000LL / (1000 * US_PER_SEC + offsets[i])) / 2);
+        double rate = a.driftPpb / 1e9;
+        for (int64_t ahead = 1; ahead < 3 * 86400; ahead = ahead * 3 + 1) {
+            int64_t edge = clock.edgeTimerUs(a.epochSec + ahead);
+            int64_t error = SoftClock::nowUs(a, edge) - (a.epochSec + ahead) * US_PER_SEC;
+            CHECK(llabs(error) <= 2 + ahead * US_PER_SEC * rate * rate);
+        }
+    }
+}
+
+// toEpoch() against the host's timegm() for every day 1970-2099, across
+// month ends and leap days
+static void testToEpoch() {
+    int mismatches = 0;
+    struct tm tm = {};
+    for (time_t day = 0; day < (time_t)47482 * 86400; day += 86400) {
+        time_t t = day + 13 * 3600 + 7 * 60 + 9;
+        gmtime_r(&t, &tm);
+        int64_t e = SoftClock::toEpoch(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                                       tm.tm_hour, tm.tm_min, tm.tm_sec);
+        if (e != (int64_t)t) mismatches++;
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(SoftClock::toEpoch(1970, 1, 1, 0, 0, 0), 0);
+    CHECK_EQ(SoftClock::toEpoch(2024, 3, 1, 0, 0, 0) - SoftClock::toEpoch(2024, 2, 28, 0, 0, 0), 2 * 86400);
+    CHECK_EQ(SoftClock::toEpoch(2100, 3, 1, 0, 0, 0) - SoftClock::toEpoch(2100, 2, 28, 0, 0, 0), 86400);
+}
+
+int main() {
+    testSyncRules();
+    testEdgePrediction();
+    testToEpoch();
+    printf("softclock week (after %d h settling):\n", SETTLE_S / HOUR_S);
+    checkWeek("timer +40 ppm", 40);
+    checkWeek("timer -25 ppm", -25);
+    checkWeek("timer exact", 0);
+    checkWeek("+40 ppm, +15 on day 3", 40, 15, 3 * 86400);
+    return checkSummary("softclock_test");
+}
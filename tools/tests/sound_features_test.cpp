@@ -0,0 +1,246 @@
+// SoundFeatures: band energies, snore and noise flags, the floor, and cost
+//
+//     g++ -O1 -I. -Itools/tests tools/tests/sound_features_test.cpp sound_features.cpp
+//     ./a.out [night.wav]
+//
+// Synthetic windows stand in for the mic: a tone in each Goertzel band, a
+// quiet room, snoring (125/250 Hz over the room), broadband noise and a
+// room that gets louder and quieter over the night. A night recording
+// (8 kHz, 16-bit) can be named on the command line; it is run a window a
+// second as the firmware would and the events are counted.
+
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+#include "check.h"
+#include "wav.h"
+#include "sound_features.h"
+
+#define BENCH_WINDOWS 4000
+#define MINUTE_WINDOWS 60     // One window a second
+
+static const int BAND_HZ[SOUND_BANDS] = {125, 250, 500, 1000, 2000};
+static const double MIC_DC = -300;  // The PDM mic's offset, in LSB
+
+static double nowSec() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Deterministic noise, roughly Gaussian (sum of four uniforms), unit RMS
+static uint32_t noiseState = 47;
+
+static double noise() {
+    double sum = 0;
+    for (int i = 0; i < 4; i++) {
+        noiseState = noiseState * 1664525 + 1013904223;
+        sum += (noiseState >> 8) / (double)(1 << 24) - 0.5;
+    }
+    return sum * sqrt(3.0);
+}
+
+// A window: tones (amplitude per band, 0 for none) over noise of the given
+// RMS, with the mic's DC offset
+struct Window {
+    int16_t pcm[SOUND_WINDOW_SAMPLES];
+};
+
+static void fill(Window& w, const double* bandAmp, double noiseRms, uint32_t& sampleAt) {
+    for (int k = 0; k < SOUND_WINDOW_SAMPLES; k++, sampleAt++) {
+        double t = sampleAt / (double)SOUND_SAMPLE_RATE;
+        double v = MIC_DC + noiseRms * noise();
+        for (int b = 0; b < SOUND_BANDS; b++) {
+            if (bandAmp && bandAmp[b]) v += bandAmp[b] * sin(2 * M_PI * BAND_HZ[b] * t);
+        }
+        if (v > 32767) v = 32767;
+        if (v < -32768) v = -32768;
+        w.pcm[k] = (int16_t)lrint(v);
+    }
+}
+
+static double dbOf(double meanSquare) {
+    return 10 * log10(meanSquare);
+}
+
+// RMS for a level in dB re 1 LSB^2
+static double rmsFor(double db) {
+    return sqrt(pow(10, db / 10));
+}
+
+static void testPowerDb() {
+    CHECK_EQ(SoundFeatures::powerDb(0), 0);
+    CHECK_EQ(SoundFeatures::powerDb(1), 0);
+    int worst = 0;
+    for (uint64_t x = 2; x < (1ULL << 40); x = x * 3 / 2 + 1) {
+        int err = abs((int)SoundFeatures::powerDb(x) - (int)floor(dbOf(x)));
+        if (err > worst) worst = err;
+    }
+    CHECK(worst <= 1);
+}
+
+// A tone in each band reads at its level there and well down elsewhere;
+// the DC offset never shows
+static void testBands() {
+    uint32_t at = 0;
+    Window w;
+    for (int b = 0; b < SOUND_BANDS; b++) {
+        double amp[SOUND_BANDS] = {0};
+        amp[b] = 2000;
+        fill(w, amp, 0, at);
+        SoundFeatures sound;
+        SoundFrame frame;
+        sound.process(w.pcm, frame);
+        int expect = (int)dbOf(2000.0 * 2000 / 2);  // 63 dB
+        if (!CHECK(abs(frame.levelDb - expect) <= 1)) printf("  %d Hz level %d\n", BAND_HZ[b], frame.levelDb);
+        if (!CHECK(abs(frame.bandDb[b] - expect) <= 1)) printf("  %d Hz band %d\n", BAND_HZ[b], frame.bandDb[b]);
+        for (int o = 0; o < SOUND_BANDS; o++) {
+            if (o != b && !CHECK(frame.bandDb[o] + 30 <= frame.bandDb[b])) {
+                printf("  %d Hz leaks %d dB into %d Hz\n", BAND_HZ[b], frame.bandDb[o], BAND_HZ[o]);
+            }
+        }
+    }
+
+    // DC alone (no signal) is silence, whatever the offset
+    SoundFeatures sound;
+    SoundFrame frame;
+    fill(w, NULL, 0, at);
+    sound.process(w.pcm, frame);
+    CHECK_EQ(frame.levelDb, 0);
+    for (int b = 0; b < SOUND_BANDS; b++) CHECK_EQ(frame.bandDb[b], 0);
+
+    // White noise spreads evenly: each bin holds its 1/128 share of the level
+    fill(w, NULL, 1000, at);
+    sound.process(w.pcm, frame);
+    CHECK(abs(frame.levelDb - 60) <= 1);
+    for (int b = 0; b < SOUND_BANDS; b++) {
+        if (!CHECK(abs(frame.bandDb[b] - (60 - 21)) <= 4)) printf("  noise band %d: %d dB\n", b, frame.bandDb[b]);
+    }
+}
+
+// Runs windows of one kind; returns how many had the event
+static int run(SoundFeatures& sound, int windows, const double* amp, double noiseRms, SoundEvent event,
+               SoundFrame& last) {
+    static uint32_t at = 0;
+    Window w;
+    int hits = 0;
+    for (int i = 0; i < windows; i++) {
+        fill(w, amp, noiseRms, at);
+        hits += sound.process(w.pcm, last) == event;
+    }
+    return hits;
+}
+
+static void testEvents() {
+    const double roomDb = 35;
+    SoundFeatures sound;
+    SoundFrame frame;
+
+    CHECK_EQ(run(sound, MINUTE_WINDOWS, NULL, rmsFor(roomDb), SOUND_QUIET, frame), MINUTE_WINDOWS);
+    CHECK(abs(frame.floorDb - roomDb) <= 1);
+    uint8_t floor = frame.floorDb;
+
+    // Snoring 12 dB over the room: 125 and 250 Hz, a little 500
+    double snore[SOUND_BANDS] = {rmsFor(roomDb + 10) * sqrt(2.0), rmsFor(roomDb + 6) * sqrt(2.0),
+                                 rmsFor(roomDb - 5) * sqrt(2.0), 0, 0};
+    CHECK_EQ(run(sound, 10, snore, rmsFor(roomDb), SOUND_SNORE, frame), 10);
+    CHECK(frame.bandDb[0] > frame.bandDb[3] + SOUND_LOW_DOMINANCE_DB);
+
+    // Broadband noise 15+ dB over: noise, not snore, even though the low
+    // bands get their share
+    CHECK_EQ(run(sound, 10, NULL, rmsFor(roomDb + 18), SOUND_NOISE, frame), 10);
+
+    // Low but loud (a truck idling outside) is noise once it's 25 dB over
+    double hum[SOUND_BANDS] = {rmsFor(roomDb + 28) * sqrt(2.0), 0, 0, 0, 0};
+    CHECK_EQ(run(sound, 10, hum, rmsFor(roomDb), SOUND_NOISE, frame), 10);
+
+    // A soft low hum under the snore threshold, and quieter broadband, stay quiet
+    double softHum[SOUND_BANDS] = {rmsFor(roomDb + 4) * sqrt(2.0), 0, 0, 0, 0};
+    CHECK_EQ(run(sound, 10, softHum, rmsFor(roomDb), SOUND_QUIET, frame), 10);
+    CHECK_EQ(run(sound, 10, NULL, rmsFor(roomDb + 10), SOUND_QUIET, frame), 10);
+
+    // None of that moved the floor faster than its rise rate (50 windows)
+    CHECK(frame.floorDb <= floor + 50 * SOUND_FLOOR_RISE_DB / MINUTE_WINDOWS + 1);
+}
+
+// The floor follows a room that drifts: down at once, up SOUND_FLOOR_RISE_DB
+// a minute, so a slow rise (a heater, rain) never reads as noise but a
+// sudden one does until the floor catches up
+static void testDriftingFloor() {
+    SoundFeatures sound;
+    SoundFrame frame;
+    int events = 0;
+
+    run(sound, MINUTE_WINDOWS, NULL, rmsFor(40), SOUND_QUIET, frame);
+    // Up 1 dB a minute for 20 minutes
+    for (int minute = 1; minute <= 20; minute++) {
+        events += MINUTE_WINDOWS - run(sound, MINUTE_WINDOWS, NULL, rmsFor(40 + minute), SOUND_QUIET, frame);
+    }
+    CHECK_EQ(events, 0);
+    CHECK(abs(frame.floorDb - 60) <= 2);
+
+    // Down 15 dB: the floor drops with the first window
+    run(sound, 1, NULL, rmsFor(45), SOUND_QUIET, frame);
+    CHECK(abs(frame.floorDb - 45) <= 1);
+
+    // Up 20 dB and staying there: noise at first, quiet within the
+    // (20 - 15) / 2 minutes the floor needs, plus one for the window
+    int noisy = run(sound, 10 * MINUTE_WINDOWS, NULL, rmsFor(65), SOUND_NOISE, frame);
+    CHECK(noisy >= 2 * MINUTE_WINDOWS);
+    CHECK(noisy <= 4 * MINUTE_WINDOWS);
+    CHECK_EQ(frame.event, SOUND_QUIET);
+
+    // reset() forgets the floor
+    sound.reset();
+    run(sound, 1, NULL, rmsFor(30), SOUND_QUIET, frame);
+    CHECK(abs(frame.floorDb - 30) <= 1);
+}
+
+static void testCost() {
+    Window w;
+    uint32_t at = 0;
+    double snore[SOUND_BANDS] = {1500, 900, 0, 0, 0};
+    fill(w, snore, 60, at);
+    SoundFeatures sound;
+    SoundFrame frame;
+    uint32_t snores = 0;
+    double start = nowSec();
+    for (int i = 0; i < BENCH_WINDOWS; i++) snores += sound.process(w.pcm, frame) == SOUND_SNORE;
+    double perWindowUs = (nowSec() - start) / BENCH_WINDOWS * 1e6;
+    CHECK(snores < BENCH_WINDOWS);  // The same window every time: the floor catches up
+
+    // Each window is 256 ms of audio; the firmware runs one a second
+    printf("sound features cost (host):\n");
+    printf("  %.1f us per %d-sample window, %.1f us per second of audio, %.3f%% CPU at one window a second\n",
+           perWindowUs, SOUND_WINDOW_SAMPLES, perWindowUs * SOUND_SAMPLE_RATE / SOUND_WINDOW_SAMPLES,
+           perWindowUs / 1e4);
+}
+
+// A recording, a window a second as the firmware samples it
+static void replay(const char* path) {
+    Pcm pcm;
+    uint32_t rate = 0;
+    if (!CHECK(readWav(path, pcm, rate)) || !CHECK_EQ(rate, SOUND_SAMPLE_RATE)) {
+        printf("  %s: want 8 kHz 16-bit WAV\n", path);
+        return;
+    }
+    SoundFeatures sound;
+    SoundFrame frame;
+    int counts[3] = {0};
+    int seconds = 0;
+    for (size_t at = 0; at + SOUND_WINDOW_SAMPLES <= pcm.size(); at += SOUND_SAMPLE_RATE, seconds++) {
+        counts[sound.process(&pcm[at], frame)]++;
+    }
+    printf("%s: %d s, quiet %d, snore %d, noise %d, final floor %d dB\n", path, seconds,
+           counts[SOUND_QUIET], counts[SOUND_SNORE], counts[SOUND_NOISE], frame.floorDb);
+}
+
+int main(int argc, char** argv) {
+    testPowerDb();
+    testBands();
+    testEvents();
+    testDriftingFloor();
+    testCost();
+    if (argc > 1) replay(argv[1]);
+    return checkSummary("sound_features_test");
+}
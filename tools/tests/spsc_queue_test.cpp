@@ -0,0 +1,168 @@
+// SpscQueue, SpscActivity and SeqSnapshot under two real threads
+//
+//     g++ -O1 -pthread -I. -Itools/tests tools/tests/spsc_queue_test.cpp
+//
+// The firmware's producer and consumer run on different cores; here they
+// are pthreads hammering the same structures. Each test checks a property
+// a lost, duplicated or torn item would break. Spinning sides yield so it
+// also finishes on one CPU. Worth a run under -fsanitize=thread too.
+
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+#include "check.h"
+#include "spsc_queue.h"
+
+#define QUEUE_ITEMS 1000000
+#define ACTIVITY_ITEMS 200000
+#define SNAPSHOT_PUBLISHES 1000000
+
+struct Item {
+    uint32_t seq;
+    uint32_t check;  // ~seq, so a torn copy shows
+};
+
+static SpscQueue<Item, 8> queue;
+static std::atomic<bool> producerDone(false);
+
+static void* queueProducer(void*) {
+    for (uint32_t i = 0; i < QUEUE_ITEMS; i++) {
+        Item item = {i, ~i};
+        while (!queue.push(item)) sched_yield();
+    }
+    producerDone.store(true);
+    return NULL;
+}
+
+// Every item arrives once, in order and intact. A push into a full queue
+// is refused and counted, and the producer above retries it.
+static void testQueue() {
+    pthread_t producer;
+    pthread_create(&producer, NULL, queueProducer, NULL);
+    uint32_t expect = 0;
+    uint32_t bad = 0;
+    Item item;
+    while (expect < QUEUE_ITEMS) {
+        if (!queue.pop(item)) {
+            sched_yield();
+            continue;
+        }
+        if (item.seq != expect || item.check != ~expect) bad++;
+        expect = item.seq + 1;
+    }
+    pthread_join(producer, NULL);
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(expect, QUEUE_ITEMS);
+    CHECK(queue.empty());
+    CHECK(!queue.pop(item));
+    CHECK(queue.getDropped() > 0);  // The consumer fell behind at some point
+}
+
+// As the audio task and playCue(): the consumer drains, "plays" what it
+// got and goes idle; the producer pushes, marks, and must see the channel
+// active until its item has been taken
+static SpscQueue<uint32_t, 4> commands;
+static SpscActivity activity;
+static std::atomic<uint32_t> taken(0);  // Highest item the consumer popped, + 1
+static std::atomic<bool> activityDone(false);
+
+static void* activityConsumer(void*) {
+    while (!activityDone.load()) {
+        activity.beginDrain();
+        uint32_t item;
+        bool any = false;
+        while (commands.pop(item)) {
+            taken.store(item + 1);
+            any = true;
+        }
+        if (!any) {
+            sched_yield();  // Ran dry; a push can land before idle()
+            activity.idle();
+            sched_yield();  // As the audio task waiting for its notification
+        }
+    }
+    return NULL;
+}
+
+static void testActivity() {
+    pthread_t consumer;
+    pthread_create(&consumer, NULL, activityConsumer, NULL);
+    uint32_t idleTooSoon = 0;
+    uint32_t sawIdle = 0;
+    for (uint32_t i = 0; i < ACTIVITY_ITEMS; i++) {
+        while (!commands.push(i)) sched_yield();
+        activity.mark();
+        // Until the consumer takes it, through any idle() it was part way into
+        while (taken.load() <= i) {
+            if (!activity.active() && taken.load() <= i) idleTooSoon++;
+            sched_yield();
+        }
+        // Now and then let it run dry so idle() really races the next push
+        if ((i & 63) == 0) {
+            while (activity.active()) sched_yield();
+            sawIdle++;
+        }
+    }
+    while (activity.active()) sched_yield();
+    CHECK_EQ(taken.load(), ACTIVITY_ITEMS);
+    activityDone.store(true);
+    pthread_join(consumer, NULL);
+    CHECK_EQ(idleTooSoon, 0);
+    CHECK(sawIdle > 0);
+}
+
+// As the clock anchor: one writer republishing, readers never see a mix of
+// two publishes
+struct Anchor {
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    uint32_t d;
+};
+
+static SeqSnapshot<Anchor> snapshot;
+static std::atomic<bool> publishing(true);
+static std::atomic<uint32_t> torn(0);
+static std::atomic<uint32_t> reads(0);
+static std::atomic<uint32_t> backwards(0);
+
+static void* snapshotReader(void*) {
+    uint32_t last = 0;
+    while (publishing.load()) {
+        Anchor value = snapshot.read();
+        if (value.b != value.a * 3 || value.c != ~value.a || value.d != (value.a ^ 0x5a5a5a5au)) {
+            torn.fetch_add(1);
+        }
+        if (value.a < last) backwards.fetch_add(1);
+        last = value.a;
+        reads.fetch_add(1, std::memory_order_relaxed);
+        sched_yield();
+    }
+    return NULL;
+}
+
+static void testSnapshot() {
+    Anchor first = {0, 0, ~0u, 0x5a5a5a5au};
+    snapshot.publish(first);
+    pthread_t readers[2];
+    for (int i = 0; i < 2; i++) pthread_create(&readers[i], NULL, snapshotReader, NULL);
+    for (uint32_t i = 1; i <= SNAPSHOT_PUBLISHES; i++) {
+        Anchor value = {i, i * 3, ~i, i ^ 0x5a5a5a5au};
+        snapshot.publish(value);
+        if ((i & 1023) == 0) sched_yield();
+    }
+    publishing.store(false);
+    for (int i = 0; i < 2; i++) pthread_join(readers[i], NULL);
+    CHECK_EQ(torn.load(), 0);
+    CHECK_EQ(backwards.load(), 0);
+    CHECK(reads.load() > 0);
+    CHECK_EQ(snapshot.version(), SNAPSHOT_PUBLISHES + 1);
+    CHECK_EQ(snapshot.read().a, SNAPSHOT_PUBLISHES);
+}
+
+int main() {
+    testQueue();
+    testActivity();
+    testSnapshot();
+    return checkSummary("spsc_queue_test");
+}
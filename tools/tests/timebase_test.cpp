@@ -0,0 +1,316 @@
+// Wall-clock scheduling through millis() wrap, calendar edges and resets
+//
+//     g++ -I. -Itools/tests tools/tests/timebase_test.cpp softclock.cpp scheduler.cpp
+//
+// A simulated watch: the RTC and NVS survive a reset, esp_timer and RAM
+// don't. Its loop mirrors the firmware's - TimeBase::epochSec() from the
+// soft clock, then runTimedEvents() for the random reality check and the
+// morning alarm - and is fast-forwarded a second at a time past the
+// 49.7-day millis() wrap, over month ends and DST changes (the wearer
+// setting the clock an hour forward or back) and through resets, counting
+// every alarm that fires or is missed.
+
+#include <vector>
+#include "check.h"
+#include "scheduler.h"
+#include "softclock.h"
+
+#define US_PER_SEC 1000000LL
+#define DAY_S 86400
+#define MORNING_S (7 * 3600)          // Morning alarm at 07:00
+#define RC_MIN_INTERVAL_MIN 56        // 12 alarms a day: 80 min +-30%
+#define RC_MAX_INTERVAL_MIN 104
+// Longest interval, plus the morning guard moving a check past the alarm
+#define RC_MAX_GAP_S ((RC_MAX_INTERVAL_MIN + 2 * SCHED_MORNING_GUARD_S / 60) * 60)
+
+struct Fired {
+    int64_t dueSec;
+    int64_t atSec;
+};
+
+class Watch {
+public:
+    // Survive a reset
+    int64_t rtcSec;
+    int64_t nvsNextAlarm;
+    uint32_t seed;
+
+    // RAM and esp_timer: start over at each boot
+    int64_t timerUs;
+    SoftClock clock;
+    EventScheduler scheduler;
+
+    std::vector<Fired> rcFired;
+    std::vector<Fired> morningFired;
+    int rcMissed;
+    int morningMissed;
+    uint32_t lastMillis;
+    bool millisWrapped;
+    int boots;
+
+    Watch(int64_t startSec, uint32_t randomSeed)
+        : rtcSec(startSec), nvsNextAlarm(0), seed(randomSeed), timerUs(0),
+          rcMissed(0), morningMissed(0), lastMillis(0), millisWrapped(false), boots(0) {
+        boot();
+    }
+
+    int64_t nowSec() { return SoftClock::nowUs(clock.getAnchor(), timerUs) / US_PER_SEC; }
+
+    // Tasks::begin() and setup()
+    void boot() {
+        boots++;
+        timerUs = 0;
+        lastMillis = 0;
+        clock = SoftClock();
+        clock.sync(rtcSec, timerUs, false);
+        scheduler.clear();
+        if (nvsNextAlarm) scheduler.schedule(EVENT_REALITY_CHECK, nvsNextAlarm);
+        if (!scheduler.isScheduled(EVENT_REALITY_CHECK)) scheduleNextAlarm(nowSec());
+        scheduleMorningAlarm(nowSec());
+    }
+
+    void powerOff(int64_t seconds) {
+        rtcSec += seconds;
+        boot();
+    }
+
+    // Time set from the menu: the RTC is written, the soft clock re-anchors
+    void setClock(int64_t localSec) {
+        rtcSec = localSec;
+        clock.sync(rtcSec, timerUs, false);
+    }
+
+    // One second of loop() and the sensor task
+    void tick() {
+        uint32_t millis = (uint32_t)(timerUs / 1000);
+        if (millis < lastMillis) millisWrapped = true;
+        lastMillis = millis;
+        if (clock.resyncDue(timerUs)) clock.sync(rtcSec, timerUs, true);
+        runTimedEvents(nowSec());
+        timerUs += US_PER_SEC;
+        rtcSec++;
+    }
+
+    void runUntil(int64_t localSec) {
+        while (rtcSec < localSec) tick();
+    }
+
+    // Until a reality check fires; false if none does within two days
+    bool runUntilRealityCheck() {
+        size_t fired = rcFired.size();
+        for (int i = 0; i < 2 * DAY_S && rcFired.size() == fired; i++) tick();
+        return rcFired.size() > fired;
+    }
+
+private:
+    // random(min, max + 1)
+    int nextAlarmIntervalMin() {
+        seed = seed * 1103515245u + 12345u;
+        return RC_MIN_INTERVAL_MIN + (seed >> 8) % (RC_MAX_INTERVAL_MIN - RC_MIN_INTERVAL_MIN + 1);
+    }
+
+    // scheduleNextAlarm(): schedule and persist
+    void scheduleNextAlarm(int64_t now) {
+        scheduler.schedule(EVENT_REALITY_CHECK, now + nextAlarmIntervalMin() * 60);
+        nvsNextAlarm = scheduler.dueOf(EVENT_REALITY_CHECK);
+    }
+
+    void scheduleMorningAlarm(int64_t now) {
+        scheduler.schedule(EVENT_MORNING_ALARM, EventScheduler::nextDaily(now, MORNING_S));
+    }
+
+    void runTimedEvents(int64_t now) {
+        uint32_t allowed = EVENT_BIT(EVENT_REALITY_CHECK) | EVENT_BIT(EVENT_MORNING_ALARM);
+        TimedEvent event;
+        SchedResult result = scheduler.poll(now, allowed, event);
+        if (result == SCHED_NONE) return;
+        Fired fired = {event.dueSec, now};
+        if (event.kind == EVENT_REALITY_CHECK) {
+            // Move on (and persist) before firing, so a reset can't fire it twice
+            scheduleNextAlarm(now);
+            if (result == SCHED_FIRE) {
+                rcFired.push_back(fired);
+            } else {
+                rcMissed++;
+            }
+        } else if (event.kind == EVENT_MORNING_ALARM) {
+            if (result == SCHED_FIRE) {
+                morningFired.push_back(fired);
+                int64_t due = scheduler.dueOf(EVENT_MORNING_ALARM);  // startDreamJournal()
+                scheduleMorningAlarm((due > now ? due : now) + 60);
+            } else {
+                morningMissed++;
+                scheduleMorningAlarm(now);
+            }
+        }
+    }
+};
+
+// Each reality check fires once, within maxLateS of its due time, and the
+// next follows within maxGapS
+static void checkRealityChecks(const Watch& w, int maxLateS, int maxGapS) {
+    int late = 0;
+    int repeats = 0;
+    int64_t maxGap = 0;
+    for (size_t i = 0; i < w.rcFired.size(); i++) {
+        if (w.rcFired[i].atSec - w.rcFired[i].dueSec > maxLateS) late++;
+        if (i == 0) continue;
+        if (w.rcFired[i].dueSec <= w.rcFired[i - 1].dueSec) repeats++;
+        int64_t gap = w.rcFired[i].atSec - w.rcFired[i - 1].atSec;
+        if (gap > maxGap) maxGap = gap;
+    }
+    CHECK_EQ(late, 0);
+    CHECK_EQ(repeats, 0);
+    CHECK(maxGap <= maxGapS);
+}
+
+// The morning alarm fires at 07:00 once on each of the local days
+// [firstDay, firstDay + days), and on no other
+static void checkMornings(const Watch& w, int64_t firstDay, int days) {
+    std::vector<int> perDay(days, 0);
+    int outside = 0;
+    int offTime = 0;
+    for (size_t i = 0; i < w.morningFired.size(); i++) {
+        const Fired& f = w.morningFired[i];
+        int64_t day = f.atSec / DAY_S - firstDay;
+        if (day < 0 || day >= days) {
+            outside++;
+            continue;
+        }
+        perDay[day]++;
+        if (f.dueSec % DAY_S != MORNING_S || f.atSec - f.dueSec > 1) offTime++;
+    }
+    for (int d = 0; d < days; d++) {
+        if (!CHECK_EQ(perDay[d], 1)) printf("  day %d\n", d);
+    }
+    CHECK_EQ(outside, 0);
+    CHECK_EQ(offTime, 0);
+    CHECK_EQ(w.morningMissed, 0);
+}
+
+// Sixty days from boot: millis() wraps at 49.7, over two month ends and a
+// leap day; nothing is missed or fires twice
+static void testMillisWrap() {
+    int64_t start = SoftClock::toEpoch(2024, 1, 20, 9, 0, 0);
+    Watch w(start, 12345);
+    w.runUntil(start + 60 * DAY_S);
+    CHECK(w.millisWrapped);
+    CHECK(w.timerUs > 4294967296LL * 1000);  // 2^32 ms
+    CHECK_EQ(w.nowSec(), start + 60 * DAY_S);
+    CHECK_EQ(w.boots, 1);
+    CHECK_EQ(w.rcMissed, 0);
+    checkRealityChecks(w, 1, RC_MAX_GAP_S);
+    CHECK(w.rcFired.size() > 60 * 24 * 60 / RC_MAX_INTERVAL_MIN);
+    checkMornings(w, SoftClock::toEpoch(2024, 1, 21, 0, 0, 0) / DAY_S, 60);
+    bool leapDay = false;
+    for (size_t i = 0; i < w.morningFired.size(); i++) {
+        leapDay |= w.morningFired[i].dueSec == SoftClock::toEpoch(2024, 2, 29, 7, 0, 0);
+    }
+    CHECK(leapDay);
+}
+
+// Spring forward over the end of March: the clock jumps 02:00 -> 03:00.
+// A reality check due in the skipped hour fires late if within its stale
+// limit, else is missed once and replaced; the 07:00 alarms still fire once
+// a day. Over several seeds both cases come up.
+static void testSpringForward() {
+    int64_t start = SoftClock::toEpoch(2024, 3, 30, 12, 0, 0);
+    int64_t jump = SoftClock::toEpoch(2024, 3, 31, 2, 0, 0);
+    int32_t stale = EventScheduler::staleLimitS(EVENT_REALITY_CHECK);
+    int firedLate = 0;
+    int missed = 0;
+    for (uint32_t seed = 1; seed <= 40; seed++) {
+        Watch w(start, seed);
+        w.runUntil(jump);
+        int64_t skippedDue = w.scheduler.dueOf(EVENT_REALITY_CHECK);
+        w.setClock(jump + 3600);
+        w.runUntil(SoftClock::toEpoch(2024, 4, 2, 12, 0, 0));
+        bool inHour = skippedDue < jump + 3600;
+        bool expectMissed = skippedDue < jump + 3600 - stale;
+        CHECK_EQ(w.rcMissed, expectMissed ? 1 : 0);
+        missed += expectMissed;
+        firedLate += inHour && !expectMissed;
+        checkRealityChecks(w, stale, RC_MAX_GAP_S + 3600 + RC_MAX_INTERVAL_MIN * 60);
+        checkMornings(w, SoftClock::toEpoch(2024, 3, 31, 0, 0, 0) / DAY_S, 3);
+    }
+    CHECK(missed > 0);
+    CHECK(firedLate > 0);
+}
+
+// Fall back: 03:00 -> 02:00 replays an hour. Nothing fires twice, even
+// the morning alarm when the clock goes back just after it.
+static void testFallBack() {
+    int64_t start = SoftClock::toEpoch(2024, 10, 26, 12, 0, 0);
+    Watch w(start, 12345);
+    w.runUntil(SoftClock::toEpoch(2024, 10, 27, 3, 0, 0));
+    w.setClock(SoftClock::toEpoch(2024, 10, 27, 2, 0, 0));
+    w.runUntil(SoftClock::toEpoch(2024, 10, 28, 7, 0, 30));
+    CHECK_EQ(w.morningFired.size(), 2u);
+    w.setClock(SoftClock::toEpoch(2024, 10, 28, 6, 0, 30));
+    w.runUntil(SoftClock::toEpoch(2024, 11, 1, 12, 0, 0));
+    CHECK_EQ(w.rcMissed, 0);
+    checkRealityChecks(w, 1, RC_MAX_GAP_S);
+    checkMornings(w, SoftClock::toEpoch(2024, 10, 27, 0, 0, 0) / DAY_S, 6);
+}
+
+// Resets: the persisted epoch brings the pending reality check back as it
+// was; a reset just after one fires doesn't fire it again; a long outage
+// reports it missed once and moves on
+static void testRestarts() {
+    int64_t start = SoftClock::toEpoch(2024, 4, 28, 10, 0, 0);
+    Watch w(start, 12345);
+
+    // First boot had nothing in NVS
+    CHECK(w.scheduler.isScheduled(EVENT_REALITY_CHECK));
+    CHECK_EQ(w.nvsNextAlarm, w.scheduler.dueOf(EVENT_REALITY_CHECK));
+
+    for (int i = 0; i < 20; i++) {
+        CHECK(w.runUntilRealityCheck());
+        int64_t pending = w.scheduler.dueOf(EVENT_REALITY_CHECK);
+        w.powerOff(1);
+        CHECK_EQ(w.scheduler.dueOf(EVENT_REALITY_CHECK), pending);
+        CHECK_EQ(w.nowSec(), w.rtcSec);
+    }
+    CHECK_EQ(w.rcMissed, 0);
+    checkRealityChecks(w, 1, RC_MAX_GAP_S);
+
+    // Off for longer than the stale limit across the pending check
+    int64_t due = w.scheduler.dueOf(EVENT_REALITY_CHECK);
+    w.powerOff(due - w.rtcSec + EventScheduler::staleLimitS(EVENT_REALITY_CHECK) + 60);
+    w.tick();
+    CHECK_EQ(w.rcMissed, 1);
+    CHECK(w.scheduler.dueOf(EVENT_REALITY_CHECK) > w.rtcSec);
+    CHECK_EQ(w.nvsNextAlarm, w.scheduler.dueOf(EVENT_REALITY_CHECK));
+
+    // Off from 06:00 to 09:00: that morning is skipped, not fired late, and
+    // the next one is on time
+    int64_t today = w.rtcSec / DAY_S * DAY_S;
+    w.runUntil(today + DAY_S + 6 * 3600);
+    size_t mornings = w.morningFired.size();
+    w.powerOff(3 * 3600);
+    w.runUntil(today + 3 * DAY_S);
+    CHECK_EQ(w.morningFired.size(), mornings + 1);
+    CHECK_EQ(w.morningFired.back().dueSec, today + 2 * DAY_S + MORNING_S);
+    CHECK_EQ(w.morningMissed, 0);
+    CHECK(w.rcMissed <= 2);  // Plus one if a check was due while it was off
+}
+
+// The date arithmetic behind the morning alarm
+static void testNextDaily() {
+    int64_t jan31 = SoftClock::toEpoch(2023, 1, 31, 0, 0, 0);
+    CHECK_EQ(EventScheduler::nextDaily(jan31 + MORNING_S - 1, MORNING_S), jan31 + MORNING_S);
+    CHECK_EQ(EventScheduler::nextDaily(jan31 + MORNING_S, MORNING_S), SoftClock::toEpoch(2023, 2, 1, 7, 0, 0));
+    CHECK_EQ(EventScheduler::nextDaily(SoftClock::toEpoch(2024, 2, 28, 23, 59, 59), 0),
+             SoftClock::toEpoch(2024, 2, 29, 0, 0, 0));
+    CHECK_EQ(EventScheduler::nextDaily(SoftClock::toEpoch(2023, 12, 31, 8, 0, 0), MORNING_S),
+             SoftClock::toEpoch(2024, 1, 1, 7, 0, 0));
+}
+
+int main() {
+    testNextDaily();
+    testMillisWrap();
+    testSpringForward();
+    testFallBack();
+    testRestarts();
+    return checkSummary("timebase_test");
+}
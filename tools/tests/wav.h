@@ -0,0 +1,87 @@
+#ifndef WAV_H
+#define WAV_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+// 16-bit PCM WAV files for the audio host tests: write a synthetic fixture,
+// or read a recording (the first channel, at whatever rate it was made)
+
+typedef std::vector<int16_t> Pcm;
+
+static inline void wavPut16(FILE* f, uint16_t v) {
+    fputc(v & 0xFF, f);
+    fputc(v >> 8, f);
+}
+
+static inline void wavPut32(FILE* f, uint32_t v) {
+    wavPut16(f, v & 0xFFFF);
+    wavPut16(f, v >> 16);
+}
+
+static inline bool writeWav(const char* path, const Pcm& pcm, uint32_t rate) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    uint32_t bytes = pcm.size() * 2;
+    fwrite("RIFF", 1, 4, f);
+    wavPut32(f, 36 + bytes);
+    fwrite("WAVEfmt ", 1, 8, f);
+    wavPut32(f, 16);
+    wavPut16(f, 1);         // PCM
+    wavPut16(f, 1);         // Mono
+    wavPut32(f, rate);
+    wavPut32(f, rate * 2);
+    wavPut16(f, 2);
+    wavPut16(f, 16);
+    fwrite("data", 1, 4, f);
+    wavPut32(f, bytes);
+    for (size_t i = 0; i < pcm.size(); i++) wavPut16(f, (uint16_t)pcm[i]);
+    fclose(f);
+    return true;
+}
+
+static inline uint32_t wavLe(const uint8_t* p, int n) {
+    uint32_t v = 0;
+    for (int i = n - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+// Mono or the first channel; rate is set from the file
+static inline bool readWav(const char* path, Pcm& pcm, uint32_t& rate) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    uint8_t head[12];
+    bool ok = fread(head, 1, 12, f) == 12 && !memcmp(head, "RIFF", 4) && !memcmp(head + 8, "WAVE", 4);
+    int channels = 0;
+    int bits = 0;
+    while (ok) {
+        uint8_t chunk[8];
+        if (fread(chunk, 1, 8, f) != 8) {
+            ok = false;
+            break;
+        }
+        uint32_t size = wavLe(chunk + 4, 4);
+        if (!memcmp(chunk, "fmt ", 4)) {
+            uint8_t fmt[16];
+            ok = size >= 16 && fread(fmt, 1, 16, f) == 16;
+            channels = wavLe(fmt + 2, 2);
+            rate = wavLe(fmt + 4, 4);
+            bits = wavLe(fmt + 14, 2);
+            fseek(f, size - 16 + (size & 1), SEEK_CUR);
+        } else if (!memcmp(chunk, "data", 4)) {
+            ok = bits == 16 && channels > 0;
+            std::vector<uint8_t> data(size);
+            ok = ok && size > 0 && fread(&data[0], 1, size, f) == size;
+            for (size_t i = 0; ok && i + 1 < size; i += 2 * channels) pcm.push_back((int16_t)wavLe(&data[i], 2));
+            break;
+        } else {
+            fseek(f, size + (size & 1), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    return ok && !pcm.empty();
+}
+
+#endif
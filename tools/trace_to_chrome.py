@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Convert LucidWatch `trace` serial dumps into Chrome trace JSON.
+
+Capture from a m5stick-c-plus2-trace build, either one-shot ("trace") or
+continuously ("trace stream on"), then convert and open the result in
+https://ui.perfetto.dev or chrome://tracing:
+
+    pio device monitor | tee trace.log       # send "trace stream on"
+    tools/trace_to_chrome.py trace.log > lucid.json
+
+Every dump in the log is used, in order, so a streamed capture becomes one
+continuous timeline. Gaps from overwritten events are marked with a
+"trace_lost" instant.
+"""
+
+import argparse
+import json
+import sys
+
+TYPES = {0: "B", 1: "E", 2: "i", 3: "C"}
+RECORD_HEX = 30  # tsUs(8) name(8) value(8) type(2) tid(2) core(2)
+
+
+def parse_records(hexstr):
+    for i in range(0, len(hexstr) - RECORD_HEX + 1, RECORD_HEX):
+        r = hexstr[i:i + RECORD_HEX]
+        value = int(r[16:24], 16)
+        if value >= 1 << 31:
+            value -= 1 << 32
+        yield (int(r[0:8], 16), int(r[8:16], 16), value,
+               int(r[24:26], 16), int(r[26:28], 16), int(r[28:30], 16))
+
+
+def read_dumps(lines):
+    """Yield (header, names, records) for each complete dump in the log."""
+    header, names, records = None, {}, []
+    for line in lines:
+        line = line.strip()
+        if not line.startswith('{"trace'):
+            continue
+        try:
+            obj = json.loads(line)
+        except ValueError:
+            continue  # Line mangled by other serial output
+        if "trace_begin" in obj:
+            header, names, records = obj["trace_begin"], {}, []
+        elif header is None:
+            continue  # Tail of a dump that started before the capture
+        elif "trace_name" in obj:
+            addr, name = obj["trace_name"]
+            names[int(addr, 16)] = name
+        elif "trace" in obj:
+            records.extend(parse_records(obj["trace"]))
+        elif "trace_end" in obj:
+            yield header, names, records
+            header = None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", help="serial log containing trace dumps")
+    args = parser.parse_args()
+
+    events = []
+    tasks = []
+    epoch = 0      # Added to the 32-bit device timestamps after each wrap
+    last_ts = None
+    dumps = 0
+    with open(args.log, errors="replace") as f:
+        for header, names, records in read_dumps(f):
+            dumps += 1
+            tasks = header.get("tasks", tasks)
+            if header.get("lost"):
+                ts = (last_ts or 0) / 1000.0
+                events.append({"name": "trace_lost", "ph": "i", "s": "g", "pid": 1, "tid": 0,
+                               "ts": ts, "args": {"events": header["lost"]}})
+            for ts, addr, value, kind, tid, core in records:
+                # Slots are claimed before they are timestamped, so tasks on
+                # the two cores can be slightly out of order; only a large
+                # backwards step is a wrap (every ~71 minutes)
+                full = epoch + ts
+                if last_ts is not None and full < last_ts - (1 << 31):
+                    epoch += 1 << 32
+                    full += 1 << 32
+                last_ts = max(last_ts or 0, full)
+
+                ev = {"name": names.get(addr, "0x%08x" % addr), "ph": TYPES.get(kind, "i"),
+                      "pid": 1, "tid": tid, "ts": full}
+                if kind == 2:
+                    ev["s"] = "t"
+                    ev["args"] = {"core": core}
+                elif kind == 3:
+                    ev["args"] = {"value": value}
+                events.append(ev)
+    if not dumps:
+        sys.exit("no trace dump found in " + args.log)
+
+    events.sort(key=lambda e: e["ts"])
+    for tid, name in enumerate(tasks):
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid,
+                       "args": {"name": name}})
+    events.append({"name": "process_name", "ph": "M", "pid": 1, "tid": 0,
+                   "args": {"name": "LucidWatch"}})
+    json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, sys.stdout)
+    print("%d events from %d dumps" % (len(events), dumps), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,146 @@
+// Replay a labelled IMU trace through the wake detectors, on a host.
+//
+// Builds against the firmware's own detectors, the shake detector behind
+// the Light Tap .. Very Hard sensitivity levels (shake_detector.h) and the
+// Wrist Raise level's detector (wrist_raise.h):
+//
+//     g++ -O2 -I. tools/wrist_replay.cpp wrist_raise.cpp -o wrist_replay
+//     ./wrist_replay tools/wrist_trace.csv
+//
+// The trace is 10 Hz CSV - ms, accel x/y/z (g), gyro x/y/z (deg/s), label -
+// as written by tools/wrist_trace.py. Rows labelled "raise" are one
+// raise-to-look each (consecutive rows form a span); every other label is
+// activity that shouldn't wake the panel. A detection inside a raise span,
+// or within REPLAY_GRACE_MS after it, is a hit; a raise span with no hit is
+// a missed wake and any other detection is a false wake. A shake detector
+// fires on most samples of a fast movement, so a detection within
+// REPLAY_MERGE_MS of the previous one is the same wake.
+//
+// Prints one row per detector: raises, missed, missed %, false wakes and
+// false wakes per hour of trace.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "shake_detector.h"
+#include "wrist_raise.h"
+
+#define REPLAY_GRACE_MS 500
+#define REPLAY_MERGE_MS 1000
+
+struct TraceSample {
+    unsigned long ms;
+    float ax, ay, az;
+    float gx, gy, gz;
+    bool raise;
+};
+
+struct Score {
+    int raises;
+    int missed;
+    int falseWakes;
+};
+
+// The shake thresholds from main.cpp's SENSITIVITY_VALUES
+static const struct {
+    const char* name;
+    float threshold;
+} SHAKE_LEVELS[] = {
+    {"Light Tap", 0.15f}, {"Gentle", 0.30f}, {"Normal", 0.50f},
+    {"Firm", 0.80f}, {"Hard", 1.2f}, {"Very Hard", 1.8f},
+};
+
+static bool readTrace(const char* path, std::vector<TraceSample>& trace) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[256];
+    char label[32];
+    while (fgets(line, sizeof(line), f)) {
+        TraceSample s;
+        if (sscanf(line, "%lu,%f,%f,%f,%f,%f,%f,%31s", &s.ms, &s.ax, &s.ay, &s.az,
+                   &s.gx, &s.gy, &s.gz, label) != 8) {
+            continue;  // Header
+        }
+        s.raise = !strcmp(label, "raise");
+        trace.push_back(s);
+    }
+    fclose(f);
+    return !trace.empty();
+}
+
+// fired[i]: the detector fired on sample i
+static Score score(const std::vector<TraceSample>& trace, const std::vector<bool>& fired) {
+    Score result = {0, 0, 0};
+    unsigned long lastFired = 0;
+    bool anyFired = false;
+    size_t i = 0;
+    while (i < trace.size()) {
+        if (!trace[i].raise) {
+            if (fired[i]) {
+                if (!anyFired || trace[i].ms - lastFired > REPLAY_MERGE_MS) result.falseWakes++;
+                lastFired = trace[i].ms;
+                anyFired = true;
+            }
+            i++;
+            continue;
+        }
+        // One raise span, plus the grace period after it
+        size_t end = i;
+        while (end < trace.size() && trace[end].raise) end++;
+        unsigned long graceEnd = trace[end - 1].ms + REPLAY_GRACE_MS;
+        while (end < trace.size() && trace[end].ms <= graceEnd) end++;
+        bool hit = false;
+        for (; i < end; i++) {
+            if (!fired[i]) continue;
+            hit = true;
+            lastFired = trace[i].ms;
+            anyFired = true;
+        }
+        result.raises++;
+        if (!hit) result.missed++;
+    }
+    return result;
+}
+
+static void printRow(const char* name, const Score& s, double hours) {
+    printf("%-22s %6d %6d %8.0f%% %6d %10.1f\n", name, s.raises, s.missed,
+           s.raises ? 100.0 * s.missed / s.raises : 0.0, s.falseWakes, s.falseWakes / hours);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s TRACE.csv\n", argv[0]);
+        return 2;
+    }
+    std::vector<TraceSample> trace;
+    if (!readTrace(argv[1], trace)) {
+        fprintf(stderr, "%s: no samples\n", argv[1]);
+        return 1;
+    }
+    double hours = (trace.back().ms - trace.front().ms + 100) / 3600000.0;
+    std::vector<bool> fired(trace.size());
+
+    printf("%s: %u samples, %.1f min\n", argv[1], (unsigned)trace.size(), hours * 60);
+    printf("%-22s %6s %6s %9s %6s %10s\n", "detector", "raises", "missed", "missed", "false", "false/h");
+
+    for (size_t level = 0; level < sizeof(SHAKE_LEVELS) / sizeof(SHAKE_LEVELS[0]); level++) {
+        ShakeDetector shake;
+        shake.reset(trace[0].ax, trace[0].ay, trace[0].az);
+        for (size_t i = 0; i < trace.size(); i++) {
+            const TraceSample& s = trace[i];
+            fired[i] = shake.update(s.ax, s.ay, s.az, SHAKE_LEVELS[level].threshold);
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "shake %s", SHAKE_LEVELS[level].name);
+        printRow(name, score(trace, fired), hours);
+    }
+
+    WristRaise wrist;
+    for (size_t i = 0; i < trace.size(); i++) {
+        const TraceSample& s = trace[i];
+        fired[i] = wrist.update(s.ax, s.ay, s.az, s.gx, s.gy, s.gz, s.ms);
+    }
+    printRow("wrist raise", score(trace, fired), hours);
+    return 0;
+}
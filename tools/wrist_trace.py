@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Write the synthetic labelled wrist trace tools/wrist_replay.cpp replays.
+
+    tools/wrist_trace.py > tools/wrist_trace.csv
+
+10 Hz samples (the rate the sensor task feeds the wake detectors) of a
+modelled forearm: the face tilts about the watch's X axis, so gravity reads
+(0, sin t, cos t) g with the gyro's X rate the tilt rate, plus the arm's own
+acceleration and sensor noise. Columns: ms, accel x/y/z (g), gyro x/y/z
+(deg/s) and a label - "raise" for a raise-to-look, from the arm starting to
+move to the end of the glance, and the activity otherwise (still, type,
+walk, bump, drift, lower). Only raises should wake the panel.
+
+Seeded, so the checked-in trace can be regenerated exactly. Swap in a real
+capture in the same format to check the detectors against a wearer.
+"""
+
+import math
+import random
+
+RATE_HZ = 10
+DOWN_DEG = 85      # Arm at the side, face turned away
+UP_DEG = 5         # Face towards the wearer
+TYPE_DEG = 20      # Forearm on a desk
+
+rng = random.Random(28)
+samples = []
+tilt = DOWN_DEG
+
+
+def emit(label, rate_dps=0.0, lin=(0.0, 0.0, 0.0), noise=0.02):
+    t = math.radians(tilt)
+    ax = lin[0] + rng.gauss(0, noise)
+    ay = math.sin(t) + lin[1] + rng.gauss(0, noise)
+    az = math.cos(t) + lin[2] + rng.gauss(0, noise)
+    gyro = (rate_dps + rng.gauss(0, 2), rng.gauss(0, 2), rng.gauss(0, 2))
+    samples.append((ax, ay, az) + gyro + (label,))
+
+
+def move_to(target, seconds, label, push=0.0):
+    """Turn to target over seconds; push is the arm's acceleration (g) at the start."""
+    global tilt
+    n = max(1, int(seconds * RATE_HZ))
+    step = (target - tilt) / n
+    for i in range(n):
+        tilt += step
+        kick = push * math.sin(math.pi * i / n) if push else 0.0
+        emit(label, step * RATE_HZ, (0.0, kick, kick * 0.5))
+
+
+def hold(seconds, label, noise=0.02, wobble=0.0):
+    global tilt
+    base = tilt
+    for i in range(int(seconds * RATE_HZ)):
+        prev = tilt
+        tilt = base + wobble * math.sin(i * 0.9)
+        emit(label, (tilt - prev) * RATE_HZ, noise=noise)
+    tilt = base
+
+
+def walk(seconds):
+    global tilt
+    for i in range(int(seconds * RATE_HZ)):
+        prev = tilt
+        phase = 2 * math.pi * i / RATE_HZ   # 1 Hz arm swing
+        tilt = DOWN_DEG - 8 + 15 * math.sin(phase)
+        step = 0.35 * abs(math.sin(2 * phase)) + rng.gauss(0, 0.08)
+        emit("walk", (tilt - prev) * RATE_HZ, (0.1 * math.cos(phase), step, 0.15 * step), noise=0.05)
+    tilt = DOWN_DEG
+
+
+def bump(axis, g):
+    lin = [0.0, 0.0, 0.0]
+    lin[axis] = g
+    emit("bump", lin=tuple(lin))
+    emit("bump", lin=tuple(-0.3 * x for x in lin))
+
+
+def raise_to_look(seconds, push, glance_s, then):
+    move_to(UP_DEG, seconds, "raise", push)
+    hold(glance_s, "raise", wobble=1.0)
+    move_to(then, 0.8, "lower", push * 0.5)
+
+
+hold(5, "still")
+raise_to_look(0.8, 0.35, 2.5, DOWN_DEG)
+hold(4, "still")
+walk(12)
+raise_to_look(0.6, 0.5, 2.0, DOWN_DEG)
+walk(10)
+bump(0, 0.9)
+hold(3, "still")
+bump(2, 1.4)
+hold(3, "still")
+raise_to_look(1.2, 0.15, 3.0, DOWN_DEG)     # Slow, gentle raise
+hold(3, "still")
+move_to(TYPE_DEG, 1.0, "type", 0.2)
+for _ in range(3):
+    hold(6, "type", noise=0.06, wobble=2.0)
+    bump(1, 0.7)                            # Hand lands on the desk
+raise_to_look(0.5, 0.3, 2.0, TYPE_DEG)      # Glance from the keyboard
+hold(5, "type", noise=0.06, wobble=2.0)
+move_to(DOWN_DEG, 1.0, "lower", 0.2)
+hold(3, "still")
+move_to(UP_DEG, 12.0, "drift")              # Face drifts up, e.g. lying down
+hold(4, "drift")
+move_to(DOWN_DEG, 1.0, "lower", 0.2)
+hold(3, "still")
+walk(8)
+raise_to_look(0.7, 0.6, 1.5, DOWN_DEG)      # Check the time mid-stride
+walk(8)
+raise_to_look(0.9, 0.25, 2.5, DOWN_DEG)
+hold(5, "still")
+
+print("ms,ax,ay,az,gx,gy,gz,label")
+for i, s in enumerate(samples):
+    print("%d,%.3f,%.3f,%.3f,%.1f,%.1f,%.1f,%s" % ((i * 1000 // RATE_HZ,) + s))
@@ -0,0 +1,90 @@
+#include "trace.h"
+
+#ifdef LUCID_TRACE
+
+#include <Arduino.h>
+#include <atomic>
+#include "memstats.h"
+#include "tasks.h"
+
+#define TRACE_MAX_NAMES 64        // Distinct names per dump
+#define TRACE_EVENTS_PER_LINE 4   // 30 hex chars each, fits LOG_LINE_MAX
+
+static TraceEvent ring[TRACE_EVENTS];
+static std::atomic<uint32_t> head(0);  // Total events ever recorded
+static uint32_t flushed = 0;           // UI task only
+static bool streaming = false;
+
+void Trace::record(uint8_t type, const char* name, int32_t value) {
+    uint32_t index = head.fetch_add(1, std::memory_order_relaxed);
+    TraceEvent& e = ring[index & (TRACE_EVENTS - 1)];
+    e.tsUs = (uint32_t)esp_timer_get_time();
+    e.name = name;
+    e.value = value;
+    e.type = type;
+    e.tid = Tasks::currentId();
+    e.core = xPortGetCoreID();
+}
+
+// Header, name table, then events as fixed-width hex records:
+//   tsUs(8) name(8) value(8) type(2) tid(2) core(2)
+void Trace::dump() {
+    uint32_t end = head.load(std::memory_order_acquire);
+    uint32_t start = flushed;
+    uint32_t lost = 0;
+    if (end - start > TRACE_EVENTS) {
+        lost = end - start - TRACE_EVENTS;  // Overwritten before we got to them
+        start = end - TRACE_EVENTS;
+    }
+
+    logPrintf("{\"trace_begin\":{\"first\":%lu,\"count\":%lu,\"lost\":%lu,\"tasks\":[",
+              (unsigned long)start, (unsigned long)(end - start), (unsigned long)lost);
+    for (int i = 0; i <= TASK_COUNT; i++) {
+        logPrintf("%s\"%s\"", i ? "," : "", i < TASK_COUNT ? Tasks::name(i) : "other");
+    }
+    logPrintf("]}}\n");
+
+    const char* names[TRACE_MAX_NAMES];
+    int nameCount = 0;
+    for (uint32_t i = start; i != end; i++) {
+        const char* name = ring[i & (TRACE_EVENTS - 1)].name;
+        int k = 0;
+        while (k < nameCount && names[k] != name) k++;
+        if (k == nameCount && nameCount < TRACE_MAX_NAMES) {
+            names[nameCount++] = name;
+            logPrintf("{\"trace_name\":[\"%08lx\",\"%s\"]}\n", (unsigned long)(uint32_t)(uintptr_t)name, name);
+        }
+    }
+
+    char hex[TRACE_EVENTS_PER_LINE * 30 + 1];
+    int len = 0;
+    for (uint32_t i = start; i != end; i++) {
+        const TraceEvent& e = ring[i & (TRACE_EVENTS - 1)];
+        len += snprintf(hex + len, sizeof(hex) - len, "%08lx%08lx%08lx%02x%02x%02x",
+                        (unsigned long)e.tsUs, (unsigned long)(uint32_t)(uintptr_t)e.name,
+                        (unsigned long)(uint32_t)e.value, e.type, e.tid, e.core);
+        if (len >= TRACE_EVENTS_PER_LINE * 30 || i + 1 == end) {
+            logPrintf("{\"trace\":\"%s\"}\n", hex);
+            len = 0;
+        }
+    }
+    logPrintf("{\"trace_end\":true}\n");
+    flushed = end;
+}
+
+void Trace::setStreaming(bool on) {
+    streaming = on;
+}
+
+void Trace::poll() {
+    if (streaming && head.load(std::memory_order_relaxed) - flushed >= TRACE_STREAM_CHUNK) {
+        dump();
+    }
+}
+
+#else
+void Trace::record(uint8_t, const char*, int32_t) {}
+void Trace::dump() {}
+void Trace::setStreaming(bool) {}
+void Trace::poll() {}
+#endif
@@ -0,0 +1,58 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// Trace-event recorder
+// Build with -DLUCID_TRACE (m5stick-c-plus2-trace env). Begin/end, instant
+// and counter events with microsecond timestamps go into a fixed binary ring
+// from any task. The `trace` serial command dumps what is buffered;
+// `trace stream on` flushes automatically so a whole day can be logged.
+// tools/trace_to_chrome.py converts the log to Chrome trace JSON for
+// Perfetto / chrome://tracing. Without the flag every TRACE_* macro compiles
+// to nothing.
+//
+// Event names must be string literals (or other static strings): only the
+// pointer is recorded, and names are resolved when dumping.
+
+#define TRACE_EVENTS 1024        // Power of two, 16 bytes each
+#define TRACE_STREAM_CHUNK 256   // Streaming flushes once this many are pending
+
+enum TraceType : uint8_t {
+    TRACE_TYPE_BEGIN,
+    TRACE_TYPE_END,
+    TRACE_TYPE_INSTANT,
+    TRACE_TYPE_COUNTER
+};
+
+struct TraceEvent {
+    uint32_t tsUs;      // Low 32 bits of esp_timer time; the host unwraps
+    const char* name;
+    int32_t value;      // Counter value
+    uint8_t type;
+    uint8_t tid;        // TaskId, TASK_COUNT for anything else
+    uint8_t core;
+    uint8_t reserved;
+};
+
+class Trace {
+public:
+    static void record(uint8_t type, const char* name, int32_t value);
+    static void dump();               // Everything not yet flushed
+    static void setStreaming(bool on);
+    static void poll();               // From loop(): flushes when streaming
+};
+
+#ifdef LUCID_TRACE
+#define TRACE_BEGIN(name) Trace::record(TRACE_TYPE_BEGIN, name, 0)
+#define TRACE_END(name) Trace::record(TRACE_TYPE_END, name, 0)
+#define TRACE_INSTANT(name) Trace::record(TRACE_TYPE_INSTANT, name, 0)
+#define TRACE_COUNTER(name, value) Trace::record(TRACE_TYPE_COUNTER, name, (int32_t)(value))
+#else
+#define TRACE_BEGIN(name) do {} while (0)
+#define TRACE_END(name) do {} while (0)
+#define TRACE_INSTANT(name) do {} while (0)
+#define TRACE_COUNTER(name, value) do {} while (0)
+#endif
+
+#endif
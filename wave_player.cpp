@@ -0,0 +1,99 @@
+#include "wave_player.h"
+#include "config.h"
+#include "wave_synth.h"
+#include <atomic>
+#include <soc/ledc_struct.h>
+
+// Arduino's LEDC channels 0-7 are the high-speed group, 8-15 low-speed
+#define LEDC_GROUP (BUZZER_CHANNEL / 8)
+#define LEDC_INDEX (BUZZER_CHANNEL % 8)
+
+static DRAM_ATTR uint8_t ring[WAVE_BUFFER_SAMPLES];
+static DRAM_ATTR volatile uint32_t readPos = 0;
+static std::atomic<int> drainedHalf(-1);
+static TaskHandle_t notifyTask = NULL;
+static hw_timer_t* timer = NULL;
+
+static DRAM_ATTR volatile uint32_t statSamples = 0;
+static DRAM_ATTR volatile uint32_t statUnderruns = 0;
+#ifdef LUCID_PROFILE
+static DRAM_ATTR volatile uint32_t statCyclesMax = 0;
+static DRAM_ATTR volatile uint64_t statCyclesTotal = 0;
+#endif
+
+// ledcWrite() takes a lock and lives in flash, so write the duty register
+// directly: 4 fractional bits, then latch it at the next PWM period. The
+// low-speed group would also need its update bit.
+static void IRAM_ATTR sampleIsr() {
+#ifdef LUCID_PROFILE
+    uint32_t start = ESP.getCycleCount();
+#endif
+    uint32_t pos = readPos;
+    LEDC.channel_group[LEDC_GROUP].channel[LEDC_INDEX].duty.duty = (uint32_t)ring[pos] << 4;
+    LEDC.channel_group[LEDC_GROUP].channel[LEDC_INDEX].conf1.duty_start = 1;
+    pos = (pos + 1) & (WAVE_BUFFER_SAMPLES - 1);
+    readPos = pos;
+    statSamples = statSamples + 1;
+
+    if ((pos & (WAVE_HALF_SAMPLES - 1)) == 0) {
+        if (drainedHalf.exchange(pos ? 0 : 1) >= 0) statUnderruns = statUnderruns + 1;
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(notifyTask, &woken);
+        if (woken) portYIELD_FROM_ISR();
+    }
+#ifdef LUCID_PROFILE
+    uint32_t cycles = ESP.getCycleCount() - start;
+    statCyclesTotal = statCyclesTotal + cycles;
+    if (cycles > statCyclesMax) statCyclesMax = cycles;
+#endif
+}
+
+void WavePlayer::begin() {
+    timer = timerBegin(WAVE_TIMER, 80, true);  // 1 MHz tick
+    timerAttachInterrupt(timer, sampleIsr, true);
+    timerAlarmWrite(timer, 1000000UL / WAVE_SAMPLE_RATE, true);
+}
+
+uint8_t* WavePlayer::buffer() {
+    return ring;
+}
+
+void WavePlayer::start(TaskHandle_t notify) {
+    notifyTask = notify;
+    readPos = 0;
+    drainedHalf.store(-1);
+    ledcChangeFrequency(BUZZER_CHANNEL, WAVE_PWM_HZ, 8);
+    ledcWrite(BUZZER_CHANNEL, ring[0]);
+    timerWrite(timer, 0);
+    timerAlarmEnable(timer);
+}
+
+void WavePlayer::stop() {
+    timerAlarmDisable(timer);
+    ledcWrite(BUZZER_CHANNEL, 0);
+}
+
+int WavePlayer::takeDrained() {
+    return drainedHalf.exchange(-1);
+}
+
+void WavePlayer::stats(WaveStats& out) {
+    out.samples = statSamples;
+    out.underruns = statUnderruns;
+#ifdef LUCID_PROFILE
+    out.cyclesMax = statCyclesMax;
+    out.cyclesTotal = statCyclesTotal;
+#else
+    out.cyclesMax = 0;
+    out.cyclesTotal = 0;
+#endif
+}
+
+void WavePlayer::resetStats() {
+    statSamples = 0;
+    statUnderruns = 0;
+#ifdef LUCID_PROFILE
+    statCyclesMax = 0;
+    statCyclesTotal = 0;
+#endif
+}
@@ -0,0 +1,41 @@
+#ifndef WAVE_PLAYER_H
+#define WAVE_PLAYER_H
+
+#include <Arduino.h>
+
+// PWM sample playback on the buzzer
+// A hardware timer fires at WAVE_SAMPLE_RATE and its ISR copies the next
+// byte of a ring buffer into the buzzer's LEDC duty register - a load, two
+// register writes and, every half ring, a task notification. Rendering
+// (wave_synth.h) stays in the audio task, which refills each half as the
+// ISR drains it, so the ISR cost is fixed whatever the cue. While playing,
+// the LEDC channel runs at WAVE_PWM_HZ, far above hearing; the buzzer
+// follows the average duty. Audio task only.
+//   LUCID_PROFILE: the ISR counts its own cycles (stats())
+
+#define WAVE_TIMER 0                // pcprof.h uses timers 2 and 3
+#define WAVE_PWM_HZ 78125           // 80 MHz / 2^8 / 4
+#define WAVE_BUFFER_SAMPLES 512     // 64 ms, refilled 32 ms at a time
+#define WAVE_HALF_SAMPLES (WAVE_BUFFER_SAMPLES / 2)
+#define WAVE_STALL_MS 100           // No half drained in this long: give up
+
+struct WaveStats {
+    uint32_t samples;
+    uint32_t underruns;    // Halves the ISR reached before they were refilled
+    uint32_t cyclesMax;    // LUCID_PROFILE only
+    uint64_t cyclesTotal;
+};
+
+class WavePlayer {
+public:
+    static void begin();   // From the audio task, so the ISR runs on its core
+    static uint8_t* buffer();
+    static void start(TaskHandle_t notify);  // Ring must hold the first samples
+    static void stop();
+    static int takeDrained();  // Half (0/1) the ISR finished since last asked, or -1
+
+    static void stats(WaveStats& out);
+    static void resetStats();
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "wave_synth.h"
+
+// Fundamental + 0.35 x 2nd + 0.2 x 3rd harmonic, peak 127
+static const int8_t WAVE_TABLE[256] = {
+    0, 6, 12, 18, 24, 29, 35, 41, 46, 52, 57, 62, 67, 72, 77, 81,
+    85, 90, 94, 97, 101, 104, 107, 110, 113, 115, 117, 119, 121, 123, 124, 125,
+    126, 126, 127, 127, 127, 127, 126, 126, 125, 124, 123, 122, 121, 120, 118, 117,
+    115, 113, 111, 109, 107, 106, 104, 102, 99, 97, 95, 93, 91, 90, 88, 86,
+    84, 82, 80, 79, 77, 76, 74, 73, 71, 70, 69, 68, 67, 66, 65, 64,
+    63, 62, 61, 61, 60, 59, 59, 58, 57, 57, 56, 56, 55, 54, 54, 53,
+    52, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43, 41, 40, 38, 37, 35,
+    34, 32, 30, 28, 26, 24, 22, 20, 18, 16, 14, 11, 9, 7, 5, 2,
+    0, -2, -5, -7, -9, -11, -14, -16, -18, -20, -22, -24, -26, -28, -30, -32,
+    -34, -35, -37, -38, -40, -41, -43, -44, -45, -46, -47, -48, -49, -50, -51, -52,
+    -52, -53, -54, -54, -55, -56, -56, -57, -57, -58, -59, -59, -60, -61, -61, -62,
+    -63, -64, -65, -66, -67, -68, -69, -70, -71, -73, -74, -76, -77, -79, -80, -82,
+    -84, -86, -88, -90, -91, -93, -95, -97, -99, -102, -104, -106, -107, -109, -111, -113,
+    -115, -117, -118, -120, -121, -122, -123, -124, -125, -126, -126, -127, -127, -127, -127, -126,
+    -126, -125, -124, -123, -121, -119, -117, -115, -113, -110, -107, -104, -101, -97, -94, -90,
+    -85, -81, -77, -72, -67, -62, -57, -52, -46, -41, -35, -29, -24, -18, -12, -6
+};
+
+static int32_t stepSamples(const CuePattern& pattern, int index) {
+    if (pattern.voice == CUE_VOICE_CLIP) return (int32_t)pattern.clipBytes * 2;
+    return (int32_t)pattern.steps[index].durationMs * WAVE_SAMPLE_RATE / 1000;
+}
+
+WaveSynth::WaveSynth() : pattern(0), stage(STAGE_DONE) {
+}
+
+void WaveSynth::start(const CuePattern& p) {
+    pattern = &p;
+    stage = STAGE_RISE;
+    stageSamples = 0;
+    stepIndex = 0;
+    phase = 0;
+}
+
+void WaveSynth::beginStep() {
+    const CueStep& step = pattern->steps[stepIndex];
+    stageSamples = stepSamples(*pattern, stepIndex);
+    stepPos = 0;
+    amplitude = step.level > 127 ? 127 : step.level;
+    phaseInc = (uint32_t)(((uint64_t)step.freqHz << 32) / WAVE_SAMPLE_RATE);
+    if (pattern->voice == CUE_VOICE_CLIP) {
+        decoder.reset();
+        clipPos = pattern->clip;
+        clipHeld = 0;
+    }
+}
+
+// Signed sample, at most +/-127
+int32_t WaveSynth::nextBodySample() {
+    if (pattern->voice == CUE_VOICE_CLIP) {
+        if (!clipHeld) {
+            decoder.decode(clipPos++, 1, clipPair);
+            clipHeld = 2;
+        }
+        int32_t pcm = clipPair[2 - clipHeld--];
+        return pcm * amplitude >> 15;
+    }
+    if (!phaseInc) return 0;
+
+    // min(attack ramp, release ramp, full), 0-256
+    int32_t envelope = stepPos * (256 / WAVE_ATTACK_SAMPLES);
+    int32_t release = stageSamples * (256 / WAVE_RELEASE_SAMPLES);
+    if (release < envelope) envelope = release;
+    if (envelope > 256) envelope = 256;
+
+    int32_t s = WAVE_TABLE[phase >> 24] * amplitude * envelope >> 15;
+    phase += phaseInc;
+    return s;
+}
+
+int WaveSynth::render(uint8_t* out, int count) {
+    int n = 0;
+    while (n < count && stage != STAGE_DONE) {
+        switch (stage) {
+            case STAGE_RISE:
+                out[n++] = (uint8_t)(stageSamples * WAVE_DUTY_MID / WAVE_BIAS_SAMPLES);
+                if (++stageSamples == WAVE_BIAS_SAMPLES) {
+                    stage = STAGE_BODY;
+                    beginStep();
+                }
+                break;
+
+            case STAGE_BODY:
+                if (stageSamples == 0) {
+                    if (++stepIndex >= pattern->count || pattern->voice == CUE_VOICE_CLIP) {
+                        stage = STAGE_FALL;
+                        stageSamples = WAVE_BIAS_SAMPLES;
+                    } else {
+                        beginStep();
+                    }
+                    break;
+                }
+                out[n++] = (uint8_t)(WAVE_DUTY_MID + nextBodySample());
+                stepPos++;
+                stageSamples--;
+                break;
+
+            case STAGE_FALL:
+                out[n++] = (uint8_t)(--stageSamples * WAVE_DUTY_MID / WAVE_BIAS_SAMPLES);
+                if (stageSamples == 0) stage = STAGE_DONE;
+                break;
+
+            default:
+                break;
+        }
+    }
+    return n;
+}
+
+uint32_t WaveSynth::lengthSamples(const CuePattern& p) {
+    uint32_t total = 2 * WAVE_BIAS_SAMPLES;
+    int steps = p.voice == CUE_VOICE_CLIP ? 1 : p.count;
+    for (int i = 0; i < steps; i++) total += stepSamples(p, i);
+    return total;
+}
@@ -0,0 +1,63 @@
+#ifndef WAVE_SYNTH_H
+#define WAVE_SYNTH_H
+
+#include <stdint.h>
+#include "cue.h"
+#include "adpcm.h"
+
+// Wave and clip cue voices, rendered to PWM duty samples
+// The audio task renders ahead into wave_player.h's ring; the timer ISR
+// only copies one byte per sample to the LEDC duty register. Samples are
+// duty values around WAVE_DUTY_MID, so the buzzer sees the waveform as the
+// average of a fast carrier:
+//   wave - each step a note from a 256-entry table (fundamental with 2nd
+//          and 3rd harmonics, which small buzzers reproduce better than a
+//          sine), phase accumulator, amplitude = level (capped at 127),
+//          linear attack over WAVE_ATTACK_SAMPLES and release over the
+//          last WAVE_RELEASE_SAMPLES of the step. Keep notes under about
+//          1300 Hz so the 3rd harmonic stays below Nyquist.
+//   clip - IMA-ADPCM from flash, scaled by level / 128
+// A cue starts and ends with a WAVE_BIAS_SAMPLES ramp between duty 0 and
+// the mid duty, so the carrier's DC doesn't click. No Arduino dependencies -
+// tools/cue_to_wav.cpp renders cues to WAV on a host with this code.
+
+#define WAVE_SAMPLE_RATE 8000
+#define WAVE_DUTY_MID 128
+#define WAVE_ATTACK_SAMPLES 64      // 8 ms
+#define WAVE_RELEASE_SAMPLES 256    // 32 ms
+#define WAVE_BIAS_SAMPLES 64        // 8 ms
+
+class WaveSynth {
+private:
+    enum Stage : uint8_t { STAGE_RISE, STAGE_BODY, STAGE_FALL, STAGE_DONE };
+
+    const CuePattern* pattern;
+    Stage stage;
+    uint8_t stepIndex;
+    int32_t stageSamples;   // Rise/fall position, or samples left in the step
+    int32_t stepPos;        // Samples into the step
+    uint32_t phase;
+    uint32_t phaseInc;
+    int32_t amplitude;
+    AdpcmDecoder decoder;
+    const uint8_t* clipPos;
+    int16_t clipPair[2];
+    uint8_t clipHeld;       // Samples of clipPair still to play
+
+    void beginStep();
+    int32_t nextBodySample();
+
+public:
+    WaveSynth();
+
+    // pattern must outlive the render (the cue tables are static)
+    void start(const CuePattern& pattern);
+    // Up to count duty samples; fewer only once the cue is done
+    int render(uint8_t* out, int count);
+    bool done() const { return stage == STAGE_DONE; }
+
+    // Samples a pattern renders to, ramps included
+    static uint32_t lengthSamples(const CuePattern& pattern);
+};
+
+#endif
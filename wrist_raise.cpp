@@ -0,0 +1,101 @@
+#include "wrist_raise.h"
+
+#define Q12_ONE 4096
+#define DEG_TO_RAD_Q12 71.4887f  // 4096 * pi / 180
+
+WristRaise::WristRaise() {
+    reset();
+}
+
+void WristRaise::reset() {
+    gravX = 0;
+    gravY = 0;
+    gravZ = 0;
+    initialized = false;
+    armed = false;
+    holding = false;
+    lastSampleTime = 0;
+    lastLowTime = 0;
+    holdStartTime = 0;
+}
+
+bool WristRaise::update(float ax, float ay, float az, float gx, float gy, float gz, unsigned long now) {
+    int32_t accX = (int32_t)(ax * Q12_ONE);
+    int32_t accY = (int32_t)(ay * Q12_ONE);
+    int32_t accZ = (int32_t)(az * Q12_ONE);
+
+    if (!initialized) {
+        gravX = accX;
+        gravY = accY;
+        gravZ = accZ;
+        initialized = true;
+        lastSampleTime = now;
+        return false;
+    }
+
+    unsigned long dt = now - lastSampleTime;
+    if (dt > 500) dt = 500;  // Don't integrate across gaps in the sample stream
+    lastSampleTime = now;
+
+    // Predict: a world-fixed vector rotates in the body frame as dg/dt = g x w
+    int32_t wx = (int32_t)(gx * DEG_TO_RAD_Q12);
+    int32_t wy = (int32_t)(gy * DEG_TO_RAD_Q12);
+    int32_t wz = (int32_t)(gz * DEG_TO_RAD_Q12);
+
+    int64_t dx = ((int64_t)gravY * wz - (int64_t)gravZ * wy) >> 12;
+    int64_t dy = ((int64_t)gravZ * wx - (int64_t)gravX * wz) >> 12;
+    int64_t dz = ((int64_t)gravX * wy - (int64_t)gravY * wx) >> 12;
+
+    int32_t predX = gravX + (int32_t)(dx * (int64_t)dt / 1000);
+    int32_t predY = gravY + (int32_t)(dy * (int64_t)dt / 1000);
+    int32_t predZ = gravZ + (int32_t)(dz * (int64_t)dt / 1000);
+
+    // Correct: pull the prediction towards the measured acceleration
+    gravX = (predX * (256 - WRIST_ACCEL_WEIGHT) + accX * WRIST_ACCEL_WEIGHT) >> 8;
+    gravY = (predY * (256 - WRIST_ACCEL_WEIGHT) + accY * WRIST_ACCEL_WEIGHT) >> 8;
+    gravZ = (predZ * (256 - WRIST_ACCEL_WEIGHT) + accZ * WRIST_ACCEL_WEIGHT) >> 8;
+
+    // Face turned away (arm down or to the side) arms the detector
+    if (gravZ < WRIST_LOW_Z_Q12) {
+        lastLowTime = now;
+        armed = true;
+        holding = false;
+        return false;
+    }
+
+    if (!armed) return false;
+
+    if (gravZ < WRIST_VIEW_Z_Q12) {
+        holding = false;
+        return false;
+    }
+
+    if (!holding) {
+        // Too slow - the face drifted into view rather than being raised
+        if (now - lastLowTime > WRIST_RAISE_WINDOW_MS) {
+            armed = false;
+            return false;
+        }
+        holding = true;
+        holdStartTime = now;
+    }
+
+    // Still turning - restart the hold period
+    int32_t rateSq = (int32_t)(gx * gx + gy * gy + gz * gz);
+    if (rateSq > WRIST_HOLD_GYRO_DPS * WRIST_HOLD_GYRO_DPS) {
+        holdStartTime = now;
+        return false;
+    }
+
+    if (now - holdStartTime >= WRIST_HOLD_MS) {
+        armed = false;  // One wake per raise
+        holding = false;
+        return true;
+    }
+
+    return false;
+}
+
+bool WristRaise::isInView() {
+    return initialized && gravZ >= WRIST_VIEW_Z_Q12;
+}
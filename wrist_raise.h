@@ -0,0 +1,40 @@
+#ifndef WRIST_RAISE_H
+#define WRIST_RAISE_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Wrist-raise (tilt-to-view) detector
+// Tracks the gravity vector with a fixed-point complementary filter and fires
+// on the raise-and-hold trajectory: face pointing away, then turned up towards
+// the wearer within WRIST_RAISE_WINDOW_MS and held steady for WRIST_HOLD_MS.
+// Short bumps barely move the filtered gravity, so they don't wake the panel.
+// No Arduino dependencies; tools/wrist_replay.cpp replays labelled traces
+// through it on a host.
+
+class WristRaise {
+private:
+    // Gravity estimate, Q12 g (4096 = 1 g)
+    int32_t gravX;
+    int32_t gravY;
+    int32_t gravZ;
+    bool initialized;
+    bool armed;
+    bool holding;
+    unsigned long lastSampleTime;
+    unsigned long lastLowTime;
+    unsigned long holdStartTime;
+
+public:
+    WristRaise();
+    void reset();
+
+    // Feed one sample (accel in g, gyro in deg/s). Returns true on a raise.
+    bool update(float ax, float ay, float az, float gx, float gy, float gz, unsigned long now);
+
+    // Face currently turned towards the wearer
+    bool isInView();
+    int32_t getGravityZ() { return gravZ; }
+};
+
+#endif